@@ -1,3 +1,12 @@
 #pragma once
 
 #include "audio/StemPlayer.h"
+#include "audio/ParameterHandles.h"
+#include "audio/RealtimeSanitizer.h"
+#include "audio/Profiler.h"
+#include "audio/TruePeak.h"
+#include "audio/LoudnessMeter.h"
+#include "audio/MeterFifo.h"
+#include "audio/MinMaxPyramid.h"
+#include "audio/RealFft.h"
+#include "audio/PartitionedConvolver.h"
@@ -0,0 +1,323 @@
+#pragma once
+#include "TruePeak.h"
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace audio {
+
+/**
+ * Streaming EBU R128 / ITU-R BS.1770-4 loudness meter: momentary (400 ms), short-term (3 s),
+ * gated integrated loudness, loudness range (EBU Tech 3342) and maximum true peak.
+ *
+ * Audio is K-weighted per channel (two biquads, double state) and reduced to one mean-square
+ * energy per 100 ms; every reading is derived from that 10 Hz sequence. Each completed 400 ms
+ * and 3 s window drops into a fixed 0.1 LU histogram, so gating costs O(1) per window and one
+ * short scan per 100 ms regardless of programme length. All storage is fixed-size:
+ * process() never allocates or locks.
+ */
+class LoudnessMeter
+{
+public:
+    static constexpr int kMaxChannels = 16; // up to 9.1.6
+
+    /** Reported for loudness with nothing to measure (silence, or not enough audio yet). */
+    static constexpr float kNoLevel = -std::numeric_limits<float>::infinity();
+
+    struct Readings
+    {
+        float momentary  = kNoLevel;  // LUFS
+        float shortTerm  = kNoLevel;  // LUFS
+        float integrated = kNoLevel;  // LUFS
+        float range      = 0.0f;      // LU
+        float truePeakDb = kNoLevel;  // dBTP, maximum since reset
+    };
+
+    /** Allocation-free; call before processing and whenever the rate or channel count changes. */
+    void prepare(double sampleRate, int numChannelsToUse) noexcept
+    {
+        numChannels = juce::jlimit(1, kMaxChannels, numChannelsToUse);
+        subBlockLength = juce::jmax(1, (int)std::lround(sampleRate * 0.1));
+        designKWeighting(sampleRate);
+        reset();
+    }
+
+    /** BS.1770 channel weight: 1 for L/R/C, 1.41 for surrounds, 0 to skip an LFE channel. */
+    void setChannelWeight(int channel, float weight) noexcept
+    {
+        if (channel >= 0 && channel < kMaxChannels)
+            weights[(size_t)channel] = weight;
+    }
+
+    /** Starts a new measurement: clears the windows, the gating histograms and the peak. */
+    void reset() noexcept
+    {
+        for (auto& s : kState) s = {};
+        for (auto& t : truePeak) t.reset();
+        subBlockEnergy.fill(0.0);
+        subBlockFill = 0;
+        windowEnergy.fill(0.0);
+        windowPos = 0;
+        subBlocksSeen = 0;
+
+        momentaryHist.fill({});
+        momentaryEnergySum = 0.0;
+        momentaryCount = 0;
+        shortTermHist.fill(0);
+        shortTermEnergySum = 0.0;
+        shortTermCount = 0;
+
+        readings = {};
+    }
+
+    /** channels: numChannels pointers (as passed to prepare) of numSamples each. */
+    void process(const float* const* channels, int numSamples) noexcept
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+            truePeak[(size_t)ch].process(channels[ch], numSamples);
+
+        for (int pos = 0; pos < numSamples;)
+        {
+            const int n = juce::jmin(numSamples - pos, subBlockLength - subBlockFill);
+            for (int ch = 0; ch < numChannels; ++ch)
+                subBlockEnergy[(size_t)ch] += kWeightedSumOfSquares(kState[(size_t)ch], channels[ch] + pos, n);
+
+            pos += n;
+            subBlockFill += n;
+            if (subBlockFill == subBlockLength)
+                completeSubBlock();
+        }
+
+        float tp = 0.0f;
+        for (int ch = 0; ch < numChannels; ++ch)
+            tp = juce::jmax(tp, truePeak[(size_t)ch].getPeak());
+        readings.truePeakDb = tp > 0.0f ? 20.0f * std::log10(tp) : kNoLevel;
+    }
+
+    /** Updated every 100 ms of audio (true peak every call). */
+    const Readings& getReadings() const noexcept { return readings; }
+
+    static float energyToLufs(double energy) noexcept
+    {
+        return energy > 0.0 ? (float)(-0.691 + 10.0 * std::log10(energy)) : kNoLevel;
+    }
+
+private:
+    static constexpr int kSubBlocksMomentary = 4;   // 400 ms
+    static constexpr int kSubBlocksShortTerm = 30;  // 3 s
+
+    // Gating histograms: 0.1 LU bins from the -70 LUFS absolute gate up to +5 LUFS
+    static constexpr float kHistMinLufs = -70.0f;
+    static constexpr float kHistStepLu = 0.1f;
+    static constexpr int kHistBins = 750;
+
+    struct Biquad { double b0 = 1, b1 = 0, b2 = 0, a1 = 0, a2 = 0; };
+    struct KState { double z1a = 0, z2a = 0, z1b = 0, z2b = 0; };
+    struct Bin { std::uint32_t count = 0; double energy = 0.0; };
+
+    // BS.1770 pre-filter (high shelf) and RLB high-pass, re-derived for any sample rate from the
+    // analogue prototypes so 44.1-192 kHz all match the 48 kHz reference coefficients.
+    void designKWeighting(double sampleRate) noexcept
+    {
+        const double pi = juce::MathConstants<double>::pi;
+        {
+            const double f0 = 1681.974450955533, gainDb = 3.999843853973347, q = 0.7071752369554196;
+            const double k = std::tan(pi * f0 / sampleRate);
+            const double vh = std::pow(10.0, gainDb / 20.0);
+            const double vb = std::pow(vh, 0.4996667741545416);
+            const double a0 = 1.0 + k / q + k * k;
+            shelf.b0 = (vh + vb * k / q + k * k) / a0;
+            shelf.b1 = 2.0 * (k * k - vh) / a0;
+            shelf.b2 = (vh - vb * k / q + k * k) / a0;
+            shelf.a1 = 2.0 * (k * k - 1.0) / a0;
+            shelf.a2 = (1.0 - k / q + k * k) / a0;
+        }
+        {
+            const double f0 = 38.13547087602444, q = 0.5003270373238773;
+            const double k = std::tan(pi * f0 / sampleRate);
+            const double a0 = 1.0 + k / q + k * k;
+            highPass.b0 = 1.0;
+            highPass.b1 = -2.0;
+            highPass.b2 = 1.0;
+            highPass.a1 = 2.0 * (k * k - 1.0) / a0;
+            highPass.a2 = (1.0 - k / q + k * k) / a0;
+        }
+    }
+
+    // Both filters (transposed direct form II) in one pass, state kept in registers for the run
+    double kWeightedSumOfSquares(KState& s, const float* x, int n) const noexcept
+    {
+        const Biquad f = shelf, h = highPass;
+        double z1a = s.z1a, z2a = s.z2a, z1b = s.z1b, z2b = s.z2b, sum = 0.0;
+        for (int i = 0; i < n; ++i)
+        {
+            const double in = (double)x[i];
+            const double y = f.b0 * in + z1a;
+            z1a = f.b1 * in - f.a1 * y + z2a;
+            z2a = f.b2 * in - f.a2 * y;
+
+            const double k = h.b0 * y + z1b;
+            z1b = h.b1 * y - h.a1 * k + z2b;
+            z2b = h.b2 * y - h.a2 * k;
+
+            sum += k * k;
+        }
+        s = { z1a, z2a, z1b, z2b };
+        return sum;
+    }
+
+    static int binFor(float lufs) noexcept
+    {
+        return juce::jlimit(0, kHistBins - 1, (int)std::floor((lufs - kHistMinLufs) / kHistStepLu));
+    }
+
+    static float binCentre(int bin) noexcept { return kHistMinLufs + ((float)bin + 0.5f) * kHistStepLu; }
+
+    double windowMean(int subBlocks) const noexcept
+    {
+        double sum = 0.0;
+        for (int i = 1; i <= subBlocks; ++i)
+            sum += windowEnergy[(size_t)((windowPos - i + kSubBlocksShortTerm) % kSubBlocksShortTerm)];
+        return sum / (double)subBlocks;
+    }
+
+    void completeSubBlock() noexcept
+    {
+        double energy = 0.0;
+        for (int ch = 0; ch < numChannels; ++ch)
+            energy += (double)weights[(size_t)ch] * subBlockEnergy[(size_t)ch];
+        energy /= (double)subBlockLength;
+
+        windowEnergy[(size_t)windowPos] = energy;
+        windowPos = (windowPos + 1) % kSubBlocksShortTerm;
+        ++subBlocksSeen;
+        subBlockEnergy.fill(0.0);
+        subBlockFill = 0;
+
+        // Windows reaching back before the start read the ring's zeros, i.e. leading silence
+        const double momentary = windowMean(kSubBlocksMomentary);
+        const double shortTerm = windowMean(kSubBlocksShortTerm);
+        readings.momentary = energyToLufs(momentary);
+        readings.shortTerm = energyToLufs(shortTerm);
+
+        // Gating blocks: 400 ms with 75% overlap (integrated), 3 s at 10 Hz (range)
+        if (subBlocksSeen >= kSubBlocksMomentary && readings.momentary >= kHistMinLufs)
+        {
+            auto& bin = momentaryHist[(size_t)binFor(readings.momentary)];
+            ++bin.count;
+            bin.energy += momentary;
+            momentaryEnergySum += momentary;
+            ++momentaryCount;
+            readings.integrated = gatedIntegrated();
+        }
+
+        if (subBlocksSeen >= kSubBlocksShortTerm && readings.shortTerm >= kHistMinLufs)
+        {
+            ++shortTermHist[(size_t)binFor(readings.shortTerm)];
+            shortTermEnergySum += shortTerm;
+            ++shortTermCount;
+            readings.range = loudnessRange();
+        }
+    }
+
+    // BS.1770-4: mean of the blocks above -70 LUFS sets a relative gate 10 LU below it; the
+    // integrated loudness is the mean of the blocks above both gates.
+    float gatedIntegrated() const noexcept
+    {
+        const float relativeGate = energyToLufs(momentaryEnergySum / (double)momentaryCount) - 10.0f;
+        double energy = 0.0;
+        std::uint64_t count = 0;
+        for (int b = binFor(relativeGate); b < kHistBins; ++b)
+        {
+            energy += momentaryHist[(size_t)b].energy;
+            count += momentaryHist[(size_t)b].count;
+        }
+        return count > 0 ? energyToLufs(energy / (double)count) : kNoLevel;
+    }
+
+    // EBU Tech 3342: short-term values above the -70 LUFS and -20 LU relative gates; the range is
+    // the spread between their 10th and 95th percentiles.
+    float loudnessRange() const noexcept
+    {
+        const float relativeGate = energyToLufs(shortTermEnergySum / (double)shortTermCount) - 20.0f;
+        const int first = binFor(relativeGate);
+        std::uint64_t total = 0;
+        for (int b = first; b < kHistBins; ++b)
+            total += shortTermHist[(size_t)b];
+        if (total == 0)
+            return 0.0f;
+
+        const auto percentile = [&](double fraction) {
+            const auto target = (std::uint64_t)std::llround((double)(total - 1) * fraction);
+            std::uint64_t seen = 0;
+            for (int b = first; b < kHistBins; ++b)
+            {
+                seen += shortTermHist[(size_t)b];
+                if (seen > target)
+                    return binCentre(b);
+            }
+            return binCentre(kHistBins - 1);
+        };
+        return percentile(0.95) - percentile(0.10);
+    }
+
+    int numChannels = 2;
+    int subBlockLength = 4800;
+    Biquad shelf, highPass;
+    std::array<float, kMaxChannels> weights { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+    std::array<KState, kMaxChannels> kState {};
+    std::array<TruePeakMeter, kMaxChannels> truePeak {};
+
+    std::array<double, kMaxChannels> subBlockEnergy {}; // sum of squares so far, per channel
+    int subBlockFill = 0;
+    std::array<double, kSubBlocksShortTerm> windowEnergy {}; // last 3 s of 100 ms energies
+    int windowPos = 0;
+    std::uint64_t subBlocksSeen = 0;
+
+    std::array<Bin, kHistBins> momentaryHist {};
+    double momentaryEnergySum = 0.0;
+    std::uint64_t momentaryCount = 0;
+    std::array<std::uint32_t, kHistBins> shortTermHist {};
+    double shortTermEnergySum = 0.0;
+    std::uint64_t shortTermCount = 0;
+
+    Readings readings;
+};
+
+/**
+ * LoudnessMeter::Readings shared between the audio thread (store) and the UI (load).
+ * Each field is its own relaxed atomic: readers may see fields from neighbouring updates, which
+ * is harmless for independent meter values.
+ */
+class PublishedLoudness
+{
+public:
+    void store(const LoudnessMeter::Readings& r) noexcept
+    {
+        momentary.store(r.momentary, std::memory_order_relaxed);
+        shortTerm.store(r.shortTerm, std::memory_order_relaxed);
+        integrated.store(r.integrated, std::memory_order_relaxed);
+        range.store(r.range, std::memory_order_relaxed);
+        truePeakDb.store(r.truePeakDb, std::memory_order_relaxed);
+    }
+
+    LoudnessMeter::Readings load() const noexcept
+    {
+        LoudnessMeter::Readings r;
+        r.momentary = momentary.load(std::memory_order_relaxed);
+        r.shortTerm = shortTerm.load(std::memory_order_relaxed);
+        r.integrated = integrated.load(std::memory_order_relaxed);
+        r.range = range.load(std::memory_order_relaxed);
+        r.truePeakDb = truePeakDb.load(std::memory_order_relaxed);
+        return r;
+    }
+
+private:
+    std::atomic<float> momentary { LoudnessMeter::kNoLevel }, shortTerm { LoudnessMeter::kNoLevel },
+                       integrated { LoudnessMeter::kNoLevel }, range { 0.0f },
+                       truePeakDb { LoudnessMeter::kNoLevel };
+};
+
+} // namespace audio
@@ -0,0 +1,150 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace audio {
+
+/**
+ * Peak, mean-square and gain-reduction summary of a run of samples for N lanes (channels or
+ * bands). The audio thread fills one per few milliseconds and pushes it through a MeterFifo;
+ * the UI merges whatever arrived since its last frame, so no peak falls between timer ticks.
+ */
+template <int N>
+struct MeterFrame
+{
+    static constexpr int kLanes = N;
+
+    std::array<float, N> peak {};        // max |x|, linear
+    std::array<float, N> sumSquares {};  // weighted sum of x^2 (see addLevels)
+    std::array<float, N> grMinDb {};     // gain reduction range over the frame, dB >= 0
+    std::array<float, N> grMaxDb {};
+    int numSamples = 0;                  // samples of time covered
+
+    MeterFrame() noexcept { clear(); }
+
+    void clear() noexcept
+    {
+        peak.fill(0.0f);
+        sumSquares.fill(0.0f);
+        grMinDb.fill(std::numeric_limits<float>::max()); // until the first addGainReduction()
+        grMaxDb.fill(0.0f);
+        numSamples = 0;
+    }
+
+    /** Adds a block of one lane's audio. For a lane fed by several channels pass
+        weight = 1 / numChannels, so rmsDb() stays the mean over channels. */
+    void addLevels(int lane, const float* x, int n, float weight = 1.0f) noexcept
+    {
+        const auto range = juce::FloatVectorOperations::findMinAndMax(x, n);
+        peak[(size_t)lane] = std::max(peak[(size_t)lane], std::max(-range.getStart(), range.getEnd()));
+        float sum = 0.0f;
+        for (int i = 0; i < n; ++i)
+            sum += x[i] * x[i];
+        sumSquares[(size_t)lane] += weight * sum;
+    }
+
+    void addGainReduction(int lane, float grDb) noexcept
+    {
+        grMinDb[(size_t)lane] = std::min(grMinDb[(size_t)lane], grDb);
+        grMaxDb[(size_t)lane] = std::max(grMaxDb[(size_t)lane], grDb);
+    }
+
+    /** Call once per block after adding every lane. */
+    void advance(int n) noexcept { numSamples += n; }
+
+    /** Extends this frame to cover other as well (frames are consecutive). */
+    void merge(const MeterFrame& other) noexcept
+    {
+        for (size_t i = 0; i < (size_t)N; ++i)
+        {
+            peak[i] = std::max(peak[i], other.peak[i]);
+            sumSquares[i] += other.sumSquares[i];
+            grMinDb[i] = std::min(grMinDb[i], other.grMinDb[i]);
+            grMaxDb[i] = std::max(grMaxDb[i], other.grMaxDb[i]);
+        }
+        numSamples += other.numSamples;
+    }
+
+    float peakDb(int lane, float floorDb = -100.0f) const noexcept
+    {
+        return juce::Decibels::gainToDecibels(peak[(size_t)lane], floorDb);
+    }
+
+    float rmsDb(int lane, float floorDb = -100.0f) const noexcept
+    {
+        const float ms = numSamples > 0 ? sumSquares[(size_t)lane] / (float)numSamples : 0.0f;
+        return juce::Decibels::gainToDecibels(std::sqrt(ms), floorDb);
+    }
+};
+
+/**
+ * Single-producer / single-consumer ring of trivially copyable meter records.
+ * The audio thread push()es (wait-free; a full ring drops the new record rather than block);
+ * the UI thread pop()s everything that arrived in at most two memcpy spans. The two indices and
+ * the slots sit on separate cache lines, so producer and consumer never write the same line.
+ */
+template <typename Record, int Capacity>
+class MeterFifo
+{
+    static_assert(std::is_trivially_copyable<Record>::value, "records are copied with memcpy");
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+public:
+    static constexpr int kCapacity = Capacity;
+
+    /** Producer (audio thread). Returns false if the consumer is a full ring behind. */
+    bool push(const Record& record) noexcept
+    {
+        const auto w = writeIndex.load(std::memory_order_relaxed);
+        if (w - readIndex.load(std::memory_order_acquire) == (std::uint32_t)Capacity)
+            return false;
+
+        std::memcpy(&slots[w & kMask], &record, sizeof(Record));
+        writeIndex.store(w + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Consumer (UI thread). Moves up to maxRecords of the oldest records into dest, oldest
+        first, and returns how many. */
+    int pop(Record* dest, int maxRecords) noexcept
+    {
+        const auto r = readIndex.load(std::memory_order_relaxed);
+        const auto ready = writeIndex.load(std::memory_order_acquire) - r;
+        const int n = (int)std::min<std::uint32_t>(ready, (std::uint32_t)std::max(0, maxRecords));
+
+        const int first = std::min(n, Capacity - (int)(r & kMask));
+        std::memcpy(dest, &slots[r & kMask], sizeof(Record) * (size_t)first);
+        std::memcpy(dest + first, &slots[0], sizeof(Record) * (size_t)(n - first));
+
+        readIndex.store(r + (std::uint32_t)n, std::memory_order_release);
+        return n;
+    }
+
+    /** Consumer. Drops everything queued, e.g. when an editor opens on a long-running instance. */
+    void discardAll() noexcept
+    {
+        readIndex.store(writeIndex.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    /** Either side; a snapshot that may be stale by the time it is used. */
+    int getNumReady() const noexcept
+    {
+        return (int)(writeIndex.load(std::memory_order_acquire) - readIndex.load(std::memory_order_acquire));
+    }
+
+private:
+    static constexpr std::uint32_t kMask = (std::uint32_t)Capacity - 1;
+
+    alignas(64) std::atomic<std::uint32_t> writeIndex { 0 };
+    alignas(64) std::atomic<std::uint32_t> readIndex { 0 };
+    alignas(64) Record slots[Capacity];
+};
+
+} // namespace audio
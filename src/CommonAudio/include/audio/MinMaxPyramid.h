@@ -0,0 +1,124 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace audio {
+
+/**
+ * History of min/max columns at several resolutions, for scrolling scopes that zoom.
+ * Level 0 keeps the columns as pushed; level L keeps one merged column per 2^L of them. A
+ * range of base columns is answered by covering it with the fewest aligned blocks (at most two
+ * per level), so a pixel costs O(levels) whatever the zoom and a whole frame is O(pixels).
+ *
+ * Column must be default-constructible as "empty" and provide merge(const Column&).
+ * Not thread-safe: fill it on the thread that reads it (e.g. from a MeterFifo drain).
+ */
+template <typename Column>
+class MinMaxPyramid
+{
+public:
+    /** Keeps at least historyColumns base columns; allocates, so call off the audio thread. */
+    void prepare(int historyColumns, int numLevels)
+    {
+        jassert(historyColumns > 0 && numLevels > 0);
+        const int base = juce::nextPowerOfTwo(juce::jmax(2, historyColumns));
+        levels.resize((size_t)numLevels);
+        for (size_t L = 0; L < levels.size(); ++L)
+        {
+            levels[L].ring.assign((size_t)juce::jmax(2, base >> L), Column {});
+            levels[L].count = 0;
+        }
+    }
+
+    void clear()
+    {
+        for (auto& level : levels)
+        {
+            std::fill(level.ring.begin(), level.ring.end(), Column {});
+            level.count = 0;
+        }
+    }
+
+    /** Appends one base column; every second column at a level completes one at the next. */
+    void push(const Column& c)
+    {
+        Column carry = c;
+        for (size_t L = 0; L < levels.size(); ++L)
+        {
+            auto& level = levels[L];
+            level.ring[slot(level, level.count)] = carry;
+            if ((++level.count & 1) != 0 || L + 1 == levels.size())
+                break;
+            carry = level.ring[slot(level, level.count - 2)];
+            carry.merge(level.ring[slot(level, level.count - 1)]);
+        }
+    }
+
+    /** Base columns pushed so far (the index one past the newest). */
+    std::int64_t getNumColumns() const noexcept { return levels.empty() ? 0 : levels[0].count; }
+
+    int getNumLevels() const noexcept { return (int)levels.size(); }
+
+    /** Merge of base columns [begin, end). Parts that are in the future or already dropped
+        from the history contribute nothing, so such a range comes back (partly) empty. */
+    Column read(std::int64_t begin, std::int64_t end) const
+    {
+        Column out {};
+        begin = std::max<std::int64_t>(begin, 0);
+        end = std::min(end, getNumColumns());
+
+        while (begin < end)
+        {
+            // Largest aligned block that starts at begin and fits in the range
+            int L = 0;
+            while (L + 1 < (int)levels.size()
+                   && (begin & (((std::int64_t)2 << L) - 1)) == 0
+                   && begin + ((std::int64_t)2 << L) <= end)
+                ++L;
+
+            const auto& level = levels[(size_t)L];
+            const std::int64_t index = begin >> L;
+            if (index >= level.count - (std::int64_t)level.ring.size())
+                out.merge(level.ring[slot(level, index)]);
+            begin += (std::int64_t)1 << L;
+        }
+        return out;
+    }
+
+    /** Fills out[j] with the columns of pixel j when pixel j covers base columns
+        [floor((firstPixel + j) * columnsPerPixel), floor((firstPixel + j + 1) * columnsPerPixel)),
+        and at least one column when zoomed in past one column per pixel. */
+    void readPixels(std::int64_t firstPixel, double columnsPerPixel, Column* out, int numPixels) const
+    {
+        for (int j = 0; j < numPixels; ++j)
+        {
+            const auto b = pixelStart(firstPixel + j, columnsPerPixel);
+            const auto e = std::max(pixelStart(firstPixel + j + 1, columnsPerPixel), b + 1);
+            out[j] = read(b, e);
+        }
+    }
+
+    static std::int64_t pixelStart(std::int64_t pixel, double columnsPerPixel) noexcept
+    {
+        return (std::int64_t)std::floor((double)pixel * columnsPerPixel);
+    }
+
+private:
+    struct Level
+    {
+        std::vector<Column> ring; // power-of-two size
+        std::int64_t count = 0;   // columns ever written at this level
+    };
+
+    static size_t slot(const Level& level, std::int64_t index) noexcept
+    {
+        return (size_t)(index & (std::int64_t)(level.ring.size() - 1));
+    }
+
+    std::vector<Level> levels;
+};
+
+} // namespace audio
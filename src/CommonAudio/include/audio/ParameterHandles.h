@@ -0,0 +1,155 @@
+#pragma once
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace audio {
+
+/**
+ * Lock-free reference to one AudioProcessorValueTreeState parameter value.
+ * Resolved once by ID (which hashes the string); reading it afterwards is a single relaxed
+ * atomic load, so it is safe and cheap on the audio thread.
+ */
+class ParamHandle {
+public:
+    ParamHandle() = default;
+    explicit ParamHandle(std::atomic<float>* source) noexcept : value(source) {}
+
+    bool isValid() const noexcept { return value != nullptr; }
+
+    float get(float fallback = 0.0f) const noexcept
+    {
+        return value != nullptr ? value->load(std::memory_order_relaxed) : fallback;
+    }
+
+    bool getBool(bool fallback = false) const noexcept
+    {
+        return value != nullptr ? value->load(std::memory_order_relaxed) > 0.5f : fallback;
+    }
+
+    // Choice/int parameters store their index as a float
+    int getInt(int fallback = 0) const noexcept
+    {
+        return value != nullptr ? juce::roundToInt(value->load(std::memory_order_relaxed)) : fallback;
+    }
+
+private:
+    std::atomic<float>* value = nullptr;
+};
+
+/**
+ * Resolves ParamHandles from an AudioProcessorValueTreeState.
+ * Use it where allocation is fine (constructor, prepareToPlay); every lookup builds and hashes
+ * an ID. Indexed families follow the "<family>.<N>.<name>" scheme, e.g. band.2.ratio, eq.5.q.
+ */
+class ParameterHandles {
+public:
+    explicit ParameterHandles(const juce::AudioProcessorValueTreeState& stateToUse) noexcept
+        : state(stateToUse) {}
+
+    /** A parameter that must exist in the layout. */
+    ParamHandle operator[](const juce::String& id) const
+    {
+        auto* p = state.getRawParameterValue(id);
+        jassert(p != nullptr); // ID not in the parameter layout
+        return ParamHandle(p);
+    }
+
+    /** A parameter that may be missing (older layouts); an invalid handle reads as its fallback. */
+    ParamHandle optional(const juce::String& id) const
+    {
+        return ParamHandle(state.getRawParameterValue(id));
+    }
+
+    /** One member of an indexed family, e.g. indexed("band", 2, "ratio") -> band.2.ratio */
+    ParamHandle indexed(const char* family, int index, const char* name) const
+    {
+        return (*this)[indexedId(family, index, name)];
+    }
+
+    /** The same member for N consecutive indices starting at firstIndex. */
+    template <size_t N>
+    std::array<ParamHandle, N> family(const char* family, const char* name, int firstIndex = 1) const
+    {
+        std::array<ParamHandle, N> handles;
+        for (size_t i = 0; i < N; ++i)
+            handles[i] = indexed(family, firstIndex + (int) i, name);
+        return handles;
+    }
+
+    static juce::String indexedId(const char* family, int index, const char* name)
+    {
+        return juce::String(family) + "." + juce::String(index) + "." + name;
+    }
+
+private:
+    const juce::AudioProcessorValueTreeState& state;
+};
+
+/**
+ * Per-block copy of a fixed set of parameters with change flags.
+ * Bind each slot once (slots are addressed by the caller's own enum), then call update() at the
+ * top of processBlock: one relaxed load per slot, no hashing, no allocation. Code that derives
+ * expensive state (filter coefficients, smoothing targets) can test changed() and skip the work.
+ * The first update() after construction or invalidate() reports every slot as changed.
+ */
+template <size_t N>
+class ParamSnapshot {
+public:
+    static constexpr size_t size() noexcept { return N; }
+
+    void bind(size_t slot, ParamHandle handle, float fallback = 0.0f) noexcept
+    {
+        jassert(slot < N);
+        handles[slot] = handle;
+        fallbacks[slot] = fallback;
+        forceAll = true;
+    }
+
+    /** Reload every slot; returns true if any value differs from the previous update. */
+    bool update() noexcept
+    {
+        bool any = false;
+        for (size_t i = 0; i < N; ++i)
+        {
+            const float v = handles[i].get(fallbacks[i]);
+            const bool c = forceAll || v != values[i];
+            values[i] = v;
+            flags[i] = c;
+            any = any || c;
+        }
+        forceAll = false;
+        anyFlag = any;
+        return any;
+    }
+
+    /** Make the next update() flag every slot (e.g. after prepareToPlay rebuilt derived state). */
+    void invalidate() noexcept { forceAll = true; }
+
+    float operator[](size_t slot) const noexcept { return values[slot]; }
+    float get(size_t slot) const noexcept { return values[slot]; }
+    bool getBool(size_t slot) const noexcept { return values[slot] > 0.5f; }
+    int getInt(size_t slot) const noexcept { return juce::roundToInt(values[slot]); }
+
+    bool changed(size_t slot) const noexcept { return flags[slot]; }
+    bool anyChanged() const noexcept { return anyFlag; }
+
+    /** True if any of the count slots starting at first changed (one family member's group). */
+    bool changed(size_t first, size_t count) const noexcept
+    {
+        for (size_t i = first; i < first + count && i < N; ++i)
+            if (flags[i]) return true;
+        return false;
+    }
+
+private:
+    std::array<ParamHandle, N> handles {};
+    std::array<float, N> values {};
+    std::array<float, N> fallbacks {};
+    std::array<bool, N> flags {};
+    bool forceAll = true;
+    bool anyFlag = false;
+};
+
+} // namespace audio
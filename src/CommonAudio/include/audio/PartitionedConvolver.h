@@ -0,0 +1,507 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "RealFft.h"
+
+/**
+ * Zero-latency non-uniform partitioned convolution: one input, up to two outputs (a stereo IR
+ * driven from a mono feed shares every input transform).
+ *
+ * The first kHeadSize taps run as a direct FIR. The rest of the IR is split into levels of
+ * uniform partitions (overlap-save with a frequency-domain delay line per level) whose size grows
+ * 4x per level, 64, 256, 1024 .. kMaxPartition: each level covers six of its partitions (level
+ * one, seven) and starts two of its partitions into the IR, so a level's block transform has one
+ * block period of slack before its output is due. Level one has none and runs on the audio thread
+ * as its block completes; levels from kBackgroundPartition up are queued for a shared pool of
+ * worker threads (one per core, less one for the audio thread), so several levels and instances
+ * run in parallel. A job works in buffers of its own and the audio thread commits its result when
+ * the output is due. A job still queued by then is taken back and run inline; one a worker is
+ * still running is run again inline in the level's own buffers and the worker's result dropped,
+ * so the audio thread never waits for a worker. Without the pool every level runs inline, which
+ * gives the same output and the total CPU cost.
+ *
+ * prepare() allocates and transforms the IR; process() and reset() neither allocate, lock nor wait.
+ */
+namespace audio {
+
+class PartitionedConvolver
+{
+public:
+    static constexpr int kHeadSize = 64;
+    static constexpr int kMaxOutputs = 2;
+    static constexpr int kMaxPartition = 1 << 16;
+    static constexpr int kBackgroundPartition = 1024;
+
+    PartitionedConvolver() = default;
+    ~PartitionedConvolver() { detachWorker(); }
+
+    /** Loads numOutputs IRs of `length` samples each. Not real-time safe. */
+    void prepare(const float* const* ir, int numOutputs, int length, bool useBackgroundThread = true)
+    {
+        detachWorker();
+        outputs = juce::jlimit(1, kMaxOutputs, numOutputs);
+        irLength = juce::jmax(0, length);
+
+        for (int o = 0; o < outputs; ++o)
+        {
+            head[(size_t) o].fill(0.0f);
+            for (int j = 0; j < juce::jmin(kHeadSize, irLength); ++j)
+                head[(size_t) o][(size_t) (kHeadSize - 1 - j)] = ir[o][j]; // reversed
+        }
+
+        levels.clear();
+        int maxSize = 0;
+        for (int size = kHeadSize, offset = kHeadSize; offset < irLength; size *= 4)
+        {
+            auto lv = std::make_unique<Level>();
+            lv->size = size;
+            lv->offset = offset;
+            const int end = size == kMaxPartition ? irLength : juce::jmin(irLength, 8 * size);
+            lv->count = (end - offset + size - 1) / size;
+            lv->background = useBackgroundThread && size >= kBackgroundPartition;
+            lv->prepare(outputs, ir, irLength);
+            levels.push_back(std::move(lv));
+            maxSize = size;
+            offset = end;
+        }
+
+        int histSize = 2 * kHeadSize;
+        while (histSize < 2 * maxSize) histSize *= 2;
+        history.assign((size_t) histSize, 0.0f);
+        historyMask = histSize - 1;
+
+        reset();
+
+        if (std::any_of(levels.begin(), levels.end(), [](const auto& l) { return l->background; }))
+        {
+            workers = std::make_unique<juce::SharedResourcePointer<WorkerPool>>();
+            (*workers)->add(this);
+        }
+    }
+
+    int getImpulseLength() const noexcept { return irLength; }
+    int getNumOutputs() const noexcept { return outputs; }
+    bool usesBackgroundThread() const noexcept { return workers != nullptr; }
+
+    /** Clears the input history; queued jobs are dropped, and so is the result of a running one. */
+    void reset() noexcept
+    {
+        for (auto& l : levels)
+        {
+            if (l->pending != nullptr)
+            {
+                int expected = kQueued;
+                l->pending->state.compare_exchange_strong(expected, kIdle, std::memory_order_acquire);
+                l->pending = nullptr;
+            }
+            l->slot = 0;
+            l->filled = 0;
+        }
+        headInput.fill(0.0f);
+        time = 0;
+    }
+
+    /** n samples of in convolved into out[0 .. getNumOutputs()) (overwritten). */
+    void process(const float* in, float* const* out, int n) noexcept
+    {
+        for (int done = 0; done < n;)
+        {
+            const int pos = (int) (time & (kHeadSize - 1));
+            const int m = juce::jmin(n - done, kHeadSize - pos);
+
+            for (int i = 0; i < m; ++i)
+            {
+                headInput[(size_t) (kHeadSize + pos + i)] = in[done + i];
+                history[(size_t) ((time + i) & historyMask)] = in[done + i];
+            }
+
+            // Head: y[pos + i] = sum_j head[j] x[pos + i + 1 + j - kHeadSize], vectorised over i
+            for (int o = 0; o < outputs; ++o)
+            {
+                float* y = out[o] + done;
+                std::fill(y, y + m, 0.0f);
+                const float* h = head[(size_t) o].data();
+                for (int j = 0; j < kHeadSize; ++j)
+                {
+                    const float hj = h[j];
+                    const float* x = headInput.data() + pos + 1 + j;
+                    for (int i = 0; i < m; ++i)
+                        y[i] += hj * x[i];
+                }
+            }
+
+            // Partitions: each level's ring holds its output two of its blocks ahead
+            for (auto& l : levels)
+            {
+                if (time < l->offset)
+                    continue;
+                const int ring = (int) (time & (2 * l->size - 1));
+                for (int o = 0; o < outputs; ++o)
+                {
+                    const float* r = l->output.data() + (size_t) o * (size_t) (2 * l->size) + ring;
+                    float* y = out[o] + done;
+                    for (int i = 0; i < m; ++i)
+                        y[i] += r[i];
+                }
+            }
+
+            time += m;
+            done += m;
+            if ((time & (kHeadSize - 1)) == 0)
+                blockCompleted();
+        }
+    }
+
+private:
+    enum : int { kIdle, kQueued, kRunning, kDone };
+
+    // One run of a level: transforms `window` (input [jobTime - 2 size, jobTime)) and leaves the
+    // new input spectrum and outputs [jobTime + offset - size, jobTime + offset) in its own
+    // buffers, so a worker never writes state the audio thread reads
+    struct Job
+    {
+        RealFft fft;
+        std::vector<float> window, specRe, specIm, accRe, accIm, result; // result: [output][2 * size]
+        int slot = 0, filled = 0;        // delay-line slot of the new spectrum, partitions in use
+        std::int64_t jobTime = 0;
+        std::atomic<int> state { kIdle };
+
+        void prepare(int order, int size, int outputs)
+        {
+            fft.prepare(order);
+            window.assign((size_t) (2 * size), 0.0f);
+            specRe.assign((size_t) (size + 1), 0.0f);
+            specIm.assign((size_t) (size + 1), 0.0f);
+            accRe.assign((size_t) (size + 1), 0.0f);
+            accIm.assign((size_t) (size + 1), 0.0f);
+            result.assign((size_t) (outputs * 2 * size), 0.0f);
+        }
+    };
+
+    struct Level
+    {
+        static constexpr int kJobs = 2; // background buffers: the queued job and one a worker may still hold
+
+        int size = 0, offset = 0, count = 0; // partition size, first IR sample, partitions
+        bool background = false;
+        int outputs = 1;
+        std::vector<float> irRe, irIm;   // [output][partition][bin]
+        std::vector<float> fdlRe, fdlIm; // [partition][bin], input spectra
+        std::vector<float> output;       // [output][2 * size] ring, indexed by time
+        int slot = 0, filled = 0;
+        Job own;                         // audio thread only: inline levels, take-overs and re-runs
+        std::array<Job, kJobs> jobs;     // background levels: handed to the workers
+        Job* pending = nullptr;          // job whose output is due at the level's next block
+
+        int bins() const noexcept { return size + 1; }
+
+        void prepare(int numOutputs, const float* const* ir, int irLength)
+        {
+            outputs = numOutputs;
+            int order = 1;
+            while ((1 << order) < 2 * size) ++order;
+            own.prepare(order, size, outputs);
+            if (background)
+                for (auto& j : jobs)
+                    j.prepare(order, size, outputs);
+
+            const size_t nb = (size_t) bins();
+            irRe.assign((size_t) (outputs * count) * nb, 0.0f);
+            irIm.assign((size_t) (outputs * count) * nb, 0.0f);
+            fdlRe.assign((size_t) count * nb, 0.0f);
+            fdlIm.assign((size_t) count * nb, 0.0f);
+            output.assign((size_t) (outputs * 2 * size), 0.0f);
+
+            // Partition c of output o: taps [offset + c * size, + size), zero-padded to 2 * size
+            auto& window = own.window;
+            for (int o = 0; o < outputs; ++o)
+                for (int c = 0; c < count; ++c)
+                {
+                    std::fill(window.begin(), window.end(), 0.0f);
+                    const int first = offset + c * size;
+                    const int len = juce::jmin(size, irLength - first);
+                    std::copy(ir[o] + first, ir[o] + first + len, window.begin());
+                    const size_t at = (size_t) (o * count + c) * nb;
+                    own.fft.forward(window.data(), irRe.data() + at, irIm.data() + at);
+                }
+        }
+
+        // Sets up j as the job for the block that ended at `time`
+        void issue(Job& j, std::int64_t time) const noexcept
+        {
+            j.slot = slot;
+            j.filled = juce::jmin(filled + 1, count);
+            j.jobTime = time;
+        }
+
+        // Multiplies the new spectrum and the committed ones down the delay line. Only reads
+        // level state, so it may run on a worker while the audio thread re-runs the same job.
+        void run(Job& j) const noexcept
+        {
+            const int nb = bins();
+            j.fft.forward(j.window.data(), j.specRe.data(), j.specIm.data());
+
+            for (int o = 0; o < outputs; ++o)
+            {
+                std::fill(j.accRe.begin(), j.accRe.end(), 0.0f);
+                std::fill(j.accIm.begin(), j.accIm.end(), 0.0f);
+                float* aRe = j.accRe.data();
+                float* aIm = j.accIm.data();
+                for (int c = 0; c < j.filled; ++c)
+                {
+                    const float* xRe = j.specRe.data();
+                    const float* xIm = j.specIm.data();
+                    if (c > 0)
+                    {
+                        const size_t x = (size_t) ((j.slot - c + count) % count) * (size_t) nb;
+                        xRe = fdlRe.data() + x;
+                        xIm = fdlIm.data() + x;
+                    }
+                    const size_t h = (size_t) (o * count + c) * (size_t) nb;
+                    const float* hRe = irRe.data() + h;
+                    const float* hIm = irIm.data() + h;
+                    for (int k = 0; k < nb; ++k)
+                    {
+                        aRe[k] += xRe[k] * hRe[k] - xIm[k] * hIm[k];
+                        aIm[k] += xRe[k] * hIm[k] + xIm[k] * hRe[k];
+                    }
+                }
+                j.fft.inverse(aRe, aIm, j.result.data() + (size_t) o * (size_t) (2 * size));
+            }
+        }
+
+        // Audio thread: stores the job's spectrum in the delay line and its outputs in the ring
+        void commit(const Job& j) noexcept
+        {
+            const size_t s = (size_t) j.slot * (size_t) bins();
+            std::copy(j.specRe.begin(), j.specRe.end(), fdlRe.begin() + (ptrdiff_t) s);
+            std::copy(j.specIm.begin(), j.specIm.end(), fdlIm.begin() + (ptrdiff_t) s);
+
+            // Overlap-save: the last size samples are the linear part
+            const int ring = (int) ((j.jobTime + offset - size) & (2 * size - 1));
+            for (int o = 0; o < outputs; ++o)
+            {
+                const float* r = j.result.data() + (size_t) o * (size_t) (2 * size) + size;
+                std::copy(r, r + size, output.begin() + (ptrdiff_t) o * (2 * size) + ring);
+            }
+            slot = (slot + 1) % count;
+            filled = j.filled;
+        }
+
+        // Background job that no worker holds, if any
+        Job* freeJob() noexcept
+        {
+            for (auto& j : jobs)
+            {
+                const int st = j.state.load(std::memory_order_acquire);
+                if (&j != pending && (st == kIdle || st == kDone))
+                    return &j;
+            }
+            return nullptr;
+        }
+    };
+
+    //==============================================================================
+    /**
+     * Worker threads shared by every convolver in the process that has background levels, one
+     * per core less one. The audio thread cannot wake a thread without taking a lock, so the
+     * first worker looks for queued jobs every millisecond, well inside the slack of the smallest
+     * background level (1024 samples); whenever a worker takes a job it wakes the next one to look
+     * for more, so the others only run while there is work.
+     */
+    class WorkerPool
+    {
+    public:
+        WorkerPool()
+        {
+            const int n = juce::jmax(1, juce::SystemStats::getNumCpus() - 1);
+            for (int i = 0; i < n; ++i)
+                threads.push_back(std::make_unique<WorkerThread>(*this, i));
+            for (auto& t : threads)
+                t->startThread(juce::Thread::Priority::high);
+        }
+
+        ~WorkerPool()
+        {
+            for (auto& t : threads)
+                t->signalThreadShouldExit();
+            for (auto& t : threads)
+                t->stopThread(2000);
+        }
+
+        void add(PartitionedConvolver* c)
+        {
+            const juce::ScopedWriteLock sl(lock);
+            clients.push_back(c);
+        }
+
+        /** Returns once no worker is inside c. */
+        void remove(PartitionedConvolver* c)
+        {
+            const juce::ScopedWriteLock sl(lock);
+            clients.erase(std::remove(clients.begin(), clients.end(), c), clients.end());
+        }
+
+    private:
+        class WorkerThread : public juce::Thread
+        {
+        public:
+            WorkerThread(WorkerPool& p, int i) : juce::Thread("HG convolution " + juce::String(i + 1)), pool(p), index(i) {}
+
+            void run() override
+            {
+                while (! threadShouldExit())
+                    if (! pool.runOneJob(index))
+                        wait(index == 0 ? 1 : -1);
+            }
+
+        private:
+            WorkerPool& pool;
+            const int index;
+        };
+
+        bool runOneJob(int index)
+        {
+            const juce::ScopedReadLock sl(lock);
+            const Level* level = nullptr;
+            for (auto* c : clients)
+                if (auto* job = c->claimQueuedJob(level))
+                {
+                    threads[(size_t) (index + 1) % threads.size()]->notify();
+                    level->run(*job);
+                    job->state.store(kDone, std::memory_order_release);
+                    return true;
+                }
+            return false;
+        }
+
+        juce::ReadWriteLock lock;
+        std::vector<PartitionedConvolver*> clients;
+        std::vector<std::unique_ptr<WorkerThread>> threads;
+    };
+
+    // Worker thread: the queued job of the smallest partition (earliest deadline), now kRunning
+    Job* claimQueuedJob(const Level*& level) noexcept
+    {
+        for (auto& l : levels)
+            if (l->background)
+                for (auto& j : l->jobs)
+                {
+                    int expected = kQueued;
+                    if (j.state.compare_exchange_strong(expected, kRunning, std::memory_order_acquire))
+                    {
+                        level = l.get();
+                        return &j;
+                    }
+                }
+        return nullptr;
+    }
+
+    // The output of l's pending job is due: commit it, running it here if no worker has
+    void finishPending(Level& l) noexcept
+    {
+        Job& j = *l.pending;
+        l.pending = nullptr;
+        int expected = kQueued;
+        if (j.state.compare_exchange_strong(expected, kRunning, std::memory_order_acquire))
+        {
+            l.run(j);
+            l.commit(j);
+            j.state.store(kIdle, std::memory_order_release);
+        }
+        else if (expected == kDone)
+        {
+            l.commit(j);
+            j.state.store(kIdle, std::memory_order_release);
+        }
+        else
+        {
+            // A worker is still inside it: do it again here, and let the worker finish into a
+            // job nobody reads (kDone frees it)
+            std::copy(j.window.begin(), j.window.end(), l.own.window.begin());
+            l.own.slot = j.slot;
+            l.own.filled = j.filled;
+            l.own.jobTime = j.jobTime;
+            l.run(l.own);
+            l.commit(l.own);
+        }
+    }
+
+    // A kHeadSize block ended at `time`: shift the head input and start every level whose block
+    // ended with it
+    void blockCompleted() noexcept
+    {
+        std::copy(headInput.begin() + kHeadSize, headInput.end(), headInput.begin());
+
+        for (auto& l : levels)
+        {
+            if ((time & (l->size - 1)) != 0)
+                continue;
+
+            // The previous job's output is due from now on
+            if (l->pending != nullptr)
+                finishPending(*l);
+
+            Job* j = l->background ? l->freeJob() : nullptr;
+            if (j != nullptr)
+            {
+                fillWindow(*l, j->window);
+                l->issue(*j, time);
+                l->pending = j;
+                j->state.store(kQueued, std::memory_order_release);
+            }
+            else
+            {
+                // Inline level, or both background jobs still held by stalled workers
+                fillWindow(*l, l->own.window);
+                l->issue(l->own, time);
+                l->run(l->own);
+                l->commit(l->own);
+            }
+        }
+    }
+
+    // The last 2 * size inputs, zeros before the first one since reset()
+    void fillWindow(const Level& l, std::vector<float>& window) const noexcept
+    {
+        const int len = 2 * l.size;
+        const std::int64_t first = time - len;
+        const int zeros = (int) juce::jlimit<std::int64_t>(0, len, -first);
+        std::fill(window.begin(), window.begin() + zeros, 0.0f);
+        for (int i = zeros; i < len;)
+        {
+            const int at = (int) ((first + i) & historyMask);
+            const int run = juce::jmin(len - i, historyMask + 1 - at);
+            std::copy(history.begin() + at, history.begin() + at + run, window.begin() + i);
+            i += run;
+        }
+    }
+
+    void detachWorker()
+    {
+        if (workers != nullptr)
+        {
+            (*workers)->remove(this);
+            workers.reset();
+        }
+    }
+
+    int outputs = 1;
+    int irLength = 0;
+    std::array<std::array<float, kHeadSize>, kMaxOutputs> head {}; // reversed taps
+    std::array<float, 2 * kHeadSize> headInput {};                // previous and current block
+    std::vector<float> history;                                    // input ring for the levels
+    int historyMask = 0;
+    std::int64_t time = 0;                                         // samples since reset()
+    std::vector<std::unique_ptr<Level>> levels;
+    std::unique_ptr<juce::SharedResourcePointer<WorkerPool>> workers;
+
+    JUCE_DECLARE_NON_COPYABLE(PartitionedConvolver)
+};
+
+} // namespace audio
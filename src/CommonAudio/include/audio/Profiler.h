@@ -0,0 +1,405 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#if JUCE_INTEL
+ #if JUCE_MSVC
+  #include <intrin.h>
+ #else
+  #include <x86intrin.h>
+ #endif
+#endif
+
+/**
+ * Scoped per-stage profiler for processBlock.
+ *
+ * HG_PROFILE_BLOCK / HG_PROFILE_SCOPE compile to nothing unless HG_PROFILING=1 (CMake option
+ * HG_ENABLE_PROFILING), so instrumented code costs nothing in release builds. When enabled, each
+ * scope reads the TSC (steady_clock off x86) on entry and exit and pushes one 32-byte event into
+ * a fixed single-producer/single-consumer ring owned by the plugin instance: no locks, no
+ * allocation, and a full ring drops events (counted) rather than blocking the audio thread.
+ *
+ * A ProfileCollector thread drains the ring, keeps the most recent events for a Chrome-trace /
+ * Perfetto JSON export and folds every duration into per-(stage, block size) histograms for
+ * p50/p99/max. ProfileSession bundles both and writes the files when the plugin is destroyed.
+ */
+namespace audio {
+
+struct ProfileEvent
+{
+    const char*   stage = nullptr;  // string literal, compared by content when aggregating
+    std::uint64_t begin = 0, end = 0; // Profiler::now() ticks
+    std::uint32_t blockSize = 0;    // host block size of the enclosing HG_PROFILE_BLOCK
+    std::uint32_t depth = 0;        // nesting level, 0 = block scope
+};
+
+class Profiler
+{
+public:
+    static constexpr std::uint32_t kCapacity = 1u << 14; // events; ~20 blocks of 40 scopes
+
+    Profiler() noexcept : refTicks(now()), refTime(std::chrono::steady_clock::now()) {}
+
+    static std::uint64_t now() noexcept
+    {
+       #if JUCE_INTEL
+        return (std::uint64_t) __rdtsc();
+       #else
+        return (std::uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+       #endif
+    }
+
+    //==============================================================================
+    // Audio thread
+
+    void beginBlock(int numSamples) noexcept { blockSize = (std::uint32_t) juce::jmax(0, numSamples); }
+
+    std::uint32_t enter() noexcept { return depth++; }
+
+    void exit(const char* stage, std::uint64_t begin, std::uint32_t level) noexcept
+    {
+        depth = level;
+        const auto w = writePos.load(std::memory_order_relaxed);
+        if (w - readPos.load(std::memory_order_acquire) >= kCapacity)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        ring[w & (kCapacity - 1)] = { stage, begin, now(), blockSize, level };
+        writePos.store(w + 1, std::memory_order_release);
+    }
+
+    //==============================================================================
+    // Reader thread (one at a time)
+
+    /** Hands every pending event to fn(const ProfileEvent&); returns how many. */
+    template <typename Fn>
+    int drain(Fn&& fn)
+    {
+        const auto w = writePos.load(std::memory_order_acquire);
+        auto r = readPos.load(std::memory_order_relaxed);
+        const int n = (int) (w - r);
+        for (; r != w; ++r)
+            fn(ring[r & (kCapacity - 1)]);
+        readPos.store(r, std::memory_order_release);
+        return n;
+    }
+
+    std::uint64_t getDroppedCount() const noexcept { return dropped.load(std::memory_order_relaxed); }
+
+    /** Tick rate measured against steady_clock since construction (TSC frequency on x86). */
+    double ticksPerMicrosecond() const noexcept
+    {
+       #if JUCE_INTEL
+        const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - refTime).count();
+        return us > 1000.0 ? (double) (now() - refTicks) / us : fallbackTicksPerUs;
+       #else
+        return 1000.0;
+       #endif
+    }
+
+    /** Converts a tick stamp to microseconds since this profiler was created. */
+    double toMicroseconds(std::uint64_t ticks, double ticksPerUs) const noexcept
+    {
+        return (double) (std::int64_t) (ticks - refTicks) / ticksPerUs;
+    }
+
+private:
+    std::array<ProfileEvent, kCapacity> ring {};
+    alignas(64) std::atomic<std::uint32_t> writePos { 0 };
+    alignas(64) std::atomic<std::uint32_t> readPos { 0 };
+    std::atomic<std::uint64_t> dropped { 0 };
+
+    // Audio-thread state
+    std::uint32_t blockSize = 0;
+    std::uint32_t depth = 0;
+
+    const std::uint64_t refTicks;
+    const std::chrono::steady_clock::time_point refTime;
+    static constexpr double fallbackTicksPerUs = 3000.0; // before 1 ms has elapsed
+};
+
+/** RAII scope behind HG_PROFILE_SCOPE; a null profiler records nothing. */
+class ScopedProfile
+{
+public:
+    ScopedProfile(Profiler* p, const char* stageName) noexcept
+        : profiler(p), stage(stageName)
+    {
+        if (profiler != nullptr)
+        {
+            level = profiler->enter();
+            begin = Profiler::now();
+        }
+    }
+
+    /** Block scope: also sets the host block size that the events inside it are filed under. */
+    ScopedProfile(Profiler* p, const char* stageName, int numSamples) noexcept
+        : ScopedProfile(withBlock(p, numSamples), stageName)
+    {
+    }
+
+    ~ScopedProfile() noexcept
+    {
+        if (profiler != nullptr)
+            profiler->exit(stage, begin, level);
+    }
+
+private:
+    static Profiler* withBlock(Profiler* p, int numSamples) noexcept
+    {
+        if (p != nullptr) p->beginBlock(numSamples);
+        return p;
+    }
+
+    Profiler* profiler;
+    const char* stage;
+    std::uint64_t begin = 0;
+    std::uint32_t level = 0;
+    JUCE_DECLARE_NON_COPYABLE(ScopedProfile)
+};
+
+//==============================================================================
+/**
+ * Drains a Profiler on a background thread. Keeps the newest maxTraceEvents for the trace export
+ * and a log-spaced duration histogram (~3.7% bins, 10 ns .. 1 s) per stage and block size, so
+ * memory stays bounded however long the session runs.
+ */
+class ProfileCollector : private juce::Thread
+{
+public:
+    struct StageStats
+    {
+        juce::String stage;
+        int blockSize = 0;
+        std::uint64_t count = 0;
+        double p50Us = 0.0, p99Us = 0.0, maxUs = 0.0, meanUs = 0.0;
+    };
+
+    explicit ProfileCollector(Profiler& source, int maxTraceEventsToKeep = 1 << 19)
+        : juce::Thread("HG profile collector"), profiler(source),
+          maxTraceEvents((size_t) juce::jmax(1, maxTraceEventsToKeep))
+    {
+    }
+
+    ~ProfileCollector() override { stop(); }
+
+    void start() { startThread(juce::Thread::Priority::low); }
+
+    /** Stops the thread and collects whatever is still queued. */
+    void stop()
+    {
+        stopThread(1000);
+        poll();
+    }
+
+    /** Drains pending events now (also what the thread does every 20 ms). */
+    void poll()
+    {
+        const juce::ScopedLock sl(lock);
+        const double tpu = profiler.ticksPerMicrosecond();
+        profiler.drain([&](const ProfileEvent& e) {
+            if (trace.size() < maxTraceEvents) trace.push_back(e);
+            else trace[traceHead++ % maxTraceEvents] = e;
+
+            auto& h = histograms[{ std::string(e.stage), (int) e.blockSize }];
+            h.add((double) (e.end - e.begin) / tpu);
+        });
+    }
+
+    std::vector<StageStats> getStats() const
+    {
+        const juce::ScopedLock sl(lock);
+        std::vector<StageStats> out;
+        for (const auto& [key, h] : histograms)
+        {
+            StageStats s;
+            s.stage = key.first;
+            s.blockSize = key.second;
+            s.count = h.count;
+            s.p50Us = h.percentile(0.50);
+            s.p99Us = h.percentile(0.99);
+            s.maxUs = h.maxUs;
+            s.meanUs = h.count > 0 ? h.sumUs / (double) h.count : 0.0;
+            out.push_back(s);
+        }
+        return out;
+    }
+
+    /** Chrome trace-event JSON ("X" complete events), loadable in chrome://tracing and Perfetto. */
+    bool writeChromeTrace(const juce::File& file, const juce::String& processName) const
+    {
+        const juce::ScopedLock sl(lock);
+        juce::FileOutputStream out(file);
+        if (! out.openedOk()) return false;
+        out.setPosition(0);
+        out.truncate();
+
+        const double tpu = profiler.ticksPerMicrosecond();
+        out << "{\"displayTimeUnit\":\"ns\",\"otherData\":{\"droppedEvents\":"
+            << juce::String((juce::int64) profiler.getDroppedCount()) << "},\"traceEvents\":[\n"
+            << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\""
+            << juce::JSON::escapeString(processName) << "\"}}";
+
+        const size_t n = trace.size();
+        const size_t first = n < maxTraceEvents ? 0 : traceHead % maxTraceEvents; // oldest kept
+        for (size_t i = 0; i < n; ++i)
+        {
+            const auto& e = trace[(first + i) % n];
+            out << ",\n{\"name\":\"" << juce::JSON::escapeString(e.stage)
+                << "\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":"
+                << juce::String(profiler.toMicroseconds(e.begin, tpu), 3)
+                << ",\"dur\":" << juce::String((double) (e.end - e.begin) / tpu, 3)
+                << ",\"args\":{\"block\":" << (int) e.blockSize << ",\"depth\":" << (int) e.depth << "}}";
+        }
+        out << "\n]}\n";
+        out.flush();
+        return out.getStatus().wasOk();
+    }
+
+    /** Per-stage p50/p99/max for each host block size, as JSON. */
+    bool writeStats(const juce::File& file) const
+    {
+        juce::Array<juce::var> rows;
+        for (const auto& s : getStats())
+        {
+            auto* o = new juce::DynamicObject();
+            o->setProperty("stage", s.stage);
+            o->setProperty("blockSize", s.blockSize);
+            o->setProperty("count", (juce::int64) s.count);
+            o->setProperty("p50_us", s.p50Us);
+            o->setProperty("p99_us", s.p99Us);
+            o->setProperty("max_us", s.maxUs);
+            o->setProperty("mean_us", s.meanUs);
+            rows.add(juce::var(o));
+        }
+        auto* root = new juce::DynamicObject();
+        root->setProperty("droppedEvents", (juce::int64) profiler.getDroppedCount());
+        root->setProperty("stages", rows);
+        return file.replaceWithText(juce::JSON::toString(juce::var(root)));
+    }
+
+    /** One line per stage and block size, for logs and the console. */
+    juce::String getSummary() const
+    {
+        juce::String s;
+        for (const auto& st : getStats())
+            s << st.stage.paddedRight(' ', 28) << " block " << juce::String(st.blockSize).paddedLeft(' ', 5)
+              << "  n " << juce::String((juce::int64) st.count).paddedLeft(' ', 8)
+              << "  p50 " << juce::String(st.p50Us, 2) << " us  p99 " << juce::String(st.p99Us, 2)
+              << " us  max " << juce::String(st.maxUs, 2) << " us\n";
+        return s;
+    }
+
+private:
+    struct Histogram
+    {
+        static constexpr int kBins = 512;
+        static constexpr double kMinUs = 0.01, kDecades = 8.0; // 10 ns .. 1 s
+
+        std::array<std::uint64_t, kBins> bins {};
+        std::uint64_t count = 0;
+        double maxUs = 0.0, sumUs = 0.0;
+
+        void add(double us)
+        {
+            const double pos = std::log10(juce::jmax(us, kMinUs) / kMinUs) * (kBins / kDecades);
+            ++bins[(size_t) juce::jlimit(0, kBins - 1, (int) pos)];
+            ++count;
+            maxUs = juce::jmax(maxUs, us);
+            sumUs += us;
+        }
+
+        // Upper edge of the bin holding the q-quantile, capped by the exact max
+        double percentile(double q) const
+        {
+            if (count == 0) return 0.0;
+            const auto rank = (std::uint64_t) std::ceil(q * (double) count);
+            std::uint64_t seen = 0;
+            for (int i = 0; i < kBins; ++i)
+                if ((seen += bins[(size_t) i]) >= rank)
+                    return juce::jmin(maxUs, kMinUs * std::pow(10.0, (i + 1) * kDecades / kBins));
+            return maxUs;
+        }
+    };
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            poll();
+            wait(20);
+        }
+    }
+
+    Profiler& profiler;
+    const size_t maxTraceEvents;
+    juce::CriticalSection lock;
+    std::vector<ProfileEvent> trace;
+    size_t traceHead = 0;
+    std::map<std::pair<std::string, int>, Histogram> histograms;
+};
+
+//==============================================================================
+/**
+ * A plugin instance's profiler plus its collector. On destruction it writes
+ * <name>-<time>-<n>.trace.json and .stats.json to $HG_PROFILE_DIR, or the temp directory's
+ * HungryGhostProfiles folder.
+ */
+class ProfileSession
+{
+public:
+    explicit ProfileSession(juce::String sessionName)
+        : name(std::move(sessionName)), collector(profiler)
+    {
+        collector.start();
+    }
+
+    ~ProfileSession()
+    {
+        collector.stop();
+        const auto dir = outputDirectory();
+        if (dir.createDirectory().wasOk())
+        {
+            static std::atomic<int> sessionCounter { 0 }; // several instances may close in the same second
+            const auto stem = name + "-" + juce::Time::getCurrentTime().formatted("%Y%m%d-%H%M%S")
+                            + "-" + juce::String(++sessionCounter);
+            collector.writeChromeTrace(dir.getChildFile(stem + ".trace.json"), name);
+            collector.writeStats(dir.getChildFile(stem + ".stats.json"));
+        }
+    }
+
+    static juce::File outputDirectory()
+    {
+        const auto env = juce::SystemStats::getEnvironmentVariable("HG_PROFILE_DIR", {});
+        if (env.isNotEmpty() && juce::File::isAbsolutePath(env))
+            return juce::File(env);
+        return juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("HungryGhostProfiles");
+    }
+
+    Profiler profiler;
+    const juce::String name;
+    ProfileCollector collector;
+};
+
+} // namespace audio
+
+#if HG_PROFILING
+ /** Starts a block: records the host block size and times the enclosing scope as `stage`. */
+ #define HG_PROFILE_BLOCK(profilerPtr, stage, numSamples) \
+     const audio::ScopedProfile JUCE_JOIN_MACRO(hgProfScope_, __LINE__) ((profilerPtr), (stage), (numSamples))
+ #define HG_PROFILE_SCOPE(profilerPtr, stage) \
+     const audio::ScopedProfile JUCE_JOIN_MACRO(hgProfScope_, __LINE__) ((profilerPtr), (stage))
+#else
+ #define HG_PROFILE_BLOCK(profilerPtr, stage, numSamples)
+ #define HG_PROFILE_SCOPE(profilerPtr, stage)
+#endif
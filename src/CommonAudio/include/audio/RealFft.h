@@ -0,0 +1,232 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace audio {
+
+/**
+ * Real-input FFT of size N = 2^order for real-time code: all tables are built in prepare(), and
+ * forward()/inverse() never allocate (unlike juce::dsp::FFT's fallback engine, which takes
+ * stack or heap scratch of 8N bytes per call). Spectra are N/2 + 1 bins in split form, re[] and
+ * im[], so multiply-adds over them are plain float loops the compiler vectorises.
+ *
+ * A real transform of N runs as one complex radix-2 transform of N/2 on the even/odd samples,
+ * plus one pass that separates the two. The complex transform is decimation-in-frequency going
+ * forward and decimation-in-time going back, so neither pass reorders its data (a bit-reversal
+ * permutation costs as much as the butterflies at large N): bins are kept in bit-reversed order,
+ * with Nyquist last. Bin k is at binIndex(k). That is no matter for convolution, where spectra
+ * from the same RealFft are only multiplied bin by bin. inverse() includes the 1/N, so it undoes
+ * forward() exactly and forward-multiply-inverse is a circular convolution with no extra gain.
+ */
+class RealFft
+{
+public:
+    void prepare(int order)
+    {
+        n = 1 << order;
+        m = n / 2;
+        bits = order - 1;
+
+        bitrev.resize((size_t) m);
+        for (int i = 0; i < m; ++i)
+        {
+            int r = 0;
+            for (int b = 0; b < bits; ++b)
+                r |= ((i >> b) & 1) << (bits - 1 - b);
+            bitrev[(size_t) i] = r;
+        }
+
+        // Per-stage twiddles, contiguous: stage with half-length h holds e^(-i pi k / h), k < h,
+        // from index h - 1
+        twRe.assign((size_t) std::max(1, m), 0.0f);
+        twIm.assign((size_t) std::max(1, m), 0.0f);
+        for (int h = 1; h < m; h *= 2)
+            for (int k = 0; k < h; ++k)
+            {
+                const double a = -3.14159265358979323846 * k / h;
+                twRe[(size_t) (h - 1 + k)] = (float) std::cos(a);
+                twIm[(size_t) (h - 1 + k)] = (float) std::sin(a);
+            }
+
+        // Split/merge twiddles e^(-2 pi i k / N) for the bin stored at p, k = bitrev[p]
+        spRe.resize((size_t) m);
+        spIm.resize((size_t) m);
+        for (int p = 0; p < m; ++p)
+        {
+            const double a = -2.0 * 3.14159265358979323846 * bitrev[(size_t) p] / n;
+            spRe[(size_t) p] = (float) std::cos(a);
+            spIm[(size_t) p] = (float) std::sin(a);
+        }
+
+        zRe.assign((size_t) m, 0.0f);
+        zIm.assign((size_t) m, 0.0f);
+    }
+
+    int getSize() const noexcept { return n; }
+    int getNumBins() const noexcept { return m + 1; }
+
+    /** Where bin k (0 .. N/2) is stored in a spectrum. */
+    int binIndex(int k) const noexcept { return k == m ? m : bitrev[(size_t) k]; }
+
+    /** x: n samples. re, im: n/2 + 1 bins each, in binIndex() order. */
+    void forward(const float* x, float* re, float* im) noexcept
+    {
+        for (int i = 0; i < m; ++i)
+        {
+            zRe[(size_t) i] = x[2 * i];
+            zIm[(size_t) i] = x[2 * i + 1];
+        }
+        butterfliesDif(zRe.data(), zIm.data());
+
+        // X[k] = E[k] + W^k O[k], with E = (Z[k] + Z*[m-k]) / 2 and O = (Z[k] - Z*[m-k]) / 2i.
+        // Stored bit-reversed, bins k and m - k sit mirrored within each octave [j, 2j).
+        re[0] = zRe[0] + zIm[0];
+        im[0] = 0.0f;
+        re[m] = zRe[0] - zIm[0];
+        im[m] = 0.0f;
+        if (m >= 2)
+        {
+            re[1] = zRe[1]; // k = m/2: X = Z*
+            im[1] = -zIm[1];
+        }
+        for (int j = 2; j < m; j *= 2)
+            for (int p = j, q = 2 * j - 1; p < q; ++p, --q)
+            {
+                const float eRe = 0.5f * (zRe[(size_t) p] + zRe[(size_t) q]);
+                const float eIm = 0.5f * (zIm[(size_t) p] - zIm[(size_t) q]);
+                const float oRe = 0.5f * (zIm[(size_t) p] + zIm[(size_t) q]);
+                const float oIm = -0.5f * (zRe[(size_t) p] - zRe[(size_t) q]);
+                const float wRe = spRe[(size_t) p], wIm = spIm[(size_t) p];
+                const float tRe = wRe * oRe - wIm * oIm;
+                const float tIm = wRe * oIm + wIm * oRe;
+                re[p] = eRe + tRe;
+                im[p] = eIm + tIm;
+                // Bin m - k: E[m-k] = E*[k], O[m-k] = O*[k], W^(m-k) = -conj(W^k)
+                re[q] = eRe - tRe;
+                im[q] = -(eIm - tIm);
+            }
+    }
+
+    /** re, im: n/2 + 1 bins in binIndex() order (left untouched). x: n samples. */
+    void inverse(const float* re, const float* im, float* x) noexcept
+    {
+        // Z[k] = E[k] + i O[k], with E = (X[k] + X*[m-k]) / 2 and O = (X[k] - X*[m-k]) / 2W^k
+        zRe[0] = 0.5f * (re[0] + re[m]);
+        zIm[0] = 0.5f * (re[0] - re[m]);
+        if (m >= 2)
+        {
+            zRe[1] = re[1];
+            zIm[1] = -im[1];
+        }
+        for (int j = 2; j < m; j *= 2)
+            for (int p = j, q = 2 * j - 1; p < q; ++p, --q)
+            {
+                const float eRe = 0.5f * (re[p] + re[q]);
+                const float eIm = 0.5f * (im[p] - im[q]);
+                const float dRe = 0.5f * (re[p] - re[q]);
+                const float dIm = 0.5f * (im[p] + im[q]);
+                const float wRe = spRe[(size_t) p], wIm = -spIm[(size_t) p]; // W^-k
+                const float oRe = dRe * wRe - dIm * wIm;
+                const float oIm = dRe * wIm + dIm * wRe;
+                zRe[(size_t) p] = eRe - oIm;
+                zIm[(size_t) p] = eIm + oRe;
+                // Bin m - k: E*, and O* rotated the other way
+                zRe[(size_t) q] = eRe + oIm;
+                zIm[(size_t) q] = -eIm + oRe;
+            }
+        butterfliesDit(zIm.data(), zRe.data()); // re and im swapped: the inverse transform
+
+        const float scale = 1.0f / (float) m;
+        for (int i = 0; i < m; ++i)
+        {
+            x[2 * i] = zRe[(size_t) i] * scale;
+            x[2 * i + 1] = zIm[(size_t) i] * scale;
+        }
+    }
+
+private:
+    // In-place radix-2 DIF, natural order in, bit-reversed out. The last two stages (twiddles 1
+    // and -i) run as one multiply-free radix-4 pass; earlier stages are contiguous runs the
+    // compiler vectorises.
+    void butterfliesDif(float* re, float* im) const noexcept
+    {
+        for (int h = m / 2; h > (m >= 4 ? 2 : 0); h /= 2)
+            for (int i = 0; i < m; i += 2 * h)
+                difRun(re + i, im + i, re + i + h, im + i + h, twRe.data() + h - 1, twIm.data() + h - 1, h);
+
+        if (m >= 4)
+            for (int i = 0; i < m; i += 4)
+            {
+                const float a0r = re[i] + re[i + 2], a0i = im[i] + im[i + 2];
+                const float a2r = re[i] - re[i + 2], a2i = im[i] - im[i + 2];
+                const float a1r = re[i + 1] + re[i + 3], a1i = im[i + 1] + im[i + 3];
+                const float a3r = im[i + 1] - im[i + 3], a3i = re[i + 3] - re[i + 1]; // (-i)(z1 - z3)
+                re[i] = a0r + a1r;     im[i] = a0i + a1i;
+                re[i + 1] = a0r - a1r; im[i + 1] = a0i - a1i;
+                re[i + 2] = a2r + a3r; im[i + 2] = a2i + a3i;
+                re[i + 3] = a2r - a3r; im[i + 3] = a2i - a3i;
+            }
+    }
+
+    // In-place radix-2 DIT, bit-reversed in, natural order out; the first two stages as one
+    // radix-4 pass. Called with re and im swapped it computes the inverse transform (times m).
+    void butterfliesDit(float* re, float* im) const noexcept
+    {
+        int h = 1;
+        if (m >= 4)
+        {
+            for (int i = 0; i < m; i += 4)
+            {
+                const float b0r = re[i] + re[i + 1], b0i = im[i] + im[i + 1];
+                const float b1r = re[i] - re[i + 1], b1i = im[i] - im[i + 1];
+                const float b2r = re[i + 2] + re[i + 3], b2i = im[i + 2] + im[i + 3];
+                const float b3r = re[i + 2] - re[i + 3], b3i = im[i + 2] - im[i + 3];
+                re[i] = b0r + b2r;     im[i] = b0i + b2i;
+                re[i + 2] = b0r - b2r; im[i + 2] = b0i - b2i;
+                re[i + 1] = b1r + b3i; im[i + 1] = b1i - b3r; // b1 + (-i) b3
+                re[i + 3] = b1r - b3i; im[i + 3] = b1i + b3r;
+            }
+            h = 4;
+        }
+        for (; h < m; h *= 2)
+            for (int i = 0; i < m; i += 2 * h)
+                ditRun(re + i, im + i, re + i + h, im + i + h, twRe.data() + h - 1, twIm.data() + h - 1, h);
+    }
+
+    // h butterflies a[k], b[k] <- a[k] + b[k], (a[k] - b[k]) w[k]
+    static void difRun(float* __restrict aRe, float* __restrict aIm, float* __restrict bRe, float* __restrict bIm,
+                       const float* __restrict wr, const float* __restrict wi, int h) noexcept
+    {
+        for (int k = 0; k < h; ++k)
+        {
+            const float dr = aRe[k] - bRe[k];
+            const float di = aIm[k] - bIm[k];
+            aRe[k] += bRe[k];
+            aIm[k] += bIm[k];
+            bRe[k] = dr * wr[k] - di * wi[k];
+            bIm[k] = dr * wi[k] + di * wr[k];
+        }
+    }
+
+    // h butterflies a[k], b[k] <- a[k] + w[k] b[k], a[k] - w[k] b[k]
+    static void ditRun(float* __restrict aRe, float* __restrict aIm, float* __restrict bRe, float* __restrict bIm,
+                       const float* __restrict wr, const float* __restrict wi, int h) noexcept
+    {
+        for (int k = 0; k < h; ++k)
+        {
+            const float tr = bRe[k] * wr[k] - bIm[k] * wi[k];
+            const float ti = bRe[k] * wi[k] + bIm[k] * wr[k];
+            bRe[k] = aRe[k] - tr;
+            bIm[k] = aIm[k] - ti;
+            aRe[k] += tr;
+            aIm[k] += ti;
+        }
+    }
+
+    int n = 0, m = 0, bits = 0;
+    std::vector<int> bitrev;
+    std::vector<float> twRe, twIm, spRe, spIm, zRe, zIm;
+};
+
+} // namespace audio
@@ -0,0 +1,123 @@
+#pragma once
+#include <juce_core/juce_core.h>
+
+/**
+ * Real-time-safety sanitizer for the headless test apps.
+ *
+ * HG_RT_SCOPE("name") marks the current thread as rendering audio until the end of the enclosing
+ * scope. In normal builds it compiles to nothing. Test targets that link CommonAudioRTSanitizer get
+ * HG_RT_SANITIZER=1 plus hooks on operator new/delete, malloc/free and pthread_mutex_lock (which
+ * std::mutex and juce::CriticalSection sit on); any of those reached inside a marked scope is
+ * recorded with its call stack. audio::rtsan::TestRunner turns the records into test failures.
+ * The malloc/free and mutex hooks (and the stacks) need glibc; elsewhere only operator new/delete
+ * are seen, which is why CI also runs every test app on Linux.
+ *
+ * Code that must allocate or lock inside a marked scope on purpose can open an HG_RT_ALLOW scope.
+ */
+namespace audio::rtsan {
+
+#if HG_RT_SANITIZER
+// Implemented in CommonAudio/testing/RealtimeSanitizer.cpp (test targets only)
+void enterRealtime(const char* context) noexcept;
+void exitRealtime() noexcept;
+void enterAllow() noexcept;
+void exitAllow() noexcept;
+
+/** Formats (symbolizes) the violations recorded since the last call and clears them.
+    Returns how many occurred. */
+int takeViolations(juce::String& summary);
+
+/** Violations since process start, including ones already taken. */
+int getTotalViolations() noexcept;
+#else
+inline void enterRealtime(const char*) noexcept {}
+inline void exitRealtime() noexcept {}
+inline void enterAllow() noexcept {}
+inline void exitAllow() noexcept {}
+inline int takeViolations(juce::String&) { return 0; }
+inline int getTotalViolations() noexcept { return 0; }
+#endif
+
+struct ScopedRealtime
+{
+    explicit ScopedRealtime(const char* context) noexcept { enterRealtime(context); }
+    ~ScopedRealtime() noexcept { exitRealtime(); }
+    JUCE_DECLARE_NON_COPYABLE(ScopedRealtime)
+};
+
+struct ScopedAllow
+{
+    ScopedAllow() noexcept { enterAllow(); }
+    ~ScopedAllow() noexcept { exitAllow(); }
+    JUCE_DECLARE_NON_COPYABLE(ScopedAllow)
+};
+
+/**
+ * UnitTestRunner that reports sanitizer violations as failures of the test that was running
+ * when they happened. Use finish() as main()'s return value: non-zero if anything failed.
+ */
+class TestRunner : public juce::UnitTestRunner
+{
+public:
+    int finish()
+    {
+        flushViolations();
+
+        int failures = 0;
+        for (int i = 0; i < getNumResults(); ++i)
+            if (auto* r = getResult(i))
+                failures += r->failures;
+
+        if (getTotalViolations() > 0)
+            logMessage("Real-time sanitizer: " + juce::String(getTotalViolations())
+                       + " allocation/lock violation(s) on the audio thread");
+
+        return failures > 0 || getTotalViolations() > 0 ? 1 : 0;
+    }
+
+protected:
+    // Called after every expect(), so violations are attributed close to where they happened
+    void resultsUpdated() override { flushViolations(); }
+
+private:
+    void flushViolations()
+    {
+        if (reporting)
+            return;
+
+        juce::String summary;
+        if (takeViolations(summary) == 0)
+            return;
+
+        const ScopedAllow allow;
+        const juce::ScopedValueSetter<bool> svs(reporting, true);
+        if (auto* test = findRunningTest())
+            test->expect(false, summary);
+        else
+            logMessage(summary);
+    }
+
+    juce::UnitTest* findRunningTest() const
+    {
+        if (getNumResults() == 0)
+            return nullptr;
+
+        const auto name = getResult(getNumResults() - 1)->unitTestName;
+        for (auto* t : juce::UnitTest::getAllTests())
+            if (t->getName() == name)
+                return t;
+        return nullptr;
+    }
+
+    bool reporting = false;
+};
+
+} // namespace audio::rtsan
+
+#if HG_RT_SANITIZER
+ #define HG_RT_SCOPE(context) const audio::rtsan::ScopedRealtime JUCE_JOIN_MACRO(hgRtScope_, __LINE__) (context)
+ #define HG_RT_ALLOW()        const audio::rtsan::ScopedAllow JUCE_JOIN_MACRO(hgRtAllow_, __LINE__)
+#else
+ #define HG_RT_SCOPE(context)
+ #define HG_RT_ALLOW()
+#endif
@@ -0,0 +1,116 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace audio {
+namespace bs1770 {
+
+// ITU-R BS.1770-4 Annex 2 true-peak interpolator: 48-tap FIR split into 4 phases of 12 taps.
+// Phase p of the 4x upsampled signal at input sample i is sum_k coeffs[p][k] * x[i - k];
+// phase 0 is centred on x[i - kTruePeakLatency].
+inline constexpr int kTruePeakTaps = 12;
+inline constexpr int kTruePeakPhases = 4;
+inline constexpr int kTruePeakLatency = 6;
+
+inline constexpr float kTruePeakCoeffs[kTruePeakPhases][kTruePeakTaps] = {
+    {  0.0017089843750f,  0.0109863281250f, -0.0196533203125f,  0.0332031250000f, -0.0594482421875f,  0.1373291015625f,
+       0.9721679687500f, -0.1022949218750f,  0.0476074218750f, -0.0266113281250f,  0.0148925781250f, -0.0083007812500f },
+    { -0.0291748046875f,  0.0292968750000f, -0.0517578125000f,  0.0891113281250f, -0.1665039062500f,  0.4650878906250f,
+       0.7797851562500f, -0.2003173828125f,  0.1015625000000f, -0.0582275390625f,  0.0330810546875f, -0.0189208984375f },
+    { -0.0189208984375f,  0.0330810546875f, -0.0582275390625f,  0.1015625000000f, -0.2003173828125f,  0.7797851562500f,
+       0.4650878906250f, -0.1665039062500f,  0.0891113281250f, -0.0517578125000f,  0.0292968750000f, -0.0291748046875f },
+    { -0.0083007812500f,  0.0148925781250f, -0.0266113281250f,  0.0476074218750f, -0.1022949218750f,  0.9721679687500f,
+       0.1373291015625f, -0.0594482421875f,  0.0332031250000f, -0.0196533203125f,  0.0109863281250f,  0.0017089843750f }
+};
+
+// Largest sum of |coeffs| over the phases: no interpolated value can exceed this times the
+// largest |x| under the filter.
+constexpr float truePeakInterpolationBound() noexcept
+{
+    float bound = 0.0f;
+    for (const auto& phase : kTruePeakCoeffs)
+    {
+        float sum = 0.0f;
+        for (float c : phase)
+            sum += c < 0.0f ? -c : c;
+        bound = sum > bound ? sum : bound;
+    }
+    return bound;
+}
+
+} // namespace bs1770
+
+/**
+ * Running maximum true peak (linear) of one channel, per BS.1770-4 Annex 2.
+ * Works in chunks over fixed scratch, so process() never allocates. A chunk whose sample peak
+ * times the interpolation bound cannot beat the running maximum skips the filter entirely,
+ * which makes the meter nearly free once a programme's loudest peak has gone by.
+ */
+class TruePeakMeter
+{
+public:
+    void reset() noexcept
+    {
+        hist.fill(0.0f);
+        peak = 0.0f;
+    }
+
+    /** Clears the held maximum but keeps the filter history. */
+    void resetPeak() noexcept { peak = 0.0f; }
+
+    float getPeak() const noexcept { return peak; }
+
+    void process(const float* in, int numSamples) noexcept
+    {
+        using FVO = juce::FloatVectorOperations;
+        constexpr int H = bs1770::kTruePeakTaps - 1;
+
+        for (int start = 0; start < numSamples; start += kChunk)
+        {
+            const int n = std::min(kChunk, numSamples - start);
+
+            // hist = [last H inputs | this chunk], so x[i - k] = h[i + H - k]
+            float* h = hist.data();
+            std::memcpy(h + H, in + start, sizeof(float) * (size_t)n);
+
+            const auto range = FVO::findMinAndMax(h, H + n);
+            const float windowPeak = std::max(-range.getStart(), range.getEnd());
+            peak = std::max(peak, windowPeak); // the taps include every input sample exactly
+
+            if (windowPeak * kBound > peak)
+            {
+                // All four phases per output in one pass over the history (independent
+                // accumulators, vectorisable over i) instead of a multiply-add pass per tap
+                const auto& c = bs1770::kTruePeakCoeffs;
+                for (int i = 0; i < n; ++i)
+                {
+                    const float* x = h + H + i;
+                    float y0 = 0.0f, y1 = 0.0f, y2 = 0.0f, y3 = 0.0f;
+                    for (int k = 0; k < bs1770::kTruePeakTaps; ++k)
+                    {
+                        y0 += c[0][k] * x[-k];
+                        y1 += c[1][k] * x[-k];
+                        y2 += c[2][k] * x[-k];
+                        y3 += c[3][k] * x[-k];
+                    }
+                    acc[(size_t)i] = std::max(std::max(std::abs(y0), std::abs(y1)), std::max(std::abs(y2), std::abs(y3)));
+                }
+                peak = std::max(peak, FVO::findMaximum(acc.data(), n));
+            }
+
+            std::memmove(h, h + n, sizeof(float) * (size_t)H);
+        }
+    }
+
+private:
+    static constexpr int kChunk = 256;
+    static constexpr float kBound = bs1770::truePeakInterpolationBound();
+
+    std::array<float, bs1770::kTruePeakTaps - 1 + kChunk> hist {};
+    std::array<float, kChunk> acc {};
+    float peak = 0.0f;
+};
+
+} // namespace audio
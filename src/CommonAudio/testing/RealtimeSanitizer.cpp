@@ -0,0 +1,328 @@
+// Allocation and lock hooks for the real-time sanitizer (see audio/RealtimeSanitizer.h).
+// Linked into test executables only, via the CommonAudioRTSanitizer CMake target.
+
+#include <audio/RealtimeSanitizer.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+// The C entry points can only be interposed (and forwarded to) on glibc; other platforms get the
+// operator new/delete hooks alone. CI's Linux job is what gates on the full set.
+#if defined(__GLIBC__)
+ #define HG_RTSAN_HOOK_LIBC 1
+ #include <dlfcn.h>
+ #include <execinfo.h>
+ #include <cxxabi.h>
+ #include <pthread.h>
+#else
+ #define HG_RTSAN_HOOK_LIBC 0
+#endif
+
+#if defined(_MSC_VER)
+ #include <malloc.h>
+#endif
+
+#if HG_RTSAN_HOOK_LIBC
+// glibc's real allocator entry points; calling them keeps our malloc hooks from recursing
+extern "C" {
+void* __libc_malloc(size_t);
+void* __libc_calloc(size_t, size_t);
+void* __libc_realloc(void*, size_t);
+void* __libc_memalign(size_t, size_t);
+void  __libc_free(void*);
+}
+#endif
+
+namespace audio::rtsan {
+// Not in an anonymous namespace: with -rdynamic these names resolve, so the report can strip
+// the sanitizer's own frames from the top of each stack.
+namespace detail {
+
+constexpr int kMaxReports = 16;  // distinct stacks kept per flush; the count covers the rest
+constexpr int kMaxFrames = 24;
+
+struct Report
+{
+    const char* what = nullptr;
+    const char* context = nullptr;
+    void* frames[kMaxFrames] {};
+    int numFrames = 0;
+};
+
+// Fixed storage: recording a violation must not allocate (that would be a violation itself)
+Report reports[kMaxReports];
+std::atomic<int> numPending { 0 };
+std::atomic<int> numTotal { 0 };
+
+thread_local int realtimeDepth = 0;
+thread_local int allowDepth = 0;
+thread_local bool inHook = false;
+thread_local const char* realtimeContext = nullptr;
+
+void record(const char* what) noexcept
+{
+    if (realtimeDepth == 0 || allowDepth > 0 || inHook)
+        return;
+
+    inHook = true;
+    numTotal.fetch_add(1, std::memory_order_relaxed);
+    const int slot = numPending.fetch_add(1, std::memory_order_acq_rel);
+    if (slot < kMaxReports)
+    {
+        auto& r = reports[slot];
+        r.what = what;
+        r.context = realtimeContext;
+       #if HG_RTSAN_HOOK_LIBC
+        r.numFrames = backtrace(r.frames, kMaxFrames);
+       #else
+        r.numFrames = 0;
+       #endif
+    }
+    inHook = false;
+}
+
+#if HG_RTSAN_HOOK_LIBC
+void* rawMalloc(size_t n) noexcept              { return __libc_malloc(n); }
+void* rawAligned(size_t n, size_t align) noexcept { return __libc_memalign(align, n); }
+void  rawFree(void* p) noexcept                 { __libc_free(p); }
+void  rawAlignedFree(void* p) noexcept          { __libc_free(p); }
+
+using MutexLockFn = int (*)(pthread_mutex_t*);
+std::atomic<MutexLockFn> realMutexLock { nullptr };
+
+MutexLockFn resolveMutexLock() noexcept
+{
+    auto fn = realMutexLock.load(std::memory_order_relaxed);
+    if (fn == nullptr)
+    {
+        fn = reinterpret_cast<MutexLockFn>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+        realMutexLock.store(fn, std::memory_order_relaxed);
+    }
+    return fn;
+}
+
+// backtrace() lazily loads libgcc on first use, which allocates; do that before any test runs
+const bool warmedUp = [] {
+    void* frames[2];
+    backtrace(frames, 2);
+    resolveMutexLock();
+    return true;
+}();
+
+juce::String describeFrame(void* frame)
+{
+    Dl_info info {};
+    if (dladdr(frame, &info) == 0)
+        return "0x" + juce::String::toHexString((juce::pointer_sized_int) frame);
+    if (info.dli_sname == nullptr) // not exported: binary + offset, for addr2line
+        return juce::String(info.dli_fname) + " +0x"
+             + juce::String::toHexString((juce::pointer_sized_int) frame - (juce::pointer_sized_int) info.dli_fbase);
+
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+    juce::String name(status == 0 && demangled != nullptr ? demangled : info.dli_sname);
+    std::free(demangled);
+    return name;
+}
+#else
+void* rawMalloc(size_t n) noexcept { return std::malloc(n); }
+void  rawFree(void* p) noexcept    { std::free(p); }
+ #if defined(_MSC_VER)
+void* rawAligned(size_t n, size_t align) noexcept { return _aligned_malloc(n, align); }
+void  rawAlignedFree(void* p) noexcept          { _aligned_free(p); }
+ #else
+void* rawAligned(size_t n, size_t align) noexcept
+{
+    void* p = nullptr;
+    return posix_memalign(&p, align < sizeof(void*) ? sizeof(void*) : align, n) == 0 ? p : nullptr;
+}
+void  rawAlignedFree(void* p) noexcept { std::free(p); }
+ #endif
+juce::String describeFrame(void* frame) { return "0x" + juce::String::toHexString((juce::pointer_sized_int) frame); }
+#endif
+
+void* newImpl(size_t n, const char* what)
+{
+    record(what);
+    if (void* p = rawMalloc(n != 0 ? n : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* newAlignedImpl(size_t n, std::align_val_t align, const char* what)
+{
+    record(what);
+    if (void* p = rawAligned(n != 0 ? n : 1, (size_t) align))
+        return p;
+    throw std::bad_alloc();
+}
+
+void deleteImpl(void* p) noexcept
+{
+    if (p == nullptr) return;
+    record("operator delete");
+    rawFree(p);
+}
+
+void deleteAlignedImpl(void* p) noexcept
+{
+    if (p == nullptr) return;
+    record("operator delete");
+    rawAlignedFree(p);
+}
+
+// The sanitizer's own frames at the top of a recorded stack
+bool isHookFrame(const juce::String& name)
+{
+    static const char* const hooks[] { "malloc", "calloc", "realloc", "free", "aligned_alloc",
+                                       "memalign", "posix_memalign", "pthread_mutex_lock" };
+    if (name.startsWith("audio::rtsan::") || name.startsWith("operator new") || name.startsWith("operator delete"))
+        return true;
+    for (auto* h : hooks)
+        if (name == h)
+            return true;
+    return false;
+}
+
+} // namespace detail
+
+using namespace detail;
+
+void enterRealtime(const char* context) noexcept
+{
+    if (realtimeDepth++ == 0)
+        realtimeContext = context;
+}
+
+void exitRealtime() noexcept
+{
+    if (--realtimeDepth == 0)
+        realtimeContext = nullptr;
+}
+
+void enterAllow() noexcept { ++allowDepth; }
+void exitAllow() noexcept  { --allowDepth; }
+
+int getTotalViolations() noexcept { return numTotal.load(std::memory_order_relaxed); }
+
+int takeViolations(juce::String& summary)
+{
+    const ScopedAllow allow; // formatting allocates, even if a test calls expect() mid-render
+    const int pending = numPending.exchange(0, std::memory_order_acq_rel);
+    if (pending == 0)
+        return 0;
+
+    summary << "Real-time sanitizer: " << pending << " allocation/lock call(s) inside an audio scope";
+    for (int i = 0; i < juce::jmin(pending, kMaxReports); ++i)
+    {
+        const auto& r = reports[i];
+
+        // Skip repeats of a stack already listed
+        bool seen = false;
+        for (int j = 0; j < i && ! seen; ++j)
+            seen = reports[j].what == r.what && reports[j].numFrames == r.numFrames
+                && std::memcmp(reports[j].frames, r.frames, sizeof(void*) * (size_t) r.numFrames) == 0;
+        if (seen)
+            continue;
+
+        summary << "\n  " << r.what << " in " << (r.context != nullptr ? r.context : "?");
+        int f = 1; // frame 0 is record() itself (or a local clone of it)
+        while (f < r.numFrames && isHookFrame(describeFrame(r.frames[f])))
+            ++f;
+        for (int shown = 0; f < r.numFrames; ++f, ++shown)
+            summary << "\n    #" << shown << " " << describeFrame(r.frames[f]);
+    }
+    return pending;
+}
+
+} // namespace audio::rtsan
+
+using namespace audio::rtsan::detail;
+
+void* operator new(size_t n)                                    { return newImpl(n, "operator new"); }
+void* operator new[](size_t n)                                  { return newImpl(n, "operator new[]"); }
+void* operator new(size_t n, std::align_val_t a)                { return newAlignedImpl(n, a, "operator new"); }
+void* operator new[](size_t n, std::align_val_t a)              { return newAlignedImpl(n, a, "operator new[]"); }
+void* operator new(size_t n, const std::nothrow_t&) noexcept    { try { return newImpl(n, "operator new"); } catch (...) { return nullptr; } }
+void* operator new[](size_t n, const std::nothrow_t&) noexcept  { try { return newImpl(n, "operator new[]"); } catch (...) { return nullptr; } }
+void* operator new(size_t n, std::align_val_t a, const std::nothrow_t&) noexcept   { try { return newAlignedImpl(n, a, "operator new"); } catch (...) { return nullptr; } }
+void* operator new[](size_t n, std::align_val_t a, const std::nothrow_t&) noexcept { try { return newAlignedImpl(n, a, "operator new[]"); } catch (...) { return nullptr; } }
+
+void operator delete(void* p) noexcept                                    { deleteImpl(p); }
+void operator delete[](void* p) noexcept                                  { deleteImpl(p); }
+void operator delete(void* p, size_t) noexcept                            { deleteImpl(p); }
+void operator delete[](void* p, size_t) noexcept                          { deleteImpl(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept             { deleteImpl(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept           { deleteImpl(p); }
+void operator delete(void* p, std::align_val_t) noexcept                  { deleteAlignedImpl(p); }
+void operator delete[](void* p, std::align_val_t) noexcept                { deleteAlignedImpl(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept          { deleteAlignedImpl(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept        { deleteAlignedImpl(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept   { deleteAlignedImpl(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { deleteAlignedImpl(p); }
+
+#if HG_RTSAN_HOOK_LIBC
+// C allocation and mutex entry points. Defining them in the executable interposes them for the
+// whole process, including JUCE and libstdc++ (std::mutex, CriticalSection, HeapBlock).
+extern "C" {
+
+void* malloc(size_t n)
+{
+    record("malloc");
+    return __libc_malloc(n);
+}
+
+void* calloc(size_t count, size_t n)
+{
+    record("calloc");
+    return __libc_calloc(count, n);
+}
+
+void* realloc(void* p, size_t n)
+{
+    record("realloc");
+    return __libc_realloc(p, n);
+}
+
+void free(void* p)
+{
+    if (p == nullptr) return;
+    record("free");
+    __libc_free(p);
+}
+
+void* aligned_alloc(size_t align, size_t n)
+{
+    record("aligned_alloc");
+    return __libc_memalign(align, n);
+}
+
+void* memalign(size_t align, size_t n)
+{
+    record("memalign");
+    return __libc_memalign(align, n);
+}
+
+int posix_memalign(void** out, size_t align, size_t n)
+{
+    record("posix_memalign");
+    if (align < sizeof(void*) || (align & (align - 1)) != 0)
+        return EINVAL;
+    void* p = __libc_memalign(align, n);
+    if (p == nullptr)
+        return ENOMEM;
+    *out = p;
+    return 0;
+}
+
+int pthread_mutex_lock(pthread_mutex_t* m)
+{
+    record("pthread_mutex_lock");
+    return resolveMutexLock()(m);
+}
+
+} // extern "C"
+#endif
@@ -0,0 +1,54 @@
+#pragma once
+#include <JuceHeader.h>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace hgbench {
+
+// Something to time: prepared once per (sample rate, block size), then fed stereo host blocks
+// in place. Core DSP classes and whole processors are wrapped the same way.
+struct Subject
+{
+    virtual ~Subject() = default;
+    virtual void prepare(double sampleRate, int blockSize) = 0;
+    virtual void process(juce::AudioBuffer<float>& buffer) = 0;
+};
+
+struct Preset
+{
+    juce::String name;
+    std::function<std::unique_ptr<Subject>()> create;
+};
+
+// One DSP class or processor and the parameter presets it is run with
+struct Suite
+{
+    juce::String name;
+    std::vector<Preset> presets;
+};
+
+struct Result
+{
+    juce::String id;          // suite/preset/rate/block: the key compare mode matches on
+    juce::String suite, preset;
+    double sampleRate = 0.0;
+    int blockSize = 0;
+    double nsPerSample = 0.0;    // mean over the timed run (throughput)
+    double p50NsPerSample = 0.0; // median block, per sample: what compare mode checks
+    double p99NsPerSample = 0.0; // 99th percentile block, per sample: callback headroom
+    double realtimeFactor = 0.0; // audio seconds rendered per CPU second
+    int allocations = 0;         // allocation/lock calls while timing (real-time sanitizer hooks)
+};
+
+// CoreBenches.cpp / ProcessorBenches.cpp
+void addCoreSuites(std::vector<Suite>& suites);
+void addProcessorSuites(std::vector<Suite>& suites);
+
+template <typename SubjectType, typename... Args>
+Preset makePreset(const juce::String& name, Args... args)
+{
+    return { name, [=] { return std::unique_ptr<Subject>(std::make_unique<SubjectType>(args...)); } };
+}
+
+} // namespace hgbench
@@ -0,0 +1,466 @@
+#include "Bench.h"
+#include "../../HungryGhostLimiter/Source/dsp/LimiterDSP.h"
+#include "../../HungryGhostReverb/Source/DSP/ReverbEngine.h"
+#include "../../HungryGhostMultibandLimiter/Source/dsp/BandSplitterIIR.h"
+#include "../../HungryGhostMultibandLimiter/Source/dsp/LimiterBand.h"
+#include "../../HungryGhostMultibandCompressor/Source/dsp/BandSplitterIIR.h"
+#include "../../HungryGhostMultibandCompressor/Source/dsp/CompressorBand.h"
+#include "../../HungryGhostSaturation/Source/dsp/Shaper.h"
+#include <audio/LoudnessMeter.h>
+
+// Core DSP classes, driven the way their processors drive them but without parameter plumbing,
+// oversampling or metering. The sample rate is the rate the class itself runs at.
+
+namespace hgbench {
+namespace {
+
+enum class LimiterMode { Digital, TruePeakDetect, AutoRelease };
+
+class LimiterDSPSubject : public Subject
+{
+public:
+    explicit LimiterDSPSubject(LimiterMode m) : mode(m) {}
+
+    void prepare(double sampleRate, int) override
+    {
+        lim.prepare((float) sampleRate, (int) std::ceil(0.005 * sampleRate) + 64);
+
+        hgl::LimiterParams p {};
+        p.preGainL = p.preGainR = juce::Decibels::decibelsToGain(10.0f);
+        p.ceilLin = juce::Decibels::decibelsToGain(-1.0f);
+        p.lookAheadSamplesOS = (int) std::round(0.001 * sampleRate); // 1 ms
+        p.releaseAlphaOS = std::exp(-1.0f / (0.120f * (float) sampleRate));
+        p.scHpfOn = true;
+        p.safetyOn = true;
+        p.truePeakDetect = (mode == LimiterMode::TruePeakDetect);
+        p.autoReleaseOn = (mode == LimiterMode::AutoRelease);
+        lim.setParams(p);
+    }
+
+    void process(juce::AudioBuffer<float>& buffer) override
+    {
+        lim.processBlockOS(buffer.getWritePointer(0), buffer.getWritePointer(1), buffer.getNumSamples());
+    }
+
+private:
+    LimiterMode mode;
+    hgl::LimiterDSP lim;
+};
+
+// numChannels channels through one N-channel engine, or (stereoPairs) through numChannels / 2
+// stereo engines, the way a host would stack instances on a bed. The stereo input is copied
+// onto every pair, so the copy costs the same either way.
+class MultichannelLimiterSubject : public Subject
+{
+public:
+    MultichannelLimiterSubject(int channels, hgl::ChannelLink l, bool pairs)
+        : numChannels(channels), link(l), stereoPairs(pairs) {}
+
+    void prepare(double sampleRate, int blockSize) override
+    {
+        const int maxLook = (int) std::ceil(0.005 * sampleRate) + 64;
+        engines.resize((size_t) (stereoPairs ? numChannels / 2 : 1));
+        for (auto& e : engines)
+        {
+            e.prepare((float) sampleRate, maxLook, stereoPairs ? 2 : numChannels);
+
+            hgl::LimiterParams p {};
+            p.preGainL = p.preGainR = juce::Decibels::decibelsToGain(10.0f);
+            p.ceilLin = juce::Decibels::decibelsToGain(-1.0f);
+            p.lookAheadSamplesOS = (int) std::round(0.001 * sampleRate); // 1 ms
+            p.releaseAlphaOS = std::exp(-1.0f / (0.120f * (float) sampleRate));
+            p.scHpfOn = true;
+            p.safetyOn = true;
+            p.link = link;
+            e.setParams(p);
+        }
+        bed.setSize(numChannels, blockSize);
+    }
+
+    void process(juce::AudioBuffer<float>& buffer) override
+    {
+        const int n = buffer.getNumSamples();
+        for (int ch = 0; ch < numChannels; ++ch)
+            bed.copyFrom(ch, 0, buffer, ch & 1, 0, n);
+
+        float* const* channels = bed.getArrayOfWritePointers();
+        if (stereoPairs)
+        {
+            for (size_t k = 0; k < engines.size(); ++k)
+                engines[k].processBlockOS(channels + 2 * k, 2, n);
+        }
+        else
+        {
+            engines[0].processBlockOS(channels, numChannels, n);
+        }
+
+        buffer.copyFrom(0, 0, bed, 0, 0, n);
+        buffer.copyFrom(1, 0, bed, 1, 0, n);
+    }
+
+private:
+    int numChannels;
+    hgl::ChannelLink link;
+    bool stereoPairs;
+    std::vector<hgl::LimiterDSP> engines;
+    juce::AudioBuffer<float> bed;
+};
+
+// automated: decay and HF damping sweep slowly, with the parameters handed over every block
+// Static: fixed parameters. Automated: decay and damping swept every block. Morphing: size
+// steps every 40 blocks and the mode flips between this one and Plate every 120, so the tank
+// crossfades (and moves networks between delay memory slots) all along. Silent: the input
+// is zeroed, so after the tail the engine runs its idle (dry-only) path. decimated: the tank
+// runs at 44.1/48 kHz at high host rates (the engine default), else at the host rate. lines:
+// the mode's tank network size, or the engine's default for the mode when 0.
+class ReverbEngineSubject : public Subject
+{
+public:
+    enum class Drive { Static, Automated, Morphing, Silent };
+
+    ReverbEngineSubject(hgr::dsp::ReverbMode m, Drive d, bool decimated = true, int numLines = 0)
+        : mode(m), drive(d), decimateTank(decimated), lines(numLines) {}
+
+    void prepare(double sampleRate, int blockSize) override
+    {
+        engine.setTankDecimation(decimateTank);
+        if (lines > 0)
+            engine.setModeLineCount(mode, lines);
+        engine.prepare(sampleRate, blockSize, 2);
+        params.mode = mode;
+        params.mixPercent = 30.0f;
+        engine.setParameters(params);
+        blocks = 0;
+    }
+
+    void process(juce::AudioBuffer<float>& buffer) override
+    {
+        if (drive == Drive::Silent)
+            buffer.clear();
+        if (drive == Drive::Automated)
+        {
+            const float t = (float) (blocks++ % 200) / 200.0f; // triangle over 200 blocks
+            const float tri = t < 0.5f ? 2.0f * t : 2.0f - 2.0f * t;
+            params.decaySeconds = 1.5f + 3.0f * tri;
+            params.hfDampingHz = 4000.0f + 8000.0f * tri;
+            engine.setParameters(params);
+        }
+        if (drive == Drive::Morphing)
+        {
+            const int b = blocks++;
+            params.size = (b / 40) % 2 == 0 ? 0.8f : 1.2f;
+            params.mode = (b / 120) % 2 == 0 ? mode : hgr::dsp::ReverbMode::Plate;
+            engine.setParameters(params);
+        }
+        juce::dsp::AudioBlock<float> block(buffer);
+        engine.process(block);
+    }
+
+private:
+    hgr::dsp::ReverbMode mode;
+    Drive drive;
+    bool decimateTank;
+    int lines;
+    hgr::dsp::ReverbParameters params;
+    int blocks = 0;
+    hgr::dsp::ReverbEngine engine;
+};
+
+// The live FDN tank vs the same tank rendered to a stereo IR and convolved
+// (ReverbEngine::renderStaticImpulse), at one decay time. Inline: every partition runs on the
+// audio thread, so the timing is the whole cost of the instance; otherwise the large partitions
+// go to the shared worker thread and only the audio thread's share is timed.
+class ReverbStaticTankSubject : public Subject
+{
+public:
+    enum class Tank { Live, StaticInline, StaticThreaded };
+
+    ReverbStaticTankSubject(float decay, Tank t) : decaySeconds(decay), tank(t) {}
+
+    void prepare(double sampleRate, int blockSize) override
+    {
+        engine.prepare(sampleRate, blockSize, 2);
+        hgr::dsp::ReverbParameters params;
+        params.mixPercent = 30.0f;
+        params.decaySeconds = decaySeconds;
+        engine.setParameters(params);
+        if (tank == Tank::Live)
+            engine.clearStaticImpulse();
+        else
+            engine.renderStaticImpulse(tank == Tank::StaticThreaded);
+    }
+
+    void process(juce::AudioBuffer<float>& buffer) override
+    {
+        juce::dsp::AudioBlock<float> block(buffer);
+        engine.process(block);
+    }
+
+private:
+    float decaySeconds;
+    Tank tank;
+    hgr::dsp::ReverbEngine engine;
+};
+
+// An N-line network. blockwise: FDN::tickBlock + mixStereoBlock over the longest blocks the
+// network allows, else tick + mixStereo per sample. simd: the lines as SSE2/NEON lanes, else the
+// scalar path.
+template <int N>
+class FDNSubject : public Subject
+{
+public:
+    FDNSubject(float rateHz, float depthMs, bool block, bool vector)
+        : modRateHz(rateHz), modDepthMs(depthMs), blockwise(block), simd(vector) {}
+
+    void prepare(double sampleRate, int blockSize) override
+    {
+        fdn.prepare(sampleRate, blockSize);
+        fdn.setModulation(modRateHz, modDepthMs);
+        fdn.setSimdEnabled(simd);
+        width.fill(1.0f);
+    }
+
+    void process(juce::AudioBuffer<float>& buffer) override
+    {
+        auto* L = buffer.getWritePointer(0);
+        auto* R = buffer.getWritePointer(1);
+        if (blockwise)
+        {
+            float* v[N];
+            for (int i = 0; i < N; ++i)
+                v[i] = lines[(size_t) i].data();
+            for (int start = 0; start < buffer.getNumSamples();)
+            {
+                const int n = juce::jmin(fdn.maxBlockSamples(), buffer.getNumSamples() - start);
+                for (int k = 0; k < n; ++k)
+                    x[(size_t) k] = 0.5f * (L[start + k] + R[start + k]);
+                fdn.tickBlock(x.data(), v, n);
+                fdn.mixStereoBlock(v, width.data(), L + start, R + start, n);
+                start += n;
+            }
+            return;
+        }
+
+        float out[N];
+        for (int n = 0; n < buffer.getNumSamples(); ++n)
+        {
+            fdn.tick(0.5f * (L[n] + R[n]), out);
+            fdn.mixStereo(out, 1.0f, L[n], R[n]);
+        }
+    }
+
+private:
+    float modRateHz, modDepthMs;
+    bool blockwise, simd;
+    hgr::dsp::FDN<N> fdn;
+    std::array<float, hgr::dsp::FDN<N>::kMaxBlock> x {}, width {};
+    std::array<std::array<float, hgr::dsp::FDN<N>::kMaxBlock>, N> lines {};
+};
+
+// Both splitters share the N-band API; Splitter is hgml:: or hgmbc::BandSplitterIIR
+template <typename Splitter>
+class SplitterSubject : public Subject
+{
+public:
+    explicit SplitterSubject(std::vector<float> crossovers) : freqs(std::move(crossovers)) {}
+
+    void prepare(double sampleRate, int blockSize) override
+    {
+        splitter.prepare(sampleRate, 2);
+        splitter.setCrossoverFrequencies(freqs);
+        bands.resize(freqs.size() + 1);
+        for (auto& b : bands)
+            b.setSize(2, blockSize);
+    }
+
+    void process(juce::AudioBuffer<float>& buffer) override { splitter.process(buffer, bands); }
+
+private:
+    std::vector<float> freqs;
+    Splitter splitter;
+    std::vector<juce::AudioBuffer<float>> bands;
+};
+
+class LimiterBandSubject : public Subject
+{
+public:
+    LimiterBandSubject(float thresholdDb, float releaseMs) : threshold(thresholdDb), release(releaseMs) {}
+
+    void prepare(double sampleRate, int) override
+    {
+        band.prepare((float) sampleRate);
+        hgml::LimiterBandParams p;
+        p.thresholdDb = threshold;
+        p.releaseMs = release;
+        band.setParams(p);
+    }
+
+    void process(juce::AudioBuffer<float>& buffer) override { band.processBlock(buffer); }
+
+private:
+    float threshold, release;
+    hgml::LimiterBand band;
+};
+
+class CompressorBandSubject : public Subject
+{
+public:
+    CompressorBandSubject(int detectorType, float lookAheadMs) : detector(detectorType), lookAhead(lookAheadMs) {}
+
+    void prepare(double sampleRate, int) override
+    {
+        const int la = (int) std::round(lookAhead * 0.001 * sampleRate);
+        band.prepare(sampleRate, 2, (int) std::ceil(0.02 * sampleRate));
+        hgmbc::CompressorBandParams p;
+        p.threshold_dB = -24.0f;
+        p.ratio = 4.0f;
+        p.detectorType = detector;
+        band.setParams(p);
+        band.setLookaheadSamples(la);
+    }
+
+    void process(juce::AudioBuffer<float>& buffer) override { band.process(buffer); }
+
+private:
+    int detector;
+    float lookAhead;
+    hgmbc::CompressorBand band;
+};
+
+class ShaperSubject : public Subject
+{
+public:
+    explicit ShaperSubject(hgs::Shaper::Model m) : model(m) {}
+
+    void prepare(double, int) override
+    {
+        shaper.setModel(model);
+        shaper.setDriveDb(18.0f);
+        shaper.setAsymmetry(0.2f);
+    }
+
+    void process(juce::AudioBuffer<float>& buffer) override
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            shaper.process(buffer.getWritePointer(ch), buffer.getNumSamples());
+    }
+
+private:
+    hgs::Shaper::Model model;
+    hgs::Shaper shaper;
+};
+
+class LoudnessMeterSubject : public Subject
+{
+public:
+    void prepare(double sampleRate, int) override { meter.prepare(sampleRate, 2); }
+
+    void process(juce::AudioBuffer<float>& buffer) override
+    {
+        meter.process(buffer.getArrayOfReadPointers(), buffer.getNumSamples());
+    }
+
+private:
+    audio::LoudnessMeter meter;
+};
+
+} // namespace
+
+void addCoreSuites(std::vector<Suite>& suites)
+{
+    suites.push_back({ "hgl::LimiterDSP", {
+        makePreset<LimiterDSPSubject>("digital", LimiterMode::Digital),
+        makePreset<LimiterDSPSubject>("truePeakDetect", LimiterMode::TruePeakDetect),
+        makePreset<LimiterDSPSubject>("autoRelease", LimiterMode::AutoRelease) } });
+
+    // One N-channel engine vs N/2 stereo instances for 5.1, 7.1.4 and 9.1.6 beds
+    using hgl::ChannelLink;
+    suites.push_back({ "hgl::LimiterDSP/multichannel", {
+        makePreset<MultichannelLimiterSubject>("6ch-linked", 6, ChannelLink::Linked, false),
+        makePreset<MultichannelLimiterSubject>("6ch-stereo-pairs", 6, ChannelLink::Linked, true),
+        makePreset<MultichannelLimiterSubject>("12ch-linked", 12, ChannelLink::Linked, false),
+        makePreset<MultichannelLimiterSubject>("12ch-grouped", 12, ChannelLink::Grouped, false),
+        makePreset<MultichannelLimiterSubject>("12ch-stereo-pairs", 12, ChannelLink::Linked, true),
+        makePreset<MultichannelLimiterSubject>("16ch-linked", 16, ChannelLink::Linked, false),
+        makePreset<MultichannelLimiterSubject>("16ch-unlinked", 16, ChannelLink::Unlinked, false),
+        makePreset<MultichannelLimiterSubject>("16ch-stereo-pairs", 16, ChannelLink::Linked, true) } });
+    using hgr::dsp::ReverbMode;
+    using Drive = ReverbEngineSubject::Drive;
+    using hgr::dsp::ReverbMode;
+    suites.push_back({ "hgr::dsp::ReverbEngine", {
+        makePreset<ReverbEngineSubject>("hall", ReverbMode::Hall, Drive::Static),
+        makePreset<ReverbEngineSubject>("room", ReverbMode::Room, Drive::Static),
+        makePreset<ReverbEngineSubject>("plate", ReverbMode::Plate, Drive::Static),
+        makePreset<ReverbEngineSubject>("ambience", ReverbMode::Ambience, Drive::Static),
+        makePreset<ReverbEngineSubject>("hall-automated", ReverbMode::Hall, Drive::Automated),
+        makePreset<ReverbEngineSubject>("hall-morphing", ReverbMode::Hall, Drive::Morphing),
+        makePreset<ReverbEngineSubject>("hall-fullrate", ReverbMode::Hall, Drive::Static, false),
+        makePreset<ReverbEngineSubject>("hall-silent", ReverbMode::Hall, Drive::Silent),
+        makePreset<ReverbEngineSubject>("hall-4lines", ReverbMode::Hall, Drive::Static, true, 4),
+        makePreset<ReverbEngineSubject>("hall-16lines", ReverbMode::Hall, Drive::Static, true, 16),
+        makePreset<ReverbEngineSubject>("hall-32lines", ReverbMode::Hall, Drive::Static, true, 32) } });
+
+    using Tank = ReverbStaticTankSubject::Tank;
+    suites.push_back({ "hgr::dsp::ReverbEngine/static", {
+        makePreset<ReverbStaticTankSubject>("live-5s", 5.0f, Tank::Live),
+        makePreset<ReverbStaticTankSubject>("static-5s", 5.0f, Tank::StaticInline),
+        makePreset<ReverbStaticTankSubject>("static-5s-threaded", 5.0f, Tank::StaticThreaded),
+        makePreset<ReverbStaticTankSubject>("live-20s", 20.0f, Tank::Live),
+        makePreset<ReverbStaticTankSubject>("static-20s", 20.0f, Tank::StaticInline),
+        makePreset<ReverbStaticTankSubject>("static-20s-threaded", 20.0f, Tank::StaticThreaded) } });
+
+    // Depth past ~8 samples switches the modulated lines to Lagrange interpolation
+    suites.push_back({ "hgr::dsp::FDN8", {
+        makePreset<FDNSubject<8>>("linear", 0.3f, 0.05f, false, true),
+        makePreset<FDNSubject<8>>("linear-scalar", 0.3f, 0.05f, false, false),
+        makePreset<FDNSubject<8>>("lagrange", 0.8f, 6.0f, false, true),
+        makePreset<FDNSubject<8>>("lagrange-scalar", 0.8f, 6.0f, false, false),
+        makePreset<FDNSubject<8>>("linear-block", 0.3f, 0.05f, true, true),
+        makePreset<FDNSubject<8>>("linear-block-scalar", 0.3f, 0.05f, true, false),
+        makePreset<FDNSubject<8>>("lagrange-block", 0.8f, 6.0f, true, true),
+        makePreset<FDNSubject<8>>("lagrange-block-scalar", 0.8f, 6.0f, true, false) } });
+
+    // CPU against echo density per network size (blockwise, SIMD; shallow modulation, then deep
+    // enough for Lagrange reads). Normalised echo density of the network's left output for an
+    // impulse (20 ms windows, 1 = Gaussian) at 100 / 300 ms, and the mixing time where it first
+    // reaches 0.9: 4 lines 0.02 / 0.21, over 1 s; 8 lines 0.10 / 0.57, 424 ms; 16 lines 0.38 /
+    // 0.88, 240 ms; 32 lines 0.67 / 1.03, 154 ms. Modal density 0.31 / 0.57 / 0.93 / 1.59 per Hz.
+    suites.push_back({ "hgr::dsp::FDN/lines", {
+        makePreset<FDNSubject<4>>("4", 0.3f, 0.05f, true, true),
+        makePreset<FDNSubject<8>>("8", 0.3f, 0.05f, true, true),
+        makePreset<FDNSubject<16>>("16", 0.3f, 0.05f, true, true),
+        makePreset<FDNSubject<32>>("32", 0.3f, 0.05f, true, true),
+        makePreset<FDNSubject<4>>("4-lagrange", 0.3f, 6.0f, true, true),
+        makePreset<FDNSubject<8>>("8-lagrange", 0.3f, 6.0f, true, true),
+        makePreset<FDNSubject<16>>("16-lagrange", 0.3f, 6.0f, true, true),
+        makePreset<FDNSubject<32>>("32-lagrange", 0.3f, 6.0f, true, true) } });
+
+    suites.push_back({ "hgml::BandSplitterIIR", {
+        makePreset<SplitterSubject<hgml::BandSplitterIIR>>("2band", std::vector<float> { 120.0f }),
+        makePreset<SplitterSubject<hgml::BandSplitterIIR>>("6band", std::vector<float> { 80.0f, 250.0f, 1000.0f, 4000.0f, 10000.0f }) } });
+
+    suites.push_back({ "hgml::LimiterBand", {
+        makePreset<LimiterBandSubject>("light", -3.0f, 150.0f),
+        makePreset<LimiterBandSubject>("heavy", -18.0f, 40.0f) } });
+
+    suites.push_back({ "hgmbc::BandSplitterIIR", {
+        makePreset<SplitterSubject<hgmbc::BandSplitterIIR>>("2band", std::vector<float> { 120.0f }),
+        makePreset<SplitterSubject<hgmbc::BandSplitterIIR>>("6band", std::vector<float> { 80.0f, 250.0f, 1000.0f, 4000.0f, 10000.0f }) } });
+
+    suites.push_back({ "hgmbc::CompressorBand", {
+        makePreset<CompressorBandSubject>("peak", 0, 0.0f),
+        makePreset<CompressorBandSubject>("rms-lookahead", 1, 5.0f) } });
+
+    using Model = hgs::Shaper::Model;
+    suites.push_back({ "hgs::Shaper", {
+        makePreset<ShaperSubject>("tanh", Model::TANH),
+        makePreset<ShaperSubject>("soft", Model::SOFT),
+        makePreset<ShaperSubject>("fexp", Model::FEXP),
+        makePreset<ShaperSubject>("amp", Model::AMP) } });
+
+    // Output metering of the limiter: K-weighting, gating histograms and 4x true peak
+    suites.push_back({ "audio::LoudnessMeter", {
+        makePreset<LoudnessMeterSubject>("stereo") } });
+}
+
+} // namespace hgbench
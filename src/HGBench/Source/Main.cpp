@@ -0,0 +1,272 @@
+#include "Bench.h"
+#include <audio/RealtimeSanitizer.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <map>
+
+// HGBench: headless benchmark of every plugin processor and the core DSP classes across sample
+// rates, host block sizes (odd ones included) and parameter presets.
+//
+//   HGBench [--quick] [--filter=<text>] [--seconds=<s>] [--json=<file>]
+//           [--baseline=<file> [--tolerance=<percent>]] [--list]
+//
+// --json writes the results as machine-readable JSON; --baseline compares this run against a
+// stored one (matched by id) and exits non-zero if any case got slower than the tolerance or
+// started allocating on the audio path.
+
+namespace hgbench {
+namespace {
+
+const double kSampleRates[] = { 44100.0, 48000.0, 96000.0, 192000.0 };
+const int kBlockSizes[] = { 16, 31, 64, 127, 256, 512, 1001, 2048, 4096 };
+const double kQuickSampleRates[] = { 48000.0 };
+const int kQuickBlockSizes[] = { 64, 127, 512 };
+
+// Program-like stereo input: noise bursts over low sines, so dynamics processors work part of
+// the time and the reverb always has something to chew on. Looped over the timed run.
+class TestSignal
+{
+public:
+    TestSignal()
+    {
+        juce::Random rng(42);
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            auto* d = signal.getWritePointer(ch);
+            for (int i = 0; i < kLength; ++i)
+            {
+                const float burst = ((i / 6000) % 3 == 0) ? 0.8f : 0.1f;
+                d[i] = burst * (rng.nextFloat() * 2.0f - 1.0f) + 0.2f * std::sin(0.001f * (float) i + (float) ch);
+            }
+        }
+    }
+
+    void fill(juce::AudioBuffer<float>& buffer, int& position) const
+    {
+        const int n = buffer.getNumSamples();
+        if (position + n > kLength)
+            position = 0;
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            buffer.copyFrom(ch, 0, signal, ch, position, n);
+        position += n;
+    }
+
+private:
+    static constexpr int kLength = 1 << 16;
+    juce::AudioBuffer<float> signal { 2, kLength };
+};
+
+Result runCase(const Suite& suite, const Preset& preset, double sampleRate, int blockSize,
+               double seconds, const TestSignal& input)
+{
+    Result r;
+    r.suite = suite.name;
+    r.preset = preset.name;
+    r.sampleRate = sampleRate;
+    r.blockSize = blockSize;
+    r.id = suite.name + "/" + preset.name + "/" + juce::String((int) sampleRate) + "/" + juce::String(blockSize);
+
+    auto subject = preset.create();
+    subject->prepare(sampleRate, blockSize);
+
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    const int numBlocks = juce::jmax(64, (int) std::ceil(seconds * sampleRate / blockSize));
+    std::vector<double> blockNs((size_t) numBlocks);
+    int position = 0;
+
+    // Warm-up: caches, first-block parameter work and any deferred setup stay out of the numbers
+    for (int b = 0; b < juce::jmax(16, numBlocks / 10); ++b)
+    {
+        input.fill(buffer, position);
+        subject->process(buffer);
+    }
+
+    juce::String ignored;
+    audio::rtsan::takeViolations(ignored);
+    {
+        const audio::rtsan::ScopedRealtime rt("HGBench timed run");
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            input.fill(buffer, position);
+            const auto t0 = std::chrono::steady_clock::now();
+            subject->process(buffer);
+            const auto t1 = std::chrono::steady_clock::now();
+            blockNs[(size_t) b] = (double) std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+        }
+    }
+    juce::String detail;
+    r.allocations = audio::rtsan::takeViolations(detail);
+
+    double total = 0.0;
+    for (auto ns : blockNs)
+        total += ns;
+    std::sort(blockNs.begin(), blockNs.end());
+
+    r.nsPerSample = total / ((double) numBlocks * blockSize);
+    r.p50NsPerSample = blockNs[(size_t) numBlocks / 2] / blockSize;
+    r.p99NsPerSample = blockNs[juce::jmin((size_t) numBlocks - 1, (size_t) (0.99 * numBlocks))] / blockSize;
+    r.realtimeFactor = r.nsPerSample > 0.0 ? 1.0e9 / (r.nsPerSample * sampleRate) : 0.0;
+    return r;
+}
+
+juce::var toJson(const std::vector<Result>& results, double seconds, bool quick)
+{
+    auto* machine = new juce::DynamicObject();
+    machine->setProperty("cpu", juce::SystemStats::getCpuModel());
+    machine->setProperty("cores", juce::SystemStats::getNumPhysicalCpus());
+    machine->setProperty("os", juce::SystemStats::getOperatingSystemName());
+    machine->setProperty("juce", juce::SystemStats::getJUCEVersion());
+
+    juce::Array<juce::var> cases;
+    for (const auto& r : results)
+    {
+        auto* o = new juce::DynamicObject();
+        o->setProperty("id", r.id);
+        o->setProperty("suite", r.suite);
+        o->setProperty("preset", r.preset);
+        o->setProperty("sampleRate", r.sampleRate);
+        o->setProperty("blockSize", r.blockSize);
+        o->setProperty("nsPerSample", r.nsPerSample);
+        o->setProperty("p50NsPerSample", r.p50NsPerSample);
+        o->setProperty("p99NsPerSample", r.p99NsPerSample);
+        o->setProperty("realtimeFactor", r.realtimeFactor);
+        o->setProperty("allocations", r.allocations);
+        cases.add(juce::var(o));
+    }
+
+    auto* root = new juce::DynamicObject();
+    root->setProperty("schema", 1);
+    root->setProperty("timestamp", juce::Time::getCurrentTime().toISO8601(true));
+    root->setProperty("machine", juce::var(machine));
+    root->setProperty("secondsPerCase", seconds);
+    root->setProperty("quick", quick);
+    root->setProperty("results", cases);
+    return juce::var(root);
+}
+
+// Cases present in both runs are compared on the median block time (robust to the odd
+// preempted block) and on allocations. Returns the number of regressions.
+int compareWithBaseline(const std::vector<Result>& results, const juce::var& baseline, double tolerance)
+{
+    std::map<juce::String, const juce::DynamicObject*> base;
+    if (auto* arr = baseline.getProperty("results", {}).getArray())
+        for (const auto& v : *arr)
+            if (auto* o = v.getDynamicObject())
+                base[o->getProperty("id").toString()] = o;
+
+    int regressions = 0, improvements = 0, matched = 0;
+    std::printf("\n%-64s %10s %10s %8s\n", "compare (p50 ns/smp)", "baseline", "current", "change");
+    for (const auto& r : results)
+    {
+        const auto it = base.find(r.id);
+        if (it == base.end())
+            continue;
+        ++matched;
+
+        const double before = (double) it->second->getProperty("p50NsPerSample");
+        const int allocsBefore = (int) it->second->getProperty("allocations");
+        const double change = before > 0.0 ? r.p50NsPerSample / before - 1.0 : 0.0;
+        const bool slower = change > tolerance;
+        const bool allocating = r.allocations > allocsBefore;
+
+        if (slower || allocating)
+        {
+            ++regressions;
+            std::printf("%-64s %10.2f %10.2f %+7.1f%% REGRESSION%s\n", r.id.toRawUTF8(), before,
+                        r.p50NsPerSample, 100.0 * change, allocating ? " (allocates)" : "");
+        }
+        else if (change < -tolerance)
+        {
+            ++improvements;
+            std::printf("%-64s %10.2f %10.2f %+7.1f%% faster\n", r.id.toRawUTF8(), before, r.p50NsPerSample, 100.0 * change);
+        }
+    }
+
+    std::printf("%d case(s) compared, %d regression(s), %d improvement(s) beyond %.0f%%; %d case(s) without a baseline\n",
+                matched, regressions, improvements, 100.0 * tolerance, (int) results.size() - matched);
+    return regressions;
+}
+
+} // namespace
+} // namespace hgbench
+
+int main(int argc, char* argv[])
+{
+    using namespace hgbench;
+
+    juce::ScopedJuceInitialiser_GUI juceInit; // processors own parameter trees with timers
+    juce::ScopedNoDenormals noDenormals;
+    const juce::ArgumentList args(argc, argv);
+
+    std::vector<Suite> suites;
+    addCoreSuites(suites);
+    addProcessorSuites(suites);
+
+    if (args.containsOption("--list"))
+    {
+        for (const auto& s : suites)
+            for (const auto& p : s.presets)
+                std::printf("%s/%s\n", s.name.toRawUTF8(), p.name.toRawUTF8());
+        return 0;
+    }
+
+    const bool quick = args.containsOption("--quick");
+    const auto filter = args.getValueForOption("--filter");
+    const double seconds = args.containsOption("--seconds") ? args.getValueForOption("--seconds").getDoubleValue() : 1.0;
+    const double tolerance = 0.01 * (args.containsOption("--tolerance") ? args.getValueForOption("--tolerance").getDoubleValue() : 10.0);
+
+    juce::var baseline;
+    const auto baselinePath = args.getValueForOption("--baseline");
+    if (baselinePath.isNotEmpty())
+    {
+        baseline = juce::JSON::parse(juce::File::getCurrentWorkingDirectory().getChildFile(baselinePath));
+        if (! baseline.isObject())
+        {
+            std::fprintf(stderr, "HGBench: cannot read baseline %s\n", baselinePath.toRawUTF8());
+            return 2;
+        }
+    }
+
+    const juce::Array<double> rates = quick ? juce::Array<double>(kQuickSampleRates, (int) std::size(kQuickSampleRates))
+                                            : juce::Array<double>(kSampleRates, (int) std::size(kSampleRates));
+    const juce::Array<int> blocks = quick ? juce::Array<int>(kQuickBlockSizes, (int) std::size(kQuickBlockSizes))
+                                          : juce::Array<int>(kBlockSizes, (int) std::size(kBlockSizes));
+
+    const TestSignal input;
+    std::vector<hgbench::Result> results;
+    std::printf("%-64s %10s %10s %10s %10s %6s\n", "case", "ns/smp", "p50", "p99", "xRT", "alloc");
+    for (const auto& suite : suites)
+    {
+        if (filter.isNotEmpty() && ! suite.name.containsIgnoreCase(filter))
+            continue;
+
+        for (const auto& preset : suite.presets)
+            for (auto rate : rates)
+                for (auto block : blocks)
+                {
+                    const auto r = runCase(suite, preset, rate, block, seconds, input);
+                    std::printf("%-64s %10.2f %10.2f %10.2f %10.1f %6d\n", r.id.toRawUTF8(), r.nsPerSample,
+                                r.p50NsPerSample, r.p99NsPerSample, r.realtimeFactor, r.allocations);
+                    std::fflush(stdout);
+                    results.push_back(r);
+                }
+    }
+
+    const auto jsonPath = args.getValueForOption("--json");
+    if (jsonPath.isNotEmpty())
+    {
+        const auto file = juce::File::getCurrentWorkingDirectory().getChildFile(jsonPath);
+        if (! file.replaceWithText(juce::JSON::toString(toJson(results, seconds, quick))))
+        {
+            std::fprintf(stderr, "HGBench: cannot write %s\n", file.getFullPathName().toRawUTF8());
+            return 2;
+        }
+        std::printf("\nwrote %s\n", file.getFullPathName().toRawUTF8());
+    }
+
+    if (baseline.isObject())
+        return compareWithBaseline(results, baseline, tolerance) > 0 ? 1 : 0;
+    return 0;
+}
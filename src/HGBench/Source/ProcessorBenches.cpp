@@ -0,0 +1,93 @@
+#include "Bench.h"
+#include "../../HungryGhostLimiter/Source/PluginProcessor.h"
+#include "../../HungryGhostMultibandLimiter/Source/PluginProcessor.h"
+#include "../../HungryGhostMultibandCompressor/Source/PluginProcessor.h"
+#include "../../HungryGhostReverb/Source/PluginProcessor.h"
+#include "../../HungryGhostSaturation/Source/PluginProcessor.h"
+#include <cstdio>
+
+// Whole processors, built headless (no editors): parameter snapshot, oversampling, metering and
+// everything else processBlock does. Presets are plain parameter values applied before prepare.
+
+namespace hgbench {
+namespace {
+
+using Settings = std::vector<std::pair<juce::String, float>>;
+
+template <typename Processor>
+class ProcessorSubject : public Subject
+{
+public:
+    explicit ProcessorSubject(Settings s) : settings(std::move(s)) {}
+
+    void prepare(double sampleRate, int blockSize) override
+    {
+        for (const auto& [id, value] : settings)
+            setParameter(id, value);
+
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+    }
+
+    void process(juce::AudioBuffer<float>& buffer) override { processor.processBlock(buffer, midi); }
+
+private:
+    void setParameter(const juce::String& id, float value)
+    {
+        for (auto* p : processor.getParameters())
+        {
+            if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(p); ranged != nullptr && ranged->getParameterID() == id)
+            {
+                ranged->setValueNotifyingHost(ranged->convertTo0to1(value));
+                return;
+            }
+        }
+        std::fprintf(stderr, "HGBench: %s has no parameter '%s'\n",
+                     processor.getName().toRawUTF8(), id.toRawUTF8());
+        jassertfalse;
+    }
+
+    Settings settings;
+    Processor processor;
+    juce::MidiBuffer midi;
+};
+
+} // namespace
+
+void addProcessorSuites(std::vector<Suite>& suites)
+{
+    using Limiter = ProcessorSubject<HungryGhostLimiterAudioProcessor>;
+    suites.push_back({ "HungryGhostLimiter", {
+        makePreset<Limiter>("truePeak", Settings { { "thresholdL", -8.0f }, { "thresholdR", -8.0f } }),
+        makePreset<Limiter>("truePeak-4x", Settings { { "thresholdL", -8.0f }, { "thresholdR", -8.0f }, { "osRate", 2.0f } }),
+        makePreset<Limiter>("truePeak-2x-lowLatency", Settings { { "thresholdL", -8.0f }, { "thresholdR", -8.0f },
+                                                                 { "osRate", 1.0f }, { "osFilter", 1.0f } }),
+        makePreset<Limiter>("fastTruePeak", Settings { { "thresholdL", -8.0f }, { "thresholdR", -8.0f },
+                                                       { "domTruePeak", 0.0f }, { "domFastTP", 1.0f } }),
+        makePreset<Limiter>("digital", Settings { { "thresholdL", -8.0f }, { "thresholdR", -8.0f },
+                                                  { "domTruePeak", 0.0f }, { "domDigital", 1.0f } }) } });
+
+    using MBL = ProcessorSubject<HungryGhostMultibandLimiterAudioProcessor>;
+    suites.push_back({ "HungryGhostMultibandLimiter", {
+        makePreset<MBL>("2band", Settings {}),
+        makePreset<MBL>("6band", Settings { { "global.bandCount", 6.0f } }) } });
+
+    using MBC = ProcessorSubject<HungryGhostMultibandCompressorAudioProcessor>;
+    suites.push_back({ "HungryGhostMultibandCompressor", {
+        makePreset<MBC>("2band", Settings {}),
+        makePreset<MBC>("6band", Settings { { "global.bandCount", 6.0f } }) } });
+
+    using Reverb = ProcessorSubject<HungryGhostReverbAudioProcessor>;
+    suites.push_back({ "HungryGhostReverb", {
+        makePreset<Reverb>("hall", Settings { { "mode", 0.0f } }),
+        makePreset<Reverb>("plate", Settings { { "mode", 2.0f } }),
+        makePreset<Reverb>("freeze", Settings { { "mode", 0.0f }, { "freeze", 1.0f } }) } });
+
+    using Saturation = ProcessorSubject<HungryGhostSaturationAudioProcessor>;
+    suites.push_back({ "HungryGhostSaturation", {
+        makePreset<Saturation>("tanh-1x", Settings { { "model", 0.0f }, { "os", 0.0f } }),
+        makePreset<Saturation>("amp-4x", Settings { { "model", 4.0f }, { "os", 2.0f } }),
+        makePreset<Saturation>("vocal-2x", Settings { { "model", 2.0f }, { "os", 1.0f }, { "vocal", 1.0f } }) } });
+}
+
+} // namespace hgbench
@@ -0,0 +1,135 @@
+#include "FileRenderer.h"
+
+namespace hgrender {
+namespace {
+
+juce::AudioFormat* findOutputFormat(juce::AudioFormatManager& formats, const juce::File& input,
+                                    const RenderSettings& settings)
+{
+    const auto ext = settings.format.isNotEmpty() ? "." + settings.format : input.getFileExtension();
+    return formats.findFormatForFileExtension(ext);
+}
+
+int chooseBitDepth(juce::AudioFormat& format, int requested)
+{
+    const auto depths = format.getPossibleBitDepths();
+    if (depths.contains(requested))
+        return requested;
+
+    // The deepest the format can do that doesn't exceed the request (FLAC tops out at 24)
+    int best = depths.isEmpty() ? 16 : depths.getFirst();
+    for (auto d : depths)
+        if (d <= requested && d > best)
+            best = d;
+    return best;
+}
+
+} // namespace
+
+RenderResult renderFile(const juce::File& input, const juce::File& output,
+                        const ChainSpec& chainSpec, const RenderSettings& settings)
+{
+    RenderResult result;
+    result.input = input;
+    result.output = output;
+    const auto started = juce::Time::getMillisecondCounterHiRes();
+
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    const std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(input));
+    if (reader == nullptr)
+    {
+        result.error = "unreadable or unsupported audio file";
+        return result;
+    }
+    const int numChannels = (int) reader->numChannels;
+    if (numChannels < 1 || numChannels > 2)
+    {
+        result.error = "only mono and stereo files are supported";
+        return result;
+    }
+
+    auto* format = findOutputFormat(formats, input, settings);
+    if (format == nullptr)
+    {
+        result.error = "no writer for the output format";
+        return result;
+    }
+
+    ProcessorChain chain;
+    if (! chain.build(chainSpec, result.error))
+        return result;
+
+    const double sampleRate = reader->sampleRate;
+    const int blockSize = juce::jmax(64, settings.blockSize);
+    chain.prepare(sampleRate, blockSize);
+    result.latencySamples = chain.getLatencySamples();
+
+    const int requestedBits = settings.bitDepth > 0 ? settings.bitDepth : (int) reader->bitsPerSample;
+    const int bits = chooseBitDepth(*format, requestedBits);
+    auto options = juce::AudioFormatWriterOptions{}.withSampleRate(sampleRate)
+                                                   .withNumChannels(numChannels)
+                                                   .withBitsPerSample(bits);
+    if (bits == 32 && reader->usesFloatingPointData)
+        options = options.withSampleFormat(juce::AudioFormatWriterOptions::SampleFormat::floatingPoint);
+
+    output.getParentDirectory().createDirectory();
+    output.deleteFile();
+    std::unique_ptr<juce::OutputStream> stream = output.createOutputStream();
+    if (stream == nullptr)
+    {
+        result.error = "cannot create " + output.getFullPathName();
+        return result;
+    }
+    const auto writer = format->createWriterFor(stream, options);
+    if (writer == nullptr)
+    {
+        result.error = format->getFormatName() + " cannot write " + juce::String(bits) + "-bit at "
+                     + juce::String(sampleRate) + " Hz";
+        return result;
+    }
+
+    // A processor reports an infinite tail while it sustains on its own (a frozen reverb): render
+    // up to the cap rather than converting that to a length
+    double tail = juce::jmax(0.0, settings.tailSeconds);
+    if (settings.autoTail)
+    {
+        tail = chain.getTailLengthSeconds();
+        result.tailCapped = ! std::isfinite(tail) || tail > settings.maxAutoTailSeconds;
+        tail = result.tailCapped ? settings.maxAutoTailSeconds : juce::jmax(0.0, tail);
+    }
+    result.tailSeconds = tail;
+    const juce::int64 outputLength = reader->lengthInSamples + (juce::int64) std::ceil(tail * sampleRate);
+    juce::int64 toSkip = result.latencySamples;
+    juce::int64 written = 0;
+
+    // reader->read() zero-fills past the end of the file, which provides both the tail and the
+    // silence that flushes the chain's latency
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    for (juce::int64 readPos = 0; written < outputLength; readPos += blockSize)
+    {
+        reader->read(&buffer, 0, blockSize, readPos, true, numChannels > 1);
+        if (numChannels == 1)
+            buffer.copyFrom(1, 0, buffer, 0, 0, blockSize);
+
+        chain.process(buffer);
+
+        const int start = (int) juce::jmin(toSkip, (juce::int64) blockSize);
+        toSkip -= start;
+        const int count = (int) juce::jmin((juce::int64) (blockSize - start), outputLength - written);
+        if (count > 0 && ! writer->writeFromAudioSampleBuffer(buffer, start, count))
+        {
+            result.error = "write failed";
+            return result;
+        }
+        written += count;
+    }
+
+    result.ok = true;
+    result.audioSeconds = (double) outputLength / sampleRate;
+    result.renderSeconds = 0.001 * (juce::Time::getMillisecondCounterHiRes() - started);
+    return result;
+}
+
+} // namespace hgrender
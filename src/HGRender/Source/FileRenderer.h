@@ -0,0 +1,37 @@
+#pragma once
+#include "ProcessorChain.h"
+
+namespace hgrender {
+
+struct RenderSettings
+{
+    int blockSize = 8192;
+    double tailSeconds = 0.0;   // silence rendered past the end of the input
+    bool autoTail = false;      // use the chain's reported tail instead
+    double maxAutoTailSeconds = 300.0; // rendered when the reported tail is longer or not finite
+    juce::String format;        // "wav", "aiff" or "flac"; empty keeps the input's format
+    int bitDepth = 0;           // 0 keeps the input's bit depth (capped to what the format supports)
+};
+
+struct RenderResult
+{
+    juce::File input, output;
+    bool ok = false;
+    juce::String error;
+    double audioSeconds = 0.0;
+    double renderSeconds = 0.0;
+    int latencySamples = 0;
+    double tailSeconds = 0.0;
+    bool tailCapped = false;    // the chain reported an infinite (e.g. frozen) or over-long tail
+};
+
+/**
+ * Streams one file through a fresh ProcessorChain in blocks of settings.blockSize and writes the
+ * result to output. Memory is bounded by the block size whatever the file length.
+ * The chain's latency is compensated: that many leading output samples are dropped and the input
+ * is padded with silence to flush them, so output and input line up sample for sample.
+ */
+RenderResult renderFile(const juce::File& input, const juce::File& output,
+                        const ChainSpec& chain, const RenderSettings& settings);
+
+} // namespace hgrender
@@ -0,0 +1,152 @@
+#include "FileRenderer.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <cstdio>
+#include <mutex>
+
+// HGRender: offline batch renderer. Streams audio files through a chain of the in-repo
+// processors (built headless) on one thread per core.
+//
+//   HGRender --chain=<chain.json|chain.xml> --out=<dir> [--jobs=<n>] [--block=<samples>]
+//            [--tail=<seconds>|auto] [--format=wav|aiff|flac] [--bits=16|24|32]
+//            <files or folders...>
+//
+// Folders are searched recursively for WAV/AIFF/FLAC; their layout is mirrored under --out.
+// --tail=auto renders the chain's reported tail, at most RenderSettings::maxAutoTailSeconds
+// (an infinite tail, such as a frozen reverb's, renders the cap).
+// See ProcessorChain.h for the chain file format.
+
+namespace {
+
+struct Job
+{
+    juce::File input, output;
+};
+
+void collectJobs(const juce::File& source, const juce::File& outDir, const juce::String& format,
+                 std::vector<Job>& jobs)
+{
+    auto outputFor = [&](const juce::File& in, const juce::File& root) {
+        auto out = outDir.getChildFile(in.getRelativePathFrom(root));
+        return format.isNotEmpty() ? out.withFileExtension(format) : out;
+    };
+
+    if (source.isDirectory())
+    {
+        for (const auto& f : source.findChildFiles(juce::File::findFiles, true, "*.wav;*.aif;*.aiff;*.flac"))
+            jobs.push_back({ f, outputFor(f, source) });
+    }
+    else
+    {
+        jobs.push_back({ source, outputFor(source, source.getParentDirectory()) });
+    }
+}
+
+int usage()
+{
+    std::fprintf(stderr, "usage: HGRender --chain=<chain.json|xml> --out=<dir> [--jobs=<n>] [--block=<samples>]\n"
+                         "                [--tail=<seconds>|auto] [--format=wav|aiff|flac] [--bits=16|24|32]\n"
+                         "                <files or folders...>\n");
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    using namespace hgrender;
+
+    juce::ScopedJuceInitialiser_GUI juceInit; // processors own parameter trees with timers
+    const juce::ArgumentList args(argc, argv);
+
+    const auto chainPath = args.getValueForOption("--chain");
+    const auto outPath = args.getValueForOption("--out");
+    if (chainPath.isEmpty() || outPath.isEmpty())
+        return usage();
+
+    const auto cwd = juce::File::getCurrentWorkingDirectory();
+    ChainSpec chain;
+    juce::String error;
+    if (! ChainSpec::load(cwd.getChildFile(chainPath), chain, error))
+    {
+        std::fprintf(stderr, "HGRender: %s\n", error.toRawUTF8());
+        return 2;
+    }
+
+    // Build one chain up front so a bad type or parameter ID fails before any file is touched
+    {
+        ProcessorChain probe;
+        if (! probe.build(chain, error))
+        {
+            std::fprintf(stderr, "HGRender: %s\n", error.toRawUTF8());
+            return 2;
+        }
+    }
+
+    RenderSettings settings;
+    if (args.containsOption("--block"))
+        settings.blockSize = args.getValueForOption("--block").getIntValue();
+    if (args.containsOption("--tail"))
+    {
+        const auto tail = args.getValueForOption("--tail");
+        settings.autoTail = tail == "auto";
+        settings.tailSeconds = tail.getDoubleValue();
+    }
+    settings.format = args.getValueForOption("--format").toLowerCase();
+    settings.bitDepth = args.getValueForOption("--bits").getIntValue();
+
+    const auto outDir = cwd.getChildFile(outPath);
+    std::vector<Job> jobs;
+    for (const auto& a : args.arguments)
+        if (! a.isOption())
+            collectJobs(cwd.getChildFile(a.text), outDir, settings.format, jobs);
+    if (jobs.empty())
+        return usage();
+
+    // Longest files first, so the last ones to finish are short
+    std::sort(jobs.begin(), jobs.end(), [](const Job& a, const Job& b) { return a.input.getSize() > b.input.getSize(); });
+
+    const int numWorkers = args.containsOption("--jobs") ? juce::jmax(1, args.getValueForOption("--jobs").getIntValue())
+                                                         : juce::SystemStats::getNumCpus();
+    std::printf("Rendering %d file(s) through %d processor(s) on %d thread(s)\n",
+                (int) jobs.size(), (int) chain.processors.size(), numWorkers);
+
+    std::mutex reportLock;
+    std::vector<RenderResult> results;
+    results.reserve(jobs.size());
+
+    std::vector<WorkStealingPool::Job> work;
+    for (const auto& job : jobs)
+    {
+        work.push_back([&, job] {
+            auto r = renderFile(job.input, job.output, chain, settings);
+            const std::lock_guard<std::mutex> sl(reportLock);
+            const juce::String capped = r.tailCapped ? "  tail capped at " + juce::String(r.tailSeconds) + " s" : juce::String();
+            if (r.ok)
+                std::printf("  %-48s %8.1f s  %7.1fx RT  latency %d%s\n", job.input.getFileName().toRawUTF8(),
+                            r.audioSeconds, r.audioSeconds / juce::jmax(1.0e-6, r.renderSeconds), r.latencySamples,
+                            capped.toRawUTF8());
+            else
+                std::printf("  %-48s FAILED: %s\n", job.input.getFileName().toRawUTF8(), r.error.toRawUTF8());
+            std::fflush(stdout);
+            results.push_back(std::move(r));
+        });
+    }
+
+    const auto started = juce::Time::getMillisecondCounterHiRes();
+    WorkStealingPool(numWorkers).run(std::move(work));
+    const double wallSeconds = 0.001 * (juce::Time::getMillisecondCounterHiRes() - started);
+
+    int failed = 0;
+    double audioSeconds = 0.0;
+    for (const auto& r : results)
+    {
+        failed += r.ok ? 0 : 1;
+        audioSeconds += r.audioSeconds;
+    }
+
+    std::printf("Done: %d ok, %d failed; %.1f s of audio in %.1f s wall clock (%.1fx realtime)\n",
+                (int) results.size() - failed, failed, audioSeconds, wallSeconds,
+                audioSeconds / juce::jmax(1.0e-6, wallSeconds));
+    return failed > 0 ? 1 : 0;
+}
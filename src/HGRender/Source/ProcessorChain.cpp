@@ -0,0 +1,192 @@
+#include "ProcessorChain.h"
+#include "../../HungryGhostLimiter/Source/PluginProcessor.h"
+#include "../../HungryGhostMultibandLimiter/Source/PluginProcessor.h"
+#include "../../HungryGhostMultibandCompressor/Source/PluginProcessor.h"
+#include "../../HungryGhostReverb/Source/PluginProcessor.h"
+#include "../../HungryGhostSaturation/Source/PluginProcessor.h"
+
+namespace hgrender {
+namespace {
+
+bool parseJson(const juce::File& file, ChainSpec& result, juce::String& error)
+{
+    const auto root = juce::JSON::parse(file);
+    const auto* chain = root.getProperty("chain", {}).getArray();
+    if (chain == nullptr)
+    {
+        error = "expected a \"chain\" array";
+        return false;
+    }
+
+    for (const auto& entry : *chain)
+    {
+        ProcessorSpec p;
+        p.type = entry.getProperty("processor", {}).toString();
+        p.program = (int) entry.getProperty("program", -1);
+        if (const auto state = entry.getProperty("state", {}).toString(); state.isNotEmpty())
+            p.stateFile = file.getSiblingFile(state);
+        if (auto* params = entry.getProperty("parameters", {}).getDynamicObject())
+            for (const auto& prop : params->getProperties())
+                p.parameters.emplace_back(prop.name.toString(), (float) prop.value);
+        result.processors.push_back(std::move(p));
+    }
+    return true;
+}
+
+bool parseXml(const juce::File& file, ChainSpec& result, juce::String& error)
+{
+    const auto xml = juce::parseXML(file);
+    if (xml == nullptr || ! xml->hasTagName("HGRenderChain"))
+    {
+        error = "expected an <HGRenderChain> document";
+        return false;
+    }
+
+    for (auto* e : xml->getChildWithTagNameIterator("Processor"))
+    {
+        ProcessorSpec p;
+        p.type = e->getStringAttribute("type");
+        p.program = e->getIntAttribute("program", -1);
+        if (e->hasAttribute("state"))
+            p.stateFile = file.getSiblingFile(e->getStringAttribute("state"));
+        for (auto* param : e->getChildWithTagNameIterator("Parameter"))
+            p.parameters.emplace_back(param->getStringAttribute("id"), (float) param->getDoubleAttribute("value"));
+        result.processors.push_back(std::move(p));
+    }
+    return true;
+}
+
+bool setParameter(juce::AudioProcessor& processor, const juce::String& id, float value)
+{
+    for (auto* p : processor.getParameters())
+    {
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(p); ranged != nullptr && ranged->getParameterID() == id)
+        {
+            ranged->setValueNotifyingHost(ranged->convertTo0to1(value));
+            return true;
+        }
+    }
+    return false;
+}
+
+bool loadState(juce::AudioProcessor& processor, const juce::File& file, juce::String& error)
+{
+    juce::MemoryBlock data;
+    if (! file.loadFileAsData(data))
+    {
+        error = "cannot read state " + file.getFullPathName();
+        return false;
+    }
+
+    // Plain XML (a saved parameter tree) is wrapped the way getStateInformation() writes it
+    if (auto xml = juce::parseXML(data.toString()))
+    {
+        data.reset();
+        juce::AudioProcessor::copyXmlToBinary(*xml, data);
+    }
+    processor.setStateInformation(data.getData(), (int) data.getSize());
+    return true;
+}
+
+} // namespace
+
+bool ChainSpec::load(const juce::File& file, ChainSpec& result, juce::String& error)
+{
+    if (! file.existsAsFile())
+    {
+        error = "chain file not found: " + file.getFullPathName();
+        return false;
+    }
+
+    result = {};
+    const bool ok = file.hasFileExtension("xml") ? parseXml(file, result, error) : parseJson(file, result, error);
+    if (ok && result.processors.empty())
+    {
+        error = "the chain has no processors";
+        return false;
+    }
+    return ok;
+}
+
+juce::StringArray getProcessorTypes()
+{
+    return { "HungryGhostSaturation", "HungryGhostMultibandCompressor", "HungryGhostMultibandLimiter",
+             "HungryGhostLimiter", "HungryGhostReverb" };
+}
+
+std::unique_ptr<juce::AudioProcessor> createProcessor(const juce::String& type)
+{
+    if (type == "HungryGhostLimiter")             return std::make_unique<HungryGhostLimiterAudioProcessor>();
+    if (type == "HungryGhostMultibandLimiter")    return std::make_unique<HungryGhostMultibandLimiterAudioProcessor>();
+    if (type == "HungryGhostMultibandCompressor") return std::make_unique<HungryGhostMultibandCompressorAudioProcessor>();
+    if (type == "HungryGhostReverb")              return std::make_unique<HungryGhostReverbAudioProcessor>();
+    if (type == "HungryGhostSaturation")          return std::make_unique<HungryGhostSaturationAudioProcessor>();
+    return nullptr;
+}
+
+bool ProcessorChain::build(const ChainSpec& spec, juce::String& error)
+{
+    processors.clear();
+    for (const auto& s : spec.processors)
+    {
+        auto processor = createProcessor(s.type);
+        if (processor == nullptr)
+        {
+            error = "unknown processor '" + s.type + "' (expected one of " + getProcessorTypes().joinIntoString(", ") + ")";
+            return false;
+        }
+
+        if (s.program >= 0)
+            processor->setCurrentProgram(s.program);
+        if (s.stateFile != juce::File() && ! loadState(*processor, s.stateFile, error))
+            return false;
+        for (const auto& [id, value] : s.parameters)
+        {
+            if (! setParameter(*processor, id, value))
+            {
+                error = s.type + " has no parameter '" + id + "'";
+                return false;
+            }
+        }
+
+        processor->setNonRealtime(true);
+        processors.push_back(std::move(processor));
+    }
+    return true;
+}
+
+void ProcessorChain::prepare(double sampleRate, int blockSize)
+{
+    for (auto& p : processors)
+    {
+        p->setPlayConfigDetails(2, 2, sampleRate, blockSize);
+        p->prepareToPlay(sampleRate, blockSize);
+    }
+}
+
+int ProcessorChain::getLatencySamples() const
+{
+    int total = 0;
+    for (const auto& p : processors)
+        total += p->getLatencySamples();
+    return total;
+}
+
+double ProcessorChain::getTailLengthSeconds() const
+{
+    double total = 0.0;
+    for (const auto& p : processors)
+        total += p->getTailLengthSeconds();
+    return total;
+}
+
+void ProcessorChain::process(juce::AudioBuffer<float>& buffer)
+{
+    for (auto& p : processors)
+    {
+        midi.clear();
+        p->processBlock(buffer, midi);
+    }
+}
+
+} // namespace hgrender
@@ -0,0 +1,68 @@
+#pragma once
+#include <JuceHeader.h>
+#include <memory>
+#include <vector>
+
+namespace hgrender {
+
+// One processor in a chain file: its type, then (in this order) an optional factory program, an
+// optional saved state and any number of parameter overrides in plain (unnormalised) units.
+struct ProcessorSpec
+{
+    juce::String type;                 // e.g. "HungryGhostLimiter"; see getProcessorTypes()
+    int program = -1;
+    juce::File stateFile;              // APVTS state XML, or the raw getStateInformation() blob
+    std::vector<std::pair<juce::String, float>> parameters;
+};
+
+/**
+ * A chain description loaded from JSON or XML (chosen by extension):
+ *
+ *   { "chain": [ { "processor": "HungryGhostSaturation", "program": 1 },
+ *                { "processor": "HungryGhostLimiter", "state": "master.xml",
+ *                  "parameters": { "thresholdL": -6, "thresholdR": -6 } } ] }
+ *
+ *   <HGRenderChain>
+ *     <Processor type="HungryGhostSaturation" program="1"/>
+ *     <Processor type="HungryGhostLimiter" state="master.xml">
+ *       <Parameter id="thresholdL" value="-6"/>
+ *     </Processor>
+ *   </HGRenderChain>
+ *
+ * State paths are relative to the chain file.
+ */
+struct ChainSpec
+{
+    std::vector<ProcessorSpec> processors;
+
+    static bool load(const juce::File& file, ChainSpec& result, juce::String& error);
+};
+
+juce::StringArray getProcessorTypes();
+std::unique_ptr<juce::AudioProcessor> createProcessor(const juce::String& type);
+
+/**
+ * Fresh instances of every processor in a ChainSpec, run in series on a stereo buffer.
+ * One chain per file being rendered: nothing is shared between threads.
+ */
+class ProcessorChain
+{
+public:
+    bool build(const ChainSpec& spec, juce::String& error);
+
+    void prepare(double sampleRate, int blockSize);
+
+    // Sum of the processors' reported latencies; valid after prepare()
+    int getLatencySamples() const;
+
+    // Tail the processors report (reverb); the renderer may append this much silence
+    double getTailLengthSeconds() const;
+
+    void process(juce::AudioBuffer<float>& buffer);
+
+private:
+    std::vector<std::unique_ptr<juce::AudioProcessor>> processors;
+    juce::MidiBuffer midi;
+};
+
+} // namespace hgrender
@@ -0,0 +1,81 @@
+#pragma once
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hgrender {
+
+/**
+ * Runs a fixed batch of independent jobs on N threads, each with its own deque.
+ * Jobs are dealt round-robin in the order given (callers put the longest first); a worker takes
+ * from the front of its own deque and, once that is empty, steals from the back of the others.
+ * A worker that was dealt short files keeps the cores busy with someone else's backlog instead
+ * of idling at the end of the batch.
+ */
+class WorkStealingPool
+{
+public:
+    using Job = std::function<void()>;
+
+    explicit WorkStealingPool(int numWorkers) : queues((size_t) (numWorkers > 0 ? numWorkers : 1)) {}
+
+    /** Deals the jobs out, runs them and returns once all have finished. */
+    void run(std::vector<Job> jobs)
+    {
+        for (size_t i = 0; i < jobs.size(); ++i)
+            queues[i % queues.size()].jobs.push_back(std::move(jobs[i]));
+
+        std::vector<std::thread> workers;
+        for (size_t w = 0; w < queues.size(); ++w)
+            workers.emplace_back([this, w] { workerLoop(w); });
+        for (auto& t : workers)
+            t.join();
+    }
+
+private:
+    struct Queue
+    {
+        std::mutex lock;
+        std::deque<Job> jobs;
+    };
+
+    void workerLoop(size_t self)
+    {
+        // No job is added once run() starts, so finding every queue empty means the batch is done
+        for (Job job; takeOwn(self, job) || steal(self, job); job = nullptr)
+            job();
+    }
+
+    bool takeOwn(size_t self, Job& job)
+    {
+        auto& q = queues[self];
+        const std::lock_guard<std::mutex> sl(q.lock);
+        if (q.jobs.empty())
+            return false;
+        job = std::move(q.jobs.front());
+        q.jobs.pop_front();
+        return true;
+    }
+
+    bool steal(size_t self, Job& job)
+    {
+        for (size_t i = 1; i < queues.size(); ++i)
+        {
+            auto& victim = queues[(self + i) % queues.size()];
+            const std::lock_guard<std::mutex> sl(victim.lock);
+            if (! victim.jobs.empty())
+            {
+                job = std::move(victim.jobs.back());
+                victim.jobs.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::vector<Queue> queues;
+};
+
+} // namespace hgrender
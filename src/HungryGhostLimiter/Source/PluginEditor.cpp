@@ -16,7 +16,7 @@ HungryGhostLimiterAudioProcessorEditor::HungryGhostLimiterAudioProcessorEditor(H
     setLookAndFeel(&lnf);
     setResizable(false, false);
     setOpaque(true);
-    setSize(Layout::kTotalColsWidthPx + 2 * Layout::kPaddingPx, 520);
+    setSize(Layout::kTotalColsWidthPx + 2 * Layout::kPaddingPx, 520 + Layout::kScopeRowHeightPx);
 
     // Configure release knob filmstrip on DonutKnobLNF
     {
@@ -50,6 +50,10 @@ HungryGhostLimiterAudioProcessorEditor::HungryGhostLimiterAudioProcessorEditor(H
     addAndMakeVisible(controlsCol);
     addAndMakeVisible(meterCol);
     addAndMakeVisible(outputCol);
+    loudnessPanel.onReset = [this]() { proc.resetLoudness(); };
+    addAndMakeVisible(loudnessPanel);
+    scopeView.setColumnSeconds(proc.getScopeColumnSeconds());
+    addAndMakeVisible(scopeView);
 
     // Load kit-03 background-03 into memory via ResourceResolver
     {
@@ -84,10 +88,14 @@ HungryGhostLimiterAudioProcessorEditor::HungryGhostLimiterAudioProcessorEditor(H
         controlsCol.repaint();
         meterCol.repaint();
         outputCol.repaint();
+        loudnessPanel.repaint();
+        scopeView.redraw();
         logoHeader.repaint();
         advanced.repaint();
     });
 
+    proc.getMeterFifo().discardAll(); // records queued before the editor opened are stale
+    proc.getScopeFifo().discardAll();
     startTimerHz(30);
 }
 
@@ -166,6 +174,10 @@ void HungryGhostLimiterAudioProcessorEditor::resized()
     // auto footer = bounds.removeFromBottom(Layout::kFooterHeightPx);
     // advanced.setBounds(footer);
 
+    // --- Loudness strip under the columns ---
+    loudnessPanel.setBounds(bounds.removeFromBottom(Layout::kLoudnessRowHeightPx));
+    scopeView.setBounds(bounds.removeFromBottom(Layout::kScopeRowHeightPx).reduced(Layout::kCellMarginPx));
+
     // --- Main content: 6 columns in a Grid ---
     const int required = Layout::kTotalColsWidthPx;
     auto main = bounds.withWidth(juce::jmin(required, bounds.getWidth()));
@@ -198,12 +210,28 @@ void HungryGhostLimiterAudioProcessorEditor::resized()
 
 void HungryGhostLimiterAudioProcessorEditor::timerCallback()
 {
-    // Map attenuation in dB (0..12/24) to meter dBFS range [-60..0], where 0 attenuation -> -60 dB (empty)
-    const float atten = proc.getSmoothedAttenDb();
-    const float capped = juce::jlimit(0.0f, 12.0f, atten); // visualize up to 12 dB
-    const float mappedDb = -60.0f + (capped / 12.0f) * 60.0f; // -60..0 dBFS
-    meterCol.setDb(mappedDb);
-
-    // Update output live levels (dBFS) -> Output column smooths and displays
-    outputCol.setLevelsDbFs(proc.getOutDbL(), proc.getOutDbR());
+    // Everything the audio thread metered since the last tick, merged: peaks and the deepest
+    // reduction are held even when many host blocks went by (or none did)
+    const int n = proc.getMeterFifo().pop(meterRecords.data(), (int)meterRecords.size());
+    if (n > 0)
+    {
+        HungryGhostLimiterAudioProcessor::MeterRecord sum = meterRecords[0];
+        for (int i = 1; i < n; ++i)
+            sum.merge(meterRecords[(size_t)i]);
+
+        // Map attenuation in dB (0..12/24) to meter dBFS range [-60..0], where 0 attenuation -> -60 dB (empty)
+        const float capped = juce::jlimit(0.0f, 12.0f, sum.grMaxDb[0]); // visualize up to 12 dB
+        const float mappedDb = -60.0f + (capped / 12.0f) * 60.0f; // -60..0 dBFS
+        meterCol.setDb(mappedDb);
+
+        // Update output live levels (dBFS) -> Output column smooths and displays
+        outputCol.setLevelsDbFs(sum.peakDb(0), sum.peakDb(1));
+    }
+
+    // Scope: every column since the last tick (the view draws only the pixels they complete)
+    scopeView.setColumnSeconds(proc.getScopeColumnSeconds()); // no-op unless the rate changed
+    const int numColumns = proc.getScopeFifo().pop(scopeColumns.data(), (int)scopeColumns.size());
+    scopeView.pushColumns(scopeColumns.data(), numColumns);
+
+    loudnessPanel.setReadings(proc.getLoudness());
 }
@@ -14,6 +14,8 @@
 #include <Controls/LogoHeader.h>
 #include "ui/AdvancedPanel.h"
 #include "ui/SettingsPanel.h"
+#include "ui/LoudnessPanel.h"
+#include "ui/ScopeView.h"
 #include <BinaryData.h>
 #include <Styling/Theme.h>
 class HungryGhostLimiterAudioProcessorEditor
@@ -47,6 +49,12 @@ private:
     ControlsColumn  controlsCol;
     MeterColumn     meterCol;
     OutputColumn     outputCol;
+    LoudnessPanel    loudnessPanel;
+    ScopeView        scopeView;
+
+    // Scratch for draining the processor's meter and scope FIFOs (message thread only)
+    std::array<HungryGhostLimiterAudioProcessor::MeterRecord, HungryGhostLimiterAudioProcessor::MeterFifo::kCapacity> meterRecords;
+    std::array<HungryGhostLimiterAudioProcessor::ScopeColumn, HungryGhostLimiterAudioProcessor::ScopeFifo::kCapacity> scopeColumns;
 
     // Cached UI background image (kit-03 background-03)
     juce::Image      bgCardImage;
@@ -2,6 +2,7 @@
 #ifndef HGL_HEADLESS_TEST
 #include "PluginEditor.h"
 #endif
+#include <audio/RealtimeSanitizer.h>
 
 //=====================================================================
 
@@ -19,6 +20,54 @@ namespace
     }
 
     constexpr float kMaxLookAheadMs = 5.0f; // pre-allocate up to 5 ms to avoid reallocations in audio thread
+
+    // Per-channel value of a stereo L/R control; centre channels take the mean in dB
+    inline float sideValue(hgl::ChannelSide side, float l, float r) noexcept
+    {
+        return side == hgl::ChannelSide::Left ? l : side == hgl::ChannelSide::Right ? r : 0.5f * (l + r);
+    }
+
+    struct ChannelRole
+    {
+        hgl::ChannelSide side;
+        int pair;      // mirrored channels share a pair; -1 = not a known speaker
+        float weight;  // BS.1770 loudness weight
+    };
+
+    ChannelRole roleOf(juce::AudioChannelSet::ChannelType type) noexcept
+    {
+        using CS = juce::AudioChannelSet;
+        using S = hgl::ChannelSide;
+        switch (type)
+        {
+            case CS::left:            return { S::Left, 0, 1.0f };
+            case CS::right:           return { S::Right, 0, 1.0f };
+            case CS::centre:          return { S::Centre, 0, 1.0f };
+            case CS::LFE:             return { S::Centre, 1, 0.0f };
+            case CS::LFE2:            return { S::Centre, 1, 0.0f };
+            case CS::leftCentre:      return { S::Left, 2, 1.0f };
+            case CS::rightCentre:     return { S::Right, 2, 1.0f };
+            case CS::leftSurround:    return { S::Left, 3, 1.41f };
+            case CS::rightSurround:   return { S::Right, 3, 1.41f };
+            case CS::leftSurroundSide:return { S::Left, 4, 1.41f };
+            case CS::rightSurroundSide:return { S::Right, 4, 1.41f };
+            case CS::leftSurroundRear:return { S::Left, 5, 1.41f };
+            case CS::rightSurroundRear:return { S::Right, 5, 1.41f };
+            case CS::centreSurround:  return { S::Centre, 5, 1.41f };
+            case CS::wideLeft:        return { S::Left, 6, 1.0f };
+            case CS::wideRight:       return { S::Right, 6, 1.0f };
+            case CS::topFrontLeft:    return { S::Left, 7, 1.0f };
+            case CS::topFrontRight:   return { S::Right, 7, 1.0f };
+            case CS::topFrontCentre:  return { S::Centre, 7, 1.0f };
+            case CS::topSideLeft:     return { S::Left, 8, 1.0f };
+            case CS::topSideRight:    return { S::Right, 8, 1.0f };
+            case CS::topMiddle:       return { S::Centre, 8, 1.0f };
+            case CS::topRearLeft:     return { S::Left, 9, 1.0f };
+            case CS::topRearRight:    return { S::Right, 9, 1.0f };
+            case CS::topRearCentre:   return { S::Centre, 9, 1.0f };
+            default:                                           return { S::Centre, -1, 1.0f };
+        }
+    }
 }
 
 //=====================================================================
@@ -27,48 +76,339 @@ HungryGhostLimiterAudioProcessor::HungryGhostLimiterAudioProcessor()
     : AudioProcessor(BusesProperties().withInput("Input", juce::AudioChannelSet::stereo(), true)
         .withOutput("Output", juce::AudioChannelSet::stereo(), true))
 {
+    const audio::ParameterHandles h(apvts);
+    const std::pair<Param, const char*> ids[] = {
+        { pInTrimL, "inTrimL" }, { pInTrimR, "inTrimR" }, { pInTrimLink, "inTrimLink" },
+        { pThresholdL, "thresholdL" }, { pThresholdR, "thresholdR" }, { pThresholdLink, "thresholdLink" },
+        { pCeilingL, "outCeilingL" }, { pCeilingR, "outCeilingR" }, { pCeilingLink, "outCeilingLink" },
+        { pRelease, "release" }, { pLookAhead, "lookAheadMs" }, { pScHpf, "scHpf" },
+        { pSafetyClip, "safetyClip" }, { pAutoRelease, "autoRelease" },
+        { pDomDigital, "domDigital" }, { pDomAnalog, "domAnalog" }, { pDomFastTP, "domFastTP" },
+        { pQ24, "q24" }, { pQ20, "q20" }, { pQ16, "q16" }, { pQ12, "q12" }, { pQ8, "q8" },
+        { pDitherT2, "dT2" }, { pShapeArc, "sArc" }, { pShapeE5, "sE5" }, { pShapeF9, "sF9" },
+        { pOutVolL, "outVolL" }, { pOutVolR, "outVolR" }, { pOutVolLink, "outVolLink" },
+        { pChannelLink, "channelLink" },
+        { pOsRate, "osRate" }, { pOsFilter, "osFilter" }, { pOsOfflineMax, "osOfflineMax" },
+        { pFixedLatency, "fixedLatency" },
+    };
+    static_assert(std::size(ids) == kNumParams, "every snapshot slot needs an ID");
+    for (const auto& [slot, id] : ids)
+        params.bind(slot, h[id]);
+
+    lookAheadMaxMs = apvts.getParameterRange("lookAheadMs").end;
+    jassert(lookAheadMaxMs <= kMaxLookAheadMs);
+
+    startTimerHz(20); // picks up oversampling policy changes (see updateOversampling)
+}
+
+HungryGhostLimiterAudioProcessor::~HungryGhostLimiterAudioProcessor()
+{
+    stopTimer();
+    discardEngineSets();
 }
 
 //=====================================================================
 
 bool HungryGhostLimiterAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
 {
-    return layouts.getMainInputChannelSet() == juce::AudioChannelSet::stereo()
-        && layouts.getMainOutputChannelSet() == juce::AudioChannelSet::stereo();
+    // Any layout up to 16 channels (mono, stereo, surround and immersive beds), in == out
+    const auto& out = layouts.getMainOutputChannelSet();
+    return !out.isDisabled() && out.size() <= kMaxChannels && layouts.getMainInputChannelSet() == out;
 }
 
 //=====================================================================
 
-void HungryGhostLimiterAudioProcessor::buildOversampler(double sr, int samplesPerBlockExpected)
+void HungryGhostLimiterAudioProcessor::configureChannels()
 {
-    // Choose factor: 8� for 44.1/48k, 4� for 88.2/96k or higher
-    osFactor = (sr <= 48000.0 ? 8 : 4);
-    osSampleRate = (float)(sr * osFactor);
+    const auto layout = getChannelLayoutOfBus(true, 0);
+    numChannels = juce::jlimit(1, kMaxChannels, layout.size());
+    loudness.prepare(sampleRateHz, numChannels);
+
+    // Speaker layouts link mirrored pairs; discrete channels (or unknown speakers) are taken as
+    // consecutive L/R pairs. Plain mono is a single centre channel.
+    const bool discrete = layout.isDiscreteLayout() || layout.size() != numChannels;
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        auto role = roleOf(layout.getTypeOfChannel(ch));
+        if (discrete || role.pair < 0)
+        {
+            const bool lone = (ch | 1) >= numChannels;
+            role.side = lone && ch == 0 ? hgl::ChannelSide::Centre
+                      : (ch & 1) != 0 ? hgl::ChannelSide::Right : hgl::ChannelSide::Left;
+            role.pair = 16 + ch / 2;
+            role.weight = 1.0f;
+        }
+        channelSide[(size_t)ch] = role.side;
+        channelGroup[(size_t)ch] = role.pair;
+        loudness.setChannelWeight(ch, role.weight);
+    }
+}
 
-    const int stages = (int)std::log2((double)osFactor);
-    oversampler.reset(new juce::dsp::Oversampling<float>(
-        /*channels*/ 2,
-        /*numStages*/ stages,
-        /*filter*/ juce::dsp::Oversampling<float>::FilterType::filterHalfBandFIREquiripple,
-        /*isMaxQuality*/ true));
+//=====================================================================
 
-    oversampler->reset();
-    oversampler->initProcessing((size_t)samplesPerBlockExpected);
+void HungryGhostLimiterAudioProcessor::prepareEngine(Engine& e, Domain d, const OversamplingPolicy& policy)
+{
+    const bool oversampled = (d == Domain::TruePeak || d == Domain::Analog);
+    e.domain = d;
+    e.factor = oversampled ? policy.factor : 1;
+    e.rate = sampleRateHz * (float)e.factor;
 
-    oversamplingLatencyNative = (int)oversampler->getLatencyInSamples();
+    if (oversampled)
+    {
+        // Integer latency so every domain can be padded to the same whole-sample delay
+        using OS = juce::dsp::Oversampling<float>;
+        e.oversampler.reset(new OS(
+            /*channels*/ (size_t)numChannels,
+            /*numStages*/ (size_t)std::log2((double)e.factor),
+            /*filter*/ policy.filter == OsFilter::LowLatency ? OS::filterHalfBandPolyphaseIIR : OS::filterHalfBandFIREquiripple,
+            /*isMaxQuality*/ policy.maxQuality,
+            /*useIntegerLatency*/ true));
+        e.oversampler->reset();
+        e.oversampler->initProcessing((size_t)maxChunk);
+    }
+    else
+    {
+        e.oversampler.reset();
+    }
+
+    const int maxLASamples = (int)std::ceil(kMaxLookAheadMs * 0.001f * e.rate) + 64;
+    e.limiter.prepare(e.rate, maxLASamples, numChannels);
+    for (int ch = 0; ch < numChannels; ++ch)
+        e.limiter.setChannelConfig(ch, channelSide[(size_t)ch], channelGroup[(size_t)ch]);
+
+    // Analog flavour: sidechain HPF at 60 Hz (prepare() sets the default 30 Hz)
+    if (d == Domain::Analog)
+        e.limiter.setSidechainHPFCutoff(60.0f);
+
+    e.out.setSize(numChannels, maxChunk);
+    e.attenDb = 0.0f;
 }
 
 //=====================================================================
 
+std::unique_ptr<HungryGhostLimiterAudioProcessor::EngineSet>
+HungryGhostLimiterAudioProcessor::buildEngineSet(const OversamplingPolicy& policy)
+{
+    auto set = std::make_unique<EngineSet>();
+    set->policyCode = policy.code();
+
+    for (auto d : { Domain::TruePeak, Domain::Digital, Domain::Analog, Domain::FastTruePeak })
+        prepareEngine((*set)[d], d, policy);
+
+    // Extra host-rate delay of each engine beyond look-ahead; pad all of them to the largest
+    const auto extraLatency = [&set](Domain d)
+    {
+        const auto& e = (*set)[d];
+        if (e.oversampler != nullptr) return (int)e.oversampler->getLatencyInSamples();
+        return d == Domain::FastTruePeak ? hgl::LimiterDSP::kTruePeakDetectorLatency : 0;
+    };
+
+    for (auto d : { Domain::TruePeak, Domain::Digital, Domain::Analog, Domain::FastTruePeak })
+        set->sharedExtraLatency = juce::jmax(set->sharedExtraLatency, extraLatency(d));
+
+    for (auto d : { Domain::TruePeak, Domain::Digital, Domain::Analog, Domain::FastTruePeak })
+    {
+        auto& e = (*set)[d];
+        e.padSamples = set->sharedExtraLatency - extraLatency(d);
+        e.pad.setSize(numChannels, juce::jmax(1, e.padSamples));
+        e.pad.clear();
+        e.padWrite = 0;
+    }
+    return set;
+}
+
+void HungryGhostLimiterAudioProcessor::discardEngineSets() noexcept
+{
+    delete incomingEngineSet.exchange(nullptr, std::memory_order_acq_rel);
+    delete retiredEngineSet.exchange(nullptr, std::memory_order_acq_rel);
+}
 
 //=====================================================================
 
-void HungryGhostLimiterAudioProcessor::updateLatencyReport(float lookMs, bool oversamplingActive)
+void HungryGhostLimiterAudioProcessor::updateOversampling()
+{
+    const juce::ScopedLock sl(buildLock);
+    delete retiredEngineSet.exchange(nullptr, std::memory_order_acq_rel);
+
+    const int wanted = wantedPolicyCode.load(std::memory_order_relaxed);
+    if (engineSet == nullptr || wanted == builtPolicyCode)
+        return;
+
+    // Replaces a set the audio thread has not taken yet (it only ever exchanges it for null)
+    builtPolicyCode = wanted;
+    delete incomingEngineSet.exchange(buildEngineSet(OversamplingPolicy::fromCode(wanted)).release(),
+                                      std::memory_order_acq_rel);
+}
+
+void HungryGhostLimiterAudioProcessor::installEngines(const OversamplingPolicy& policy)
+{
+    ReplacedEngineSets replaced;
+    installEngines(buildEngineSet(policy), replaced);
+}
+
+void HungryGhostLimiterAudioProcessor::installEngines(std::unique_ptr<EngineSet> set, ReplacedEngineSets& replaced) noexcept
+{
+    // Anything built for the previous configuration is dropped: handed to the caller, so a
+    // caller holding the callback lock frees it after releasing the lock
+    {
+        const juce::ScopedLock sl(buildLock);
+        replaced[0].reset(incomingEngineSet.exchange(nullptr, std::memory_order_acq_rel));
+        replaced[1].reset(retiredEngineSet.exchange(nullptr, std::memory_order_acq_rel));
+        replaced[2] = std::move(nextEngineSet);
+        replaced[3] = std::move(engineSet);
+        scopeEngine = nullptr;
+
+        engineSet = std::move(set);
+        requestedPolicyCode = builtPolicyCode = engineSet->policyCode;
+        wantedPolicyCode.store(engineSet->policyCode, std::memory_order_relaxed);
+        activePolicyCode.store(engineSet->policyCode, std::memory_order_relaxed);
+    }
+    sharedExtraLatency = engineSet->sharedExtraLatency;
+
+    activeDomain = pendingDomain = selectedDomain();
+    activeEngine = pendingEngine = &(*engineSet)[activeDomain];
+    switching = false;
+    attachScope(*activeEngine);
+    primeRemaining = 0;
+    fadePos = 0;
+}
+
+void HungryGhostLimiterAudioProcessor::setNonRealtime(bool isNonRealtime) noexcept
+{
+    AudioProcessor::setNonRealtime(isNonRealtime);
+
+    // Before prepareToPlay() there is nothing to switch: it picks the policy itself
+    if (engineSet == nullptr)
+        return;
+
+    // Hosts may go offline without preparing again, and a bounce has to start on the engines
+    // and latency it ends with: switch now rather than through the timer and a crossfade.
+    // Hosts call this off the audio thread; processing is held off only to read the policy and
+    // to swap in the set, which is built (and the old ones freed) outside the callback lock.
+    OversamplingPolicy policy;
+    {
+        const juce::ScopedLock cl(getCallbackLock());
+        params.update();
+        policy = selectedPolicy();
+        if (policy.code() == activePolicyCode.load(std::memory_order_relaxed) && nextEngineSet == nullptr)
+            return;
+    }
+
+    auto set = buildEngineSet(policy);
+    ReplacedEngineSets replaced;
+    {
+        const juce::ScopedLock cl(getCallbackLock());
+        installEngines(std::move(set), replaced);
+        lastReportedLookMs = latencyLookMs();
+        updateLatencyReport(lastReportedLookMs);
+    }
+}
+
+//=====================================================================
+
+void HungryGhostLimiterAudioProcessor::attachScope(Engine& e) noexcept
+{
+    if (scopeEngine != nullptr)
+        scopeEngine->limiter.setScopeOutput(nullptr, 0);
+
+    e.limiter.setScopeOutput(&scopeFifo, scopeColumnSamples * e.factor);
+    scopeEngine = &e;
+}
+
+//=====================================================================
+
+void HungryGhostLimiterAudioProcessor::beginSwitch(Engine& to, Domain d, int latencyLookNative) noexcept
+{
+    pendingEngine = &to;
+    pendingDomain = d;
+    to.limiter.reset();
+    if (to.oversampler != nullptr) to.oversampler->reset();
+    to.pad.clear();
+    to.padWrite = 0;
+    // The new engine's output is valid once its whole pipeline has filled with live input
+    primeRemaining = latencyLookNative + sharedExtraLatency;
+    fadePos = 0;
+    switching = true;
+}
+
+//=====================================================================
+
+void HungryGhostLimiterAudioProcessor::renderEngine(Engine& e, const hgl::LimiterParams& base,
+                                                    int lookNative, int fixedDelayNative,
+                                                    float releaseSec, int n) noexcept
+{
+
+    // Look-ahead in whole host samples for every domain keeps the engines sample-aligned
+    hgl::LimiterParams p = base;
+    p.lookAheadSamplesOS = juce::jmax(1, lookNative * e.factor);
+    p.fixedDelaySamplesOS = fixedDelayNative * e.factor;
+    p.releaseAlphaOS = std::exp(-1.0f / (releaseSec * e.rate));
+    p.truePeakDetect = (e.domain == Domain::FastTruePeak);
+    e.limiter.setParams(p);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        e.out.copyFrom(ch, 0, dryBuffer, ch, 0, n);
+
+    auto block = juce::dsp::AudioBlock<float>(e.out).getSubBlock(0, (size_t)n);
+    float* channels[kMaxChannels];
+    if (e.oversampler != nullptr)
+    {
+        juce::dsp::AudioBlock<float> up;
+        {
+            HG_PROFILE_SCOPE(&profiling.profiler, "limiter.oversampleUp");
+            up = e.oversampler->processSamplesUp(block);
+        }
+        {
+            HG_PROFILE_SCOPE(&profiling.profiler, "limiter.dsp");
+            for (int ch = 0; ch < numChannels; ++ch)
+                channels[ch] = up.getChannelPointer((size_t)ch);
+            e.attenDb = e.limiter.processBlockOS(channels, numChannels, (int)up.getNumSamples());
+        }
+        HG_PROFILE_SCOPE(&profiling.profiler, "limiter.oversampleDown");
+        e.oversampler->processSamplesDown(block);
+    }
+    else
+    {
+        HG_PROFILE_SCOPE(&profiling.profiler, "limiter.dsp");
+        for (int ch = 0; ch < numChannels; ++ch)
+            channels[ch] = block.getChannelPointer((size_t)ch);
+        e.attenDb = e.limiter.processBlockOS(channels, numChannels, n);
+    }
+
+    // Pad up to the shared latency (ring of padSamples per channel)
+    if (e.padSamples > 0)
+    {
+        const int P = e.padSamples;
+        int w = e.padWrite;
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            float* x = e.out.getWritePointer(ch);
+            float* r = e.pad.getWritePointer(ch);
+            w = e.padWrite;
+            for (int i = 0; i < n; ++i)
+            {
+                const float y = r[w];
+                r[w] = x[i];
+                x[i] = y;
+                if (++w == P) w = 0;
+            }
+        }
+        e.padWrite = w;
+    }
+}
+
+//=====================================================================
+
+void HungryGhostLimiterAudioProcessor::updateLatencyReport(float lookMs)
 {
     const int lookNative = (int)std::ceil(lookMs * 0.001f * sampleRateHz);
-    const int osFilt = oversamplingActive ? oversamplingLatencyNative : 0;
-    // Report OS filter latency + look-ahead (both expressed at native rate)
-    setLatencySamples(osFilt + lookNative);
+    // Look-ahead + the largest per-domain filter/detector delay: identical for every domain
+    setLatencySamples(lookNative + sharedExtraLatency);
+}
+
+float HungryGhostLimiterAudioProcessor::latencyLookMs() const noexcept
+{
+    return params.getBool(pFixedLatency) ? lookAheadMaxMs : params[pLookAhead];
 }
 
 //=====================================================================
@@ -76,17 +416,29 @@ void HungryGhostLimiterAudioProcessor::updateLatencyReport(float lookMs, bool ov
 void HungryGhostLimiterAudioProcessor::prepareToPlay(double sr, int samplesPerBlockExpected)
 {
     sampleRateHz = (float)sr;
+    maxChunk = juce::jmax(1, samplesPerBlockExpected);
 
-    buildOversampler(sr, samplesPerBlockExpected);
-    // Prepare core DSP (default to TruePeak domain)
-    const int maxLASamplesOS = (int)std::ceil(kMaxLookAheadMs * 0.001f * osSampleRate) + 64;
-    limiter.prepare(osSampleRate, maxLASamplesOS);
+    configureChannels();
+    params.update();
 
-    currentDomain = Domain::TruePeak;
-    lastDomain    = currentDomain;
+    // ~0.7 ms scope columns (a power of two of host samples): 1 s fills ~1400 pixels at full detail
+    scopeColumnSamples = juce::nextPowerOfTwo(juce::jmax(hgl::LimiterDSP::kMinScopeColumnSamples, (int)std::round(sr / 1500.0)));
+    scopeColumnSeconds.store(scopeColumnSamples / sr, std::memory_order_relaxed);
+
+    // Engines for the current policy, built here directly; later changes go through
+    // updateOversampling() (or setNonRealtime())
+    installEngines(selectedPolicy());
+    dryBuffer.setSize(numChannels, maxChunk);
+    fadeLen = juce::jmax(1, (int)std::round(kCrossfadeMs * 0.001f * sampleRateHz));
 
     currentGainDb = 0.0f;
 
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        dither[ch].setSeed(0x9e3779b9u * (std::uint32_t)(ch + 1));
+        dither[ch].reset();
+    }
+
     // init input trim smoothing (20 ms at native rate)
     for (auto& s : inTrimLin)
     {
@@ -94,11 +446,37 @@ void HungryGhostLimiterAudioProcessor::prepareToPlay(double sr, int samplesPerBl
         s.setCurrentAndTargetValue(1.0f);
     }
 
-    // initial latency report (respect domain parameter if set)
-    const auto* lookParam = apvts.getRawParameterValue("lookAheadMs");
-    lastReportedLookMs = lookParam ? lookParam->load() : 1.0f;
-    const bool domDigInit = (apvts.getRawParameterValue("domDigital") != nullptr) && (apvts.getRawParameterValue("domDigital")->load() > 0.5f);
-    updateLatencyReport(lastReportedLookMs, !domDigInit);
+    meterRecord.clear();
+    meterRecordSamples = juce::jmax(1, (int)std::round(sr * 0.005));
+
+    loudnessOut.store(loudness.getReadings());
+
+    // initial latency report
+    lastReportedLookMs = latencyLookMs();
+    updateLatencyReport(lastReportedLookMs);
+}
+
+//=====================================================================
+
+HungryGhostLimiterAudioProcessor::Domain HungryGhostLimiterAudioProcessor::selectedDomain() const
+{
+    if (params.getBool(pDomDigital)) return Domain::Digital;
+    if (params.getBool(pDomAnalog))  return Domain::Analog;
+    if (params.getBool(pDomFastTP))  return Domain::FastTruePeak;
+    return Domain::TruePeak;
+}
+
+HungryGhostLimiterAudioProcessor::OversamplingPolicy HungryGhostLimiterAudioProcessor::selectedPolicy() const
+{
+    const bool upTo48k = sampleRateHz <= 48000.0f;
+    if (isNonRealtime() && params.getBool(pOsOfflineMax))
+        return { upTo48k ? 16 : 8, OsFilter::LinearPhase, true };
+
+    // Auto: 8x for 44.1/48k, 4x for 88.2/96k or higher. The IIR is there for latency, so it
+    // runs at its cheapest, lowest-latency setting.
+    const int rate = juce::jlimit(0, 3, (int)params[pOsRate]);
+    const auto filter = params.getBool(pOsFilter) ? OsFilter::LowLatency : OsFilter::LinearPhase;
+    return { rate == 0 ? (upTo48k ? 8 : 4) : 1 << rate, filter, filter == OsFilter::LinearPhase };
 }
 
 //=====================================================================
@@ -107,194 +485,231 @@ void HungryGhostLimiterAudioProcessor::processBlock(juce::AudioBuffer<float>& bu
     juce::MidiBuffer&)
 {
     juce::ScopedNoDenormals _;
+    HG_RT_SCOPE("HungryGhostLimiterAudioProcessor::processBlock");
 
     const int numSmps = buffer.getNumSamples();
     if (numSmps == 0) return;
+    HG_PROFILE_BLOCK(&profiling.profiler, "limiter.processBlock", numSmps);
+
+    params.update(); // one relaxed load per parameter, no ID lookups
 
     // --- INPUT TRIM (pre) ---
-    float inTrimLdB = 0.0f;
-    float inTrimRdB = 0.0f;
-    if (auto* v = apvts.getRawParameterValue("inTrimL")) inTrimLdB = v->load();
-    if (auto* v = apvts.getRawParameterValue("inTrimR")) inTrimRdB = v->load();
-    const bool inLink = (apvts.getRawParameterValue("inTrimLink") != nullptr)
-                        && (apvts.getRawParameterValue("inTrimLink")->load() > 0.5f);
+    const float inTrimLdB = params[pInTrimL];
+    float inTrimRdB = params[pInTrimR];
+    const bool inLink = params.getBool(pInTrimLink);
     if (inLink) inTrimRdB = inTrimLdB;
 
-    const float inGL = dbToLin(inTrimLdB);
-    const float inGR = dbToLin(inTrimRdB);
-
-    inTrimLin[0].setTargetValue(inGL);
-    inTrimLin[1].setTargetValue(inGR);
-
-    const int numCh = juce::jmin(buffer.getNumChannels(), 2);
+    const int numCh = juce::jmin(buffer.getNumChannels(), numChannels);
     for (int ch = 0; ch < numCh; ++ch)
     {
-        auto* x = buffer.getWritePointer(ch);
         auto& s = inTrimLin[ch];
+        s.setTargetValue(dbToLin(sideValue(channelSide[(size_t)ch], inTrimLdB, inTrimRdB)));
+        auto* x = buffer.getWritePointer(ch);
         for (int n = 0; n < numSmps; ++n)
             x[n] *= s.getNextValue();
     }
 
-    // --- fetch params (atomic, no locks) ---
-    const float thL = apvts.getRawParameterValue("thresholdL")->load();
-    float       thR = apvts.getRawParameterValue("thresholdR")->load();
-    const bool  thLink = apvts.getRawParameterValue("thresholdLink")->load() > 0.5f;
+    // --- limiter params (from the block snapshot) ---
+    const float thL = params[pThresholdL];
+    float       thR = params[pThresholdR];
+    const bool  thLink = params.getBool(pThresholdLink);
     if (thLink) { /* mirror left into right for pre-gain */ thR = thL; }
 
-    float ceilLDb = apvts.getRawParameterValue("outCeilingL")->load();
-    float ceilRDb = apvts.getRawParameterValue("outCeilingR")->load();
-    const bool  ceilLink = apvts.getRawParameterValue("outCeilingLink")->load() > 0.5f;
+    const float ceilLDb = params[pCeilingL];
+    float       ceilRDb = params[pCeilingR];
+    const bool  ceilLink = params.getBool(pCeilingLink);
     if (ceilLink) ceilRDb = ceilLDb;
 
-    const float releaseMs = apvts.getRawParameterValue("release")->load();
-    const float lookMs = apvts.getRawParameterValue("lookAheadMs")->load();
-    const bool  scHPFOn = apvts.getRawParameterValue("scHpf")->load() > 0.5f;
-    const bool  safetyOn = apvts.getRawParameterValue("safetyClip")->load() > 0.5f;
-    const bool  autoRel = (apvts.getRawParameterValue("autoRelease") != nullptr)
-                          && (apvts.getRawParameterValue("autoRelease")->load() > 0.5f);
+    const float releaseMs = params[pRelease];
+    const float lookMs = params[pLookAhead];
+    const bool  scHPFOn = params.getBool(pScHpf);
+    const bool  safetyOn = params.getBool(pSafetyClip);
+    const bool  autoRel = params.getBool(pAutoRelease);
 
     const float ceilLin = dbToLin(juce::jmin(ceilLDb, ceilRDb));
     const float preGainL = dbToLin(-thL);
     const float preGainR = dbToLin(-thR);
 
-    // --- Domain selection ---
-    const bool domDig  = (apvts.getRawParameterValue("domDigital") != nullptr) && (apvts.getRawParameterValue("domDigital")->load() > 0.5f);
-    const bool domAna  = (apvts.getRawParameterValue("domAnalog")  != nullptr) && (apvts.getRawParameterValue("domAnalog")->load()  > 0.5f);
-    currentDomain = domDig ? Domain::Digital : (domAna ? Domain::Analog : Domain::TruePeak);
-
-    // --- derive time constants based on domain sample-rate ---
-    const float compSR = (currentDomain == Domain::Digital) ? sampleRateHz : osSampleRate;
-    lookAheadSamplesOS = juce::jlimit(1, (int)std::round(lookMs * 0.001f * compSR), (int)std::round(lookMs * 0.001f * compSR));
-
+    const int lookNative = juce::jmax(1, (int)std::ceil(lookMs * 0.001f * sampleRateHz));
+    // Fixed latency: the audio is always delayed by the top of the look-ahead range and the gain
+    // by whatever the look-ahead leaves, so the pipeline (and the report) stays the same length
+    const float reportLookMs = latencyLookMs();
+    const int fixedDelayNative = params.getBool(pFixedLatency)
+        ? juce::jmax(lookNative, (int)std::ceil(lookAheadMaxMs * 0.001f * sampleRateHz)) : 0;
+    const int latencyLookNative = fixedDelayNative > 0 ? fixedDelayNative : lookNative;
     const float relSec = juce::jlimit(0.001f, 2.0f, releaseMs * 0.001f);
-    releaseAlphaOS = std::exp(-1.0f / (relSec * compSR));
 
-    // Re-prepare limiter if domain switched (updates SR and delay capacities)
-    if (currentDomain != lastDomain)
+    // --- oversampling policy: a change is built off the audio thread (updateOversampling) and
+    //     taken up below like a domain switch, once the previous set has been handed back ---
+    const int policyCode = selectedPolicy().code();
+    if (policyCode != requestedPolicyCode)
     {
-        const int maxLASamples = (int)std::ceil(kMaxLookAheadMs * 0.001f * compSR) + 64;
-        limiter.prepare(compSR, maxLASamples);
-        lastDomain = currentDomain;
+        requestedPolicyCode = policyCode;
+        wantedPolicyCode.store(policyCode, std::memory_order_relaxed);
     }
 
-    // Adjust sidechain HPF cutoff for analog flavour
-    if (currentDomain == Domain::Analog)
-        limiter.setSidechainHPFCutoff(60.0f);
-    else
-        limiter.setSidechainHPFCutoff(30.0f);
-
-    // --- latency report only if look-ahead changed noticeably ---
-    if (!std::isfinite(lastReportedLookMs) || std::abs(lookMs - lastReportedLookMs) > 1.0e-3f)
+    const Domain target = selectedDomain();
+    if (!switching && retiredEngineSet.load(std::memory_order_acquire) == nullptr)
     {
-        updateLatencyReport(lookMs, currentDomain != Domain::Digital);
-        lastReportedLookMs = lookMs;
+        if (auto* incoming = incomingEngineSet.exchange(nullptr, std::memory_order_acq_rel))
+        {
+            nextEngineSet.reset(incoming);
+            sharedExtraLatency = nextEngineSet->sharedExtraLatency;
+            lastReportedLookMs = std::numeric_limits<float>::quiet_NaN(); // report the new latency
+            beginSwitch((*nextEngineSet)[target], target, latencyLookNative);
+        }
     }
 
-    juce::dsp::AudioBlock<float> inBlock(buffer);
-
-    float* upL = nullptr; float* upR = nullptr; int N = 0;
-
-    if (currentDomain == Domain::Digital)
-    {
-        upL = inBlock.getChannelPointer(0);
-        upR = inBlock.getChannelPointer(1);
-        N = (int)inBlock.getNumSamples();
-    }
-    else
+    // --- latency report only if look-ahead changed noticeably (domain does not move it; with
+    //     fixed latency neither does look-ahead) ---
+    if (!std::isfinite(lastReportedLookMs) || std::abs(reportLookMs - lastReportedLookMs) > 1.0e-3f)
     {
-        // --- oversample up ---
-        auto upBlock = oversampler->processSamplesUp(inBlock);
-        upL = upBlock.getChannelPointer(0);
-        upR = upBlock.getChannelPointer(1);
-        N = (int)upBlock.getNumSamples();
+        updateLatencyReport(reportLookMs);
+        lastReportedLookMs = reportLookMs;
     }
 
-    // Prepare params for core DSP
+    // --- Domain selection: start a switch; a request during a switch waits for it to finish ---
+    if (!switching && target != activeDomain)
+        beginSwitch((*engineSet)[target], target, latencyLookNative);
+
+    // Prepare params for core DSP (rate-dependent fields are filled per engine)
     hgl::LimiterParams p;
     p.preGainL = preGainL;
     p.preGainR = preGainR;
     p.ceilLin  = ceilLin;
-    p.releaseAlphaOS = releaseAlphaOS;
-    p.lookAheadSamplesOS = lookAheadSamplesOS;
     p.scHpfOn = scHPFOn;
     p.safetyOn = safetyOn;
     p.autoReleaseOn = autoRel;
+    p.link = (hgl::ChannelLink)juce::jlimit(0, 2, (int)params[pChannelLink]);
+
+    float meterMaxAttenDb = 0.0f;
+    for (int start = 0; start < numSmps; start += maxChunk)
+    {
+        const int n = juce::jmin(maxChunk, numSmps - start);
+        for (int ch = 0; ch < numChannels; ++ch)
+            dryBuffer.copyFrom(ch, 0, buffer, ch, start, n);
+
+        auto& active = *activeEngine;
+        renderEngine(active, p, lookNative, fixedDelayNative, relSec, n);
+        float chunkAttenDb = active.attenDb;
+
+        if (!switching)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                buffer.copyFrom(ch, start, active.out, ch, 0, n);
+        }
+        else
+        {
+            auto& pending = *pendingEngine;
+            renderEngine(pending, p, lookNative, fixedDelayNative, relSec, n);
+
+            // Raised-cosine crossfade (gains sum to 1) once the pending engine is primed
+            int prime = primeRemaining, pos = fadePos;
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                const float* a = active.out.getReadPointer(ch);
+                const float* b = pending.out.getReadPointer(ch);
+                float* y = buffer.getWritePointer(ch, start);
+                prime = primeRemaining; pos = fadePos;
+                for (int i = 0; i < n; ++i)
+                {
+                    float gNew = 0.0f;
+                    if (prime > 0) --prime;
+                    else
+                    {
+                        const float t = juce::jmin(1.0f, (float)pos++ / (float)fadeLen);
+                        gNew = 0.5f - 0.5f * std::cos(juce::MathConstants<float>::pi * t);
+                    }
+                    y[i] = a[i] + gNew * (b[i] - a[i]);
+                }
+            }
+            primeRemaining = prime;
+            fadePos = pos;
 
-    limiter.setParams(p);
-    const float meterMaxAttenDb = limiter.processBlockOS(upL, upR, N);
+            if (primeRemaining == 0)
+                chunkAttenDb = juce::jmax(chunkAttenDb, pending.attenDb);
 
-    // --- downsample back to host rate if needed ---
-    if (currentDomain != Domain::Digital)
-        oversampler->processSamplesDown(inBlock);
+            if (primeRemaining == 0 && fadePos >= fadeLen)
+            {
+                activeDomain = pendingDomain;
+                activeEngine = pendingEngine;
+                switching = false;
+                attachScope(*activeEngine);
+
+                if (nextEngineSet != nullptr)
+                {
+                    activePolicyCode.store(nextEngineSet->policyCode, std::memory_order_relaxed);
+                    retiredEngineSet.store(engineSet.release(), std::memory_order_release);
+                    engineSet = std::move(nextEngineSet);
+                }
+            }
+        }
+
+        meterMaxAttenDb = juce::jmax(meterMaxAttenDb, chunkAttenDb);
+    }
 
     // --- ADVANCED: optional quantize + dither + shaping (host rate) ---
     int bits = 0; // 0 = bypass
-    const auto on = [](const juce::AudioProcessorValueTreeState& s, const char* id){ if (auto* v = s.getRawParameterValue(id)) return v->load() > 0.5f; return false; };
-    if (on(apvts, "q24")) bits = 24; else if (on(apvts, "q20")) bits = 20; else if (on(apvts, "q16")) bits = 16; else if (on(apvts, "q12")) bits = 12; else if (on(apvts, "q8")) bits = 8;
-    const bool ditherT2 = on(apvts, "dT2"); // default to T2 in layout
-    const bool shapeArc = on(apvts, "sArc");
+    const auto on = [this](Param slot) { return params.getBool(slot); };
+    if (on(pQ24)) bits = 24; else if (on(pQ20)) bits = 20; else if (on(pQ16)) bits = 16; else if (on(pQ12)) bits = 12; else if (on(pQ8)) bits = 8;
+    const bool ditherT2 = on(pDitherT2); // default to T2 in layout
+    const auto shape = on(pShapeF9) ? hgl::Dither::Shape::FWeighted9
+                     : on(pShapeE5) ? hgl::Dither::Shape::EWeighted5
+                     : on(pShapeArc) ? hgl::Dither::Shape::FirstOrder
+                     : hgl::Dither::Shape::None;
 
     if (bits > 0 && bits < 32)
     {
-        const float step = std::ldexp(1.0f, 1 - bits); // 2^(1-bits)
-        const float amp  = ditherT2 ? 2.0f : 1.0f;     // scale for T2
-        const int numCh = juce::jmin(buffer.getNumChannels(), 2);
-        const int N = buffer.getNumSamples();
+        HG_PROFILE_SCOPE(&profiling.profiler, "limiter.dither");
+        const float amp = ditherT2 ? 2.0f : 1.0f; // TPDF peak in steps (T2 = double width)
         for (int ch = 0; ch < numCh; ++ch)
-        {
-            float* x = buffer.getWritePointer(ch);
-            float ePrev = nsErrPrev[ch];
-            for (int n = 0; n < N; ++n)
-            {
-                float y = x[n];
-                if (shapeArc) y += 0.8f * ePrev; // simple error-feedback shaping
-                // TPDF dither in [-amp*step, amp*step]
-                const float u1 = rng.nextFloat();
-                const float u2 = rng.nextFloat();
-                const float tpdf = ((u1 + u2) - 1.0f) * (amp * step);
-                y += tpdf;
-                // quantize to nearest step
-                const float q = std::round(y / step) * step;
-                const float err = y - q; ePrev = err;
-                x[n] = juce::jlimit(-1.0f, 1.0f, q);
-            }
-            nsErrPrev[ch] = ePrev;
-        }
+            dither[ch].process(buffer.getWritePointer(ch), buffer.getNumSamples(), bits, amp, shape);
     }
 
     // --- post output volume (host rate, after all processing) ---
-    float outLdB = 0.0f, outRdB = 0.0f;
-    if (auto* v = apvts.getRawParameterValue("outVolL")) outLdB = v->load();
-    if (auto* v = apvts.getRawParameterValue("outVolR")) outRdB = v->load();
-    const bool outLink = (apvts.getRawParameterValue("outVolLink") != nullptr)
-                         && (apvts.getRawParameterValue("outVolLink")->load() > 0.5f);
+    const float outLdB = params[pOutVolL];
+    float outRdB = params[pOutVolR];
+    const bool outLink = params.getBool(pOutVolLink);
     if (outLink) outRdB = outLdB;
 
-    const float gL = dbToLin(outLdB);
-    const float gR = dbToLin(outRdB);
+    int laneCount[2] {};
+    for (int ch = 0; ch < numCh; ++ch)
     {
-        const int numCh = juce::jmin(buffer.getNumChannels(), 2);
-        const int N2 = buffer.getNumSamples();
-        float peak[2] { 0.0f, 0.0f };
-        for (int ch = 0; ch < numCh; ++ch)
-        {
-            float* x = buffer.getWritePointer(ch);
-            const float g = (ch == 0 ? gL : gR);
-            for (int n = 0; n < N2; ++n) {
-                x[n] *= g;
-                peak[ch] = juce::jmax(peak[ch], std::abs(x[n]));
-            }
-        }
-        // convert to dBFS and clamp
-        for (int ch = 0; ch < numCh; ++ch)
-        {
-            const float db = 20.0f * std::log10(juce::jmax(peak[ch], 1.0e-5f)); // [-100,0]
-            outDbRaw[ch].store(juce::jlimit(-60.0f, 0.0f, db), std::memory_order_relaxed);
-        }
+        const auto side = channelSide[(size_t)ch];
+        laneCount[0] += side != hgl::ChannelSide::Right ? 1 : 0;
+        laneCount[1] += side != hgl::ChannelSide::Left ? 1 : 0;
+    }
+    for (int ch = 0; ch < numCh; ++ch)
+    {
+        const auto side = channelSide[(size_t)ch];
+        buffer.applyGain(ch, 0, numSmps, dbToLin(sideValue(side, outLdB, outRdB)));
+        for (int lane = 0; lane < 2; ++lane)
+            if (side != (lane == 0 ? hgl::ChannelSide::Right : hgl::ChannelSide::Left))
+                meterRecord.addLevels(lane, buffer.getReadPointer(ch), numSmps, 1.0f / (float)laneCount[lane]);
+    }
+
+    // --- meter (host rate): raw values, the UI merges records and smooths
+    const float attenDb = juce::jlimit(0.0f, 24.0f, meterMaxAttenDb);
+    meterRecord.addGainReduction(0, attenDb);
+    meterRecord.addGainReduction(1, attenDb);
+    meterRecord.advance(numSmps);
+    if (meterRecord.numSamples >= meterRecordSamples)
+    {
+        meterFifo.push(meterRecord); // dropped when no editor is draining
+        meterRecord.clear();
     }
 
-    // --- meter (host rate): store raw dB and let UI smooth
-    attenDbRaw.store(juce::jlimit(0.0f, 24.0f, meterMaxAttenDb), std::memory_order_relaxed);
+    // --- loudness (host rate): BS.1770 / R128 of exactly what leaves the plugin ---
+    {
+        HG_PROFILE_SCOPE(&profiling.profiler, "limiter.loudness");
+        if (loudnessResetRequested.exchange(false, std::memory_order_relaxed))
+            loudness.reset();
+        const float* out[kMaxChannels];
+        for (int ch = 0; ch < numChannels; ++ch)
+            out[ch] = buffer.getReadPointer(juce::jmin(ch, buffer.getNumChannels() - 1));
+        loudness.process(out, numSmps);
+        loudnessOut.store(loudness.getReadings());
+    }
 }
 
 //=====================================================================
@@ -401,10 +816,13 @@ HungryGhostLimiterAudioProcessor::createParameterLayout()
 
     params.push_back(std::make_unique<AudioParameterBool>(ParameterID{ "sNone", 1 }, "Shape None", false));
     params.push_back(std::make_unique<AudioParameterBool>(ParameterID{ "sArc",  1 }, "Shape Arc",  true));
+    params.push_back(std::make_unique<AudioParameterBool>(ParameterID{ "sE5",   1 }, "Shape E-weighted 5", false));
+    params.push_back(std::make_unique<AudioParameterBool>(ParameterID{ "sF9",   1 }, "Shape F-weighted 9", false));
 
     params.push_back(std::make_unique<AudioParameterBool>(ParameterID{ "domDigital", 1 }, "Domain Digital", false));
     params.push_back(std::make_unique<AudioParameterBool>(ParameterID{ "domAnalog",  1 }, "Domain Analog",  false));
     params.push_back(std::make_unique<AudioParameterBool>(ParameterID{ "domTruePeak",1 }, "Domain TruePeak", true));
+    params.push_back(std::make_unique<AudioParameterBool>(ParameterID{ "domFastTP",  1 }, "Domain Fast TruePeak", false));
 
     // --- Output Volume (post-processing), stereo + link ---
     params.push_back(std::make_unique<AudioParameterFloat>(
@@ -418,12 +836,36 @@ HungryGhostLimiterAudioProcessor::createParameterLayout()
     params.push_back(std::make_unique<AudioParameterBool>(
         ParameterID{ "outVolLink", 1 }, "Link Output Vol", true));
 
+    // --- Oversampling of the TruePeak/Analog domains ---
+    params.push_back(std::make_unique<AudioParameterChoice>(
+        ParameterID{ "osRate", 1 }, "Oversampling",
+        StringArray{ "Auto", "2x", "4x", "8x" }, 0));
+
+    params.push_back(std::make_unique<AudioParameterChoice>(
+        ParameterID{ "osFilter", 1 }, "Oversampling Filter",
+        StringArray{ "Linear Phase", "Low Latency" }, 0));
+
+    params.push_back(std::make_unique<AudioParameterBool>(
+        ParameterID{ "osOfflineMax", 1 }, "Offline Max Quality", true));
+
+    // --- Latency: report the longest look-ahead once and pad internally, so look-ahead can be
+    //     automated without the host re-running delay compensation ---
+    params.push_back(std::make_unique<AudioParameterBool>(
+        ParameterID{ "fixedLatency", 1 }, "Constant Latency", false));
+
+    // --- Multichannel: how channels share gain reduction (stereo: Groups/Linked are the same) ---
+    params.push_back(std::make_unique<AudioParameterChoice>(
+        ParameterID{ "channelLink", 1 }, "Channel Link",
+        StringArray{ "Linked", "Groups", "Unlinked" }, 0));
+
     return { params.begin(), params.end() };
 }
 
 //=====================================================================
 
+#ifndef HGL_HEADLESS_TEST // headless builds link several processors into one binary
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 {
     return new HungryGhostLimiterAudioProcessor();
 }
+#endif
@@ -12,15 +12,21 @@
 #include <atomic>
 #include <limits>
 #include "dsp/LimiterDSP.h"
+#include "dsp/Dither.h"
 #include <juce_dsp/juce_dsp.h>
+#include <audio/ParameterHandles.h>
+#include <audio/Profiler.h>
+#include <audio/LoudnessMeter.h>
+#include <audio/MeterFifo.h>
 
 //==============================================================================
 
-class HungryGhostLimiterAudioProcessor : public juce::AudioProcessor
+class HungryGhostLimiterAudioProcessor : public juce::AudioProcessor,
+                                         private juce::Timer
 {
 public:
     HungryGhostLimiterAudioProcessor();
-    ~HungryGhostLimiterAudioProcessor() override = default;
+    ~HungryGhostLimiterAudioProcessor() override;
 
     //==============================================================================
     void prepareToPlay(double sampleRate, int samplesPerBlockExpected) override;
@@ -54,101 +60,195 @@ public:
     APVTS apvts{ *this, nullptr, "params", createParameterLayout() };
     static APVTS::ParameterLayout createParameterLayout();
 
-    // exposed to editor (gain-reduction, dB, >= 0). UI applies smoothing.
-    float getSmoothedAttenDb() const { return attenDbRaw.load(); }
-    float getOutDbL() const { return outDbRaw[0].load(); }
-    float getOutDbR() const { return outDbRaw[1].load(); }
+    // Output level (lanes L/R) and gain reduction (dB >= 0, same in both lanes) per ~5 ms of
+    // audio, whatever the host block size. On multichannel buses left-side channels fold into lane
+    // 0, right-side ones into lane 1 and centre channels into both. The editor is the only
+    // consumer; UI applies smoothing.
+    using MeterRecord = audio::MeterFrame<2>;
+    using MeterFifo = audio::MeterFifo<MeterRecord, 512>;
+    MeterFifo& getMeterFifo() noexcept { return meterFifo; }
+
+    // Scrolling scope: one min/max column of input/output/gain per getScopeColumnSeconds() of
+    // audio, streamed from whichever engine is active. Columns are dropped while nobody drains.
+    using ScopeColumn = hgl::ScopeColumn;
+    using ScopeFifo = hgl::LimiterDSP::ScopeFifo;
+    ScopeFifo& getScopeFifo() noexcept { return scopeFifo; }
+    double getScopeColumnSeconds() const noexcept { return scopeColumnSeconds.load(std::memory_order_relaxed); }
+
+    // EBU R128 loudness + dBTP of the output, refreshed every 100 ms of audio
+    audio::LoudnessMeter::Readings getLoudness() const { return loudnessOut.load(); }
+    // Starts a new integrated/LRA/max-TP measurement (taken up by the next processBlock)
+    void resetLoudness() { loudnessResetRequested.store(true, std::memory_order_relaxed); }
+
+    // Oversampling of the TruePeak/Analog domains, from "osRate" (Auto = 8x up to 48 kHz, else 4x)
+    // and "osFilter". With "osOfflineMax" on, non-realtime renders use max-quality linear phase at
+    // 16x (8x above 48 kHz).
+    enum class OsFilter { LinearPhase, LowLatency }; // half-band equiripple FIR / polyphase IIR
+    struct OversamplingPolicy
+    {
+        int factor = 8;
+        OsFilter filter = OsFilter::LinearPhase;
+        bool maxQuality = true;
 
-private:
-    // ========= Parameters we read every block =========
-    float sampleRateHz = 44100.0f;
-    int   osFactor = 1;        // 1, 4, or 8 (set in prepare based on sample rate)
-    float osSampleRate = 44100.0f; // sampleRateHz * osFactor
+        int code() const noexcept { return factor | ((int)filter << 8) | ((maxQuality ? 1 : 0) << 9); }
+        static OversamplingPolicy fromCode(int c) noexcept { return { c & 0xff, (OsFilter)((c >> 8) & 1), ((c >> 9) & 1) != 0 }; }
+        bool operator==(const OversamplingPolicy& o) const noexcept { return code() == o.code(); }
+    };
+    // Policy of the engines currently producing the output
+    OversamplingPolicy getOversamplingPolicy() const noexcept { return OversamplingPolicy::fromCode(activePolicyCode.load(std::memory_order_relaxed)); }
 
-    // --- metering (host-rate): raw dB reduction (smoothed in UI component) ---
-    std::atomic<float> attenDbRaw { 0.0f }; // 0..24 dB
+    // Message thread: builds the engines for a changed policy and frees the ones the audio thread
+    // has finished with. Runs from a timer; headless hosts without a message loop call it directly.
+    void updateOversampling();
 
-    // --- metering (host-rate): output peak dBFS per channel (UI smooths) ---
-    std::atomic<float> outDbRaw[2] { -60.0f, -60.0f }; // dBFS, clamp [-60, 0]
+    // Switching to or from offline rendering installs that mode's oversampling at once (engines
+    // built here, latency reported) rather than on the timer, so a bounce starts on the engines
+    // and latency it ends with. Not called on the audio thread.
+    void setNonRealtime(bool isNonRealtime) noexcept override;
 
-    // ========= Oversampling =========
-    std::unique_ptr<juce::dsp::Oversampling<float>> oversampler; // built in prepare
-    int oversamplingLatencyNative = 0; // in native samples
+private:
+    // TruePeak/Analog: whole signal at 4x/8x. Digital: host rate, sample peak.
+    // FastTruePeak: host rate, 8x interpolated detector only (no oversampling filters).
+    enum class Domain { TruePeak, Digital, Analog, FastTruePeak };
 
-    // ========= DSP Core =========
-    // Extracted into hgl::LimiterDSP; processor manages oversampling, state, and params.
-    hgl::LimiterDSP limiter;
+    // ========= Parameters we read every block =========
+    // Handles are resolved once in the constructor; processBlock only loads the snapshot.
+    enum Param : size_t
+    {
+        pInTrimL, pInTrimR, pInTrimLink,
+        pThresholdL, pThresholdR, pThresholdLink,
+        pCeilingL, pCeilingR, pCeilingLink,
+        pRelease, pLookAhead, pScHpf, pSafetyClip, pAutoRelease,
+        pDomDigital, pDomAnalog, pDomFastTP,
+        pQ24, pQ20, pQ16, pQ12, pQ8, pDitherT2,
+        pShapeArc, pShapeE5, pShapeF9,
+        pOutVolL, pOutVolR, pOutVolLink,
+        pChannelLink,
+        pOsRate, pOsFilter, pOsOfflineMax,
+        pFixedLatency,
+        kNumParams
+    };
+    audio::ParamSnapshot<kNumParams> params;
 
-    // ========= Advanced post (host-rate) state =========
-    juce::Random rng;
-    float nsErrPrev[2] { 0.0f, 0.0f }; // noise-shaping error (per channel)
+    float sampleRateHz = 44100.0f;
 
-    // ========= Input Trim smoothing =========
-    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> inTrimLin[2];
+    // ========= Channel layout (set in prepare from the main bus) =========
+    // Every channel takes the L or R control values by side (centre channels the mean in dB);
+    // ChannelLink::Grouped links the mirrored pairs of the layout (L/R with C, Ls/Rs, heights...).
+    static constexpr int kMaxChannels = hgl::kMaxLimiterChannels;
+    int numChannels = 2;
+    std::array<hgl::ChannelSide, kMaxChannels> channelSide {};
+    std::array<int, kMaxChannels> channelGroup {};
+
+    // --- metering (host-rate): records are filled block by block and pushed once they cover
+    // meterRecordSamples (5 ms), so tiny blocks don't flood the FIFO and large ones don't starve it
+    MeterFifo meterFifo;
+    MeterRecord meterRecord;
+    int meterRecordSamples = 240;
+
+    // --- scope (host-rate column length; engines run it at their own rate) ---
+    ScopeFifo scopeFifo;
+    int scopeColumnSamples = 32;
+    std::atomic<double> scopeColumnSeconds { 32.0 / 44100.0 };
+
+    // --- metering (host-rate): loudness of the final output (audio thread only) + UI copy ---
+    audio::LoudnessMeter loudness;
+    audio::PublishedLoudness loudnessOut;
+    std::atomic<bool> loudnessResetRequested { false };
+
+    // ========= Domain engines =========
+    // One fully prepared engine per domain, so switching never allocates or re-prepares on the
+    // audio thread. Every engine is padded to the same host-rate latency; a switch primes the
+    // new engine on the live input and then crossfades to it.
+    struct Engine
+    {
+        Domain domain = Domain::TruePeak;
+        hgl::LimiterDSP limiter;
+        std::unique_ptr<juce::dsp::Oversampling<float>> oversampler; // null for host-rate domains
+        int   factor = 1;           // oversampling factor (1 = host rate)
+        float rate = 44100.0f;      // rate the limiter runs at
+        int   padSamples = 0;       // host-rate delay that brings this engine to the shared latency
+        juce::AudioBuffer<float> out;  // host-rate render target (sized in prepare)
+        juce::AudioBuffer<float> pad;  // ring for the padding delay
+        int   padWrite = 0;
+        float attenDb = 0.0f;       // max attenuation of the last render
+    };
 
-    // ========= Sliding-window maximum (monotonic queue, allocation-free in audio) =========
-    struct SlidingMax
+    // The four engines for one oversampling policy. A policy change builds a whole new set on the
+    // message thread; the audio thread takes it up like a domain switch and hands the old set
+    // back for deletion, so neither side allocates or frees what the other is using.
+    struct EngineSet
     {
-        void reset(int capacitySamples)
-        {
-            // capacity is the maximum look-ahead window we’ll ever use
-            vals.assign((size_t)juce::jmax(capacitySamples + 8, 32), 0.0f);
-            idxs.assign(vals.size(), 0);
-            head = tail = 0;
-            currentIdx = 0;
-            capacity = (int)vals.size();
-        }
-
-        inline void push(float v, int windowSamples) noexcept
-        {
-            // pop smaller items from the tail
-            while (head != tail)
-            {
-                const int last = (tail + capacity - 1) % capacity;
-                if (v <= vals[(size_t)last]) break;
-                tail = last; // drop the last item
-            }
-
-            vals[(size_t)tail] = v;
-            idxs[(size_t)tail] = currentIdx;
-            tail = (tail + 1) % capacity;
-
-            // purge items that are out of the window from the head
-            const int lowerBound = currentIdx - windowSamples;
-            while (head != tail && idxs[(size_t)head] <= lowerBound)
-                head = (head + 1) % capacity;
-
-            ++currentIdx;
-        }
-
-        inline float getMax() const noexcept
-        {
-            return (head != tail) ? vals[(size_t)head] : 0.0f;
-        }
-
-        std::vector<float> vals;
-        std::vector<int>   idxs;
-        int head = 0, tail = 0, capacity = 0;
-        int currentIdx = 0;
+        std::array<Engine, 4> engines; // indexed by Domain
+        int policyCode = 0;
+        int sharedExtraLatency = 0;    // host samples on top of look-ahead, same for all domains
+        Engine& operator[](Domain d) noexcept { return engines[(size_t)d]; }
     };
 
-    SlidingMax slidingMax; // (legacy leftover, will be unused after migration)
+    std::unique_ptr<EngineSet> engineSet;          // in use (audio thread once prepared)
+    std::unique_ptr<EngineSet> nextEngineSet;      // being crossfaded to after a policy change
+    std::atomic<EngineSet*> incomingEngineSet { nullptr }; // built, not yet taken by the audio thread
+    std::atomic<EngineSet*> retiredEngineSet { nullptr };  // finished with, deleted by the message thread
+    std::atomic<int> wantedPolicyCode { 0 };       // audio thread -> message thread
+    std::atomic<int> activePolicyCode { 0 };
+    int requestedPolicyCode = 0;                   // audio thread: last code published
+    int builtPolicyCode = 0;                       // message thread: newest set built
+    juce::CriticalSection buildLock;               // prepareToPlay vs. updateOversampling, never the audio thread
+
+    Engine* activeEngine = nullptr;
+    Engine* pendingEngine = nullptr;
+    Engine* scopeEngine = nullptr;                 // the one engine streaming to the scope
+
+    juce::AudioBuffer<float> dryBuffer; // trimmed input, shared by the engines during a switch
+    int maxChunk = 512;                 // largest sub-block handed to an engine
+    int sharedExtraLatency = 0;         // of the set being reported to the host
+
+    static constexpr float kCrossfadeMs = 20.0f;
+    int primeRemaining = 0;  // host samples before the pending engine's output is valid
+    int fadePos = 0, fadeLen = 1;
+    bool switching = false;
+
+    // ========= Advanced post (host-rate) state =========
+    hgl::Dither dither[kMaxChannels]; // TPDF dither + noise shaping (per channel)
+
+   #if HG_PROFILING
+    // Per-stage timings, written to a trace when the instance is destroyed (see audio/Profiler.h)
+    audio::ProfileSession profiling { "HungryGhostLimiter" };
+   #endif
+
+    // ========= Input Trim smoothing =========
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> inTrimLin[kMaxChannels];
 
     // ========= Gain computer state =========
     float currentGainDb = 0.0f; // <= 0 dB; negative means attenuation
 
     // ========= Helpers =========
-    void buildOversampler(double sr, int samplesPerBlockExpected);
-    void updateLatencyReport(float lookMs, bool oversamplingActive); // calls setLatencySamples()
+    void configureChannels(); // numChannels, channelSide/Group and loudness weights from the bus layout
+    void prepareEngine(Engine& e, Domain d, const OversamplingPolicy& policy);
+    std::unique_ptr<EngineSet> buildEngineSet(const OversamplingPolicy& policy); // off the audio thread
+    void discardEngineSets() noexcept; // incoming and retired sets (not the audio thread)
+    using ReplacedEngineSets = std::array<std::unique_ptr<EngineSet>, 4>;
+    void installEngines(const OversamplingPolicy& policy); // builds a set and makes it current at once (not the audio thread)
+    void installEngines(std::unique_ptr<EngineSet> set, ReplacedEngineSets& replaced) noexcept; // makes a built set current; frees nothing
+    void attachScope(Engine& e) noexcept; // only the active engine feeds the scope
+    void beginSwitch(Engine& to, Domain d, int latencyLookNative) noexcept;
+    // fixedDelayNative: 0, or the constant audio delay (>= lookNative) of the fixed-latency mode
+    void renderEngine(Engine& e, const hgl::LimiterParams& base, int lookNative, int fixedDelayNative,
+                      float releaseSec, int n) noexcept;
+    Domain selectedDomain() const; // from the domain toggles (snapshot); TruePeak when none is set
+    OversamplingPolicy selectedPolicy() const; // from the snapshot, the rate and isNonRealtime()
+    void timerCallback() override { updateOversampling(); }
+    void updateLatencyReport(float lookMs); // calls setLatencySamples()
+    // Look-ahead the latency is reported for: the current one, or with "fixedLatency" on the top
+    // of the look-ahead range, so automating look-ahead never changes the reported latency
+    float latencyLookMs() const noexcept;
 
     // --- cached derived values (updated per block) ---
-    int   lookAheadSamplesOS = 0;      // at OS rate
-    float releaseAlphaOS = 0.0f;   // one-pole release coefficient at OS rate
     float lastReportedLookMs = std::numeric_limits<float>::quiet_NaN();
+    float lookAheadMaxMs = 3.0f; // end of the "lookAheadMs" range
 
-    enum class Domain { TruePeak, Digital, Analog };
-    Domain currentDomain = Domain::TruePeak;
-    Domain lastDomain = Domain::TruePeak;
+    Domain activeDomain  = Domain::TruePeak;
+    Domain pendingDomain = Domain::TruePeak;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(HungryGhostLimiterAudioProcessor)
 };
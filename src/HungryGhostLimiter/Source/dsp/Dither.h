@@ -0,0 +1,178 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include "FastMath.h"
+#include <audio/RealtimeSanitizer.h>
+#include <array>
+#include <cstdint>
+
+namespace hgl {
+
+// Output word-length reduction for one channel: TPDF dither + error-feedback noise shaping.
+//
+// Dither comes from eight xorshift32 lanes stepped together (two 4-lane SSE2/NEON registers, or
+// the same arithmetic in scalar code). Each 32-bit draw is split into two 16-bit uniforms whose
+// sum is triangular, so one step yields eight TPDF samples with no per-sample RNG call.
+//
+// Shaping follows the classic error-feedback form: y = x - sum(c[k] * e[n-1-k]), q = round(y + d),
+// e = q - y, giving a noise transfer of 1 - sum(c[k] z^-(k+1)). The 5- and 9-tap sets are the
+// published Lipshitz (E-weighted) and Wannamaker (F-weighted) filters; both are designed for
+// 44.1/48 kHz and push the noise above ~15 kHz where hearing is least sensitive.
+class Dither
+{
+public:
+    enum class Shape { None, FirstOrder, EWeighted5, FWeighted9 };
+
+    static constexpr int kBlock = 256;  // noise generated per chunk
+    static constexpr int kMaxTaps = 9;
+
+    explicit Dither(std::uint32_t seed = 0x9e3779b9u) { setSeed(seed); }
+
+    void setSeed(std::uint32_t seed) noexcept
+    {
+        // Distinct non-zero lane states from a splitmix-style scramble of the seed
+        for (size_t i = 0; i < lanes.size(); ++i)
+        {
+            std::uint32_t z = seed + 0x9e3779b9u * (std::uint32_t)(i + 1);
+            z = (z ^ (z >> 16)) * 0x85ebca6bu;
+            z = (z ^ (z >> 13)) * 0xc2b2ae35u;
+            z ^= z >> 16;
+            lanes[i] = z != 0 ? z : 0x6d2b79f5u;
+        }
+    }
+
+    void reset() noexcept { feedback.fill(0.0f); }
+
+    // Quantize x in place to 'bits' (step 2^(1-bits)) with TPDF dither of +-ditherLsb steps.
+    void process(float* x, int n, int bits, float ditherLsb, Shape shape) noexcept
+    {
+        HG_RT_SCOPE("hgl::Dither::process");
+        const float step = std::ldexp(1.0f, 1 - bits);
+        for (int start = 0; start < n; start += kBlock)
+        {
+            const int m = juce::jmin(kBlock, n - start);
+            generateTpdf(noise.data(), m, ditherLsb);
+            switch (shape)
+            {
+                case Shape::None:       quantize<0>(x + start, m, step, coefficients(shape)); break;
+                case Shape::FirstOrder: quantize<1>(x + start, m, step, coefficients(shape)); break;
+                case Shape::EWeighted5: quantize<5>(x + start, m, step, coefficients(shape)); break;
+                case Shape::FWeighted9: quantize<9>(x + start, m, step, coefficients(shape)); break;
+            }
+        }
+    }
+
+    // TPDF in (-amp, amp), n rounded up to a multiple of 8 (out must have room)
+    void generateTpdf(float* out, int n, float amp) noexcept
+    {
+        const float scale = amp * (1.0f / 65536.0f);
+       #if HGL_FASTMATH_SSE2
+        __m128i s0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes.data()));
+        __m128i s1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes.data() + 4));
+        const __m128i lo16 = _mm_set1_epi32(0xffff), bias = _mm_set1_epi32(65535);
+        const __m128 k = _mm_set1_ps(scale);
+        auto step = [](__m128i s) {
+            s = _mm_xor_si128(s, _mm_slli_epi32(s, 13));
+            s = _mm_xor_si128(s, _mm_srli_epi32(s, 17));
+            return _mm_xor_si128(s, _mm_slli_epi32(s, 5));
+        };
+        auto tpdf = [&](__m128i s) {
+            const __m128i sum = _mm_add_epi32(_mm_srli_epi32(s, 16), _mm_and_si128(s, lo16));
+            return _mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(sum, bias)), k);
+        };
+        for (int i = 0; i < n; i += 8)
+        {
+            s0 = step(s0); s1 = step(s1);
+            _mm_storeu_ps(out + i, tpdf(s0));
+            _mm_storeu_ps(out + i + 4, tpdf(s1));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes.data()), s0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes.data() + 4), s1);
+       #elif HGL_FASTMATH_NEON
+        uint32x4_t s0 = vld1q_u32(lanes.data());
+        uint32x4_t s1 = vld1q_u32(lanes.data() + 4);
+        const float32x4_t k = vdupq_n_f32(scale);
+        auto step = [](uint32x4_t s) {
+            s = veorq_u32(s, vshlq_n_u32(s, 13));
+            s = veorq_u32(s, vshrq_n_u32(s, 17));
+            return veorq_u32(s, vshlq_n_u32(s, 5));
+        };
+        auto tpdf = [&](uint32x4_t s) {
+            const int32x4_t sum = vreinterpretq_s32_u32(vaddq_u32(vshrq_n_u32(s, 16), vandq_u32(s, vdupq_n_u32(0xffff))));
+            return vmulq_f32(vcvtq_f32_s32(vsubq_s32(sum, vdupq_n_s32(65535))), k);
+        };
+        for (int i = 0; i < n; i += 8)
+        {
+            s0 = step(s0); s1 = step(s1);
+            vst1q_f32(out + i, tpdf(s0));
+            vst1q_f32(out + i + 4, tpdf(s1));
+        }
+        vst1q_u32(lanes.data(), s0);
+        vst1q_u32(lanes.data() + 4, s1);
+       #else
+        for (int i = 0; i < n; i += 8)
+            for (int l = 0; l < 8; ++l)
+            {
+                std::uint32_t s = lanes[(size_t)l];
+                s ^= s << 13; s ^= s >> 17; s ^= s << 5;
+                lanes[(size_t)l] = s;
+                out[i + l] = (float)((std::int32_t)((s >> 16) + (s & 0xffffu)) - 65535) * scale;
+            }
+       #endif
+    }
+
+private:
+    // Round to nearest (ties to even) without a libm call
+    static inline float roundSteps(float u) noexcept
+    {
+       #if HGL_FASTMATH_SSE2
+        return (float)_mm_cvtss_si32(_mm_set_ss(u));
+       #elif HGL_FASTMATH_NEON
+        return vgetq_lane_f32(vrndnq_f32(vdupq_n_f32(u)), 0);
+       #else
+        return (float)juce::roundToInt(u);
+       #endif
+    }
+
+    // The feedback recursion is inherently per sample. It runs in transposed form: acc[k] holds
+    // sum(c[j] * e[n-1-j+k]) for j >= k, i.e. the part of future feedback already known. Each
+    // sample adds c[k] * e to every slot and shifts by one, so only acc[0] sits on the chain.
+    template <int Taps>
+    void quantize(float* y, int m, float step, const float* coeffs) noexcept
+    {
+        const float invStep = 1.0f / step;
+        float c[Taps + 1] {}, acc[Taps + 1] {};
+        for (int k = 0; k < Taps; ++k) { c[k] = coeffs[k]; acc[k] = feedback[(size_t)k]; }
+
+        for (int i = 0; i < m; ++i)
+        {
+            const float u = y[i] * invStep - acc[0]; // in steps
+            const float q = roundSteps(u + noise[(size_t)i]);
+            const float e = q - u;
+            for (int k = 0; k < Taps; ++k)
+                acc[k] = acc[k + 1] + c[k] * e;
+            y[i] = juce::jlimit(-1.0f, 1.0f, q * step);
+        }
+
+        for (int k = 0; k < Taps; ++k) feedback[(size_t)k] = acc[k];
+    }
+
+    static const float* coefficients(Shape s) noexcept
+    {
+        static constexpr float firstOrder[kMaxTaps] { 0.8f };
+        static constexpr float lipshitz5[kMaxTaps]  { 2.033f, -2.165f, 1.959f, -1.590f, 0.6149f };
+        static constexpr float wannamakerF9[kMaxTaps] { 2.412f, -3.370f, 3.937f, -4.174f, 3.353f,
+                                                        -2.205f, 1.281f, -0.569f, 0.0847f };
+        switch (s)
+        {
+            case Shape::EWeighted5: return lipshitz5;
+            case Shape::FWeighted9: return wannamakerF9;
+            case Shape::FirstOrder: case Shape::None: default: return firstOrder;
+        }
+    }
+
+    alignas(16) std::array<std::uint32_t, 8> lanes {};
+    alignas(16) std::array<float, kBlock> noise {};
+    std::array<float, kMaxTaps> feedback {}; // transposed-form shaping state
+};
+
+} // namespace hgl
@@ -0,0 +1,166 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <cstdint>
+#include <cstring>
+
+#if JUCE_INTEL
+ #include <emmintrin.h>
+ #define HGL_FASTMATH_SSE2 1
+#elif JUCE_ARM && JUCE_64BIT
+ #include <arm_neon.h>
+ #define HGL_FASTMATH_NEON 1
+#endif
+
+namespace hgl::fastmath {
+
+// Branch-free float log/exp for the limiter's block stages (dB <-> gain over a whole stage).
+// 4-lane SSE2 / NEON kernels with a scalar tail that evaluates the same polynomial, so every
+// path agrees to rounding. Relative error is ~1e-7 over the gain computer's range.
+
+inline float bitsToFloat(std::int32_t i) noexcept { float f; std::memcpy(&f, &i, sizeof f); return f; }
+inline std::int32_t floatToBits(float f) noexcept { std::int32_t i; std::memcpy(&i, &f, sizeof i); return i; }
+
+constexpr std::int32_t kSqrtHalfBits = 0x3f3504f3; // bits of sqrt(0.5)
+constexpr float kLn2   = 0.69314718f;
+constexpr float kLog2e = 1.44269504f;
+
+// Natural log for positive normal x.
+inline float log(float x) noexcept
+{
+    // x = m * 2^e with m in [sqrt(0.5), sqrt(2)): bias the bits so the exponent split lands there
+    const std::int32_t bits = floatToBits(x);
+    const std::int32_t e = (bits - kSqrtHalfBits) >> 23;
+    const float m = bitsToFloat(bits - (e << 23));
+
+    // ln(m) = 2 atanh(t), t = (m - 1) / (m + 1), |t| <= 0.1716
+    const float t  = (m - 1.0f) / (m + 1.0f);
+    const float t2 = t * t;
+    const float p  = 1.0f + t2 * (1.0f / 3.0f + t2 * (1.0f / 5.0f + t2 * (1.0f / 7.0f + t2 * (1.0f / 9.0f))));
+    return (float)e * kLn2 + 2.0f * t * p;
+}
+
+// e^x for x in [-87, 88].
+inline float exp(float x) noexcept
+{
+    // x = n ln2 + y with n = round(x / ln2), |y| <= ln2 / 2
+    const std::int32_t n = (std::int32_t)(x * kLog2e + 128.5f) - 128; // floor(. + 0.5), argument > 0
+    const float y = x - (float)n * kLn2;
+
+    // Taylor to degree 7: truncation error < 6e-9 on |y| <= 0.347
+    const float p = 1.0f + y * (1.0f + y * (1.0f / 2.0f + y * (1.0f / 6.0f + y * (1.0f / 24.0f
+                  + y * (1.0f / 120.0f + y * (1.0f / 720.0f + y * (1.0f / 5040.0f)))))));
+    return p * bitsToFloat((n + 127) << 23);
+}
+
+constexpr float kDbPerNeper = 8.68588964f;  // 20 / ln(10)
+constexpr float kNeperPerDb = 0.115129255f; // ln(10) / 20
+
+#if HGL_FASTMATH_SSE2
+inline __m128 log4(__m128 x) noexcept
+{
+    const __m128i bits = _mm_castps_si128(x);
+    const __m128i e = _mm_srai_epi32(_mm_sub_epi32(bits, _mm_set1_epi32(kSqrtHalfBits)), 23);
+    const __m128 m = _mm_castsi128_ps(_mm_sub_epi32(bits, _mm_slli_epi32(e, 23)));
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 t  = _mm_div_ps(_mm_sub_ps(m, one), _mm_add_ps(m, one));
+    const __m128 t2 = _mm_mul_ps(t, t);
+    __m128 p = _mm_add_ps(_mm_set1_ps(1.0f / 7.0f), _mm_mul_ps(t2, _mm_set1_ps(1.0f / 9.0f)));
+    p = _mm_add_ps(_mm_set1_ps(1.0f / 5.0f), _mm_mul_ps(t2, p));
+    p = _mm_add_ps(_mm_set1_ps(1.0f / 3.0f), _mm_mul_ps(t2, p));
+    p = _mm_add_ps(one, _mm_mul_ps(t2, p));
+    return _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(e), _mm_set1_ps(kLn2)),
+                      _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(2.0f), t), p));
+}
+
+inline __m128 exp4(__m128 x) noexcept
+{
+    const __m128 xn = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(kLog2e)), _mm_set1_ps(128.5f));
+    const __m128i n = _mm_sub_epi32(_mm_cvttps_epi32(xn), _mm_set1_epi32(128));
+    const __m128 y = _mm_sub_ps(x, _mm_mul_ps(_mm_cvtepi32_ps(n), _mm_set1_ps(kLn2)));
+    __m128 p = _mm_add_ps(_mm_set1_ps(1.0f / 720.0f), _mm_mul_ps(y, _mm_set1_ps(1.0f / 5040.0f)));
+    p = _mm_add_ps(_mm_set1_ps(1.0f / 120.0f), _mm_mul_ps(y, p));
+    p = _mm_add_ps(_mm_set1_ps(1.0f / 24.0f), _mm_mul_ps(y, p));
+    p = _mm_add_ps(_mm_set1_ps(1.0f / 6.0f), _mm_mul_ps(y, p));
+    p = _mm_add_ps(_mm_set1_ps(1.0f / 2.0f), _mm_mul_ps(y, p));
+    p = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(y, p));
+    p = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(y, p));
+    return _mm_mul_ps(p, _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23)));
+}
+#elif HGL_FASTMATH_NEON
+inline float32x4_t log4(float32x4_t x) noexcept
+{
+    const int32x4_t bits = vreinterpretq_s32_f32(x);
+    const int32x4_t e = vshrq_n_s32(vsubq_s32(bits, vdupq_n_s32(kSqrtHalfBits)), 23);
+    const float32x4_t m = vreinterpretq_f32_s32(vsubq_s32(bits, vshlq_n_s32(e, 23)));
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t t  = vdivq_f32(vsubq_f32(m, one), vaddq_f32(m, one));
+    const float32x4_t t2 = vmulq_f32(t, t);
+    float32x4_t p = vaddq_f32(vdupq_n_f32(1.0f / 7.0f), vmulq_f32(t2, vdupq_n_f32(1.0f / 9.0f)));
+    p = vaddq_f32(vdupq_n_f32(1.0f / 5.0f), vmulq_f32(t2, p));
+    p = vaddq_f32(vdupq_n_f32(1.0f / 3.0f), vmulq_f32(t2, p));
+    p = vaddq_f32(one, vmulq_f32(t2, p));
+    return vaddq_f32(vmulq_f32(vcvtq_f32_s32(e), vdupq_n_f32(kLn2)),
+                     vmulq_f32(vmulq_f32(vdupq_n_f32(2.0f), t), p));
+}
+
+inline float32x4_t exp4(float32x4_t x) noexcept
+{
+    const float32x4_t xn = vaddq_f32(vmulq_f32(x, vdupq_n_f32(kLog2e)), vdupq_n_f32(128.5f));
+    const int32x4_t n = vsubq_s32(vcvtq_s32_f32(xn), vdupq_n_s32(128));
+    const float32x4_t y = vsubq_f32(x, vmulq_f32(vcvtq_f32_s32(n), vdupq_n_f32(kLn2)));
+    float32x4_t p = vaddq_f32(vdupq_n_f32(1.0f / 720.0f), vmulq_f32(y, vdupq_n_f32(1.0f / 5040.0f)));
+    p = vaddq_f32(vdupq_n_f32(1.0f / 120.0f), vmulq_f32(y, p));
+    p = vaddq_f32(vdupq_n_f32(1.0f / 24.0f), vmulq_f32(y, p));
+    p = vaddq_f32(vdupq_n_f32(1.0f / 6.0f), vmulq_f32(y, p));
+    p = vaddq_f32(vdupq_n_f32(1.0f / 2.0f), vmulq_f32(y, p));
+    p = vaddq_f32(vdupq_n_f32(1.0f), vmulq_f32(y, p));
+    p = vaddq_f32(vdupq_n_f32(1.0f), vmulq_f32(y, p));
+    return vmulq_f32(p, vreinterpretq_f32_s32(vshlq_n_s32(vaddq_s32(n, vdupq_n_s32(127)), 23)));
+}
+#endif
+
+// Same contract as juce::Decibels::gainToDecibels(max(g, 1e-12)): floor at -100 dB.
+inline void gainToDecibels(float* dB, const float* gain, int n) noexcept
+{
+    int i = 0;
+   #if HGL_FASTMATH_SSE2
+    for (; i + 4 <= n; i += 4)
+    {
+        const __m128 g = _mm_max_ps(_mm_loadu_ps(gain + i), _mm_set1_ps(1.0e-12f));
+        _mm_storeu_ps(dB + i, _mm_max_ps(_mm_mul_ps(_mm_set1_ps(kDbPerNeper), log4(g)), _mm_set1_ps(-100.0f)));
+    }
+   #elif HGL_FASTMATH_NEON
+    for (; i + 4 <= n; i += 4)
+    {
+        const float32x4_t g = vmaxq_f32(vld1q_f32(gain + i), vdupq_n_f32(1.0e-12f));
+        vst1q_f32(dB + i, vmaxq_f32(vmulq_f32(vdupq_n_f32(kDbPerNeper), log4(g)), vdupq_n_f32(-100.0f)));
+    }
+   #endif
+    for (; i < n; ++i)
+        dB[i] = juce::jmax(-100.0f, kDbPerNeper * log(juce::jmax(gain[i], 1.0e-12f)));
+}
+
+// Same contract as juce::Decibels::decibelsToGain(dB): 0 at or below -100 dB.
+inline void decibelsToGain(float* gain, const float* dB, int n) noexcept
+{
+    int i = 0;
+   #if HGL_FASTMATH_SSE2
+    for (; i + 4 <= n; i += 4)
+    {
+        const __m128 d = _mm_max_ps(_mm_loadu_ps(dB + i), _mm_set1_ps(-100.0f));
+        const __m128 g = exp4(_mm_mul_ps(_mm_set1_ps(kNeperPerDb), d));
+        _mm_storeu_ps(gain + i, _mm_and_ps(g, _mm_cmpgt_ps(d, _mm_set1_ps(-100.0f))));
+    }
+   #elif HGL_FASTMATH_NEON
+    for (; i + 4 <= n; i += 4)
+    {
+        const float32x4_t d = vmaxq_f32(vld1q_f32(dB + i), vdupq_n_f32(-100.0f));
+        const float32x4_t g = exp4(vmulq_f32(vdupq_n_f32(kNeperPerDb), d));
+        vst1q_f32(gain + i, vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(g), vcgtq_f32(d, vdupq_n_f32(-100.0f)))));
+    }
+   #endif
+    for (; i < n; ++i)
+        gain[i] = dB[i] > -100.0f ? exp(kNeperPerDb * dB[i]) : 0.0f;
+}
+
+} // namespace hgl::fastmath
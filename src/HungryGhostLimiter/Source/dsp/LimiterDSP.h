@@ -2,11 +2,30 @@
 #include <juce_core/juce_core.h>
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_dsp/juce_dsp.h>
+#include "FastMath.h"
+#include "SlidingMax.h"
+#include <audio/RealtimeSanitizer.h>
+#include <audio/MeterFifo.h>
+#include <array>
 #include <vector>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 
 namespace hgl {
 
+inline constexpr int kMaxLimiterChannels = 16;
+
+// How channels share gain reduction: one gain for every channel, one per group given with
+// LimiterDSP::setChannelConfig() (e.g. the front, surround and height pairs of a bed), or one
+// gain per channel.
+enum class ChannelLink { Linked, Grouped, Unlinked };
+
+// Which pre-gain a channel takes: preGainL, preGainR, or for centre/LFE channels the geometric
+// mean of the two (their mean in dB).
+enum class ChannelSide : std::uint8_t { Left, Right, Centre };
+
 struct LimiterParams
 {
     float preGainL = 1.0f;      // linear
@@ -14,138 +33,455 @@ struct LimiterParams
     float ceilLin  = 1.0f;      // linear ceiling
     float releaseAlphaOS = 0.0f; // one-pole release coefficient at OS rate
     int   lookAheadSamplesOS = 1;  // samples, OS rate
+    int   fixedDelaySamplesOS = 0; // 0: audio delay follows look-ahead; else constant (>= look-ahead)
     bool  scHpfOn = true;       // sidechain HPF enable
     bool  safetyOn = false;     // safety clip enable
     bool  autoReleaseOn = false; // program-dependent release when true
+    bool  truePeakDetect = false; // 8x interpolated detector for host-rate operation
+    ChannelLink link = ChannelLink::Linked; // gain sharing across channels
+};
+
+// One column of the scrolling scope: min/max of the limiter input (after pre-gain and the
+// look-ahead delay, so it lines up with the output), of the output and of the applied gain in dB
+// (<= 0) over a fixed run of samples. All channels share a column. Default-constructed = empty.
+struct ScopeColumn
+{
+    float inMin  = std::numeric_limits<float>::max(), inMax  = std::numeric_limits<float>::lowest();
+    float outMin = std::numeric_limits<float>::max(), outMax = std::numeric_limits<float>::lowest();
+    float gainMinDb = std::numeric_limits<float>::max(), gainMaxDb = std::numeric_limits<float>::lowest();
+
+    bool isEmpty() const noexcept { return inMax < inMin; }
+
+    void merge(const ScopeColumn& o) noexcept
+    {
+        inMin = juce::jmin(inMin, o.inMin);             inMax = juce::jmax(inMax, o.inMax);
+        outMin = juce::jmin(outMin, o.outMin);          outMax = juce::jmax(outMax, o.outMax);
+        gainMinDb = juce::jmin(gainMinDb, o.gainMinDb); gainMaxDb = juce::jmax(gainMaxDb, o.gainMaxDb);
+    }
 };
 
 class LimiterDSP
 {
 public:
-    void prepare(float osSampleRateIn, int maxLookAheadSamplesOS)
+    // Internal stage length: processBlockOS() walks the OS buffer in chunks of at most this many
+    // samples so every stage runs over contiguous scratch without knowing the host block size.
+    static constexpr int kStageBlock = 256;
+
+    // Extra main-path delay while truePeakDetect is on, so gain lines up with the interpolator.
+    static constexpr int kTruePeakDetectorLatency = 16;
+
+    // Worst-case under-read of the host-rate true-peak detector for content up to 20 kHz at
+    // 44.1 kHz (0.25 dB measured on adversarial multi-tones, under 0.1 dB at 48 kHz). The
+    // ceiling the detector is compared against is lowered by this while truePeakDetect is on.
+    static constexpr float kTruePeakUnderReadDb = 0.3f;
+
+    // Scope stream: one ScopeColumn per fixed number of samples, whatever the block sizes
+    static constexpr int kMinScopeColumnSamples = 16;
+    using ScopeFifo = audio::MeterFifo<ScopeColumn, 4096>;
+
+    static constexpr int kMaxChannels = kMaxLimiterChannels;
+
+    // numChannelsIn: channels per processBlockOS() call, 1..kMaxChannels. Resets the channel
+    // config to stereo pairs: even channels Left, odd channels Right, channels 2k/2k+1 a group.
+    void prepare(float osSampleRateIn, int maxLookAheadSamplesOS, int numChannelsIn = 2)
     {
         osSampleRate = osSampleRateIn;
-        // Pre-allocate look-ahead delay and sliding max
-        delayL.reset(maxLookAheadSamplesOS + 64);
-        delayR.reset(maxLookAheadSamplesOS + 64);
-        slidingMax.reset(maxLookAheadSamplesOS + 64);
+        numChannels = juce::jlimit(1, kMaxChannels, numChannelsIn);
+        TruePeakInterpolator::coefficients(); // build the shared table off the audio thread
+        // Pre-allocate look-ahead delays and sliding maxima (a delay keeps one stage of headroom
+        // so a whole stage can be written before it is read back)
+        for (int c = 0; c < numChannels; ++c)
+        {
+            delays[(size_t)c].reset(maxLookAheadSamplesOS + 64 + kStageBlock);
+            groups[(size_t)c].slidingMax.reset(maxLookAheadSamplesOS + 64, kStageBlock);
+            groups[(size_t)c].gainDelay.reset(maxLookAheadSamplesOS + 64 + kStageBlock);
+            setChannelConfig(c, (c & 1) != 0 ? ChannelSide::Right : ChannelSide::Left, c / 2);
+        }
         updateSidechainFilter();
-        currentGainDb = 0.0f;
-        grEnvFastDb = 0.0f;
-        grEnvSlowDb = 0.0f;
+        autoReleaseFastAlpha = std::exp(-1.0f / juce::jmax(1.0f, osSampleRate * 0.02f)); // ~20 ms
+        reset();
     }
 
+    // Clears all running state (delay lines, detector, filters, envelopes) without reallocating,
+    // so an idle engine can be restarted on the audio thread.
     void reset()
     {
-        currentGainDb = 0.0f;
+        for (int c = 0; c < numChannels; ++c)
+        {
+            delays[(size_t)c].clear();
+            truePeak[(size_t)c].reset();
+            groups[(size_t)c].slidingMax.clear();
+            groups[(size_t)c].gainDelay.clear(); // 0 dB
+            groups[(size_t)c].env = {};
+        }
+        gainLook = { params.lookAheadSamplesOS, params.lookAheadSamplesOS, params.lookAheadSamplesOS, 0 };
+        for (auto& f : scHPF)
+            f.reset();
+        scope.filled = 0;
+        scope.open = {};
+    }
+
+    // Pre-gain side and ChannelLink::Grouped group (any small integer) of one channel. Call after
+    // prepare(); not while processBlockOS() runs.
+    void setChannelConfig(int channel, ChannelSide side, int group) noexcept
+    {
+        jassert(channel >= 0 && channel < numChannels);
+        channelSide[(size_t)channel] = side;
+        channelGroup[(size_t)channel] = group;
+        groupMapValid = false;
+    }
+
+    int getNumChannels() const noexcept { return numChannels; }
+
+    void setParams(const LimiterParams& p)
+    {
+        // Entering the fixed-delay mode: the gain delay has not been fed, so start it at the
+        // current gain of each group rather than at whatever it held last time
+        if (p.fixedDelaySamplesOS > 0 && params.fixedDelaySamplesOS <= 0)
+        {
+            for (int g = 0; g < numGroups; ++g)
+                std::fill(groups[(size_t)g].gainDelay.buf.begin(), groups[(size_t)g].gainDelay.buf.end(),
+                          groups[(size_t)g].env.gainDb);
+            gainLook = { p.lookAheadSamplesOS, p.lookAheadSamplesOS, p.lookAheadSamplesOS, 0 };
+        }
+        params = p;
     }
 
-    void setParams(const LimiterParams& p) { params = p; }
+    // Streams a ScopeColumn into fifo every samplesPerColumn samples (at the rate this engine runs
+    // at); nullptr stops the stream. Starts a fresh column, so call it between blocks.
+    void setScopeOutput(ScopeFifo* fifo, int samplesPerColumn) noexcept
+    {
+        scope.fifo = fifo;
+        scope.columnLength = juce::jmax(kMinScopeColumnSamples, samplesPerColumn);
+        scope.filled = 0;
+        scope.open = {};
+    }
 
     // Allow host to change sidechain HPF cutoff (Hz) at runtime
     void setSidechainHPFCutoff(float Hz)
     {
         scHPFCoefs = juce::dsp::IIR::Coefficients<float>::makeHighPass(osSampleRate, juce::jmax(5.0f, Hz));
-        scHPF_L.coefficients = scHPFCoefs;
-        scHPF_R.coefficients = scHPFCoefs;
+        for (auto& f : scHPF)
+            f.setCoefficients(*scHPFCoefs);
     }
 
-    // Process OS-rate interleaved arrays by channel pointers. Returns peak attenuation dB (positive, 0..)
-    float processBlockOS(float* upL, float* upR, int N)
+    // Process OS-rate audio in place: numChannelsIn (== the prepared count) pointers of N samples.
+    // Returns the peak attenuation of any channel in dB (positive, 0..)
+    float processBlockOS(float* const* channels, int numChannelsIn, int N)
     {
-        jassert(upL != nullptr && upR != nullptr);
+        HG_RT_SCOPE("hgl::LimiterDSP::processBlockOS");
+        jassert(channels != nullptr && numChannelsIn == numChannels);
+        juce::ignoreUnused(numChannelsIn);
         float meterMaxAttenDb = 0.0f;
 
-        for (int i = 0; i < N; ++i)
+        if (!groupMapValid || params.link != groupMapLink)
+            updateGroups();
+
+        float* stagePtrs[kMaxChannels];
+        for (int start = 0; start < N; start += kStageBlock)
         {
-            // 1) pre-gain at OS rate
-            float xl = upL[i] * params.preGainL;
-            float xr = upR[i] * params.preGainR;
+            const int n = juce::jmin(kStageBlock, N - start);
+            for (int c = 0; c < numChannels; ++c)
+                stagePtrs[c] = channels[c] + start;
+            meterMaxAttenDb = juce::jmax(meterMaxAttenDb, processStage(stagePtrs, n));
+        }
 
-            // 2) sidechain detection (optional HPF)
-            float dl = params.scHpfOn ? scHPF_L.processSample(xl) : xl;
-            float dr = params.scHpfOn ? scHPF_R.processSample(xr) : xr;
+        return meterMaxAttenDb;
+    }
 
-            const float a = juce::jmax(std::abs(dl), std::abs(dr)); // stereo max-link
-            slidingMax.push(a, params.lookAheadSamplesOS);
-            const float aMax = slidingMax.getMax();
+    // Stereo convenience (prepared with two channels)
+    float processBlockOS(float* upL, float* upR, int N)
+    {
+        jassert(upL != nullptr && upR != nullptr);
+        float* channels[2] { upL, upR };
+        return processBlockOS(channels, 2, N);
+    }
 
-            // 3) required gain to hit ceiling (true-peak @ OS): <= 1
-            float gReq = 1.0f;
-            if (aMax > params.ceilLin)
-                gReq = params.ceilLin / (aMax + 1.0e-12f);
+private:
+    using FVO = juce::FloatVectorOperations;
 
-            const float gReqDb = linToDb(gReq); // <= 0 dB (negative)
+    // Gain-computer state of one link group
+    struct Envelope
+    {
+        float gainDb = 0.0f; // <= 0 dB; negative means attenuation
+        float fastDb = 0.0f; // auto-release fast envelope (positive dB)
+        float slowDb = 0.0f; // auto-release slow envelope (positive dB)
+    };
+
+    float* x(int c) noexcept   { return stageX[(size_t)c].data(); }
+    float* det(int g) noexcept { return stageDet[(size_t)g].data(); }
+
+    // One stage of at most kStageBlock samples: pre-gain -> detector -> sliding max ->
+    // gain computer -> delay & apply -> safety. Channel data is structure-of-arrays (one row of
+    // kStageBlock per channel, one detector/gain row per link group), so the cross-channel max
+    // and the gain multiply are vector ops over each row. Only the detector filter, the sliding
+    // max and the attack/release recursion are sequential, and those run once per group.
+    float processStage(float* const* up, int n) noexcept
+    {
+        const int C = numChannels;
 
-            // 4) Attack + Release
-            if (!params.autoReleaseOn)
+        // 1) pre-gain at OS rate
+        const float preGainCentre = std::sqrt(params.preGainL * params.preGainR);
+        for (int c = 0; c < C; ++c)
+        {
+            const auto side = channelSide[(size_t)c];
+            const float gain = side == ChannelSide::Left ? params.preGainL
+                             : side == ChannelSide::Right ? params.preGainR : preGainCentre;
+            FVO::multiply(x(c), up[c], gain, n);
+        }
+
+        // 2) sidechain detection (optional HPF) of |x| (or of the 4x interpolated peak when
+        //    running at host rate in true-peak mode), max-linked into the channel's group row.
+        //    Channels go through the filter in pairs; an odd last channel is paired with itself.
+        std::uint32_t seeded = 0; // groups whose row holds a channel already
+        const auto linkInto = [&](int c, const float* d)
+        {
+            const int g = groupOf[(size_t)c];
+            if ((seeded >> g & 1u) == 0) { std::memcpy(det(g), d, sizeof(float) * (size_t)n); seeded |= 1u << g; }
+            else                         FVO::max(det(g), det(g), d, n);
+        };
+        float* a = stageA.data();
+        float* b = stageB.data();
+        for (int c = 0; c < C; c += 2)
+        {
+            const int c2 = juce::jmin(c + 1, C - 1);
+            const float* dl = x(c);
+            const float* dr = x(c2);
+            if (params.scHpfOn)
+            {
+                scHPF[(size_t)c / 2].process(dl, dr, a, b, n);
+                dl = a; dr = b;
+            }
+            if (params.truePeakDetect)
             {
-                // legacy/manual: instant attack, one-pole release in dB-domain
-                if (gReqDb < currentGainDb)               // need more attenuation (more negative dB)
-                    currentGainDb = gReqDb;               // jump instantly
-                else                                      // release toward target (usually 0 dB)
-                    currentGainDb = currentGainDb * params.releaseAlphaOS + gReqDb * (1.0f - params.releaseAlphaOS);
+                truePeak[(size_t)c].processAbsMax(dl, a, n, stageAcc.data());
+                if (c2 != c) truePeak[(size_t)c2].processAbsMax(dr, b, n, stageAcc.data());
             }
             else
             {
-                // program-dependent auto release using two envelopes in positive-dB domain
-                const float targetAttenDb = -gReqDb;                // positive dB of desired reduction
-                float currentAttenDb = -currentGainDb;              // positive dB currently applied
+                FVO::abs(a, dl, n);
+                if (c2 != c) FVO::abs(b, dr, n);
+            }
+            linkInto(c, a);
+            if (c2 != c) linkInto(c2, b);
+        }
 
-                if (targetAttenDb > currentAttenDb + 1.0e-6f)
-                {
-                    // instant attack: jump to target and reset envelopes
-                    currentGainDb = gReqDb;
-                    grEnvFastDb = targetAttenDb;
-                    grEnvSlowDb = targetAttenDb;
-                }
-                else
-                {
-                    // releasing: converge toward target using fast/slow blend
-                    const float kSlow = juce::jlimit(0.0f, 1.0f, params.releaseAlphaOS);
-                    const float kFast = std::exp(-1.0f / juce::jmax(1.0f, osSampleRate * 0.02f)); // ~20 ms
+        // 3-5) per group: look-ahead window maximum, required gain to hit the ceiling (true-peak
+        //      @ OS) in dB (<= 0), then the attack + release recursion. The log is skipped when
+        //      nothing in the stage exceeds the ceiling. Each row goes from aMax to applied dB.
+        const float ceil = params.truePeakDetect ? params.ceilLin * dbToLin(-kTruePeakUnderReadDb) : params.ceilLin;
+        float meterMaxAttenDb = 0.0f;
+        const int gainDelay = params.fixedDelaySamplesOS > 0
+            ? juce::jmax(0, params.fixedDelaySamplesOS - gainLook.advance(params.lookAheadSamplesOS, params.fixedDelaySamplesOS, n))
+            : 0;
+        for (int g = 0; g < numGroups; ++g)
+        {
+            float* d = det(g);
+            auto& group = groups[(size_t)g];
+            group.slidingMax.process(d, n, params.lookAheadSamplesOS);
 
-                    grEnvFastDb = juce::jmax(targetAttenDb, kFast * grEnvFastDb + (1.0f - kFast) * targetAttenDb);
-                    grEnvSlowDb = juce::jmax(targetAttenDb, kSlow * grEnvSlowDb + (1.0f - kSlow) * targetAttenDb);
+            if (FVO::findMaximum(d, n) > ceil)
+            {
+                for (int i = 0; i < n; ++i)
+                    d[i] = d[i] > ceil ? ceil / (d[i] + 1.0e-12f) : 1.0f;
+                fastmath::gainToDecibels(d, d, n);
+            }
+            else
+            {
+                FVO::clear(d, n);
+            }
 
-                    float alpha = juce::jlimit(0.0f, 1.0f, grEnvSlowDb / 12.0f);
-                    alpha = alpha * alpha * (3.0f - 2.0f * alpha); // smoothstep
+            if (!params.autoReleaseOn) runManualRelease(d, n, group.env);
+            else                       runAutoRelease(d, n, group.env);
 
-                    const float grSmoothDb = alpha * grEnvFastDb + (1.0f - alpha) * grEnvSlowDb;
-                    currentGainDb = -grSmoothDb; // back to negative dB domain
-                }
-            }
+            // Fixed delay: the audio waits fixedDelay, so the gain waits the difference
+            if (params.fixedDelaySamplesOS > 0)
+                group.gainDelay.process(d, d, n, gainDelay);
 
-            const float gLin = dbToLin(currentGainDb);
+            group.attenDb = -FVO::findMinimum(d, n); // positive dB of reduction
+            meterMaxAttenDb = juce::jmax(meterMaxAttenDb, group.attenDb);
+        }
 
-            // 5) delay main (look-ahead), then apply same gain to both channels
-            float yl = delayL.processSample(xl, params.lookAheadSamplesOS) * gLin;
-            float yr = delayR.processSample(xr, params.lookAheadSamplesOS) * gLin;
+        // 6) delay main (look-ahead, or the fixed delay), then apply each group's gain to its channels
+        const int audioDelay = params.fixedDelaySamplesOS > 0 ? juce::jmax(params.fixedDelaySamplesOS, params.lookAheadSamplesOS)
+                                                              : params.lookAheadSamplesOS;
+        const int mainDelay = audioDelay + (params.truePeakDetect ? kTruePeakDetectorLatency : 0);
+        for (int c = 0; c < C; ++c)
+            delays[(size_t)c].process(x(c), up[c], n, mainDelay);
 
-            // 6) optional ultra-gentle soft clip as a safety (still at OS rate)
-            if (params.safetyOn)
+        const bool scoping = scope.fifo != nullptr;
+        if (scoping)
+        {
+            scope.beginStage(n);
+            scope.forEachSegment([&](ScopeColumn& col, int s, int len)
             {
-                constexpr float safetyBelowCeilDb = -0.1f; // 0.1 dB beneath ceiling
-                const float safetyLimit = params.ceilLin * dbToLin(safetyBelowCeilDb);
+                auto gr = FVO::findMinAndMax(det(0) + s, len);
+                for (int g = 1; g < numGroups; ++g)
+                    gr = gr.getUnionWith(FVO::findMinAndMax(det(g) + s, len));
+                col.gainMinDb = gr.getStart();
+                col.gainMaxDb = gr.getEnd();
+                const auto in = rangeOverChannels(up, s, len);
+                col.inMin = in.getStart();
+                col.inMax = in.getEnd();
+            });
+        }
 
-                if (std::abs(yl) > safetyLimit) yl = softClipTanhTo(yl, safetyLimit);
-                if (std::abs(yr) > safetyLimit) yr = softClipTanhTo(yr, safetyLimit);
-            }
+        for (int g = 0; g < numGroups; ++g)
+            if (groups[(size_t)g].attenDb > 0.0f)
+                fastmath::decibelsToGain(det(g), det(g), n);
+        for (int c = 0; c < C; ++c)
+        {
+            const int g = groupOf[(size_t)c];
+            if (groups[(size_t)g].attenDb > 0.0f)
+                FVO::multiply(up[c], det(g), n);
+        }
 
-            // write back to OS buffer
-            upL[i] = yl;
-            upR[i] = yr;
+        // 7) optional ultra-gentle soft clip as a safety (still at OS rate)
+        if (params.safetyOn)
+        {
+            constexpr float safetyBelowCeilDb = -0.1f; // 0.1 dB beneath ceiling
+            const float safetyLimit = params.ceilLin * dbToLin(safetyBelowCeilDb);
 
-            const float attenDb = -currentGainDb; // positive dB of reduction
-            if (attenDb > meterMaxAttenDb) meterMaxAttenDb = attenDb;
+            for (int c = 0; c < C; ++c)
+                applySafetyClip(up[c], n, safetyLimit);
+        }
+
+        if (scoping)
+        {
+            scope.forEachSegment([&](ScopeColumn& col, int s, int len)
+            {
+                const auto out = rangeOverChannels(up, s, len);
+                col.outMin = out.getStart();
+                col.outMax = out.getEnd();
+            });
+            scope.endStage();
         }
 
         return meterMaxAttenDb;
     }
 
-private:
+    juce::Range<float> rangeOverChannels(const float* const* ch, int s, int len) const noexcept
+    {
+        auto r = FVO::findMinAndMax(ch[0] + s, len);
+        for (int c = 1; c < numChannels; ++c)
+            r = r.getUnionWith(FVO::findMinAndMax(ch[c] + s, len));
+        return r;
+    }
+
+    // Group of every channel for the current link mode. Every group starts from the combined
+    // state of the groups before it (deepest reduction, max-linked look-ahead window), so changing
+    // the link never lets an already-detected peak through.
+    void updateGroups() noexcept
+    {
+        std::array<int, kMaxChannels> newGroupOf {};
+        int newCount = 0;
+        for (int c = 0; c < numChannels; ++c)
+        {
+            if (params.link == ChannelLink::Linked)        newGroupOf[(size_t)c] = 0;
+            else if (params.link == ChannelLink::Unlinked) newGroupOf[(size_t)c] = c;
+            else
+            {
+                // compact the configured ids in order of first appearance
+                int g = 0;
+                while (g < c && channelGroup[(size_t)g] != channelGroup[(size_t)c]) ++g;
+                newGroupOf[(size_t)c] = g < c ? newGroupOf[(size_t)g] : newCount;
+            }
+            newCount = juce::jmax(newCount, newGroupOf[(size_t)c] + 1);
+        }
+
+        groupMapValid = true;
+        groupMapLink = params.link;
+        if (newCount == numGroups && newGroupOf == groupOf)
+            return;
+
+        auto& first = groups[0];
+        for (int g = 1; g < numGroups; ++g)
+        {
+            const auto& other = groups[(size_t)g];
+            first.slidingMax.mergeFrom(other.slidingMax);
+            FVO::min(first.gainDelay.buf.data(), first.gainDelay.buf.data(), other.gainDelay.buf.data(), first.gainDelay.capacity());
+            first.env.gainDb = juce::jmin(first.env.gainDb, other.env.gainDb);
+            first.env.fastDb = juce::jmax(first.env.fastDb, other.env.fastDb);
+            first.env.slowDb = juce::jmax(first.env.slowDb, other.env.slowDb);
+        }
+        for (int g = 1; g < newCount; ++g)
+        {
+            groups[(size_t)g].slidingMax.copyFrom(first.slidingMax);
+            groups[(size_t)g].gainDelay.copyFrom(first.gainDelay);
+            groups[(size_t)g].env = first.env;
+        }
+
+        groupOf = newGroupOf;
+        numGroups = newCount;
+    }
+
+    // legacy/manual: instant attack, one-pole release in dB-domain
+    void runManualRelease(float* g, int n, Envelope& env) noexcept
+    {
+        const float a = params.releaseAlphaOS;
+        float cur = env.gainDb;
+        for (int i = 0; i < n; ++i)
+        {
+            const float gReqDb = g[i];
+            if (gReqDb < cur) cur = gReqDb;                 // need more attenuation: jump instantly
+            else              cur = cur * a + gReqDb * (1.0f - a); // release toward target
+            g[i] = cur;
+        }
+        env.gainDb = cur;
+    }
+
+    // program-dependent auto release using two envelopes in positive-dB domain
+    void runAutoRelease(float* g, int n, Envelope& env) noexcept
+    {
+        const float kSlow = juce::jlimit(0.0f, 1.0f, params.releaseAlphaOS);
+        const float kFast = autoReleaseFastAlpha;
+        float currentGainDb = env.gainDb, grEnvFastDb = env.fastDb, grEnvSlowDb = env.slowDb;
+
+        for (int i = 0; i < n; ++i)
+        {
+            const float gReqDb = g[i];
+            const float targetAttenDb = -gReqDb;                // positive dB of desired reduction
+            const float currentAttenDb = -currentGainDb;        // positive dB currently applied
+
+            if (targetAttenDb > currentAttenDb + 1.0e-6f)
+            {
+                // instant attack: jump to target and reset envelopes
+                currentGainDb = gReqDb;
+                grEnvFastDb = targetAttenDb;
+                grEnvSlowDb = targetAttenDb;
+            }
+            else
+            {
+                // releasing: converge toward target using fast/slow blend
+                grEnvFastDb = juce::jmax(targetAttenDb, kFast * grEnvFastDb + (1.0f - kFast) * targetAttenDb);
+                grEnvSlowDb = juce::jmax(targetAttenDb, kSlow * grEnvSlowDb + (1.0f - kSlow) * targetAttenDb);
+
+                float alpha = juce::jlimit(0.0f, 1.0f, grEnvSlowDb / 12.0f);
+                alpha = alpha * alpha * (3.0f - 2.0f * alpha); // smoothstep
+
+                const float grSmoothDb = alpha * grEnvFastDb + (1.0f - alpha) * grEnvSlowDb;
+                currentGainDb = -grSmoothDb; // back to negative dB domain
+            }
+
+            g[i] = currentGainDb;
+        }
+
+        env.gainDb = currentGainDb;
+        env.fastDb = grEnvFastDb;
+        env.slowDb = grEnvSlowDb;
+    }
+
+    static void applySafetyClip(float* y, int n, float safetyLimit) noexcept
+    {
+        const auto range = FVO::findMinAndMax(y, n);
+        if (juce::jmax(-range.getStart(), range.getEnd()) <= safetyLimit)
+            return;
+
+        for (int i = 0; i < n; ++i)
+            if (std::abs(y[i]) > safetyLimit) y[i] = softClipTanhTo(y[i], safetyLimit);
+    }
+
     static inline float dbToLin(float dB) noexcept { return juce::Decibels::decibelsToGain(dB); }
-    static inline float linToDb(float g)  noexcept { return juce::Decibels::gainToDecibels(juce::jmax(g, 1.0e-12f)); }
 
     static inline float softClipTanhTo(float x, float limit, float k = 2.0f) noexcept
     {
@@ -157,10 +493,42 @@ private:
     void updateSidechainFilter()
     {
         scHPFCoefs = juce::dsp::IIR::Coefficients<float>::makeHighPass(osSampleRate, 30.0);
-        scHPF_L.coefficients = scHPFCoefs;
-        scHPF_R.coefficients = scHPFCoefs;
+        for (auto& f : scHPF)
+        {
+            f.setCoefficients(*scHPFCoefs);
+            f.reset();
+        }
     }
 
+    // Sidechain biquad for both channels in one loop: the two recursions are independent, so
+    // interleaving them hides each one's latency. Same TDF-II arithmetic as juce::dsp::IIR::Filter.
+    struct StereoBiquad
+    {
+        void setCoefficients(const juce::dsp::IIR::Coefficients<float>& c) noexcept
+        {
+            jassert(c.getFilterOrder() == 2);
+            const float* r = c.getRawCoefficients();
+            b0 = r[0]; b1 = r[1]; b2 = r[2]; a1 = r[3]; a2 = r[4];
+        }
+        void reset() noexcept { s1L = s2L = s1R = s2R = 0.0f; }
+        inline void process(const float* inL, const float* inR, float* outL, float* outR, int n) noexcept
+        {
+            float l1 = s1L, l2 = s2L, r1 = s1R, r2 = s2R;
+            for (int i = 0; i < n; ++i)
+            {
+                const float xl = inL[i], xr = inR[i];
+                const float yl = (b0 * xl) + l1;
+                const float yr = (b0 * xr) + r1;
+                l1 = (b1 * xl) - (a1 * yl) + l2;  l2 = (b2 * xl) - (a2 * yl);
+                r1 = (b1 * xr) - (a1 * yr) + r2;  r2 = (b2 * xr) - (a2 * yr);
+                outL[i] = yl; outR[i] = yr;
+            }
+            s1L = l1; s2L = l2; s1R = r1; s2R = r2;
+        }
+        float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+        float s1L = 0.0f, s2L = 0.0f, s1R = 0.0f, s2R = 0.0f;
+    };
+
     struct LookaheadDelay
     {
         void reset(int capacitySamples)
@@ -168,63 +536,214 @@ private:
             buf.assign((size_t)juce::jmax(capacitySamples, 1), 0.0f);
             w = 0;
         }
-        inline float processSample(float x, int delaySamples) noexcept
+        void clear() noexcept { std::fill(buf.begin(), buf.end(), 0.0f); w = 0; }
+        // Block form: write n input samples, then read n samples delaySamples behind them.
+        // Equivalent to n per-sample read-then-write steps as long as delay + n <= capacity.
+        inline void process(const float* in, float* out, int n, int delaySamples) noexcept
         {
             const int cap = (int)buf.size();
+            jassert(delaySamples + n <= cap);
+
+            const int wFirst = juce::jmin(n, cap - w);
+            std::memcpy(buf.data() + w, in, sizeof(float) * (size_t)wFirst);
+            std::memcpy(buf.data(), in + wFirst, sizeof(float) * (size_t)(n - wFirst));
+
             int r = w - delaySamples;
             if (r < 0) r += cap;
-            const float y = buf[(size_t)r];
-            buf[(size_t)w] = x;
-            if (++w == cap) w = 0;
-            return y;
+            const int rFirst = juce::jmin(n, cap - r);
+            std::memcpy(out, buf.data() + r, sizeof(float) * (size_t)rFirst);
+            std::memcpy(out + rFirst, buf.data(), sizeof(float) * (size_t)(n - rFirst));
+
+            w += n;
+            if (w >= cap) w -= cap;
         }
         inline int capacity() const noexcept { return (int)buf.size(); }
+        // Same capacity required; no allocation
+        void copyFrom(const LookaheadDelay& o) noexcept
+        {
+            jassert(o.buf.size() == buf.size());
+            std::copy(o.buf.begin(), o.buf.end(), buf.begin());
+            w = o.w;
+        }
         std::vector<float> buf; int w = 0;
     };
 
-    struct SlidingMax
+    // Look-ahead the gain delay is read for in the fixed-delay mode. A delayed gain only covers
+    // the window it was computed with: a shorter look-ahead is taken at once, a longer one only
+    // after the gains computed with shorter windows have left the line.
+    struct GainLook
     {
-        void reset(int capacitySamples)
+        int current = 1, last = 1, target = 1;
+        int hold = 0; // samples until target may be taken
+
+        int advance(int look, int fixedDelay, int n) noexcept
         {
-            vals.assign((size_t)juce::jmax(capacitySamples + 8, 32), 0.0f);
-            idxs.assign(vals.size(), 0);
-            head = tail = 0;
-            currentIdx = 0;
-            capacity = (int)vals.size();
+            if (look > last) { target = look; hold = fixedDelay; }
+            else               target = juce::jmin(target, look);
+            last = look;
+
+            if (look <= current) { current = target = look; hold = 0; }
+            else if (hold <= 0)  current = target;
+            hold -= n;
+            return current;
         }
-        inline void push(float v, int windowSamples) noexcept
+    };
+
+    struct Group
+    {
+        SlidingMax slidingMax;
+        LookaheadDelay gainDelay; // gain in dB, only used with a fixed delay
+        Envelope env;
+        float attenDb = 0.0f; // deepest reduction of the current stage
+    };
+
+    // Host-rate true-peak estimator: 8-phase Kaiser windowed sinc (32 taps per phase, beta 6),
+    // phase p at input sample i centred on x[i - kTruePeakDetectorLatency] + p/8. Emits, per
+    // input sample, max(|x|, |7 interpolated phases|) delayed by kTruePeakDetectorLatency. The
+    // BS.1770 4x filter under-reads by up to 1.6 dB near 20 kHz at 44.1 kHz; this one stays
+    // within kTruePeakUnderReadDb.
+    struct TruePeakInterpolator
+    {
+        static constexpr int kTaps = 2 * kTruePeakDetectorLatency, kPhases = 8;
+        using Coefficients = std::array<std::array<float, kTaps>, kPhases>;
+
+        // Phase 0 is the plain delayed sample; every phase is normalised to unit DC gain.
+        static const Coefficients& coefficients() noexcept
         {
-            while (head != tail)
+            static const Coefficients table = []
+            {
+                auto bessel0 = [](double x)
+                {
+                    double sum = 1.0, term = 1.0;
+                    for (int k = 1; k < 32; ++k) { term *= (x / (2 * k)) * (x / (2 * k)); sum += term; }
+                    return sum;
+                };
+                constexpr double beta = 6.0, halfWidth = kTruePeakDetectorLatency + 0.5;
+                Coefficients c {};
+                for (int p = 0; p < kPhases; ++p)
+                {
+                    double w[kTaps], sum = 0.0;
+                    for (int k = 0; k < kTaps; ++k)
+                    {
+                        const double tau = kTruePeakDetectorLatency - k - (double)p / kPhases;
+                        const double r = tau / halfWidth;
+                        const double sinc = tau == 0.0 ? 1.0 : std::sin(juce::MathConstants<double>::pi * tau)
+                                                                  / (juce::MathConstants<double>::pi * tau);
+                        w[k] = sinc * bessel0(beta * std::sqrt(juce::jmax(0.0, 1.0 - r * r))) / bessel0(beta);
+                        sum += w[k];
+                    }
+                    for (int k = 0; k < kTaps; ++k)
+                        c[(size_t)p][(size_t)k] = (float)(w[k] / sum);
+                }
+                return c;
+            }();
+            return table;
+        }
+
+        void reset() noexcept { hist.fill(0.0f); }
+
+        // acc: caller scratch of at least n floats
+        inline void processAbsMax(const float* in, float* outAbsMax, int n, float* acc) noexcept
+        {
+            const auto& coeffs = coefficients();
+
+            // hist = [last kTaps-1 inputs | this stage's n inputs], so x[i - k] = h[i + kTaps - 1 - k]
+            float* h = hist.data();
+            std::memcpy(h + kTaps - 1, in, sizeof(float) * (size_t)n);
+
+            // exact sample peak (phase 0)
+            FVO::abs(outAbsMax, h + kTaps - 1 - kTruePeakDetectorLatency, n);
+
+            for (int p = 1; p < kPhases; ++p)
             {
-                const int last = (tail + capacity - 1) % capacity;
-                if (v <= vals[(size_t)last]) break;
-                tail = last;
+                FVO::multiply(acc, h + kTaps - 1, coeffs[(size_t)p][0], n);
+                for (int k = 1; k < kTaps; ++k)
+                    FVO::addWithMultiply(acc, h + kTaps - 1 - k, coeffs[(size_t)p][(size_t)k], n);
+                FVO::abs(acc, acc, n);
+                FVO::max(outAbsMax, outAbsMax, acc, n);
             }
-            vals[(size_t)tail] = v;
-            idxs[(size_t)tail] = currentIdx;
-            tail = (tail + 1) % capacity;
-            const int lowerBound = currentIdx - windowSamples;
-            while (head != tail && idxs[(size_t)head] <= lowerBound)
-                head = (head + 1) % capacity;
-            ++currentIdx;
+
+            std::memmove(h, h + n, sizeof(float) * (size_t)(kTaps - 1));
+        }
+
+        std::array<float, kTaps - 1 + kStageBlock> hist {};
+    };
+
+    // Splits each stage at column boundaries; segment stats are merged into the open column and
+    // every column that fills up is pushed (dropped if the reader is a full FIFO behind).
+    struct ScopeTap
+    {
+        static constexpr int kMaxSegments = kStageBlock / kMinScopeColumnSamples + 2;
+
+        void beginStage(int n) noexcept
+        {
+            numSegments = 0;
+            bounds[0] = 0;
+            for (int s = 0, room = columnLength - filled; s < n; room = columnLength)
+            {
+                s += juce::jmin(room, n - s);
+                segments[(size_t)numSegments] = {};
+                bounds[(size_t)++numSegments] = s;
+            }
+        }
+
+        template <typename Fn>
+        void forEachSegment(Fn&& fn) noexcept
+        {
+            for (int k = 0; k < numSegments; ++k)
+                fn(segments[(size_t)k], bounds[(size_t)k], bounds[(size_t)k + 1] - bounds[(size_t)k]);
         }
-        inline float getMax() const noexcept
+
+        void endStage() noexcept
         {
-            return (head != tail) ? vals[(size_t)head] : 0.0f;
+            for (int k = 0; k < numSegments; ++k)
+            {
+                open.merge(segments[(size_t)k]);
+                filled += bounds[(size_t)k + 1] - bounds[(size_t)k];
+                if (filled == columnLength)
+                {
+                    fifo->push(open);
+                    open = {};
+                    filled = 0;
+                }
+            }
         }
-        std::vector<float> vals; std::vector<int> idxs;
-        int head = 0, tail = 0, capacity = 0, currentIdx = 0;
+
+        ScopeFifo* fifo = nullptr;
+        int columnLength = kMinScopeColumnSamples;
+        int filled = 0;             // samples already in open
+        ScopeColumn open;
+        std::array<ScopeColumn, kMaxSegments> segments {};
+        std::array<int, kMaxSegments + 1> bounds {};
+        int numSegments = 0;
     };
 
     float osSampleRate = 44100.0f;
     LimiterParams params{};
-    float currentGainDb = 0.0f;
-    float grEnvFastDb = 0.0f; // auto-release fast envelope (positive dB)
-    float grEnvSlowDb = 0.0f; // auto-release slow envelope (positive dB)
-    LookaheadDelay delayL, delayR;
-    SlidingMax slidingMax;
-    juce::dsp::IIR::Filter<float> scHPF_L, scHPF_R;
+    float autoReleaseFastAlpha = 0.0f; // ~20 ms one-pole at OS rate (set in prepare)
+    int numChannels = 2;
+
+    // Channel layout and the link groups derived from it (rebuilt when either changes)
+    std::array<ChannelSide, kMaxChannels> channelSide {};
+    std::array<int, kMaxChannels> channelGroup {};
+    std::array<int, kMaxChannels> groupOf {};
+    int numGroups = 1;
+    ChannelLink groupMapLink = ChannelLink::Linked;
+    bool groupMapValid = false;
+
+    std::array<LookaheadDelay, kMaxChannels> delays;
+    std::array<TruePeakInterpolator, kMaxChannels> truePeak;
+    std::array<StereoBiquad, kMaxChannels / 2> scHPF;
+    std::array<Group, kMaxChannels> groups;
+    GainLook gainLook;
+    ScopeTap scope;
     juce::dsp::IIR::Coefficients<float>::Ptr scHPFCoefs;
+
+    // Per-stage scratch (fixed size, no allocation in processBlockOS): one row per channel and
+    // per group
+    using StageRow = std::array<float, kStageBlock>;
+    alignas(16) std::array<StageRow, kMaxChannels> stageX {}, stageDet {};
+    alignas(16) StageRow stageA {}, stageB {}, stageAcc {};
 };
 
 } // namespace hgl
@@ -0,0 +1,145 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace hgl {
+
+// Trailing-window maximum, van Herk / Gil-Werman: the stream is cut into segments of W samples,
+// so every window [i - W + 1, i] spans the tail of one segment and the head of the next.
+//   out[i] = max(suffixMax[i - W + 1], prefixMax[i])
+// The prefix max is a running max over the current segment; the suffix maxima of a segment are
+// written once, backwards, when it completes. That is three max operations per sample whatever
+// the window, no data-dependent pops, and the final combine is a plain vector max.
+//
+// History and suffix rings are a power of two long and indexed with a mask. A window change
+// realigns the segments at the current sample and rebuilds one segment of suffix maxima from
+// history: O(W) once, no reallocation.
+class SlidingMax
+{
+public:
+    // maxWindowSamples: largest window ever requested; maxBlock: largest n passed to process()
+    void reset(int maxWindowSamples, int maxBlock)
+    {
+        const int need = juce::jmax(maxWindowSamples, 1) + juce::jmax(maxBlock, 1) + 1;
+        size = (std::uint32_t)juce::nextPowerOfTwo(juce::jmax(need, 32));
+        mask = size - 1;
+        maxWindow = juce::jmax(maxWindowSamples, 1);
+        hist.assign(size, 0.0f);
+        suffix.assign(size, 0.0f);
+        clear();
+    }
+
+    // Forget the signal (history reads as silence) without reallocating.
+    void clear() noexcept
+    {
+        std::fill(hist.begin(), hist.end(), 0.0f);
+        std::fill(suffix.begin(), suffix.end(), 0.0f);
+        pos = 0;
+        window = 0; // forces realignment on the next block
+        segFill = 0;
+        prefix = 0.0f;
+    }
+
+    // Take the elementwise max of another instance's state, as if both streams had been max-linked
+    // all along. Both must have been reset() with the same sizes and fed in lockstep.
+    void mergeFrom(const SlidingMax& o) noexcept
+    {
+        jassert(o.size == size && o.pos == pos && o.window == window && o.segFill == segFill);
+        juce::FloatVectorOperations::max(hist.data(), hist.data(), o.hist.data(), (int)size);
+        juce::FloatVectorOperations::max(suffix.data(), suffix.data(), o.suffix.data(), (int)size);
+        prefix = juce::jmax(prefix, o.prefix);
+    }
+
+    // Become a copy of another instance reset() with the same sizes, without reallocating.
+    void copyFrom(const SlidingMax& o) noexcept
+    {
+        jassert(o.size == size);
+        std::copy(o.hist.begin(), o.hist.end(), hist.begin());
+        std::copy(o.suffix.begin(), o.suffix.end(), suffix.begin());
+        pos = o.pos;
+        window = o.window;
+        segFill = o.segFill;
+        prefix = o.prefix;
+    }
+
+    // Replace each sample with the maximum over the trailing window of windowSamples ending at it.
+    // Samples before the first call (or clear()) read as 0.
+    inline void process(float* inOut, int n, int windowSamples) noexcept
+    {
+        jassert(n + maxWindow < (int)size);
+        const int W = juce::jlimit(1, maxWindow, windowSamples);
+        if (W != window)
+            realign(W);
+
+        // 1) append the block to history (at most two contiguous runs)
+        const std::uint32_t w0 = pos & mask;
+        const int firstRun = juce::jmin(n, (int)(size - w0));
+        std::memcpy(hist.data() + w0, inOut, sizeof(float) * (size_t)firstRun);
+        std::memcpy(hist.data(), inOut + firstRun, sizeof(float) * (size_t)(n - firstRun));
+
+        // 2) running prefix max per segment, written in place; close segments as they fill
+        for (int i = 0; i < n;)
+        {
+            const int run = juce::jmin(n - i, W - segFill);
+            float m = (segFill == 0) ? std::numeric_limits<float>::lowest() : prefix;
+            for (int k = i; k < i + run; ++k)
+            {
+                m = juce::jmax(m, inOut[k]);
+                inOut[k] = m;
+            }
+            prefix = m;
+            segFill += run;
+            i += run;
+            if (segFill == W)
+            {
+                buildSuffix(pos + (std::uint32_t)i - (std::uint32_t)W, W);
+                segFill = 0;
+            }
+        }
+
+        // 3) combine with the suffix max at the window start (at most two contiguous runs)
+        const std::uint32_t s0 = (pos + 1u - (std::uint32_t)W) & mask;
+        const int sFirst = juce::jmin(n, (int)(size - s0));
+        juce::FloatVectorOperations::max(inOut, inOut, suffix.data() + s0, sFirst);
+        juce::FloatVectorOperations::max(inOut + sFirst, inOut + sFirst, suffix.data(), n - sFirst);
+
+        pos += (std::uint32_t)n;
+    }
+
+private:
+    // Suffix maxima of the W samples starting at absolute position start.
+    inline void buildSuffix(std::uint32_t start, int W) noexcept
+    {
+        float m = std::numeric_limits<float>::lowest();
+        for (int k = W - 1; k >= 0; --k)
+        {
+            const std::uint32_t j = (start + (std::uint32_t)k) & mask;
+            m = juce::jmax(m, hist[j]);
+            suffix[j] = m;
+        }
+    }
+
+    // New window: the next sample starts a segment, and the W samples before it form a complete
+    // previous segment whose suffix maxima are rebuilt from history.
+    void realign(int W) noexcept
+    {
+        window = W;
+        segFill = 0;
+        prefix = 0.0f;
+        buildSuffix(pos - (std::uint32_t)W, W);
+    }
+
+    std::vector<float> hist, suffix;
+    std::uint32_t size = 0, mask = 0;
+    std::uint32_t pos = 0;      // absolute index of the next sample (wraps with the mask)
+    int maxWindow = 1;
+    int window = 0;             // current W (0 = not yet aligned)
+    int segFill = 0;            // samples of the current segment seen so far
+    float prefix = 0.0f;        // running max of the current segment
+};
+
+} // namespace hgl
@@ -34,12 +34,23 @@ public:
         dT1.setButtonText("T1"); dT2.setButtonText("T2");
 
         // Shaping
-        for (auto* b : { &sNone, &sArc }) { addAndMakeVisible(*b); b->setLookAndFeel(&squareLNF); }
-        sNone.setButtonText("—"); sArc.setButtonText("◠");
+        for (auto* b : { &sNone, &sArc, &sE5, &sF9 }) { addAndMakeVisible(*b); b->setLookAndFeel(&squareLNF); }
+        sNone.setButtonText("—"); sArc.setButtonText("◠"); sE5.setButtonText("E5"); sF9.setButtonText("F9");
 
         // Domain
-        for (auto* b : { &domDigital, &domAnalog, &domTruePeak }) { addAndMakeVisible(*b); b->setLookAndFeel(&squareLNF); }
+        for (auto* b : { &domDigital, &domAnalog, &domTruePeak, &domFastTP }) { addAndMakeVisible(*b); b->setLookAndFeel(&squareLNF); }
         domDigital.setButtonText("Digital"); domAnalog.setButtonText("Analog"); domTruePeak.setButtonText("TruePeak");
+        domFastTP.setButtonText("Fast TP");
+
+        // Oversampling of the TruePeak/Analog domains (items must exist before the attachments)
+        for (auto [box, id] : { std::pair { &osRate, "osRate" }, std::pair { &osFilter, "osFilter" } })
+        {
+            if (auto* choice = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter(id)))
+                box->addItemList(choice->choices, 1);
+            addAndMakeVisible(*box);
+        }
+        osRate.setTooltip("Oversampling rate of the TruePeak and Analog domains");
+        osFilter.setTooltip("Linear phase, or a low-latency IIR for tracking");
 
         // Attachments
         attQ24 = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(apvts, "q24", q24);
@@ -53,10 +64,16 @@ public:
 
         attSNone = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(apvts, "sNone", sNone);
         attSArc  = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(apvts, "sArc", sArc);
+        attSE5   = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(apvts, "sE5", sE5);
+        attSF9   = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(apvts, "sF9", sF9);
 
         attDomDig  = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(apvts, "domDigital", domDigital);
         attDomAna  = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(apvts, "domAnalog", domAnalog);
         attDomTP   = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(apvts, "domTruePeak", domTruePeak);
+        attDomFast = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(apvts, "domFastTP", domFastTP);
+
+        attOsRate   = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(apvts, "osRate", osRate);
+        attOsFilter = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(apvts, "osFilter", osFilter);
 
         // Mutual exclusivity (per group)
         auto exclusive = [](juce::ToggleButton& self, std::initializer_list<juce::ToggleButton*> others)
@@ -80,12 +97,15 @@ public:
         exclusive(dT1, { &dT2 });
         exclusive(dT2, { &dT1 });
 
-        exclusive(sNone, { &sArc });
-        exclusive(sArc,  { &sNone });
+        exclusive(sNone, { &sArc, &sE5, &sF9 });
+        exclusive(sArc,  { &sNone, &sE5, &sF9 });
+        exclusive(sE5,   { &sNone, &sArc, &sF9 });
+        exclusive(sF9,   { &sNone, &sArc, &sE5 });
 
-        exclusive(domDigital, { &domAnalog, &domTruePeak });
-        exclusive(domAnalog, { &domDigital, &domTruePeak });
-        exclusive(domTruePeak, { &domDigital, &domAnalog });
+        exclusive(domDigital, { &domAnalog, &domTruePeak, &domFastTP });
+        exclusive(domAnalog, { &domDigital, &domTruePeak, &domFastTP });
+        exclusive(domTruePeak, { &domDigital, &domAnalog, &domFastTP });
+        exclusive(domFastTP, { &domDigital, &domAnalog, &domTruePeak });
     }
 
     void paint(juce::Graphics& g) override
@@ -136,8 +156,8 @@ public:
             inner.removeFromTop(6);
             // Layout buttons centered in a row
             int totalBtn = (int)btns.size();
-            int bw = 60;
             int gapB = 8;
+            int bw = juce::jmin(60, (inner.getWidth() - (totalBtn - 1) * gapB) / juce::jmax(1, totalBtn));
             int rowW = totalBtn * bw + (totalBtn - 1) * gapB;
             auto row = inner.withWidth(rowW).withX(inner.getX() + (inner.getWidth() - rowW) / 2)
                              .removeFromTop(28);
@@ -179,8 +199,14 @@ public:
 
         layoutQuantize(qCard = q);
         layoutGroup(dCard = d, dLabel, { &dT1, &dT2 });
-        layoutGroup(sCard = s, sLabel, { &sNone, &sArc });
-        layoutGroup(mCard = m, domLabel, { &domDigital, &domAnalog, &domTruePeak });
+        layoutGroup(sCard = s, sLabel, { &sNone, &sArc, &sE5, &sF9 });
+        layoutGroup(mCard = m, domLabel, { &domDigital, &domAnalog, &domTruePeak, &domFastTP });
+
+        // Oversampling selectors under the domain buttons
+        auto osRow = m.reduced(12).withTrimmedTop(24 + 6 + 28 + 10).removeFromTop(24);
+        osRate.setBounds(osRow.removeFromLeft(osRow.getWidth() / 2 - 4));
+        osRow.removeFromLeft(8);
+        osFilter.setBounds(osRow);
     }
 
 private:
@@ -193,13 +219,15 @@ private:
     juce::Label qLabel, dLabel, sLabel, domLabel;
     juce::ToggleButton q24, q20, q16, q12, q8, qNone;
     juce::ToggleButton dT1, dT2;
-    juce::ToggleButton sNone, sArc;
-    juce::ToggleButton domDigital, domAnalog, domTruePeak;
+    juce::ToggleButton sNone, sArc, sE5, sF9;
+    juce::ToggleButton domDigital, domAnalog, domTruePeak, domFastTP;
+    juce::ComboBox osRate, osFilter;
 
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> attQ24, attQ20, attQ16, attQ12, attQ8;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> attDT1, attDT2;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> attSNone, attSArc;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> attDomDig, attDomAna, attDomTP;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> attSNone, attSArc, attSE5, attSF9;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> attDomDig, attDomAna, attDomTP, attDomFast;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> attOsRate, attOsFilter;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AdvancedPanel)
 };
@@ -37,6 +37,10 @@ inline constexpr int kMeterHeightPx          = 320; // fits 760x460 content heig
 // Output column
 inline constexpr int kColWidthOutputPx       = 100;
 
+// Loudness strip (bottom of the main card) and the scrolling scope above it
+inline constexpr int kLoudnessRowHeightPx    = 48;
+inline constexpr int kScopeRowHeightPx       = 96;
+
 // Footer / advanced controls
 inline constexpr int kFooterHeightPx         = 200;
 
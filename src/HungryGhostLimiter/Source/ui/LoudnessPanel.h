@@ -0,0 +1,81 @@
+#pragma once
+#include <juce_gui_extra/juce_gui_extra.h>
+#include <Styling/Theme.h>
+#include <Foundation/Typography.h>
+#include <audio/LoudnessMeter.h>
+#include "Layout.h"
+
+// Read-only EBU R128 strip: momentary, short-term, integrated, loudness range and max true peak
+// of the output, plus a button that starts a new measurement. Values arrive already metered
+// (see HungryGhostLimiterAudioProcessor::getLoudness), so no smoothing is applied here.
+class LoudnessPanel : public juce::Component {
+public:
+    LoudnessPanel()
+    {
+        static constexpr const char* names[kNumFields] = { "M", "S", "I", "LRA", "TP" };
+        for (int i = 0; i < kNumFields; ++i)
+        {
+            ui::foundation::Typography::apply(captions[i], ui::foundation::Typography::Style::Caption,
+                                              Style::theme().textMuted, juce::Justification::centred);
+            captions[i].setText(names[i], juce::dontSendNotification);
+            captions[i].setInterceptsMouseClicks(false, false);
+            addAndMakeVisible(captions[i]);
+
+            ui::foundation::Typography::apply(values[i], ui::foundation::Typography::Style::Body,
+                                              juce::Colours::white.withAlpha(0.95f), juce::Justification::centred);
+            values[i].setInterceptsMouseClicks(false, false);
+            addAndMakeVisible(values[i]);
+        }
+
+        resetButton.setButtonText("RESET");
+        resetButton.setColour(juce::TextButton::buttonColourId, juce::Colours::transparentBlack);
+        resetButton.setColour(juce::TextButton::textColourOffId, juce::Colours::white.withAlpha(0.6f));
+        resetButton.onClick = [this] { if (onReset) onReset(); };
+        addAndMakeVisible(resetButton);
+
+        setReadings({});
+    }
+
+    std::function<void()> onReset;
+
+    void setReadings(const audio::LoudnessMeter::Readings& r)
+    {
+        auto lufs = [](float v) { return std::isfinite(v) ? juce::String(v, 1) + " LUFS" : juce::String("-inf LUFS"); };
+        const juce::String text[kNumFields] = {
+            lufs(r.momentary), lufs(r.shortTerm), lufs(r.integrated),
+            juce::String(r.range, 1) + " LU",
+            std::isfinite(r.truePeakDb) ? juce::String(r.truePeakDb, 1) + " dBTP" : juce::String("-inf dBTP")
+        };
+        for (int i = 0; i < kNumFields; ++i)
+            values[i].setText(text[i], juce::dontSendNotification);
+
+        // Over-ceiling true peaks (> 0 dBTP) are what delivery checks reject
+        values[kNumFields - 1].setColour(juce::Label::textColourId,
+                                         r.truePeakDb > 0.0f ? juce::Colours::red : juce::Colours::white.withAlpha(0.95f));
+    }
+
+    void resized() override
+    {
+        juce::Grid g; using Track = juce::Grid::TrackInfo;
+        for (int i = 0; i < kNumFields; ++i)
+            g.templateColumns.add(Track(juce::Grid::Fr(1)));
+        g.templateColumns.add(Track(juce::Grid::Px(64)));
+        g.templateRows = { Track(juce::Grid::Fr(1)), Track(juce::Grid::Fr(1)) };
+        g.columnGap = juce::Grid::Px(Layout::kColGapPx);
+
+        for (int i = 0; i < kNumFields; ++i)
+        {
+            g.items.add(juce::GridItem(captions[i]).withArea(1, i + 1));
+            g.items.add(juce::GridItem(values[i]).withArea(2, i + 1));
+        }
+        g.items.add(juce::GridItem(resetButton).withMargin(Layout::kCellMarginPx).withArea(1, kNumFields + 1, 3, kNumFields + 2));
+        g.performLayout(getLocalBounds());
+    }
+
+private:
+    static constexpr int kNumFields = 5;
+    juce::Label captions[kNumFields], values[kNumFields];
+    juce::TextButton resetButton;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoudnessPanel)
+};
@@ -0,0 +1,172 @@
+#include "ScopeView.h"
+#include <cmath>
+
+namespace
+{
+    constexpr double kZoomSteps[] = { 1.0, 2.0, 5.0, 10.0, 20.0, 30.0, 60.0 };
+    constexpr int    kPyramidLevels = 12; // 2^11 columns per block covers 60 s on a narrow view
+}
+
+ScopeView::ScopeView()
+{
+    setOpaque(false);
+}
+
+void ScopeView::setColumnSeconds(double seconds)
+{
+    if (seconds <= 0.0 || seconds == columnSeconds)
+        return;
+
+    columnSeconds = seconds;
+    history.prepare((int)std::ceil(kMaxWindowSeconds / columnSeconds) + 1, kPyramidLevels);
+    redraw();
+}
+
+void ScopeView::setWindowSeconds(double seconds)
+{
+    windowSeconds = juce::jlimit(kMinWindowSeconds, kMaxWindowSeconds, seconds);
+    redraw();
+}
+
+double ScopeView::columnsPerPixel() const noexcept
+{
+    const int w = juce::jmax(1, image.isValid() ? image.getWidth() : getWidth());
+    return columnSeconds > 0.0 ? windowSeconds / (columnSeconds * w) : 1.0;
+}
+
+void ScopeView::pushColumns(const Column* columns, int numColumns)
+{
+    if (numColumns <= 0 || columnSeconds <= 0.0)
+        return;
+
+    for (int i = 0; i < numColumns; ++i)
+        history.push(columns[i]);
+
+    if (!image.isValid())
+        return;
+
+    // Pixels whose columns are all in: scroll the image by that many and draw just those
+    const auto newEnd = (std::int64_t)std::floor((double)history.getNumColumns() / columnsPerPixel());
+    const auto scroll = newEnd - endPixel;
+    if (scroll <= 0)
+        return;
+
+    const int w = image.getWidth();
+    if (scroll >= w)
+    {
+        endPixel = newEnd;
+        renderPixels(endPixel - w, w, 0);
+    }
+    else
+    {
+        image.moveImageSection(0, 0, (int)scroll, 0, w - (int)scroll, image.getHeight());
+        renderPixels(endPixel, (int)scroll, w - (int)scroll);
+        endPixel = newEnd;
+    }
+    repaint();
+}
+
+void ScopeView::redraw()
+{
+    if (!image.isValid())
+        return;
+
+    const int w = image.getWidth();
+    endPixel = (std::int64_t)std::floor((double)history.getNumColumns() / columnsPerPixel());
+    renderPixels(endPixel - w, w, 0);
+    repaint();
+}
+
+void ScopeView::renderPixels(std::int64_t firstPixel, int numPixels, int x)
+{
+    auto& th = Style::theme();
+    const int h = image.getHeight();
+    const float mid = (float)h * 0.5f;
+
+    history.readPixels(firstPixel, columnsPerPixel(), pixelColumns.data(), numPixels);
+
+    juce::Graphics g(image);
+    g.setColour(th.trackBot);
+    g.fillRect(x, 0, numPixels, h);
+
+    const auto ampToY = [mid](float v) { return mid - juce::jlimit(-1.0f, 1.0f, v) * (mid - 1.0f); };
+    const auto grToY = [h](float gainDb) { return juce::jlimit(0.0f, 1.0f, -gainDb / kGrRangeDb) * (float)h; };
+    const auto span = [&g](int px, float y0, float y1)
+    {
+        g.fillRect((float)px, y0, 1.0f, juce::jmax(1.0f, y1 - y0));
+    };
+
+    const auto inColour  = th.textMuted.withAlpha(0.35f);
+    const auto outColour = th.accent1.withAlpha(0.85f);
+    const auto grFill    = th.fillBot.withAlpha(0.25f);
+    const auto grLine    = th.fillTop;
+
+    for (int j = 0; j < numPixels; ++j)
+    {
+        const auto& c = pixelColumns[(size_t)j];
+        if (c.isEmpty())
+            continue; // before the history starts
+
+        const int px = x + j;
+        g.setColour(inColour);
+        span(px, ampToY(c.inMax), ampToY(c.inMin));
+        g.setColour(outColour);
+        span(px, ampToY(c.outMax), ampToY(c.outMin));
+
+        // Reduction hangs from the top edge: a faint fill down to the deepest point, with the
+        // range swept during this pixel on top
+        const float deep = grToY(c.gainMinDb), shallow = grToY(c.gainMaxDb);
+        if (deep > 0.0f)
+        {
+            g.setColour(grFill);
+            span(px, 0.0f, deep);
+            g.setColour(grLine);
+            span(px, shallow, deep);
+        }
+    }
+}
+
+void ScopeView::paint(juce::Graphics& g)
+{
+    auto& th = Style::theme();
+    auto r = getLocalBounds().toFloat();
+
+    if (image.isValid())
+        g.drawImageAt(image, 0, 0);
+
+    g.setColour(juce::Colours::white.withAlpha(0.08f));
+    g.drawHorizontalLine(getHeight() / 2, r.getX(), r.getRight());
+
+    g.setColour(th.textMuted);
+    g.setFont(juce::Font(juce::FontOptions(11.0f)));
+    g.drawText(juce::String((int)windowSeconds) + " s", getLocalBounds().reduced(6, 2), juce::Justification::topRight);
+
+    g.setColour(juce::Colours::white.withAlpha(0.12f));
+    g.drawRoundedRectangle(r.reduced(0.5f), th.borderRadius, th.borderWidth);
+}
+
+void ScopeView::resized()
+{
+    const int w = juce::jmax(1, getWidth()), h = juce::jmax(1, getHeight());
+    image = juce::Image(juce::Image::RGB, w, h, true);
+    pixelColumns.assign((size_t)w, Column {});
+    redraw();
+}
+
+void ScopeView::mouseWheelMove(const juce::MouseEvent&, const juce::MouseWheelDetails& wheel)
+{
+    if (wheel.deltaY == 0.0f)
+        return;
+
+    // Step through the zoom presets: wheel up narrows the window, down widens it
+    int i = 0;
+    while (i + 1 < (int)std::size(kZoomSteps) && kZoomSteps[i] < windowSeconds)
+        ++i;
+    i = juce::jlimit(0, (int)std::size(kZoomSteps) - 1, i + (wheel.deltaY > 0.0f ? -1 : 1));
+    setWindowSeconds(kZoomSteps[i]);
+}
+
+void ScopeView::mouseDoubleClick(const juce::MouseEvent&)
+{
+    setWindowSeconds(kDefaultWindowSeconds);
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <Styling/Theme.h>
+#include <audio/MinMaxPyramid.h>
+#include "../dsp/LimiterDSP.h"
+#include <vector>
+
+// Scrolling input / output / gain-reduction scope fed with the limiter's ScopeColumns.
+// Columns go into a min/max pyramid, so any window from 1 to 60 s is read in O(pixels); the
+// view keeps its own image and, per update, scrolls it and draws only the pixels that completed
+// since the last one. Mouse wheel zooms, double-click returns to the default window.
+class ScopeView : public juce::Component {
+public:
+    using Column = hgl::ScopeColumn;
+
+    static constexpr double kMinWindowSeconds = 1.0;
+    static constexpr double kMaxWindowSeconds = 60.0;
+    static constexpr double kDefaultWindowSeconds = 5.0;
+    static constexpr float  kGrRangeDb = 12.0f; // full height of the reduction trace
+
+    ScopeView();
+
+    // Seconds of audio per pushed column; clears the history when it changes
+    void setColumnSeconds(double seconds);
+    double getColumnSeconds() const noexcept { return columnSeconds; }
+
+    // Appends columns (oldest first) and draws whatever pixels they complete
+    void pushColumns(const Column* columns, int numColumns);
+
+    void setWindowSeconds(double seconds);
+    double getWindowSeconds() const noexcept { return windowSeconds; }
+
+    // Re-renders the whole image from the history, e.g. after a theme change
+    void redraw();
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+    void mouseWheelMove(const juce::MouseEvent&, const juce::MouseWheelDetails& wheel) override;
+    void mouseDoubleClick(const juce::MouseEvent&) override;
+
+private:
+    double columnsPerPixel() const noexcept;
+    void renderPixels(std::int64_t firstPixel, int numPixels, int x);
+
+    audio::MinMaxPyramid<Column> history;
+    std::vector<Column> pixelColumns; // scratch, one per image column
+    juce::Image image;
+
+    double columnSeconds = 0.0;
+    double windowSeconds = kDefaultWindowSeconds;
+    std::int64_t endPixel = 0; // absolute index one past the newest pixel in the image
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ScopeView)
+};
@@ -0,0 +1,72 @@
+#include <juce_core/juce_core.h>
+#include <juce_dsp/juce_dsp.h>
+#include <cmath>
+#include <vector>
+#include "../Source/dsp/Dither.h"
+
+struct DitherTpdfTest : juce::UnitTest {
+    DitherTpdfTest() : juce::UnitTest("Dither: TPDF generator") {}
+    void runTest() override {
+        beginTest("Triangular on (-amp, amp): zero mean, variance amp^2 / 6");
+        hgl::Dither d(7u);
+        const int N = 1 << 18;
+        std::vector<float> v((size_t)N);
+        for (int i = 0; i < N; i += hgl::Dither::kBlock)
+            d.generateTpdf(v.data() + i, hgl::Dither::kBlock, 2.0f);
+
+        double sum = 0.0, sq = 0.0;
+        float lo = 0.0f, hi = 0.0f;
+        for (float x : v) { sum += x; sq += (double)x * x; lo = std::min(lo, x); hi = std::max(hi, x); }
+        const double mean = sum / N, var = sq / N - mean * mean;
+        expect(std::abs(mean) < 0.01, "mean " + juce::String(mean));
+        expectWithinAbsoluteError(var, 4.0 / 6.0, 0.01);
+        expect(lo > -2.0f && hi < 2.0f, "TPDF outside (-amp, amp)");
+    }
+};
+
+struct DitherShapingTest : juce::UnitTest {
+    DitherShapingTest() : juce::UnitTest("Dither: quantize and noise shaping") {}
+    void runTest() override {
+        constexpr int order = 14, N = 1 << order;
+        const float step = std::ldexp(1.0f, 1 - 16);
+
+        // Error power (dB) below 4 kHz and in total, 16-bit quantize of a quiet 1 kHz tone at 44.1k
+        auto measure = [&](hgl::Dither::Shape shape, bool& onGrid) {
+            hgl::Dither d(11u);
+            std::vector<float> x((size_t)N), y((size_t)N);
+            for (int i = 0; i < N; ++i) x[(size_t)i] = 0.01f * std::sin(2.0f * juce::MathConstants<float>::pi * 1000.0f * (float)i / 44100.0f);
+            y = x;
+            for (int i = 0; i < N; i += 512) d.process(y.data() + i, 512, 16, 1.0f, shape);
+
+            onGrid = true;
+            std::vector<float> fft((size_t)(2 * N), 0.0f);
+            for (int i = 0; i < N; ++i) {
+                const float q = y[(size_t)i] / step;
+                onGrid = onGrid && std::abs(q - std::round(q)) < 1.0e-3f;
+                const float hann = 0.5f - 0.5f * std::cos(2.0f * juce::MathConstants<float>::pi * (float)i / (float)N);
+                fft[(size_t)i] = (y[(size_t)i] - x[(size_t)i]) * hann;
+            }
+            juce::dsp::FFT(order).performFrequencyOnlyForwardTransform(fft.data());
+            const int lowBins = (int)(4000.0 / 44100.0 * N);
+            double low = 0.0, all = 0.0;
+            for (int k = 1; k < N / 2; ++k) { const double p = (double)fft[(size_t)k] * fft[(size_t)k]; all += p; if (k < lowBins) low += p; }
+            return std::make_pair(10.0 * std::log10(low), 10.0 * std::log10(all));
+        };
+
+        beginTest("Output lands on the quantizer grid for every shape");
+        bool grid = false;
+        const auto none = measure(hgl::Dither::Shape::None, grid);       expect(grid);
+        const auto first = measure(hgl::Dither::Shape::FirstOrder, grid); expect(grid);
+        const auto e5 = measure(hgl::Dither::Shape::EWeighted5, grid);   expect(grid);
+        const auto f9 = measure(hgl::Dither::Shape::FWeighted9, grid);   expect(grid);
+
+        beginTest("Shaping moves noise out of the low band, higher orders more so");
+        expect(first.first < none.first - 3.0, "first-order low band " + juce::String(first.first - none.first));
+        expect(e5.first < first.first - 6.0, "E5 low band " + juce::String(e5.first - first.first));
+        expect(f9.first < first.first - 6.0, "F9 low band " + juce::String(f9.first - first.first));
+        expect(f9.second > none.second, "shaped total noise should exceed flat TPDF");
+    }
+};
+
+static DitherTpdfTest ditherTpdfTest;
+static DitherShapingTest ditherShapingTest;
@@ -1,27 +1,65 @@
 #include <juce_core/juce_core.h>
 #include <juce_dsp/juce_dsp.h>
 #include "../Source/PluginProcessor.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// Writes a parameter's raw value, which the processor reads at the next block
+void setParam(HungryGhostLimiterAudioProcessor& proc, const char* id, float v)
+{
+    if (auto* p = proc.apvts.getRawParameterValue(id)) *const_cast<std::atomic<float>*>(p) = v;
+}
+
+// Reference true peak: 16x oversampled with a long Kaiser windowed sinc (64 taps per phase),
+// ignoring the filter's start-up and run-out at either end
+float truePeak16x(const std::vector<float>& x)
+{
+    constexpr int kPhases = 16, kHalf = 32;
+    constexpr double beta = 10.0, pi = juce::MathConstants<double>::pi;
+    auto bessel0 = [](double v) {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 40; ++k) { term *= (v / (2 * k)) * (v / (2 * k)); sum += term; }
+        return sum;
+    };
+    std::vector<double> h((size_t)(kPhases * 2 * kHalf));
+    for (int p = 0; p < kPhases; ++p)
+        for (int k = 0; k < 2 * kHalf; ++k) {
+            const double tau = kHalf - k - (double)p / kPhases, r = tau / (kHalf + 0.5);
+            const double sinc = tau == 0.0 ? 1.0 : std::sin(pi * tau) / (pi * tau);
+            h[(size_t)(p * 2 * kHalf + k)] = sinc * bessel0(beta * std::sqrt(std::max(0.0, 1.0 - r * r))) / bessel0(beta);
+        }
+
+    double peak = 0.0;
+    for (size_t i = 2 * kHalf; i < x.size(); ++i)
+        for (int p = 0; p < kPhases; ++p) {
+            double acc = 0.0;
+            for (int k = 0; k < 2 * kHalf; ++k) acc += h[(size_t)(p * 2 * kHalf + k)] * x[i - (size_t)k];
+            peak = std::max(peak, std::abs(acc));
+        }
+    return (float)peak;
+}
+
+} // namespace
 
 struct DomainLatencyTest : juce::UnitTest {
     DomainLatencyTest() : juce::UnitTest("Processor: domain latency behavior") {}
 
     void runTest() override {
-        beginTest("Digital domain reports lower latency than TruePeak for same look-ahead");
+        beginTest("Every domain reports the same latency for the same look-ahead");
         HungryGhostLimiterAudioProcessor proc;
         const double sr = 48000.0;
         const int block = 512;
         proc.prepareToPlay(sr, block);
 
-        auto* look = proc.apvts.getRawParameterValue("lookAheadMs");
-        jassert(look != nullptr);
-        *const_cast<std::atomic<float>*>(look) = 2.0f; // 2 ms
-
-        auto setParam = [&](const char* id, float v){ if (auto* p = proc.apvts.getRawParameterValue(id)) *const_cast<std::atomic<float>*>(p) = v; };
+        setParam(proc, "lookAheadMs", 2.0f); // 2 ms
 
         // TruePeak (default)
-        setParam("domTruePeak", 1.0f);
-        setParam("domDigital", 0.0f);
-        setParam("domAnalog",  0.0f);
+        setParam(proc, "domTruePeak", 1.0f);
+        setParam(proc, "domDigital", 0.0f);
+        setParam(proc, "domAnalog",  0.0f);
         {
             juce::AudioBuffer<float> buf(2, block);
             buf.clear();
@@ -30,9 +68,9 @@ struct DomainLatencyTest : juce::UnitTest {
         const int latTP = proc.getLatencySamples();
 
         // Digital
-        setParam("domTruePeak", 0.0f);
-        setParam("domDigital", 1.0f);
-        setParam("domAnalog",  0.0f);
+        setParam(proc, "domTruePeak", 0.0f);
+        setParam(proc, "domDigital", 1.0f);
+        setParam(proc, "domAnalog",  0.0f);
         {
             juce::AudioBuffer<float> buf(2, block);
             buf.clear();
@@ -40,10 +78,444 @@ struct DomainLatencyTest : juce::UnitTest {
         }
         const int latDig = proc.getLatencySamples();
 
-        expect(latDig <= latTP, "Digital latency should be <= TruePeak latency");
-        expect(latDig >= 0, "Latency should be non-negative");
+        expectEquals(latDig, latTP, "Switching domain must not change the reported latency");
+        expect(latDig >= (int)std::ceil(0.002 * sr), "Latency should cover the look-ahead");
+    }
+};
+
+struct FastTruePeakDomainTest : juce::UnitTest {
+    FastTruePeakDomainTest() : juce::UnitTest("Processor: fast true-peak domain") {}
+
+    void runTest() override {
+        beginTest("Fast TruePeak keeps the shared latency and holds the ceiling");
+        HungryGhostLimiterAudioProcessor proc;
+        const double sr = 44100.0;
+        const int block = 512;
+        proc.prepareToPlay(sr, block);
+
+        setParam(proc, "lookAheadMs", 1.0f);
+        setParam(proc, "q24", 0.0f); // no quantize, so the ceiling check sees the limiter output
+
+        // Tones between 17 and 20 kHz: their inter-sample overs are the hardest for a host-rate
+        // detector (the BS.1770 4x filter under-reads them by more than 1 dB)
+        auto render = [&](int blocks) {
+            std::vector<float> out;
+            for (int b = 0; b < blocks; ++b) {
+                juce::AudioBuffer<float> buf(2, block);
+                for (int ch = 0; ch < 2; ++ch)
+                    for (int i = 0; i < block; ++i) {
+                        const double t = (double)(b * block + i) / sr, w = juce::MathConstants<double>::twoPi;
+                        buf.setSample(ch, i, (float)(0.6 * std::sin(w * 19900.0 * t) + 0.5 * std::sin(w * 19300.0 * t + 1.3 * ch)
+                                                     + 0.4 * std::sin(w * 17100.0 * t + 0.4)));
+                    }
+                juce::MidiBuffer midi; proc.processBlock(buf, midi);
+                if (b > 1) out.insert(out.end(), buf.getReadPointer(0), buf.getReadPointer(0) + block);
+            }
+            return out;
+        };
+
+        setParam(proc, "domTruePeak", 1.0f); setParam(proc, "domFastTP", 0.0f);
+        render(1);
+        const int latTP = proc.getLatencySamples();
+
+        setParam(proc, "domTruePeak", 0.0f); setParam(proc, "domFastTP", 1.0f);
+        const float peak = truePeak16x(render(24));
+        const int latFast = proc.getLatencySamples();
+
+        expectEquals(latFast, latTP);
+        expect(peak <= juce::Decibels::decibelsToGain(-1.0f), "Fast TruePeak output exceeds the ceiling at 16x: "
+                                                               + juce::String(juce::Decibels::gainToDecibels(peak), 2) + " dBTP");
+    }
+};
+
+struct DomainSwitchTest : juce::UnitTest {
+    DomainSwitchTest() : juce::UnitTest("Processor: domain switching") {}
+
+    void runTest() override {
+        beginTest("Switching domains mid-stream stays aligned and click-free");
+        HungryGhostLimiterAudioProcessor proc;
+        const double sr = 48000.0;
+        const int block = 256;
+        proc.prepareToPlay(sr, block);
+
+        setParam(proc, "thresholdL", 0.0f); setParam(proc, "thresholdR", 0.0f); // unity pre-gain: no limiting
+        setParam(proc, "q24", 0.0f);
+        const int lat = proc.getLatencySamples();
+
+        auto input = [](int n) { return 0.5f * std::sin(0.05f * (float)n); };
+        auto select = [&](const char* id) {
+            for (auto* d : { "domTruePeak", "domDigital", "domAnalog", "domFastTP" })
+                setParam(proc, d, juce::String(d) == id ? 1.0f : 0.0f);
+        };
+
+        const char* order[] = { "domTruePeak", "domDigital", "domFastTP", "domAnalog", "domTruePeak" };
+        float maxStep = 0.0f, maxErr = 0.0f, prev = 0.0f;
+        int n0 = 0;
+        for (const char* dom : order)
+        {
+            select(dom);
+            for (int b = 0; b < 24; ++b, n0 += block)
+            {
+                juce::AudioBuffer<float> buf(2, block);
+                for (int ch = 0; ch < 2; ++ch)
+                    for (int i = 0; i < block; ++i)
+                        buf.setSample(ch, i, input(n0 + i));
+                juce::MidiBuffer midi; proc.processBlock(buf, midi);
+                expectEquals(proc.getLatencySamples(), lat);
+
+                for (int i = 0; i < block; ++i)
+                {
+                    const int n = n0 + i;
+                    const float y = buf.getSample(0, i);
+                    if (n > 4 * lat)
+                    {
+                        maxStep = std::max(maxStep, std::abs(y - prev));
+                        maxErr = std::max(maxErr, std::abs(y - input(n - lat)));
+                    }
+                    prev = y;
+                }
+            }
+        }
+
+        // A sine of slope <= 0.025 per sample: any click or misaligned engine shows up as a jump
+        expect(maxStep < 0.03f, "Discontinuity while switching domains: " + juce::String(maxStep));
+        expect(maxErr < 0.01f, "Output not aligned to the reported latency: " + juce::String(maxErr));
+    }
+};
+
+struct ScopeStreamTest : juce::UnitTest {
+    ScopeStreamTest() : juce::UnitTest("Processor: scope column stream") {}
+
+    void runTest() override {
+        beginTest("Columns keep coming at a fixed rate through a domain switch");
+        HungryGhostLimiterAudioProcessor proc;
+        const double sr = 48000.0;
+        const int block = 333;
+        proc.prepareToPlay(sr, block);
+
+        const int columnSamples = (int)std::round(proc.getScopeColumnSeconds() * sr);
+        expectEquals(columnSamples, 32);
+
+        std::vector<HungryGhostLimiterAudioProcessor::ScopeColumn> cols(HungryGhostLimiterAudioProcessor::ScopeFifo::kCapacity);
+        int total = 0, blocks = 0;
+        float loudest = 0.0f;
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            setParam(proc, "domDigital", pass == 1 ? 1.0f : 0.0f); // TruePeak (8x), then Digital (1x)
+            for (int b = 0; b < 100; ++b, ++blocks)
+            {
+                juce::AudioBuffer<float> buf(2, block);
+                for (int ch = 0; ch < 2; ++ch)
+                    for (int i = 0; i < block; ++i)
+                        buf.setSample(ch, i, 0.5f * std::sin(0.01f * (float)(blocks * block + i)));
+                juce::MidiBuffer midi; proc.processBlock(buf, midi);
+
+                const int n = proc.getScopeFifo().pop(cols.data(), (int)cols.size());
+                for (int k = 0; k < n; ++k)
+                    loudest = juce::jmax(loudest, cols[(size_t)k].outMax);
+                total += n;
+            }
+        }
+
+        // A switch hands over between two columns, losing at most the one in progress
+        const int expected = blocks * block / columnSamples;
+        expect(total >= expected - 1 && total <= expected, "got " + juce::String(total) + " columns, expected ~" + juce::String(expected));
+        expect(loudest > 0.1f, "columns carry the signal");
+    }
+};
+
+struct MultichannelLayoutTest : juce::UnitTest {
+    MultichannelLayoutTest() : juce::UnitTest("Processor: multichannel layouts") {}
+
+    void runTest() override {
+        beginTest("Any matching layout up to 16 channels is accepted");
+        {
+            HungryGhostLimiterAudioProcessor proc;
+            auto layoutOf = [](const juce::AudioChannelSet& in, const juce::AudioChannelSet& out)
+            {
+                juce::AudioProcessor::BusesLayout l;
+                l.inputBuses.add(in);
+                l.outputBuses.add(out);
+                return l;
+            };
+            using CS = juce::AudioChannelSet;
+            expect(proc.checkBusesLayoutSupported(layoutOf(CS::mono(), CS::mono())));
+            expect(proc.checkBusesLayoutSupported(layoutOf(CS::create5point1(), CS::create5point1())));
+            expect(proc.checkBusesLayoutSupported(layoutOf(CS::create7point1point4(), CS::create7point1point4())));
+            expect(proc.checkBusesLayoutSupported(layoutOf(CS::discreteChannels(16), CS::discreteChannels(16))));
+            expect(!proc.checkBusesLayoutSupported(layoutOf(CS::discreteChannels(17), CS::discreteChannels(17))));
+            expect(!proc.checkBusesLayoutSupported(layoutOf(CS::stereo(), CS::create5point1())));
+        }
+
+        // 7.1.4 bed of quiet noise with a loud burst in the top front left channel
+        const auto layout = juce::AudioChannelSet::create7point1point4();
+        const int C = layout.size();
+        const int burstCh = layout.getChannelIndexForType(juce::AudioChannelSet::topFrontLeft);
+        const int partnerCh = layout.getChannelIndexForType(juce::AudioChannelSet::topFrontRight);
+        const int leftCh = layout.getChannelIndexForType(juce::AudioChannelSet::left);
+
+        // Peak of the partner and the front left channel over the second half, per link mode
+        auto render = [&](float link)
+        {
+            HungryGhostLimiterAudioProcessor proc;
+            juce::AudioProcessor::BusesLayout l;
+            l.inputBuses.add(layout);
+            l.outputBuses.add(layout);
+            const bool applied = proc.setBusesLayout(l);
+            expect(applied, "7.1.4 should be accepted");
+
+            const int block = 480;
+            proc.prepareToPlay(48000.0, block);
+            setParam(proc, "thresholdL", 0.0f); setParam(proc, "thresholdR", 0.0f);
+            setParam(proc, "q24", 0.0f);
+            setParam(proc, "channelLink", link);
+
+            juce::Random rng(8);
+            float peakPartner = 0.0f, peakLeft = 0.0f, peakBurst = 0.0f;
+            for (int b = 0; b < 40; ++b)
+            {
+                juce::AudioBuffer<float> buf(C, block);
+                for (int ch = 0; ch < C; ++ch)
+                    for (int i = 0; i < block; ++i)
+                        buf.setSample(ch, i, 0.25f * (rng.nextFloat() * 2.0f - 1.0f));
+                if (b >= 20)
+                    for (int i = 0; i < block; ++i)
+                        buf.setSample(burstCh, i, 3.0f * std::sin(0.13f * (float)(b * block + i)));
+                juce::MidiBuffer midi;
+                proc.processBlock(buf, midi);
+                if (b >= 22)
+                {
+                    peakPartner = std::max(peakPartner, buf.getMagnitude(partnerCh, 0, block));
+                    peakLeft = std::max(peakLeft, buf.getMagnitude(leftCh, 0, block));
+                    peakBurst = std::max(peakBurst, buf.getMagnitude(burstCh, 0, block));
+                }
+            }
+            expect(peakBurst <= juce::Decibels::decibelsToGain(-1.0f) * 1.02f, "burst channel over the ceiling");
+            return std::make_pair(peakPartner, peakLeft);
+        };
+
+        beginTest("Linked ducks the whole bed, Groups the burst's pair, Unlinked only the burst");
+        const auto linked = render(0.0f), groups = render(1.0f), unlinked = render(2.0f);
+        expect(linked.second < 0.15f, "linked: front left should follow the height burst");
+        expect(groups.first < 0.15f, "groups: the height partner should follow the burst");
+        expect(groups.second > 0.25f, "groups: front left should not be limited");
+        expect(unlinked.first > 0.25f && unlinked.second > 0.25f, "unlinked: other channels should not be limited");
+    }
+};
+
+struct OversamplingPolicyTest : juce::UnitTest {
+    OversamplingPolicyTest() : juce::UnitTest("Processor: oversampling policy") {}
+
+    using Policy = HungryGhostLimiterAudioProcessor::OversamplingPolicy;
+    using OsFilter = HungryGhostLimiterAudioProcessor::OsFilter;
+
+    // Renders blocks of a 0.9 sine at +6 dB drive; returns the output peak
+    static float render(HungryGhostLimiterAudioProcessor& proc, int blocks, int block)
+    {
+        float peak = 0.0f;
+        for (int b = 0; b < blocks; ++b)
+        {
+            juce::AudioBuffer<float> buf(2, block);
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < block; ++i)
+                    buf.setSample(ch, i, 0.9f * std::sin(0.05f * (float)(b * block + i)));
+            juce::MidiBuffer midi;
+            proc.processBlock(buf, midi);
+            peak = std::max(peak, buf.getMagnitude(0, block));
+        }
+        return peak;
+    }
+
+    void runTest() override {
+        beginTest("Every rate and filter reports the latency its impulse response shows");
+        {
+            const std::pair<float, float> options[] = { { 0, 0 }, { 1, 0 }, { 2, 0 }, { 3, 0 }, { 1, 1 }, { 2, 1 }, { 3, 1 } };
+            for (const auto& [rate, filter] : options)
+            {
+                HungryGhostLimiterAudioProcessor proc;
+                setParam(proc, "osRate", rate);
+                setParam(proc, "osFilter", filter);
+                setParam(proc, "thresholdL", 0.0f); setParam(proc, "thresholdR", 0.0f);
+                setParam(proc, "q24", 0.0f);
+                const int block = 256;
+                proc.prepareToPlay(48000.0, block);
+
+                int peakAt = -1;
+                float peak = 0.0f;
+                for (int b = 0; b < 4; ++b)
+                {
+                    juce::AudioBuffer<float> buf(2, block);
+                    buf.clear();
+                    if (b == 0) { buf.setSample(0, 0, 0.5f); buf.setSample(1, 0, 0.5f); }
+                    juce::MidiBuffer midi;
+                    proc.processBlock(buf, midi);
+                    for (int i = 0; i < block; ++i)
+                        if (std::abs(buf.getSample(0, i)) > peak) { peak = std::abs(buf.getSample(0, i)); peakAt = b * block + i; }
+                }
+                const auto tag = "osRate " + juce::String(rate) + ", osFilter " + juce::String(filter);
+                if (filter == 0.0f) expectEquals(peakAt, proc.getLatencySamples(), tag);
+                else                expect(std::abs(peakAt - proc.getLatencySamples()) <= 1, tag + ": IIR group delay off by more than a sample");
+            }
+        }
+
+        beginTest("A policy change is built off the audio thread and crossfaded in");
+        {
+            HungryGhostLimiterAudioProcessor proc;
+            setParam(proc, "q24", 0.0f);
+            setParam(proc, "thresholdL", -6.0f); setParam(proc, "thresholdR", -6.0f);
+            const int block = 256;
+            proc.prepareToPlay(48000.0, block);
+            expect(proc.getOversamplingPolicy() == Policy { 8, OsFilter::LinearPhase, true }, "Auto is 8x linear phase at 48 kHz");
+            const int latFir8 = proc.getLatencySamples();
+
+            setParam(proc, "osRate", 1.0f);
+            setParam(proc, "osFilter", 1.0f);
+            render(proc, 4, block);
+            expect(proc.getOversamplingPolicy().factor == 8, "nothing changes before the new engines are built");
+
+            proc.updateOversampling(); // what the message-thread timer does
+            const float peak = render(proc, 16, block);
+            expect(proc.getOversamplingPolicy() == Policy { 2, OsFilter::LowLatency, false });
+            expect(proc.getLatencySamples() < latFir8, "the low-latency path should report less latency");
+            expect(peak <= juce::Decibels::decibelsToGain(-1.0f) + 1.0e-3f, "ceiling held through the policy switch");
+
+            proc.updateOversampling(); // frees the retired set
+            expectLessOrEqual(render(proc, 4, block), juce::Decibels::decibelsToGain(-1.0f) + 1.0e-3f);
+        }
+
+        beginTest("Offline renders use max quality while osOfflineMax is on");
+        {
+            HungryGhostLimiterAudioProcessor proc;
+            setParam(proc, "osFilter", 1.0f);
+            proc.setNonRealtime(true);
+            proc.prepareToPlay(48000.0, 512);
+            expect(proc.getOversamplingPolicy() == Policy { 16, OsFilter::LinearPhase, true });
+
+            setParam(proc, "osOfflineMax", 0.0f);
+            render(proc, 1, 512);
+            proc.updateOversampling();
+            render(proc, 8, 512);
+            expect(proc.getOversamplingPolicy() == Policy { 8, OsFilter::LowLatency, false }, "back to the realtime selection");
+        }
+
+        beginTest("Going offline on a prepared instance switches before the first offline block");
+        {
+            HungryGhostLimiterAudioProcessor offline; // prepared offline from the start
+            offline.setNonRealtime(true);
+            offline.prepareToPlay(48000.0, 512);
+
+            HungryGhostLimiterAudioProcessor proc;
+            setParam(proc, "thresholdL", 0.0f); setParam(proc, "thresholdR", 0.0f);
+            setParam(proc, "q24", 0.0f);
+            proc.prepareToPlay(48000.0, 512);
+            render(proc, 4, 512);
+            const int latRealtime = proc.getLatencySamples();
+
+            proc.setNonRealtime(true); // no updateOversampling(), no prepareToPlay()
+            expect(proc.getOversamplingPolicy() == Policy { 16, OsFilter::LinearPhase, true }, "max quality installed at once");
+            expectEquals(proc.getLatencySamples(), offline.getLatencySamples(), "offline latency reported before the bounce");
+
+            // The first offline block already runs the 16x engines: an impulse lands on the report
+            int peakAt = -1;
+            float peak = 0.0f;
+            for (int b = 0; b < 8; ++b)
+            {
+                juce::AudioBuffer<float> buf(2, 512);
+                buf.clear();
+                if (b == 0) { buf.setSample(0, 0, 0.5f); buf.setSample(1, 0, 0.5f); }
+                juce::MidiBuffer midi;
+                proc.processBlock(buf, midi);
+                for (int i = 0; i < 512; ++i)
+                    if (std::abs(buf.getSample(0, i)) > peak) { peak = std::abs(buf.getSample(0, i)); peakAt = b * 512 + i; }
+            }
+            expectEquals(peakAt, proc.getLatencySamples(), "impulse position in the bounce");
+            expect(proc.getOversamplingPolicy().factor == 16, "no switch during the bounce");
+
+            proc.setNonRealtime(false);
+            expect(proc.getOversamplingPolicy() == Policy { 8, OsFilter::LinearPhase, true }, "realtime policy back at once");
+            expectEquals(proc.getLatencySamples(), latRealtime);
+        }
+    }
+};
+
+struct FixedLatencyTest : juce::UnitTest {
+    FixedLatencyTest() : juce::UnitTest("Processor: constant latency") {}
+
+    // Sample index of the output peak for a 0.5 impulse at sample 0
+    static int impulsePeak(HungryGhostLimiterAudioProcessor& proc, int block)
+    {
+        int peakAt = -1;
+        float peak = 0.0f;
+        for (int b = 0; b < 4; ++b)
+        {
+            juce::AudioBuffer<float> buf(2, block);
+            buf.clear();
+            if (b == 0) { buf.setSample(0, 0, 0.5f); buf.setSample(1, 0, 0.5f); }
+            juce::MidiBuffer midi;
+            proc.processBlock(buf, midi);
+            for (int i = 0; i < block; ++i)
+                if (std::abs(buf.getSample(0, i)) > peak) { peak = std::abs(buf.getSample(0, i)); peakAt = b * block + i; }
+        }
+        return peakAt;
+    }
+
+    void runTest() override {
+        constexpr int block = 256;
+
+        beginTest("The impulse lands on the reported latency for any look-ahead");
+        for (float lookMs : { 0.25f, 1.0f, 3.0f })
+        {
+            HungryGhostLimiterAudioProcessor proc;
+            setParam(proc, "fixedLatency", 1.0f);
+            setParam(proc, "lookAheadMs", lookMs);
+            setParam(proc, "thresholdL", 0.0f); setParam(proc, "thresholdR", 0.0f);
+            setParam(proc, "q24", 0.0f);
+            proc.prepareToPlay(48000.0, block);
+            expectEquals(impulsePeak(proc, block), proc.getLatencySamples(), "look-ahead " + juce::String(lookMs) + " ms");
+        }
+
+        beginTest("Sweeping look-ahead keeps the reported latency and the ceiling");
+        for (float fixed : { 0.0f, 1.0f })
+        {
+            HungryGhostLimiterAudioProcessor proc;
+            setParam(proc, "fixedLatency", fixed);
+            setParam(proc, "thresholdL", -6.0f); setParam(proc, "thresholdR", -6.0f);
+            setParam(proc, "q24", 0.0f);
+            proc.prepareToPlay(48000.0, block);
+            const int reported = proc.getLatencySamples();
+
+            bool constant = true;
+            float peak = 0.0f;
+            for (int b = 0; b < 64; ++b)
+            {
+                setParam(proc, "lookAheadMs", 0.25f + 2.75f * (float)((b * 7) % 16) / 15.0f);
+                juce::AudioBuffer<float> buf(2, block);
+                for (int ch = 0; ch < 2; ++ch)
+                    for (int i = 0; i < block; ++i)
+                        buf.setSample(ch, i, 0.9f * std::sin(0.05f * (float)(b * block + i)));
+                juce::MidiBuffer midi;
+                proc.processBlock(buf, midi);
+                constant = constant && proc.getLatencySamples() == reported;
+                if (b >= 4) peak = std::max(peak, buf.getMagnitude(0, block));
+            }
+            if (fixed > 0.0f)
+            {
+                expect(constant, "constant latency mode reported a latency change");
+                expectLessOrEqual(peak, juce::Decibels::decibelsToGain(-1.0f) + 1.0e-3f);
+            }
+            else
+            {
+                expect(!constant, "without the mode the latency should follow look-ahead");
+            }
+        }
     }
 };
 
 static DomainLatencyTest domainLatencyTest;
+static FastTruePeakDomainTest fastTruePeakDomainTest;
+static DomainSwitchTest domainSwitchTest;
+static ScopeStreamTest scopeStreamTest;
+static MultichannelLayoutTest multichannelLayoutTest;
+static OversamplingPolicyTest oversamplingPolicyTest;
+static FixedLatencyTest fixedLatencyTest;
 
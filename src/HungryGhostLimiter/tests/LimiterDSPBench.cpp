@@ -0,0 +1,251 @@
+#include <juce_core/juce_core.h>
+#include <juce_dsp/juce_dsp.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "../Source/dsp/LimiterDSP.h"
+#include "../Source/dsp/SlidingMax.h"
+#include "../Source/dsp/Dither.h"
+#include "LimiterDSPReference.h"
+
+// Headless micro-benchmark: block-staged hgl::LimiterDSP vs the original per-sample loop at the
+// oversampled rates the plugin actually runs (44.1k x 8 and 96k x 4), host block of 512.
+// Second table: whole TruePeak engine (OS up + limiter + OS down) vs Fast TruePeak (host rate,
+// interpolated detector), per host sample. Third table: sliding-window max alone, monotonic deque
+// vs van Herk/Gil-Werman, for 1..5 ms look-ahead windows at 352.8 kHz (44.1k x 8). Fourth table:
+// 16-bit T2 quantize, the former per-sample first-order loop vs hgl::Dither per shape.
+
+namespace
+{
+    struct Config { const char* name; double hostRate; int osFactor; };
+
+    template <typename Limiter>
+    double nsPerOsSample(double osRate, int osBlock, int numBlocks)
+    {
+        Limiter lim;
+        lim.prepare((float)osRate, (int)std::ceil(0.005 * osRate) + 64);
+
+        hgl::LimiterParams p{};
+        p.preGainL = p.preGainR = juce::Decibels::decibelsToGain(10.0f);
+        p.ceilLin = juce::Decibels::decibelsToGain(-1.0f);
+        p.lookAheadSamplesOS = (int)std::round(0.001 * osRate); // 1 ms
+        p.releaseAlphaOS = std::exp(-1.0f / (0.120f * (float)osRate));
+        p.scHpfOn = true;
+        p.safetyOn = true;
+        p.autoReleaseOn = false;
+        lim.setParams(p);
+
+        // Program-like input: noise bursts over a low sine so the limiter works part of the time
+        juce::Random rng(42);
+        std::vector<float> srcL((size_t)osBlock * 16), srcR(srcL.size());
+        for (size_t i = 0; i < srcL.size(); ++i)
+        {
+            const float burst = ((i / 3000) % 3 == 0) ? 0.8f : 0.1f;
+            srcL[i] = burst * (rng.nextFloat() * 2.0f - 1.0f) + 0.2f * std::sin(0.001f * (float)i);
+            srcR[i] = burst * (rng.nextFloat() * 2.0f - 1.0f) + 0.2f * std::cos(0.001f * (float)i);
+        }
+
+        std::vector<float> L((size_t)osBlock), R((size_t)osBlock);
+        const auto t0 = std::chrono::steady_clock::now();
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            const size_t off = (size_t)(b % 16) * (size_t)osBlock;
+            std::copy(srcL.begin() + (long)off, srcL.begin() + (long)(off + (size_t)osBlock), L.begin());
+            std::copy(srcR.begin() + (long)off, srcR.begin() + (long)(off + (size_t)osBlock), R.begin());
+            lim.processBlockOS(L.data(), R.data(), osBlock);
+        }
+        const auto t1 = std::chrono::steady_clock::now();
+        const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+        return ns / ((double)osBlock * (double)numBlocks);
+    }
+
+    hgl::LimiterParams engineParams(double rate)
+    {
+        hgl::LimiterParams p{};
+        p.preGainL = p.preGainR = juce::Decibels::decibelsToGain(10.0f);
+        p.ceilLin = juce::Decibels::decibelsToGain(-1.0f);
+        p.lookAheadSamplesOS = (int)std::round(0.001 * rate);
+        p.releaseAlphaOS = std::exp(-1.0f / (0.120f * (float)rate));
+        p.scHpfOn = true;
+        return p;
+    }
+
+    // ns per host sample for one stereo instance; osFactor 1 = Fast TruePeak
+    double engineNsPerHostSample(double hostRate, int osFactor, int hostBlock, int numBlocks)
+    {
+        std::unique_ptr<juce::dsp::Oversampling<float>> os;
+        if (osFactor > 1)
+        {
+            os = std::make_unique<juce::dsp::Oversampling<float>>(2, (size_t)std::log2((double)osFactor),
+                     juce::dsp::Oversampling<float>::FilterType::filterHalfBandFIREquiripple, true);
+            os->initProcessing((size_t)hostBlock);
+        }
+
+        const double rate = hostRate * osFactor;
+        hgl::LimiterDSP lim;
+        lim.prepare((float)rate, (int)std::ceil(0.005 * rate) + 64);
+        auto p = engineParams(rate);
+        p.truePeakDetect = (osFactor == 1);
+        lim.setParams(p);
+
+        juce::AudioBuffer<float> buf(2, hostBlock);
+        juce::Random rng(7);
+        const auto t0 = std::chrono::steady_clock::now();
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < hostBlock; ++i)
+                    buf.setSample(ch, i, 0.5f * (rng.nextFloat() * 2.0f - 1.0f));
+
+            juce::dsp::AudioBlock<float> block(buf);
+            if (os != nullptr)
+            {
+                auto up = os->processSamplesUp(block);
+                lim.processBlockOS(up.getChannelPointer(0), up.getChannelPointer(1), (int)up.getNumSamples());
+                os->processSamplesDown(block);
+            }
+            else
+            {
+                lim.processBlockOS(block.getChannelPointer(0), block.getChannelPointer(1), hostBlock);
+            }
+        }
+        const auto t1 = std::chrono::steady_clock::now();
+        const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+        return ns / ((double)hostBlock * (double)numBlocks);
+    }
+
+    // ns per sample of one sliding max over detector-like input (|noise| with bursts), in the
+    // limiter's stage-sized blocks
+    template <typename Max>
+    double slidingMaxNsPerSample(Max& sm, int window, int numBlocks)
+    {
+        constexpr int n = hgl::LimiterDSP::kStageBlock;
+        juce::Random rng(3);
+        std::vector<float> src((size_t)n * 64);
+        for (size_t i = 0; i < src.size(); ++i)
+            src[i] = (((i / 5000) % 2) ? 0.9f : 0.2f) * rng.nextFloat();
+
+        std::vector<float> buf((size_t)n);
+        float sink = 0.0f;
+        const auto t0 = std::chrono::steady_clock::now();
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            std::copy_n(src.begin() + (long)((size_t)(b % 64) * n), n, buf.begin());
+            sm.process(buf.data(), n, window);
+            sink += buf[(size_t)n - 1];
+        }
+        const auto t1 = std::chrono::steady_clock::now();
+        if (sink < 0.0f) std::printf("%f", sink); // keep the work observable
+        const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+        return ns / ((double)n * (double)numBlocks);
+    }
+
+    // The quantize loop the processor ran before hgl::Dither (juce::Random, first-order feedback)
+    struct LegacyDither
+    {
+        juce::Random rng;
+        float ePrev = 0.0f;
+        void process(float* x, int N, int bits, float amp, bool shapeArc)
+        {
+            const float step = std::ldexp(1.0f, 1 - bits);
+            for (int n = 0; n < N; ++n)
+            {
+                float y = x[n];
+                if (shapeArc) y += 0.8f * ePrev;
+                const float u1 = rng.nextFloat();
+                const float u2 = rng.nextFloat();
+                y += ((u1 + u2) - 1.0f) * (amp * step);
+                const float q = std::round(y / step) * step;
+                ePrev = y - q;
+                x[n] = juce::jlimit(-1.0f, 1.0f, q);
+            }
+        }
+    };
+
+    template <typename Fn>
+    double ditherNsPerSample(Fn&& process, int hostBlock, int numBlocks)
+    {
+        std::vector<float> src((size_t)hostBlock * 16), buf((size_t)hostBlock);
+        for (size_t i = 0; i < src.size(); ++i)
+            src[i] = 0.5f * std::sin(0.01f * (float)i);
+
+        float sink = 0.0f;
+        const auto t0 = std::chrono::steady_clock::now();
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            std::copy_n(src.begin() + (long)((size_t)(b % 16) * (size_t)hostBlock), hostBlock, buf.begin());
+            process(buf.data(), hostBlock);
+            sink += buf[0];
+        }
+        const auto t1 = std::chrono::steady_clock::now();
+        if (sink > 1.0e9f) std::printf("%f", sink);
+        const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+        return ns / ((double)hostBlock * (double)numBlocks);
+    }
+}
+
+int main()
+{
+    juce::ScopedNoDenormals noDenormals;
+    const int hostBlock = 512;
+    const Config configs[] = { { "44.1k x8", 44100.0, 8 }, { "96k x4", 96000.0, 4 } };
+
+    std::printf("%-10s %14s %14s %9s %12s\n", "config", "scalar ns/smp", "staged ns/smp", "speedup", "staged xRT");
+    for (const auto& c : configs)
+    {
+        const double osRate = c.hostRate * c.osFactor;
+        const int osBlock = hostBlock * c.osFactor;
+        const int numBlocks = (int)(10.0 * c.hostRate / hostBlock); // ~10 s of audio
+
+        const double scalar = nsPerOsSample<hgl::test::ScalarLimiterReference>(osRate, osBlock, numBlocks);
+        const double staged = nsPerOsSample<hgl::LimiterDSP>(osRate, osBlock, numBlocks);
+        const double realTimeFactor = 1.0e9 / (staged * osRate); // one stereo instance
+
+        std::printf("%-10s %14.2f %14.2f %8.2fx %11.1fx\n", c.name, scalar, staged, scalar / staged, realTimeFactor);
+    }
+
+    std::printf("\n%-10s %16s %16s %9s\n", "config", "TruePeak ns/smp", "FastTP ns/smp", "speedup");
+    for (const auto& c : configs)
+    {
+        const int numBlocks = (int)(10.0 * c.hostRate / hostBlock);
+        const double full = engineNsPerHostSample(c.hostRate, c.osFactor, hostBlock, numBlocks);
+        const double fast = engineNsPerHostSample(c.hostRate, 1, hostBlock, numBlocks);
+        std::printf("%-10s %16.2f %16.2f %8.2fx\n", c.name, full, fast, full / fast);
+    }
+
+    const double osRate = 352800.0;
+    const int numBlocks = (int)(10.0 * osRate / hgl::LimiterDSP::kStageBlock);
+    std::printf("\n%-10s %8s %14s %14s %9s\n", "window", "samples", "deque ns/smp", "vHGW ns/smp", "speedup");
+    for (int ms = 1; ms <= 5; ++ms)
+    {
+        const int window = (int)std::round(0.001 * ms * osRate);
+        hgl::test::DequeSlidingMax dq;
+        dq.reset(window + 64);
+        hgl::SlidingMax vhgw;
+        vhgw.reset(window + 64, hgl::LimiterDSP::kStageBlock);
+
+        const double deque = slidingMaxNsPerSample(dq, window, numBlocks);
+        const double fast = slidingMaxNsPerSample(vhgw, window, numBlocks);
+        std::printf("%7d ms %8d %14.2f %14.2f %8.2fx\n", ms, window, deque, fast, deque / fast);
+    }
+
+    {
+        const int ditherBlocks = (int)(30.0 * 44100.0 / hostBlock); // ~30 s, one channel
+        LegacyDither legacy;
+        const double base = ditherNsPerSample([&](float* x, int n) { legacy.process(x, n, 16, 2.0f, true); }, hostBlock, ditherBlocks);
+
+        std::printf("\n%-22s %9s %9s\n", "dither (16-bit, T2)", "ns/smp", "vs legacy");
+        std::printf("%-22s %9.2f %8.2fx\n", "legacy first-order", base, 1.0);
+        const std::pair<const char*, hgl::Dither::Shape> shapes[] = {
+            { "none", hgl::Dither::Shape::None }, { "first-order", hgl::Dither::Shape::FirstOrder },
+            { "E-weighted 5-tap", hgl::Dither::Shape::EWeighted5 }, { "F-weighted 9-tap", hgl::Dither::Shape::FWeighted9 } };
+        for (const auto& sh : shapes)
+        {
+            hgl::Dither d;
+            const double ns = ditherNsPerSample([&](float* x, int n) { d.process(x, n, 16, 2.0f, sh.second); }, hostBlock, ditherBlocks);
+            std::printf("%-22s %9.2f %8.2fx\n", sh.first, ns, base / ns);
+        }
+    }
+    return 0;
+}
@@ -3,6 +3,7 @@
 #include <cmath>
 #include <vector>
 #include "../Source/dsp/LimiterDSP.h"
+#include "LimiterDSPReference.h"
 
 struct LimiterAttenAndCeilTest : juce::UnitTest {
     LimiterAttenAndCeilTest() : juce::UnitTest("Limiter: attenuates and no overshoot") {}
@@ -112,13 +113,374 @@ struct LimiterAutoReleaseTest : juce::UnitTest {
     }
 };
 
+struct LimiterBlockStagedMatchesScalarTest : juce::UnitTest {
+    LimiterBlockStagedMatchesScalarTest() : juce::UnitTest("Limiter: block-staged matches scalar reference") {}
+    void runTest() override {
+        const float osSR = 352800.0f;
+        const int total = 6000;
+
+        auto run = [&](bool autoRel, bool hpf, bool safety, int chunk) {
+            hgl::LimiterDSP lim;
+            hgl::test::ScalarLimiterReference ref;
+            lim.prepare(osSR, 2048);
+            ref.prepare(osSR, 2048);
+
+            hgl::LimiterParams p{};
+            p.preGainL = juce::Decibels::decibelsToGain(9.0f);
+            p.preGainR = juce::Decibels::decibelsToGain(6.0f);
+            p.ceilLin  = juce::Decibels::decibelsToGain(-1.0f);
+            p.lookAheadSamplesOS = 353;
+            p.releaseAlphaOS = std::exp(-1.0f / (0.050f * osSR));
+            p.scHpfOn = hpf;
+            p.safetyOn = safety;
+            p.autoReleaseOn = autoRel;
+            lim.setParams(p);
+            ref.setParams(p);
+
+            juce::Random rng(1234);
+            std::vector<float> L(total), R(total);
+            for (int i = 0; i < total; ++i) {
+                const float env = (i / 1500) % 2 == 0 ? 0.9f : 0.2f; // alternate loud/quiet sections
+                L[i] = env * (rng.nextFloat() * 2.0f - 1.0f);
+                R[i] = env * std::sin(0.01f * (float)i);
+            }
+            auto refL = L, refR = R;
+
+            float maxDiff = 0.0f, maxAttenDiff = 0.0f;
+            for (int start = 0; start < total; start += chunk) {
+                const int n = juce::jmin(chunk, total - start);
+                const float a = lim.processBlockOS(L.data() + start, R.data() + start, n);
+                const float b = ref.processBlockOS(refL.data() + start, refR.data() + start, n);
+                maxAttenDiff = std::max(maxAttenDiff, std::abs(a - b));
+            }
+            for (int i = 0; i < total; ++i)
+                maxDiff = std::max(maxDiff, std::max(std::abs(L[i] - refL[i]), std::abs(R[i] - refR[i])));
+
+            expect(maxDiff < 1.0e-5f, "Output deviates from scalar reference: " + juce::String(maxDiff));
+            expect(maxAttenDiff < 1.0e-4f, "Meter deviates from scalar reference: " + juce::String(maxAttenDiff));
+        };
+
+        beginTest("Manual release, HPF on, odd host chunks");
+        run(false, true, false, 777);
+        beginTest("Auto release, HPF off, safety on");
+        run(true, false, true, 4096);
+        beginTest("Manual release, safety on, tiny chunks");
+        run(false, true, true, 31);
+    }
+};
+
+struct LimiterTruePeakDetectorTest : juce::UnitTest {
+    LimiterTruePeakDetectorTest() : juce::UnitTest("Limiter: host-rate true-peak detector") {}
+    void runTest() override {
+        beginTest("Interpolated detector catches inter-sample peaks the sample-peak detector misses");
+        const float sr = 48000.0f;
+        const int N = 4096;
+
+        // fs/4 tone at 45 degrees: every sample sits at 0.707 of the true peak
+        auto run = [&](bool tp) {
+            hgl::LimiterDSP lim;
+            lim.prepare(sr, 512);
+            hgl::LimiterParams p{};
+            p.ceilLin = juce::Decibels::decibelsToGain(-1.0f);
+            p.lookAheadSamplesOS = 48;
+            p.releaseAlphaOS = std::exp(-1.0f / (0.1f * sr));
+            p.scHpfOn = false;
+            p.truePeakDetect = tp;
+            lim.setParams(p);
+
+            std::vector<float> L(N), R(N);
+            for (int i = 0; i < N; ++i)
+                L[i] = R[i] = 1.2f * std::sin(0.5f * juce::MathConstants<float>::pi * (float)i + 0.25f * juce::MathConstants<float>::pi);
+            const float atten = lim.processBlockOS(L.data(), R.data(), N);
+
+            float peak = 0.0f;
+            for (int i = N / 2; i < N; ++i) peak = std::max(peak, std::abs(L[i]));
+            return std::make_pair(atten, peak / 0.70710678f); // reconstructed true peak of the output tone
+        };
+
+        const auto samplePeak = run(false);
+        const auto truePeak = run(true);
+        expect(samplePeak.first < 1.0e-3f, "Sample-peak detector should not see the inter-sample overs");
+        expect(truePeak.first > 1.5f, "True-peak detector should attenuate the inter-sample overs");
+        expect(truePeak.second <= juce::Decibels::decibelsToGain(-1.0f) * 1.01f, "Reconstructed true peak should respect the ceiling");
+    }
+};
+
+struct SlidingMaxTest : juce::UnitTest {
+    SlidingMaxTest() : juce::UnitTest("Limiter: van Herk/Gil-Werman sliding max") {}
+    void runTest() override {
+        beginTest("Matches brute force across block sizes and window changes");
+        {
+            hgl::SlidingMax sm;
+            sm.reset(700, 256);
+            juce::Random rng(99);
+            std::vector<float> x(20000);
+            for (auto& v : x) v = rng.nextFloat();
+
+            const int windows[] = { 353, 1, 700, 17, 256, 513 };
+            float maxErr = 0.0f;
+            int start = 0;
+            for (int seg = 0; start < (int)x.size(); ++seg) {
+                const int W = windows[seg % 6];
+                for (int b = 0; b < 12 && start < (int)x.size(); ++b) {
+                    const int n = juce::jmin(1 + rng.nextInt(256), (int)x.size() - start);
+                    std::vector<float> y(x.begin() + start, x.begin() + start + n);
+                    sm.process(y.data(), n, W);
+                    for (int i = 0; i < n; ++i) {
+                        float m = 0.0f; // samples before the start read as 0
+                        for (int j = juce::jmax(0, start + i - W + 1); j <= start + i; ++j) m = std::max(m, x[j]);
+                        maxErr = std::max(maxErr, std::abs(y[i] - m));
+                    }
+                    start += n;
+                }
+            }
+            expectEquals(maxErr, 0.0f);
+        }
+
+        beginTest("Matches the monotonic deque for a fixed window");
+        {
+            hgl::SlidingMax sm;
+            hgl::test::DequeSlidingMax dq;
+            sm.reset(2048, 256);
+            dq.reset(2048);
+            juce::Random rng(5);
+            bool same = true;
+            for (int b = 0; b < 200; ++b) {
+                std::vector<float> a(256);
+                for (auto& v : a) v = std::abs(rng.nextFloat() * 2.0f - 1.0f);
+                auto d = a;
+                sm.process(a.data(), 256, 1764);
+                dq.process(d.data(), 256, 1764);
+                same = same && (a == d);
+            }
+            expect(same, "vHGW output differs from the deque");
+        }
+    }
+};
+
+struct LimiterMultichannelLinkTest : juce::UnitTest {
+    LimiterMultichannelLinkTest() : juce::UnitTest("Limiter: multichannel linking") {}
+
+    // The burst region of the output (N = 24000, burst from N / 2; the look-ahead delays by kLook)
+    static constexpr int kLook = 96, kBurstBegin = 12000 + 300, kBurstEnd = 12000 + 1800;
+
+    static hgl::LimiterParams params(hgl::ChannelLink link)
+    {
+        hgl::LimiterParams p{};
+        p.preGainL = p.preGainR = juce::Decibels::decibelsToGain(6.0f);
+        p.ceilLin = juce::Decibels::decibelsToGain(-1.0f);
+        p.lookAheadSamplesOS = kLook;
+        p.releaseAlphaOS = std::exp(-1.0f / (0.05f * 48000.0f));
+        p.scHpfOn = true;
+        p.link = link;
+        return p;
+    }
+
+    // Quiet noise on every channel with a loud 1 kHz burst in channel 7
+    static std::vector<std::vector<float>> bed(int numChannels, int N)
+    {
+        juce::Random rng(21);
+        std::vector<std::vector<float>> ch((size_t)numChannels, std::vector<float>((size_t)N));
+        for (int c = 0; c < numChannels; ++c)
+            for (int i = 0; i < N; ++i)
+                ch[(size_t)c][(size_t)i] = 0.1f * (rng.nextFloat() * 2.0f - 1.0f)
+                                         + (c == 7 && i >= N / 2 && i < N / 2 + 2000 ? 0.9f * std::sin(0.1309f * (float)i) : 0.0f);
+        return ch;
+    }
+
+    // Runs in odd host chunks; returns the peak of each output channel over the burst
+    static std::vector<float> run(hgl::LimiterDSP& lim, std::vector<std::vector<float>>& ch)
+    {
+        const int C = (int)ch.size(), N = (int)ch[0].size();
+        float* ptrs[hgl::kMaxLimiterChannels];
+        for (int start = 0, blk = 0; start < N; ++blk)
+        {
+            const int n = std::min(N - start, 1 + (blk * 97) % 600);
+            for (int c = 0; c < C; ++c) ptrs[c] = ch[(size_t)c].data() + start;
+            lim.processBlockOS(ptrs, C, n);
+            start += n;
+        }
+        std::vector<float> peaks((size_t)C, 0.0f);
+        for (int c = 0; c < C; ++c)
+            for (int i = kBurstBegin; i < kBurstEnd; ++i)
+                peaks[(size_t)c] = std::max(peaks[(size_t)c], std::abs(ch[(size_t)c][(size_t)i]));
+        return peaks;
+    }
+
+    void runTest() override {
+        constexpr int N = 24000;
+        const float ceil = juce::Decibels::decibelsToGain(-1.0f);
+
+        beginTest("Linked: identical channel pairs render exactly like a stereo instance");
+        {
+            auto ch = bed(2, N);
+            std::vector<std::vector<float>> multi;
+            for (int k = 0; k < 4; ++k) { multi.push_back(ch[0]); multi.push_back(ch[1]); }
+
+            hgl::LimiterDSP stereo, eight;
+            stereo.prepare(48000.0f, 512);
+            eight.prepare(48000.0f, 512, 8);
+            stereo.setParams(params(hgl::ChannelLink::Linked));
+            eight.setParams(params(hgl::ChannelLink::Linked));
+            run(stereo, ch);
+            run(eight, multi);
+
+            bool same = true;
+            for (int c = 0; c < 8; ++c) same = same && multi[(size_t)c] == ch[(size_t)(c & 1)];
+            expect(same, "eight-channel output differs from the stereo render");
+        }
+
+        auto limitWith = [&](hgl::ChannelLink link)
+        {
+            auto ch = bed(12, N);
+            hgl::LimiterDSP lim;
+            lim.prepare(48000.0f, 512, 12);
+            lim.setParams(params(link));
+            return run(lim, ch);
+        };
+        const auto dryPeaks = [&]
+        {
+            const auto ch = bed(12, N);
+            const float pre = params(hgl::ChannelLink::Linked).preGainL;
+            std::vector<float> p(12, 0.0f);
+            for (int c = 0; c < 12; ++c)
+                for (int i = kBurstBegin; i < kBurstEnd; ++i)
+                    p[(size_t)c] = std::max(p[(size_t)c], std::abs(ch[(size_t)c][(size_t)(i - kLook)] * pre));
+            return p;
+        }();
+
+        beginTest("Linked: a burst in one channel ducks every channel");
+        {
+            const auto peaks = limitWith(hgl::ChannelLink::Linked);
+            expect(peaks[7] <= ceil + 1.0e-4f, "burst channel over the ceiling");
+            bool allDucked = true;
+            for (int c = 0; c < 12; ++c)
+                if (c != 7) allDucked = allDucked && peaks[(size_t)c] < dryPeaks[(size_t)c] * 0.9f;
+            expect(allDucked, "linked channels should share the reduction");
+        }
+
+        beginTest("Grouped: only the burst channel's pair is ducked");
+        {
+            const auto peaks = limitWith(hgl::ChannelLink::Grouped);
+            expect(peaks[7] <= ceil + 1.0e-4f, "burst channel over the ceiling");
+            expect(peaks[6] < dryPeaks[6] * 0.9f, "pair partner should follow the burst");
+            bool othersUntouched = true;
+            for (int c = 0; c < 12; ++c)
+                if (c != 6 && c != 7) othersUntouched = othersUntouched && peaks[(size_t)c] == dryPeaks[(size_t)c];
+            expect(othersUntouched, "other groups should not be limited");
+        }
+
+        beginTest("Unlinked: channels are independent");
+        {
+            const auto peaks = limitWith(hgl::ChannelLink::Unlinked);
+            expect(peaks[7] <= ceil + 1.0e-4f, "burst channel over the ceiling");
+            bool othersUntouched = true;
+            for (int c = 0; c < 12; ++c)
+                if (c != 7) othersUntouched = othersUntouched && peaks[(size_t)c] == dryPeaks[(size_t)c];
+            expect(othersUntouched, "unlinked channels should not be limited by channel 7");
+        }
+
+        beginTest("Changing the link mid-burst keeps the output under the ceiling");
+        {
+            auto ch = bed(12, N);
+            hgl::LimiterDSP lim;
+            lim.prepare(48000.0f, 512, 12);
+            const hgl::ChannelLink order[] = { hgl::ChannelLink::Unlinked, hgl::ChannelLink::Linked,
+                                               hgl::ChannelLink::Grouped, hgl::ChannelLink::Unlinked };
+            float* ptrs[hgl::kMaxLimiterChannels];
+            for (int start = 0, blk = 0; start < N; ++blk)
+            {
+                const int n = std::min(N - start, 40);
+                lim.setParams(params(order[blk % 4]));
+                for (int c = 0; c < 12; ++c) ptrs[c] = ch[(size_t)c].data() + start;
+                lim.processBlockOS(ptrs, 12, n);
+                start += n;
+            }
+            float peak = 0.0f;
+            for (const auto& c : ch)
+                for (float v : c) peak = std::max(peak, std::abs(v));
+            expect(peak <= ceil + 1.0e-4f, "a link change let the burst through");
+        }
+    }
+};
+
+struct LimiterFixedDelayTest : juce::UnitTest {
+    LimiterFixedDelayTest() : juce::UnitTest("Limiter: fixed delay") {}
+    void runTest() override {
+        constexpr int N = 16000, kLook = 40, kFixed = 144;
+        hgl::LimiterParams p{};
+        p.preGainL = p.preGainR = juce::Decibels::decibelsToGain(9.0f);
+        p.ceilLin = juce::Decibels::decibelsToGain(-1.0f);
+        p.lookAheadSamplesOS = kLook;
+        p.releaseAlphaOS = std::exp(-1.0f / (0.02f * 48000.0f));
+        p.scHpfOn = false; // the ceiling check needs the detector to see the whole band
+
+        juce::Random rng(17);
+        std::vector<float> inL(N), inR(N);
+        for (int i = 0; i < N; ++i)
+        {
+            inL[(size_t)i] = 0.8f * std::sin(0.02f * (float)i) * rng.nextFloat();
+            inR[(size_t)i] = 0.6f * std::sin(0.031f * (float)i);
+        }
+
+        beginTest("A fixed delay renders the look-ahead output, later by the difference");
+        {
+            hgl::LimiterDSP plain, fixed;
+            auto q = p;
+            q.fixedDelaySamplesOS = kFixed;
+            plain.prepare(48000.0f, 512);  plain.setParams(p);
+            fixed.prepare(48000.0f, 512);  fixed.setParams(q);
+
+            auto aL = inL, aR = inR, bL = inL, bR = inR;
+            for (int start = 0, blk = 0; start < N; ++blk)
+            {
+                const int n = std::min(N - start, 1 + (blk * 53) % 300);
+                plain.processBlockOS(aL.data() + start, aR.data() + start, n);
+                fixed.processBlockOS(bL.data() + start, bR.data() + start, n);
+                start += n;
+            }
+            bool same = true;
+            for (int i = kFixed - kLook; i < N; ++i)
+                same = same && bL[(size_t)i] == aL[(size_t)(i - (kFixed - kLook))]
+                            && bR[(size_t)i] == aR[(size_t)(i - (kFixed - kLook))];
+            expect(same, "fixed-delay output is not the shifted look-ahead output");
+        }
+
+        beginTest("Sweeping look-ahead under a fixed delay holds the ceiling");
+        {
+            hgl::LimiterDSP lim;
+            lim.prepare(48000.0f, 512);
+            auto L = inL, R = inR;
+            for (int start = 0, blk = 0; start < N; ++blk)
+            {
+                const int n = std::min(N - start, 64);
+                auto q = p;
+                q.fixedDelaySamplesOS = kFixed;
+                q.lookAheadSamplesOS = 8 + (blk * 7) % (kFixed - 8);
+                lim.setParams(q);
+                lim.processBlockOS(L.data() + start, R.data() + start, n);
+                start += n;
+            }
+            float peak = 0.0f;
+            for (int i = 0; i < N; ++i)
+                peak = std::max({ peak, std::abs(L[(size_t)i]), std::abs(R[(size_t)i]) });
+            expectLessOrEqual(peak, p.ceilLin + 1.0e-4f);
+        }
+    }
+};
+
 static LimiterAttenAndCeilTest test1;
 static LimiterLookAheadLatencyTest test2;
 static LimiterAutoReleaseTest test3;
+static LimiterBlockStagedMatchesScalarTest test4;
+static LimiterTruePeakDetectorTest test5;
+static SlidingMaxTest test6;
+static LimiterMultichannelLinkTest test7;
+static LimiterFixedDelayTest test8;
 
 int main() {
-    juce::UnitTestRunner r;
+    audio::rtsan::TestRunner r;
     r.runAllTests();
-    return 0; // JUCE's UnitTestRunner doesn't expose a failure count API across versions
+    return r.finish();
 }
 
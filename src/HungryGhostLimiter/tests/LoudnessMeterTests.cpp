@@ -0,0 +1,151 @@
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <audio/LoudnessMeter.h>
+#include <audio/RealtimeSanitizer.h>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// Feeds seconds of a stereo sine (same on both channels) at the given peak level, in odd blocks
+void feedSine(audio::LoudnessMeter& m, double sr, float hz, float peakDb, double seconds, float phase = 0.0f)
+{
+    const int total = (int)(seconds * sr), block = 997;
+    const float amp = juce::Decibels::decibelsToGain(peakDb);
+    std::vector<float> x((size_t)block);
+    for (int start = 0; start < total; start += block)
+    {
+        const int n = juce::jmin(block, total - start);
+        for (int i = 0; i < n; ++i)
+            x[(size_t)i] = amp * std::sin(phase + 2.0f * juce::MathConstants<float>::pi * hz * (float)((start + i) / sr));
+        const float* ch[2] { x.data(), x.data() };
+        m.process(ch, n);
+    }
+}
+
+void feedSilence(audio::LoudnessMeter& m, double sr, double seconds)
+{
+    std::vector<float> x(4096, 0.0f);
+    const float* ch[2] { x.data(), x.data() };
+    for (int left = (int)(seconds * sr); left > 0; left -= 4096)
+        m.process(ch, juce::jmin(4096, left));
+}
+
+} // namespace
+
+struct LoudnessMeterTest : juce::UnitTest {
+    LoudnessMeterTest() : juce::UnitTest("Loudness: BS.1770 / EBU R128 meter") {}
+    void runTest() override {
+        for (double sr : { 44100.0, 48000.0, 96000.0 })
+        {
+            beginTest("Stereo 1 kHz sine at -23 dBFS reads -23 LUFS at " + juce::String(sr));
+            audio::LoudnessMeter m;
+            m.prepare(sr, 2);
+            feedSine(m, sr, 1000.0f, -23.0f, 10.0);
+            const auto r = m.getReadings();
+            expectWithinAbsoluteError(r.momentary, -23.0f, 0.1f);
+            expectWithinAbsoluteError(r.shortTerm, -23.0f, 0.1f);
+            expectWithinAbsoluteError(r.integrated, -23.0f, 0.1f);
+            expectWithinAbsoluteError(r.range, 0.0f, 0.2f);
+        }
+
+        beginTest("Silence is gated out of the integrated loudness");
+        {
+            audio::LoudnessMeter m;
+            m.prepare(48000.0, 2);
+            feedSilence(m, 48000.0, 5.0);
+            expect(! std::isfinite(m.getReadings().integrated), "silence alone has no integrated loudness");
+            feedSine(m, 48000.0, 1000.0f, -20.0f, 10.0);
+            feedSilence(m, 48000.0, 10.0);
+            expectWithinAbsoluteError(m.getReadings().integrated, -20.0f, 0.15f);
+            expect(! std::isfinite(m.getReadings().momentary));
+        }
+
+        beginTest("Relative gate drops material 10 LU below the programme (Tech 3341 case 3 style)");
+        {
+            audio::LoudnessMeter m;
+            m.prepare(48000.0, 2);
+            feedSine(m, 48000.0, 1000.0f, -36.0f, 10.0);
+            feedSine(m, 48000.0, 1000.0f, -23.0f, 60.0);
+            feedSine(m, 48000.0, 1000.0f, -36.0f, 10.0);
+            expectWithinAbsoluteError(m.getReadings().integrated, -23.0f, 0.15f);
+        }
+
+        beginTest("Loudness range: 20 s at -20 then 20 s at -30 gives 10 LU (Tech 3342 case 1)");
+        {
+            audio::LoudnessMeter m;
+            m.prepare(48000.0, 2);
+            feedSine(m, 48000.0, 1000.0f, -20.0f, 20.0);
+            feedSine(m, 48000.0, 1000.0f, -30.0f, 20.0);
+            expectWithinAbsoluteError(m.getReadings().range, 10.0f, 1.0f);
+        }
+
+        beginTest("Reset starts a new measurement");
+        {
+            audio::LoudnessMeter m;
+            m.prepare(48000.0, 2);
+            feedSine(m, 48000.0, 1000.0f, -10.0f, 5.0);
+            m.reset();
+            feedSine(m, 48000.0, 1000.0f, -30.0f, 5.0);
+            expectWithinAbsoluteError(m.getReadings().integrated, -30.0f, 0.15f);
+            expectWithinAbsoluteError(m.getReadings().truePeakDb, -30.0f, 0.2f);
+        }
+    }
+};
+
+struct TruePeakMeterTest : juce::UnitTest {
+    TruePeakMeterTest() : juce::UnitTest("Loudness: true-peak meter") {}
+    void runTest() override {
+        beginTest("fs/4 sine sampled 45 degrees off its peaks: sample peak -3 dB, true peak ~0 dBTP");
+        {
+            audio::LoudnessMeter m;
+            m.prepare(48000.0, 2);
+            feedSine(m, 48000.0, 12000.0f, 0.0f, 1.0, juce::MathConstants<float>::pi * 0.25f);
+            expectWithinAbsoluteError(m.getReadings().truePeakDb, 0.0f, 0.6f);
+        }
+
+        beginTest("Peak hold matches a brute-force run of the same interpolator");
+        {
+            juce::Random rng(5);
+            std::vector<float> x(20000);
+            for (size_t i = 0; i < x.size(); ++i)
+                x[i] = (rng.nextFloat() * 2.0f - 1.0f) * (i > 12000 ? 0.05f : 0.5f) * (float)std::sin(0.001 * (double)i);
+
+            float ref = 0.0f;
+            for (size_t i = 0; i < x.size(); ++i)
+            {
+                ref = juce::jmax(ref, std::abs(x[i]));
+                for (const auto& phase : audio::bs1770::kTruePeakCoeffs)
+                {
+                    float acc = 0.0f;
+                    for (int k = 0; k < audio::bs1770::kTruePeakTaps; ++k)
+                        acc += (i >= (size_t)k ? x[i - (size_t)k] : 0.0f) * phase[k];
+                    ref = juce::jmax(ref, std::abs(acc));
+                }
+            }
+
+            audio::TruePeakMeter tp;
+            tp.reset();
+            for (size_t start = 0; start < x.size(); start += 333)
+                tp.process(x.data() + start, (int)juce::jmin((size_t)333, x.size() - start));
+            expectWithinAbsoluteError(tp.getPeak(), ref, 1.0e-5f);
+        }
+
+        beginTest("process() is real-time safe (checked by the sanitizer's test runner)");
+        {
+            audio::LoudnessMeter m;
+            m.prepare(48000.0, 2);
+            std::vector<float> x(512, 0.25f);
+            const float* ch[2] { x.data(), x.data() };
+            {
+                HG_RT_SCOPE("LoudnessMeter::process");
+                for (int i = 0; i < 200; ++i)
+                    m.process(ch, 512);
+            }
+            expect(std::isfinite(m.getReadings().integrated));
+        }
+    }
+};
+
+static LoudnessMeterTest loudnessMeterTest;
+static TruePeakMeterTest truePeakMeterTest;
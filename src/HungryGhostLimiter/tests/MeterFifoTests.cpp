@@ -0,0 +1,80 @@
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <audio/MeterFifo.h>
+#include <thread>
+#include <vector>
+
+struct MeterFifoTest : juce::UnitTest {
+    MeterFifoTest() : juce::UnitTest("CommonAudio: SPSC meter FIFO") {}
+    void runTest() override {
+        struct Rec { std::uint32_t seq; float payload[7]; };
+
+        beginTest("Wraps around, keeps order, drops on full and discards on request");
+        {
+            audio::MeterFifo<Rec, 8> fifo;
+            Rec out[8];
+            std::uint32_t next = 0, expected = 0;
+            for (int round = 0; round < 5; ++round)
+            {
+                for (int i = 0; i < 5; ++i, ++next)
+                    expect(fifo.push({ next, {} }));
+                const int n = fifo.pop(out, 8);
+                expectEquals(n, 5);
+                for (int i = 0; i < n; ++i)
+                    expectEquals((int)out[i].seq, (int)expected++);
+            }
+
+            for (int i = 0; i < 8; ++i)
+                expect(fifo.push({ (std::uint32_t)i, {} }));
+            expect(! fifo.push({ 99, {} }), "a full ring rejects the record");
+            expectEquals(fifo.getNumReady(), 8);
+            fifo.discardAll();
+            expectEquals(fifo.getNumReady(), 0);
+            expectEquals(fifo.pop(out, 8), 0);
+        }
+
+        beginTest("Producer and consumer threads: every record arrives once, in order");
+        {
+            static audio::MeterFifo<Rec, 64> fifo;
+            constexpr std::uint32_t total = 200000;
+            std::thread producer([] {
+                for (std::uint32_t i = 0; i < total;)
+                    if (fifo.push({ i, { (float)i } }))
+                        ++i;
+            });
+
+            std::vector<Rec> out(64);
+            std::uint32_t expected = 0;
+            bool ordered = true;
+            while (expected < total)
+            {
+                const int n = fifo.pop(out.data(), (int)out.size());
+                for (int i = 0; i < n; ++i, ++expected)
+                    ordered = ordered && out[(size_t)i].seq == expected && out[(size_t)i].payload[0] == (float)expected;
+            }
+            producer.join();
+            expect(ordered, "records lost, duplicated or torn");
+        }
+
+        beginTest("MeterFrame merge equals one frame over the whole run");
+        {
+            juce::Random rng(3);
+            std::vector<float> x(1000);
+            for (auto& v : x) v = rng.nextFloat() * 2.0f - 1.0f;
+
+            audio::MeterFrame<1> whole, a, b;
+            whole.addLevels(0, x.data(), 1000); whole.addGainReduction(0, 2.0f); whole.addGainReduction(0, 5.0f); whole.advance(1000);
+            a.addLevels(0, x.data(), 400); a.addGainReduction(0, 2.0f); a.advance(400);
+            b.addLevels(0, x.data() + 400, 600); b.addGainReduction(0, 5.0f); b.advance(600);
+            a.merge(b);
+
+            expectEquals(a.peak[0], whole.peak[0]);
+            expectWithinAbsoluteError(a.rmsDb(0), whole.rmsDb(0), 1.0e-3f);
+            expectEquals(a.grMinDb[0], 2.0f);
+            expectEquals(a.grMaxDb[0], 5.0f);
+            expectEquals(a.numSamples, 1000);
+        }
+    }
+};
+
+static MeterFifoTest meterFifoTest;
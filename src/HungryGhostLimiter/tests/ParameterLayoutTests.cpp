@@ -17,9 +17,35 @@ struct ParameterLayoutTest : juce::UnitTest {
             expect(hasId(id), juce::String(id) + " missing");
         // Advanced
         for (auto id : { "q24", "q20", "q16", "q12", "q8",
-                         "dT1", "dT2", "sNone", "sArc",
-                         "domDigital", "domAnalog", "domTruePeak" })
+                         "dT1", "dT2", "sNone", "sArc", "sE5", "sF9",
+                         "domDigital", "domAnalog", "domTruePeak", "domFastTP",
+                         "osRate", "osFilter", "osOfflineMax", "channelLink", "fixedLatency" })
             expect(hasId(id), juce::String(id) + " missing");
+
+        beginTest("Parameter snapshot reads handles and flags changes");
+        const audio::ParameterHandles h(proc.apvts);
+        expect(h.optional("thresholdL").isValid());
+        expect(!h.optional("noSuchParam").isValid());
+        expectEquals(h.optional("noSuchParam").get(-3.0f), -3.0f);
+
+        enum { kTh, kQ16, kN };
+        audio::ParamSnapshot<kN> snap;
+        snap.bind(kTh, h["thresholdL"]);
+        snap.bind(kQ16, h["q16"]);
+
+        expect(snap.update(), "first update reports every slot");
+        expect(snap.changed(kTh) && snap.changed(kQ16));
+        expect(!snap.update(), "no host change, no flags");
+
+        auto* th = proc.apvts.getParameter("thresholdL");
+        th->setValueNotifyingHost(th->convertTo0to1(-6.0f));
+        expect(snap.update());
+        expect(snap.changed(kTh) && !snap.changed(kQ16));
+        expectWithinAbsoluteError(snap[kTh], -6.0f, 1.0e-3f);
+
+        snap.invalidate();
+        snap.update();
+        expect(snap.changed(kTh, 2));
     }
 };
 
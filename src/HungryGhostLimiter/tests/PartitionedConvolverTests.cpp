@@ -0,0 +1,134 @@
+#include <juce_core/juce_core.h>
+#include <audio/PartitionedConvolver.h>
+#include <audio/RealFft.h>
+#include <audio/RealtimeSanitizer.h>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+namespace {
+
+// Two decaying noise IRs and a sparse noise input
+struct ConvolutionCase
+{
+    std::vector<float> h0, h1, x;
+
+    ConvolutionCase(int irLength, int inputLength, int seed)
+    {
+        juce::Random rng(seed);
+        h0.resize((size_t) irLength);
+        h1.resize((size_t) irLength);
+        for (int i = 0; i < irLength; ++i)
+        {
+            const float env = std::exp(-4.0f * (float) i / (float) irLength);
+            h0[(size_t) i] = (rng.nextFloat() * 2.0f - 1.0f) * env;
+            h1[(size_t) i] = (rng.nextFloat() * 2.0f - 1.0f) * env;
+        }
+        x.resize((size_t) inputLength);
+        for (auto& v : x)
+            v = rng.nextFloat() < 0.1f ? rng.nextFloat() * 2.0f - 1.0f : 0.0f;
+    }
+
+    double direct(const std::vector<float>& h, int t) const
+    {
+        double s = 0.0;
+        for (int k = 0; k < (int) h.size() && k <= t; ++k)
+            s += (double) h[(size_t) k] * (double) x[(size_t) (t - k)];
+        return s;
+    }
+};
+
+} // namespace
+
+struct RealFftTest : juce::UnitTest {
+    RealFftTest() : juce::UnitTest("CommonAudio: real FFT") {}
+    void runTest() override {
+        beginTest("forward() matches a DFT and inverse() undoes it");
+        for (int order = 2; order <= 10; ++order)
+        {
+            const int n = 1 << order;
+            audio::RealFft fft;
+            fft.prepare(order);
+            expectEquals(fft.getNumBins(), n / 2 + 1);
+
+            juce::Random rng(order);
+            std::vector<float> x((size_t) n), y((size_t) n), re((size_t) (n / 2 + 1)), im((size_t) (n / 2 + 1));
+            for (auto& v : x) v = rng.nextFloat() * 2.0f - 1.0f;
+            fft.forward(x.data(), re.data(), im.data());
+
+            double binErr = 0.0;
+            for (int k = 0; k <= n / 2; ++k)
+            {
+                std::complex<double> s;
+                for (int i = 0; i < n; ++i)
+                    s += (double) x[(size_t) i] * std::polar(1.0, -2.0 * juce::MathConstants<double>::pi * k * i / n);
+                const auto b = (size_t) fft.binIndex(k);
+                binErr = juce::jmax(binErr, std::abs(s - std::complex<double>(re[b], im[b])));
+            }
+            expectLessThan(binErr, 1.0e-4 * n);
+
+            fft.inverse(re.data(), im.data(), y.data());
+            float err = 0.0f;
+            for (int i = 0; i < n; ++i)
+                err = juce::jmax(err, std::abs(x[(size_t) i] - y[(size_t) i]));
+            expectLessThan(err, 1.0e-5f);
+        }
+    }
+};
+
+struct PartitionedConvolverTest : juce::UnitTest {
+    PartitionedConvolverTest() : juce::UnitTest("CommonAudio: partitioned convolver") {}
+    void runTest() override {
+        // Lengths around the head and level boundaries (64, 512, 2048, 8192 ..) and one long IR
+        for (int length : { 1, 64, 65, 511, 513, 3000, 9000, 150000 })
+            for (bool threaded : { false, true })
+            {
+                beginTest("Matches direct convolution, IR " + juce::String(length)
+                          + (threaded ? " samples, worker thread" : " samples, inline"));
+
+                ConvolutionCase c(length, length + 20000, length);
+                const float* irs[2] { c.h0.data(), c.h1.data() };
+                audio::PartitionedConvolver conv;
+                conv.prepare(irs, 2, length, threaded);
+                expectEquals(conv.getImpulseLength(), length);
+
+                const int n = (int) c.x.size();
+                std::vector<float> y0((size_t) n), y1((size_t) n);
+                juce::Random sizes(7);
+                {
+                    HG_RT_SCOPE("PartitionedConvolver::process");
+                    for (int t = 0; t < n;)
+                    {
+                        const int len = juce::jmin(n - t, 1 + sizes.nextInt(700));
+                        float* out[2] { y0.data() + t, y1.data() + t };
+                        conv.process(c.x.data() + t, out, len);
+                        t += len;
+                    }
+                }
+
+                // Zero latency: every sample, including the first, equals the direct sum
+                const int stride = length > 10000 ? 997 : 1;
+                double err = 0.0, peak = 0.0;
+                for (int t = 0; t < n; t += stride)
+                {
+                    const double r0 = c.direct(c.h0, t), r1 = c.direct(c.h1, t);
+                    err = juce::jmax(err, std::abs(r0 - y0[(size_t) t]), std::abs(r1 - y1[(size_t) t]));
+                    peak = juce::jmax(peak, std::abs(r0));
+                }
+                expectLessThan(err, 1.0e-6 * juce::jmax(1.0, peak) * std::sqrt((double) length));
+
+                // reset() starts over from silence
+                conv.reset();
+                std::vector<float> z0(4096), z1(4096);
+                float* out[2] { z0.data(), z1.data() };
+                conv.process(c.x.data(), out, 4096);
+                bool same = true;
+                for (size_t t = 0; t < z0.size(); ++t)
+                    same = same && z0[t] == y0[t] && z1[t] == y1[t];
+                expect(same, "output after reset() differs from the first run");
+            }
+    }
+};
+
+static RealFftTest realFftTest;
+static PartitionedConvolverTest partitionedConvolverTest;
@@ -0,0 +1,76 @@
+#include <juce_core/juce_core.h>
+#include <audio/Profiler.h>
+
+struct ProfilerTest : juce::UnitTest {
+    ProfilerTest() : juce::UnitTest("CommonAudio: scoped profiler") {}
+
+    static void spin(int iterations)
+    {
+        volatile float x = 0.0f;
+        for (int i = 0; i < iterations; ++i) x = x + 1.0f;
+    }
+
+    void runTest() override {
+        beginTest("Scopes land in per-stage, per-block-size stats and the trace");
+        {
+            audio::Profiler prof;
+            audio::ProfileCollector collector(prof);
+            for (int b = 0; b < 200; ++b)
+            {
+                const int n = (b & 1) ? 64 : 512;
+                audio::ScopedProfile block(&prof, "test.block", n);
+                { audio::ScopedProfile s(&prof, "test.stageA"); spin(200); }
+                { audio::ScopedProfile s(&prof, "test.stageB"); spin(2000); }
+                if (b % 50 == 49) collector.poll(); // ring holds ~5000 of these blocks
+            }
+            collector.poll();
+
+            const auto stats = collector.getStats();
+            expectEquals((int) stats.size(), 6, "three stages x two block sizes");
+            for (const auto& s : stats)
+            {
+                expectEquals((int) s.count, 100, s.stage);
+                expect(s.p50Us > 0.0 && s.p50Us <= s.p99Us && s.p99Us <= s.maxUs, s.stage + " percentiles ordered");
+            }
+            auto find = [&](const char* stage, int block) {
+                for (const auto& s : stats) if (s.stage == stage && s.blockSize == block) return s;
+                return audio::ProfileCollector::StageStats{};
+            };
+            expect(find("test.stageB", 64).p50Us > find("test.stageA", 64).p50Us, "10x the work takes longer");
+            expect(find("test.block", 512).p50Us >= find("test.stageB", 512).p50Us, "block scope encloses its stages");
+
+            const auto file = juce::File::createTempFile(".trace.json");
+            expect(collector.writeChromeTrace(file, "test"));
+            const auto json = juce::JSON::parse(file);
+            const auto* events = json["traceEvents"].getArray();
+            expect(events != nullptr && events->size() == 1 + 600, "metadata + one event per scope");
+            if (events != nullptr && events->size() > 1)
+            {
+                const auto& e = events->getReference(1);
+                expectEquals(e["ph"].toString(), juce::String("X"));
+                expect((double) e["dur"] >= 0.0);
+            }
+            file.deleteFile();
+        }
+
+        beginTest("A full ring drops events instead of blocking");
+        {
+            audio::Profiler prof;
+            for (std::uint32_t i = 0; i < audio::Profiler::kCapacity + 10; ++i)
+                audio::ScopedProfile s(&prof, "test.flood");
+            expectEquals((int) prof.getDroppedCount(), 10);
+            int drained = prof.drain([](const audio::ProfileEvent&) {});
+            expectEquals(drained, (int) audio::Profiler::kCapacity);
+            { audio::ScopedProfile s(&prof, "test.after"); }
+            expectEquals(prof.drain([](const audio::ProfileEvent&) {}), 1);
+        }
+
+        beginTest("A null profiler records nothing");
+        {
+            audio::ScopedProfile s(nullptr, "test.null");
+            expect(true);
+        }
+    }
+};
+
+static ProfilerTest profilerTest;
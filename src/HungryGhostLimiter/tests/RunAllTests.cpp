@@ -1,10 +1,11 @@
 #include <juce_core/juce_core.h>
 #include <juce_gui_basics/juce_gui_basics.h>
+#include <audio/RealtimeSanitizer.h>
 
 int main() {
     juce::ScopedJuceInitialiser_GUI gui;
-    juce::UnitTestRunner r;
+    audio::rtsan::TestRunner r;
     r.runAllTests();
-    return 0;
+    return r.finish();
 }
 
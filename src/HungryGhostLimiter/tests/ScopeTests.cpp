@@ -0,0 +1,164 @@
+#include <juce_core/juce_core.h>
+#include <juce_dsp/juce_dsp.h>
+#include <audio/MinMaxPyramid.h>
+#include <algorithm>
+#include <vector>
+#include "../Source/dsp/LimiterDSP.h"
+
+namespace {
+
+hgl::ScopeColumn bruteMerge(const std::vector<hgl::ScopeColumn>& cols, std::int64_t b, std::int64_t e)
+{
+    hgl::ScopeColumn out;
+    for (auto i = b; i < e; ++i)
+        out.merge(cols[(size_t)i]);
+    return out;
+}
+
+bool sameColumn(const hgl::ScopeColumn& a, const hgl::ScopeColumn& b)
+{
+    return a.inMin == b.inMin && a.inMax == b.inMax && a.outMin == b.outMin && a.outMax == b.outMax
+        && a.gainMinDb == b.gainMinDb && a.gainMaxDb == b.gainMaxDb;
+}
+
+} // namespace
+
+struct MinMaxPyramidTest : juce::UnitTest {
+    MinMaxPyramidTest() : juce::UnitTest("Scope: min/max pyramid") {}
+    void runTest() override {
+        juce::Random rng(11);
+        std::vector<hgl::ScopeColumn> cols(5000);
+        for (auto& c : cols)
+        {
+            const float a = rng.nextFloat() * 2.0f - 1.0f, b = rng.nextFloat() * 2.0f - 1.0f;
+            c.inMin = c.outMin = std::min(a, b);
+            c.inMax = c.outMax = std::max(a, b);
+            c.gainMinDb = -12.0f * rng.nextFloat();
+            c.gainMaxDb = c.gainMinDb * rng.nextFloat();
+        }
+
+        audio::MinMaxPyramid<hgl::ScopeColumn> pyramid;
+        pyramid.prepare(8192, 10);
+        for (const auto& c : cols)
+            pyramid.push(c);
+
+        beginTest("Any range reads as the merge of its base columns");
+        {
+            bool same = true;
+            for (int t = 0; t < 2000; ++t)
+            {
+                const auto b = (std::int64_t)rng.nextInt(5000);
+                const auto e = b + 1 + (std::int64_t)rng.nextInt((int)(5000 - b));
+                same = same && sameColumn(pyramid.read(b, e), bruteMerge(cols, b, e));
+            }
+            expect(same, "pyramid read differs from the brute-force merge");
+        }
+
+        beginTest("Pixels tile the columns at fractional and coarse zoom");
+        for (double cpp : { 0.37, 1.0, 7.3, 300.0 })
+        {
+            const int numPixels = (int)(5000 / cpp) - 1;
+            std::vector<hgl::ScopeColumn> px((size_t)numPixels);
+            pyramid.readPixels(0, cpp, px.data(), numPixels);
+
+            bool same = true;
+            for (int j = 0; j < numPixels; ++j)
+            {
+                const auto b = pyramid.pixelStart(j, cpp);
+                const auto e = std::max(pyramid.pixelStart(j + 1, cpp), b + 1);
+                same = same && sameColumn(px[(size_t)j], bruteMerge(cols, b, e));
+            }
+            expect(same, "pixel " + juce::String(cpp) + " columns wide differs");
+        }
+
+        beginTest("Columns that fell out of the history read as empty");
+        {
+            audio::MinMaxPyramid<hgl::ScopeColumn> small;
+            small.prepare(256, 6);
+            for (const auto& c : cols)
+                small.push(c);
+            expect(small.read(0, 1000).isEmpty());
+            expect(sameColumn(small.read(5000 - 200, 5000), bruteMerge(cols, 5000 - 200, 5000)));
+            expect(small.read(5000, 6000).isEmpty(), "future columns contribute nothing");
+        }
+    }
+};
+
+struct LimiterScopeStreamTest : juce::UnitTest {
+    LimiterScopeStreamTest() : juce::UnitTest("Scope: limiter column stream") {}
+    void runTest() override {
+        beginTest("One column per column length across odd blocks, matching the audio");
+
+        constexpr int kColumn = 48, kLook = 64, N = 48000;
+        hgl::LimiterParams p{};
+        p.preGainL = p.preGainR = juce::Decibels::decibelsToGain(6.0f);
+        p.ceilLin = juce::Decibels::decibelsToGain(-1.0f);
+        p.lookAheadSamplesOS = kLook;
+        p.releaseAlphaOS = std::exp(-1.0f / (0.05f * 48000.0f));
+        p.scHpfOn = false;
+
+        juce::Random rng(3);
+        std::vector<float> inL(N), inR(N);
+        for (int i = 0; i < N; ++i)
+        {
+            inL[(size_t)i] = 0.9f * std::sin(0.013f * (float)i) * (rng.nextFloat() * 0.5f + 0.5f);
+            inR[(size_t)i] = 0.7f * std::sin(0.021f * (float)i);
+        }
+
+        hgl::LimiterDSP plain, tapped;
+        auto fifo = std::make_unique<hgl::LimiterDSP::ScopeFifo>();
+        for (auto* lim : { &plain, &tapped })
+        {
+            lim->prepare(48000.0f, 512);
+            lim->setParams(p);
+        }
+        tapped.setScopeOutput(fifo.get(), kColumn);
+
+        std::vector<float> aL = inL, aR = inR, bL = inL, bR = inR;
+        std::vector<hgl::ScopeColumn> cols;
+        std::vector<hgl::ScopeColumn> drained(hgl::LimiterDSP::ScopeFifo::kCapacity);
+        for (int start = 0, blk = 0; start < N; ++blk)
+        {
+            const int n = std::min(N - start, (int)(1 + (blk * 131) % 700));
+            plain.processBlockOS(aL.data() + start, aR.data() + start, n);
+            tapped.processBlockOS(bL.data() + start, bR.data() + start, n);
+            const int got = fifo->pop(drained.data(), (int)drained.size());
+            cols.insert(cols.end(), drained.begin(), drained.begin() + got);
+            start += n;
+        }
+
+        expect(aL == bL && aR == bR, "the tap must not change the audio");
+        expectEquals((int)cols.size(), N / kColumn);
+
+        bool outOk = true, inOk = true, gainOk = true;
+        for (size_t k = 0; k < cols.size(); ++k)
+        {
+            float oMin = 1.0e9f, oMax = -1.0e9f, iMin = 1.0e9f, iMax = -1.0e9f;
+            for (size_t i = k * kColumn; i < (k + 1) * kColumn; ++i)
+            {
+                oMin = std::min({ oMin, bL[i], bR[i] });
+                oMax = std::max({ oMax, bL[i], bR[i] });
+                // Input side is the pre-gained signal after the look-ahead delay
+                const float xl = i >= (size_t)kLook ? inL[i - kLook] * p.preGainL : 0.0f;
+                const float xr = i >= (size_t)kLook ? inR[i - kLook] * p.preGainR : 0.0f;
+                iMin = std::min({ iMin, xl, xr });
+                iMax = std::max({ iMax, xl, xr });
+            }
+            const auto& c = cols[k];
+            outOk = outOk && c.outMin == oMin && c.outMax == oMax;
+            inOk = inOk && c.inMin == iMin && c.inMax == iMax;
+            gainOk = gainOk && c.gainMinDb <= c.gainMaxDb && c.gainMaxDb <= 0.0f;
+        }
+        expect(outOk, "output min/max differ from the rendered audio");
+        expect(inOk, "input min/max differ from the delayed, pre-gained input");
+        expect(gainOk, "gain range out of order or positive");
+
+        float deepest = 0.0f;
+        for (const auto& c : cols)
+            deepest = std::min(deepest, c.gainMinDb);
+        expect(deepest < -3.0f, "6 dB of drive into a -1 dB ceiling should show in the gain trace");
+    }
+};
+
+static MinMaxPyramidTest minMaxPyramidTest;
+static LimiterScopeStreamTest limiterScopeStreamTest;
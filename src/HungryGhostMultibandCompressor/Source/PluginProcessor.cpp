@@ -7,6 +7,7 @@
 #include "dsp/BandSplitterIIR.h"
 #include "dsp/CompressorBand.h"
 #include "dsp/Utilities.h"
+#include <audio/RealtimeSanitizer.h>
 
 namespace {
     inline int msToSamples(float ms, double sr) { return (int) std::round(ms * 0.001 * sr); }
@@ -21,6 +22,30 @@ HungryGhostMultibandCompressorAudioProcessor::HungryGhostMultibandCompressorAudi
       .withInput ("Sidechain", juce::AudioChannelSet::stereo(), false))
 {
     createFactoryPresets();
+    bindParameters();
+}
+
+void HungryGhostMultibandCompressorAudioProcessor::bindParameters()
+{
+    const audio::ParameterHandles h(apvts);
+
+    globals.bind(gBandCount, h["global.bandCount"]);
+    globals.bind(gLookAhead, h["global.lookAheadMs"]);
+    globals.bind(gOutputTrim, h["global.outputTrim_dB"]);
+    const auto xovers = h.family<kMaxCrossovers>("xover", "Hz");
+    for (int j = 0; j < kMaxCrossovers; ++j)
+        globals.bind(gXover1 + (size_t) j, xovers[(size_t) j]);
+
+    static constexpr const char* bandIds[kNumPerBand] = {
+        "threshold_dB", "ratio", "knee_dB", "attack_ms", "release_ms", "mix_pct", "bypass", "solo", "delta" };
+    for (int b = 0; b < kMaxBands; ++b)
+        for (size_t k = 0; k < kNumPerBand; ++k)
+            bandParams.bind(bandSlot(b, (BandParam) k), h.indexed("band", b + 1, bandIds[k]));
+
+    static constexpr const char* eqIds[kNumPerEq] = { "enabled", "type", "freq_hz", "gain_db", "q" };
+    for (int b = 0; b < kMaxEqBands; ++b)
+        for (size_t k = 0; k < kNumPerEq; ++k)
+            eqParams.bind(eqSlot(b, (EqParam) k), h.indexed("eq", b + 1, eqIds[k]));
 }
 
 HungryGhostMultibandCompressorAudioProcessor::~HungryGhostMultibandCompressorAudioProcessor() = default;
@@ -140,37 +165,25 @@ bool HungryGhostMultibandCompressorAudioProcessor::isBusesLayoutSupported(const
     return true;
 }
 
-void HungryGhostMultibandCompressorAudioProcessor::ensureBandBuffers(int numChannels, int numSamples)
+void HungryGhostMultibandCompressorAudioProcessor::prepareBandBuffers(int numChannels)
 {
+    // One dry/processed pair per possible band at the prepared block size: processBlock renders
+    // in chunks of at most maxBlockSize, so neither the vectors nor the buffers change there
     const int C = juce::jmax(2, numChannels);
-    const int N = juce::jmax(1, numSamples);
-    const int numBands = juce::jmax(1, bandCount);
-
-    // Ensure dry and processed buffers for each band
-    if ((int)bandDry.size() != numBands)
-        bandDry.resize((size_t) numBands);
-    if ((int)bandProc.size() != numBands)
-        bandProc.resize((size_t) numBands);
-
-    // Resize each band buffer
-    auto ensure = [&](juce::AudioBuffer<float>& b)
-    {
-        if (b.getNumChannels() != C || b.getNumSamples() < N)
-            b.setSize(C, N, false, true, true);
-    };
-
-    for (auto& b : bandDry) ensure(b);
-    for (auto& b : bandProc) ensure(b);
+    bandDry.resize((size_t) kMaxBands);
+    bandProc.resize((size_t) kMaxBands);
+    for (auto& b : bandDry) b.setSize(C, maxBlockSize, false, true, false);
+    for (auto& b : bandProc) b.setSize(C, maxBlockSize, false, true, false);
 }
 
 void HungryGhostMultibandCompressorAudioProcessor::prepareToPlay(double sr, int samplesPerBlockExpected)
 {
     sampleRateHz = (float) sr;
+    maxBlockSize = juce::jmax(1, samplesPerBlockExpected);
 
     // Initial latency report: look-ahead only for now
-    float la = 3.0f;
-    if (auto* v = apvts.getRawParameterValue("global.lookAheadMs")) la = v->load();
-    reportedLatency.store(msToSamples(la, sr));
+    globals.update();
+    reportedLatency.store(msToSamples(globals[gLookAhead], sr));
     setLatencySamples(reportedLatency.load());
 
     // Prepare DSP components for N-band support
@@ -187,10 +200,19 @@ void HungryGhostMultibandCompressorAudioProcessor::prepareToPlay(double sr, int
         compressors.push_back(std::move(comp));
     }
 
-    ensureBandBuffers(getTotalNumInputChannels(), samplesPerBlockExpected);
+    prepareBandBuffers(getTotalNumInputChannels());
 
-    // Reset EQ filters
-    for (auto& b : eq) { b.reset(); }
+    // EQ filters: give each a biquad now so later coefficient updates are in-place writes
+    // (no allocation, no order change), then rebuild every band on the next block
+    for (auto& b : eq)
+    {
+        for (auto& f : b.filt)
+            *f.coefficients = std::array<float, 6> { 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f }; // pass-through biquad
+        b.reset();
+    }
+    globals.invalidate();
+    bandParams.invalidate();
+    eqParams.invalidate();
 
     // Analyzer FIFO setup (mono rings ~2 seconds at 48k / decimate)
     const int ringSize = 48000 * 2 / analyzerDecimate;
@@ -202,25 +224,25 @@ void HungryGhostMultibandCompressorAudioProcessor::prepareToPlay(double sr, int
 
 void HungryGhostMultibandCompressorAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
 {
+    HG_RT_SCOPE("HungryGhostMultibandCompressorAudioProcessor::processBlock");
     juce::ScopedNoDenormals _;
 
     const int numSmps = buffer.getNumSamples();
     if (numSmps == 0) return;
+    HG_PROFILE_BLOCK(&profiling.profiler, "mbc.processBlock", numSmps);
 
-    const int numCh = juce::jmin(2, buffer.getNumChannels());
+    // Snapshot parameters (atomic loads only: no ID hashing, no allocation)
+    globals.update();
+    bandParams.update();
+    eqParams.update();
 
-    // Snapshot globals
-    bandCount = (int) juce::jlimit(1.0f, 6.0f, apvts.getRawParameterValue("global.bandCount")->load());
-    lookAheadMs = apvts.getRawParameterValue("global.lookAheadMs")->load();
+    bandCount = juce::jlimit(1, kMaxBands, globals.getInt(gBandCount));
+    lookAheadMs = globals[gLookAhead];
 
     // Read N crossover frequencies
-    crossoverHz.clear();
-    for (int j = 1; j < bandCount; ++j)
-    {
-        const juce::String id = "xover." + juce::String(j) + ".Hz";
-        if (auto* p = apvts.getRawParameterValue(id))
-            crossoverHz.push_back(p->load());
-    }
+    numCrossovers = bandCount - 1;
+    for (int j = 0; j < numCrossovers; ++j)
+        crossoverHz[(size_t) j] = globals[gXover1 + (size_t) j];
 
 
     // Update latency
@@ -231,19 +253,80 @@ void HungryGhostMultibandCompressorAudioProcessor::processBlock(juce::AudioBuffe
         setLatencySamples(laSamples);
     }
 
-    // Ensure working buffers and update splitter cutoff
-    ensureBandBuffers(numCh, numSmps);
-
-    // Extract first crossover frequency for 2-band split (band.1 is low, band.2 is high)
+    // Update splitter cutoff: first crossover frequency for 2-band split (band.1 is low, band.2 is high)
     // For M1: single crossover, bandDry[0]=low, bandDry[1]=high
-    float fcHz = 120.0f;
-    if (!crossoverHz.empty())
-        fcHz = crossoverHz[0];
-    splitter->setCrossoverHz(fcHz);
+    if (globals.changed(gBandCount) || globals.changed(gXover1))
+        splitter->setCrossoverHz(numCrossovers > 0 ? crossoverHz[0] : 120.0f);
+
+    // Configure every band, active or not: change flags last one update, so an edit to a band
+    // above global.bandCount must reach its compressor now, before the count brings it in.
+    // Time constants are only recomputed when the band's settings moved.
+    for (int b = 0; b < (int)compressors.size(); ++b)
+    {
+        if (bandParams.changed(bandSlot(b, bThreshold), kNumPerBand))
+        {
+            hgmbc::CompressorBandParams params;
+            params.threshold_dB = bandParams[bandSlot(b, bThreshold)];
+            params.ratio = bandParams[bandSlot(b, bRatio)];
+            params.knee_dB = bandParams[bandSlot(b, bKnee)];
+            params.attack_ms = bandParams[bandSlot(b, bAttack)];
+            params.release_ms = bandParams[bandSlot(b, bRelease)];
+            params.mix_pct = bandParams[bandSlot(b, bMix)];
+            compressors[b]->setParams(params);
+        }
+        compressors[b]->setLookaheadSamples(laSamples);
+    }
+
+    // EQ: recompute coefficients only when a band changed; written in place
+    auto coeffFor = [&](int type, float freq, float q, float gainDb)
+    {
+        using Coeff = juce::dsp::IIR::ArrayCoefficients<float>;
+        const double fs = (double) sampleRateHz;
+        switch (type)
+        {
+            case 0: return Coeff::makePeakFilter(fs, freq, q, juce::Decibels::decibelsToGain(gainDb));
+            case 1: return Coeff::makeLowShelf(fs, freq, q, juce::Decibels::decibelsToGain(gainDb));
+            case 2: return Coeff::makeHighShelf(fs, freq, q, juce::Decibels::decibelsToGain(gainDb));
+            case 3: return Coeff::makeLowPass(fs, freq, q);
+            case 4: return Coeff::makeHighPass(fs, freq, q);
+            case 5: return Coeff::makeNotch(fs, freq, q);
+            default: return Coeff::makePeakFilter(fs, freq, q, 1.0f);
+        }
+    };
+
+    for (int e = 0; e < kMaxEqBands; ++e)
+    {
+        if (eqParams.getBool(eqSlot(e, eEnabled)) && eqParams.changed(eqSlot(e, eEnabled), kNumPerEq))
+        {
+            const int type = eqParams.getInt(eqSlot(e, eType));
+            const float freq = eqParams[eqSlot(e, eFreq)];
+            const float gainDb = eqParams[eqSlot(e, eGain)];
+            const float q = eqParams[eqSlot(e, eQ)];
+
+            const auto coeff = coeffFor(type, juce::jlimit(20.0f, sampleRateHz * 0.45f, freq), juce::jlimit(0.1f, 10.0f, q), gainDb);
+            for (auto& f : eq[e].filt)
+                *f.coefficients = coeff;
+        }
+    }
+
+    // A host block longer than the prepared size is rendered in prepared-size chunks
+    for (int start = 0; start < numSmps; start += maxBlockSize)
+    {
+        juce::AudioBuffer<float> chunk(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), start,
+                                       juce::jmin(maxBlockSize, numSmps - start));
+        processChunk(chunk);
+    }
+}
+
+void HungryGhostMultibandCompressorAudioProcessor::processChunk(juce::AudioBuffer<float>& buffer)
+{
+    const int numSmps = buffer.getNumSamples();
+    const int numCh = juce::jmin(2, buffer.getNumChannels());
 
     // Push PRE analyzer mono samples (decimated) from input BEFORE splitting
     if (analyzerFifoPre)
     {
+        HG_PROFILE_SCOPE(&profiling.profiler, "mbc.analyzer");
         int write = analyzerFifoPre->getFreeSpace();
         int pushed = 0;
         for (int n = 0; n < numSmps && pushed < write; ++n)
@@ -259,44 +342,32 @@ void HungryGhostMultibandCompressorAudioProcessor::processBlock(juce::AudioBuffe
         }
     }
 
-    // Split input into 2 bands using the 2-band splitter API
-    // Ensure vectors have exactly 2 elements for M1
-    if ((int)bandDry.size() != 2)
-        bandDry.resize(2);
-    if ((int)bandProc.size() != 2)
-        bandProc.resize(2);
-
-    splitter->process(buffer, bandDry[0], bandDry[1]);
-    for (int b = 0; b < 2; ++b)
-        bandProc[b].makeCopyOf(bandDry[b], true);
+    // Split input into 2 bands using the 2-band splitter API (M1: only the first two
+    // of the preallocated band buffers are in use). Band buffers hold maxBlockSize samples;
+    // only the chunk's first numSmps are live.
+    constexpr int kSplitBands = 2;
+    const int activeBands = juce::jmin(bandCount, kSplitBands);
 
+    {
+        HG_PROFILE_SCOPE(&profiling.profiler, "mbc.bandSplit");
+        splitter->process(buffer, bandDry[0], bandDry[1]);
+        for (int b = 0; b < kSplitBands; ++b)
+            for (int ch = 0; ch < bandProc[b].getNumChannels(); ++ch)
+                bandProc[b].copyFrom(ch, 0, bandDry[b], ch, 0, numSmps);
+    }
 
-    // Configure and process per-band params
-    auto rp = [&](const juce::String& id) {
-        if (auto* p = apvts.getRawParameterValue(id)) return p->load();
-        return 0.0f;
-    };
-
-    for (int b = 0; b < bandCount && b < (int)compressors.size() && b < (int)bandProc.size(); ++b)
+    // Process the active bands
+    for (int b = 0; b < activeBands && b < (int)compressors.size(); ++b)
     {
-        const int bandNum = b + 1;
-        const juce::String pfx = "band." + juce::String(bandNum) + ".";
-
-        hgmbc::CompressorBandParams params;
-        params.threshold_dB = rp(pfx + "threshold_dB");
-        params.ratio = rp(pfx + "ratio");
-        params.knee_dB = rp(pfx + "knee_dB");
-        params.attack_ms = rp(pfx + "attack_ms");
-        params.release_ms = rp(pfx + "release_ms");
-        params.mix_pct = rp(pfx + "mix_pct");
-
-        compressors[b]->setParams(params);
-        compressors[b]->setLookaheadSamples(laSamples);
+        HG_PROFILE_SCOPE(&profiling.profiler, "mbc.band");
 
-        if (!(bool) (rp(pfx + "bypass") > 0.5f))
-            compressors[b]->process(bandProc[b]);
+        if (!bandParams.getBool(bandSlot(b, bBypass)))
+        {
+            juce::AudioBuffer<float> wet(bandProc[b].getArrayOfWritePointers(), bandProc[b].getNumChannels(), numSmps);
+            compressors[b]->process(wet);
+        }
 
-        if (rp(pfx + "delta") > 0.5f)
+        if (bandParams.getBool(bandSlot(b, bDelta)))
         {
             for (int ch = 0; ch < numCh; ++ch)
             {
@@ -313,22 +384,20 @@ void HungryGhostMultibandCompressorAudioProcessor::processBlock(juce::AudioBuffe
 
     // Solo logic
     int soloedBand = -1;
-    for (int b = 0; b < bandCount && b < 6; ++b)
+    for (int b = 0; b < bandCount && b < kMaxBands; ++b)
     {
-        const juce::String id = "band." + juce::String(b + 1) + ".solo";
-        if (auto* p = apvts.getRawParameterValue(id))
+        if (bandParams.getBool(bandSlot(b, bSolo)))
         {
-            if (p->load() > 0.5f)
-            {
-                soloedBand = b;
-                break;
-            }
+            soloedBand = b;
+            break;
         }
     }
 
     if (soloedBand >= 0)
     {
-        buffer.makeCopyOf(bandProc[soloedBand], true);
+        buffer.clear();
+        for (int ch = 0; ch < numCh; ++ch)
+            buffer.copyFrom(ch, 0, bandProc[soloedBand], ch, 0, numSmps);
     }
     else
     {
@@ -340,7 +409,7 @@ void HungryGhostMultibandCompressorAudioProcessor::processBlock(juce::AudioBuffe
             for (int n = 0; n < numSmps; ++n)
             {
                 float sum = 0.0f;
-                for (int b = 0; b < bandCount && b < (int)bandProc.size(); ++b)
+                for (int b = 0; b < activeBands; ++b)
                     sum += bandProc[b].getSample(ch, n);
                 out[n] = juce::jlimit(-2.0f, 2.0f, sum);
             }
@@ -349,48 +418,23 @@ void HungryGhostMultibandCompressorAudioProcessor::processBlock(juce::AudioBuffe
 
     // ===== Parallel EQ stage (after compressor) =====
     {
-        auto coeffFor = [&](int type, float freq, float q, float gainDb)
+        HG_PROFILE_SCOPE(&profiling.profiler, "mbc.eq");
+        for (int e = 0; e < kMaxEqBands; ++e)
         {
-            using Coeff = juce::dsp::IIR::Coefficients<float>;
-            const double fs = (double) sampleRateHz;
-            switch (type)
-            {
-                case 0: return Coeff::makePeakFilter(fs, freq, q, juce::Decibels::decibelsToGain(gainDb));
-                case 1: return Coeff::makeLowShelf(fs, freq, q, juce::Decibels::decibelsToGain(gainDb));
-                case 2: return Coeff::makeHighShelf(fs, freq, q, juce::Decibels::decibelsToGain(gainDb));
-                case 3: return Coeff::makeLowPass(fs, freq, q);
-                case 4: return Coeff::makeHighPass(fs, freq, q);
-                case 5: return Coeff::makeNotch(fs, freq, q);
-                default: return Coeff::makePeakFilter(fs, freq, q, 1.0f);
-            }
-        };
-
-        for (int bi = 1; bi <= kMaxEqBands; ++bi)
-        {
-            const juce::String pfx = "eq." + juce::String(bi) + ".";
-            const bool enabled = apvts.getRawParameterValue(pfx + "enabled")->load() > 0.5f;
-            if (!enabled) continue;
-            const int type = (int) apvts.getRawParameterValue(pfx + "type")->load();
-            const float freq = apvts.getRawParameterValue(pfx + "freq_hz")->load();
-            const float gainDb = apvts.getRawParameterValue(pfx + "gain_db")->load();
-            const float q = apvts.getRawParameterValue(pfx + "q")->load();
-
-            auto coeff = coeffFor(type, juce::jlimit(20.0f, sampleRateHz * 0.45f, freq), juce::jlimit(0.1f, 10.0f, q), gainDb);
-            for (int ch = 0; ch < numCh; ++ch)
-                eq[bi-1].filt[ch].coefficients = coeff;
+            if (!eqParams.getBool(eqSlot(e, eEnabled))) continue;
 
             juce::dsp::AudioBlock<float> blk(buffer);
             for (int ch = 0; ch < numCh; ++ch)
             {
                 auto cb = blk.getSingleChannelBlock((size_t) ch);
                 juce::dsp::ProcessContextReplacing<float> ctx(cb);
-                eq[bi-1].filt[ch].process(ctx);
+                eq[e].filt[ch].process(ctx);
             }
         }
     }
 
     // Global output trim
-    const float outTrimDb = apvts.getRawParameterValue("global.outputTrim_dB")->load();
+    const float outTrimDb = globals[gOutputTrim];
     const float g = juce::Decibels::decibelsToGain(outTrimDb);
     for (int ch = 0; ch < numCh; ++ch)
         buffer.applyGain(ch, 0, numSmps, g);
@@ -398,6 +442,7 @@ void HungryGhostMultibandCompressorAudioProcessor::processBlock(juce::AudioBuffe
     // Now push POST analyzer after EQ and output trim so yellow line reflects final output
     if (analyzerFifoPost)
     {
+        HG_PROFILE_SCOPE(&profiling.profiler, "mbc.analyzer");
         int write = analyzerFifoPost->getFreeSpace(); // in samples
         int pushed = 0;
         for (int n = 0; n < numSmps && pushed < write; ++n)
@@ -554,7 +599,9 @@ const juce::String HungryGhostMultibandCompressorAudioProcessor::getProgramName(
     return {};
 }
 
+#ifndef HG_MBC_HEADLESS_TEST // headless builds link several processors into one binary
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 {
     return new HungryGhostMultibandCompressorAudioProcessor();
 }
+#endif
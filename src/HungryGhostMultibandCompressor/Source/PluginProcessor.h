@@ -1,5 +1,7 @@
 #pragma once
 #include <JuceHeader.h>
+#include <audio/ParameterHandles.h>
+#include <audio/Profiler.h>
 
 namespace hgmbc { class BandSplitterIIR; class CompressorBand; }
 
@@ -42,10 +44,15 @@ public:
 
 private:
     float sampleRateHz = 44100.0f;
+    int maxBlockSize = 512; // prepared block size: band buffers hold this many samples
+
+    static constexpr int kMaxBands = 6;
+    static constexpr int kMaxCrossovers = kMaxBands - 1;
 
     // Global params (cached per block)
     int   bandCount = 2;
-    std::vector<float> crossoverHz;
+    std::array<float, kMaxCrossovers> crossoverHz {};
+    int   numCrossovers = 0;
     float lookAheadMs = 3.0f;
 
     // Factory presets
@@ -101,7 +108,29 @@ static constexpr int kMaxEqBands = 16;
     };
     EqBandProc eq[kMaxEqBands];
 
-    void ensureBandBuffers(int numChannels, int numSamples);
+    // ===== Parameter snapshots =====
+    // Handles resolved once in the constructor; processBlock loads each snapshot once per block.
+    // Indexed families (xover.N.Hz, band.N.*, eq.N.*) are laid out as fixed-stride slot groups.
+    enum GlobalParam : size_t { gBandCount, gLookAhead, gOutputTrim, gXover1, kNumGlobalParams = gXover1 + kMaxCrossovers };
+    enum BandParam : size_t { bThreshold, bRatio, bKnee, bAttack, bRelease, bMix, bBypass, bSolo, bDelta, kNumPerBand };
+    enum EqParam : size_t { eEnabled, eType, eFreq, eGain, eQ, kNumPerEq };
+    static constexpr size_t bandSlot(int band, BandParam p) noexcept { return (size_t) band * kNumPerBand + p; }
+    static constexpr size_t eqSlot(int band, EqParam p) noexcept { return (size_t) band * kNumPerEq + p; }
+
+    audio::ParamSnapshot<kNumGlobalParams> globals;
+    audio::ParamSnapshot<kNumPerBand * kMaxBands> bandParams;
+    audio::ParamSnapshot<kNumPerEq * kMaxEqBands> eqParams;
+    void bindParameters();
+
+    // Sizes bandDry/bandProc for maxBlockSize samples; prepareToPlay only
+    void prepareBandBuffers(int numChannels);
+    // Renders one chunk of at most maxBlockSize samples with the block's parameters
+    void processChunk(juce::AudioBuffer<float>& buffer);
+
+   #if HG_PROFILING
+    // Per-stage timings, written to a trace when the instance is destroyed (see audio/Profiler.h)
+    audio::ProfileSession profiling { "HungryGhostMultibandCompressor" };
+   #endif
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(HungryGhostMultibandCompressorAudioProcessor)
 };
@@ -1,5 +1,6 @@
 #pragma once
 #include <juce_dsp/juce_dsp.h>
+#include <audio/RealtimeSanitizer.h>
 #include <vector>
 
 namespace hgmbc {
@@ -29,22 +30,23 @@ public:
     void setCrossoverHz(float fc)
     {
         fcHz = juce::jlimit(20.0f, (float) (0.45 * sampleRate), fc);
-        auto lpCoefs = juce::dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, fcHz);
-        auto hpCoefs = juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, fcHz);
+        // Written into each filter's own coefficient object: no allocation, safe per block
+        const auto lpCoefs = juce::dsp::IIR::ArrayCoefficients<float>::makeLowPass(sampleRate, fcHz);
+        const auto hpCoefs = juce::dsp::IIR::ArrayCoefficients<float>::makeHighPass(sampleRate, fcHz);
         for (auto& ch : chans)
         {
-            ch.lp1.coefficients = lpCoefs; ch.lp2.coefficients = lpCoefs;
-            ch.hp1.coefficients = hpCoefs; ch.hp2.coefficients = hpCoefs;
+            *ch.lp1.coefficients = lpCoefs; *ch.lp2.coefficients = lpCoefs;
+            *ch.hp1.coefficients = hpCoefs; *ch.hp2.coefficients = hpCoefs;
         }
     }
 
-    // Process: src -> low & high (both must be allocated with same layout as src)
+    // Process: src -> low & high, written over src's samples. Both must already hold at least
+    // src's samples; channels beyond src's (or the prepared count) are cleared.
     void process(const juce::AudioBuffer<float>& src, juce::AudioBuffer<float>& low, juce::AudioBuffer<float>& high)
     {
-        const int N = src.getNumSamples();
-        const int C = juce::jmin(src.getNumChannels(), numChannels);
-        low.makeCopyOf(src, true);
-        high.makeCopyOf(src, true);
+        HG_RT_SCOPE("hgmbc::BandSplitterIIR::process");
+        const int N = juce::jmin(src.getNumSamples(), low.getNumSamples(), high.getNumSamples());
+        const int C = juce::jmin(src.getNumChannels(), numChannels, juce::jmin(low.getNumChannels(), high.getNumChannels()));
         for (int ch = 0; ch < C; ++ch)
         {
             const float* srcPtr = src.getReadPointer(ch);
@@ -88,52 +90,52 @@ public:
         }
     }
 
-    // N-band process: Split input into multiple bands using cascaded crossovers
+    // N-band process: Split input into multiple bands using cascaded crossovers. `bands` holds
+    // getNumBands() buffers sized up front with at least src's samples; only those are written.
     void process(const juce::AudioBuffer<float>& src, std::vector<juce::AudioBuffer<float>>& bands)
     {
-        const int N = src.getNumSamples();
-        const int C = juce::jmin(src.getNumChannels(), numChannels);
-        const int numBands = numCrossovers + 1;
-
-        // Ensure output vector has correct size
-        if ((int)bands.size() != numBands)
-            bands.resize(numBands);
-        for (auto& band : bands)
-            band.setSize(src.getNumChannels(), N, false, true);
+        HG_RT_SCOPE("hgmbc::BandSplitterIIR::process");
+        const int numBands = juce::jmin(numCrossovers + 1, (int) bands.size());
+        if (numBands == 0)
+            return;
+        int N = src.getNumSamples();
+        int C = juce::jmin(src.getNumChannels(), numChannels);
+        for (int b = 0; b < numBands; ++b)
+        {
+            N = juce::jmin(N, bands[(size_t) b].getNumSamples());
+            C = juce::jmin(C, bands[(size_t) b].getNumChannels());
+        }
 
-        // Initialize all bands as copies of input
-        for (auto& band : bands)
-            band.makeCopyOf(src, true);
+        // Band 0 starts as the input; every band's extra channels are silent
+        for (int ch = 0; ch < C; ++ch)
+            bands[0].copyFrom(ch, 0, src, ch, 0, N);
+        for (int b = 0; b < numBands; ++b)
+            for (int ch = C; ch < bands[(size_t) b].getNumChannels(); ++ch)
+                bands[(size_t) b].clear(ch, 0, N);
 
         // Process cascaded stages: each stage splits one band into two
         // Stage 0: splits bands[0] into low (stays in bands[0]) and high (goes to bands[1])
         // Stage 1: splits bands[1] into low (stays in bands[1]) and high (goes to bands[2])
         // etc.
-        for (int stage = 0; stage < numCrossovers; ++stage)
+        // The complementary high part is written straight into the next band (no temporary buffer)
+        for (int stage = 0; stage + 1 < numBands; ++stage)
         {
-            juce::AudioBuffer<float> tempHigh(C, N);
-            tempHigh.makeCopyOf(bands[stage], true);
-
             for (int ch = 0; ch < C; ++ch)
             {
                 float* bandPtr = bands[stage].getWritePointer(ch);
-                float* highPtr = tempHigh.getWritePointer(ch);
+                float* highPtr = bands[stage + 1].getWritePointer(ch);
                 auto& c = chans[(size_t)ch];
 
                 for (int n = 0; n < N; ++n)
                 {
+                    const float x = bandPtr[n];
                     // Low-pass for current band
-                    const float lp = c.lpStages[stage][1].processSample(
-                        c.lpStages[stage][0].processSample(bandPtr[n]));
+                    const float lp = c.lpStages[stage][1].processSample(c.lpStages[stage][0].processSample(x));
                     bandPtr[n] = lp;
                     // High-pass (complementary)
-                    highPtr[n] = highPtr[n] - lp;
+                    highPtr[n] = x - lp;
                 }
             }
-
-            // Move high band to next output
-            if (stage + 1 < (int)bands.size())
-                bands[stage + 1].makeCopyOf(tempHigh, true);
         }
     }
 
@@ -1,5 +1,6 @@
 #pragma once
 #include <juce_dsp/juce_dsp.h>
+#include <audio/RealtimeSanitizer.h>
 #include "Utilities.h"
 
 namespace hgmbc {
@@ -57,6 +58,7 @@ public:
     // In-place process on band; detectorInput optional for external sidechain
     void process(juce::AudioBuffer<float>& band, const juce::AudioBuffer<float>* detectorInput = nullptr)
     {
+        HG_RT_SCOPE("hgmbc::CompressorBand::process");
         const int N = band.getNumSamples();
         const int C = juce::jmin(band.getNumChannels(), numChannels);
         const float mix = juce::jlimit(0.0f, 100.0f, params.mix_pct) * 0.01f;
@@ -89,6 +89,148 @@ public:
     }
 };
 
+class ProcessorEqUpdateTest : public UnitTest
+{
+public:
+    ProcessorEqUpdateTest() : UnitTest("MBC Processor EQ Updates") {}
+    void runTest() override
+    {
+        beginTest("EQ gain changes between blocks take effect");
+        const double sr = 48000.0; const int block = 512; const int C = 2;
+        HungryGhostMultibandCompressorAudioProcessor proc;
+        proc.prepareToPlay(sr, block);
+
+        auto set = [&](const char* id, float v) {
+            auto* p = proc.apvts.getParameter(id);
+            p->setValueNotifyingHost(p->convertTo0to1(v));
+        };
+        set("eq.1.freq_hz", 1000.0f);
+        set("eq.1.gain_db", 12.0f);
+
+        // 1 kHz at -30 dBFS: below every band threshold, so the output level is the EQ's
+        double phase = 0.0;
+        auto render = [&](int numBlocks) {
+            AudioBuffer<float> buf(C, block); MidiBuffer midi;
+            for (int i = 0; i < numBlocks; ++i)
+            {
+                for (int n = 0; n < block; ++n)
+                {
+                    const float s = Decibels::decibelsToGain(-30.0f) * (float) std::sin(phase);
+                    phase += 2.0 * MathConstants<double>::pi * 1000.0 / sr;
+                    for (int ch = 0; ch < C; ++ch) buf.setSample(ch, n, s);
+                }
+                proc.processBlock(buf, midi);
+            }
+            return Decibels::gainToDecibels(rms(buf) + 1e-9f);
+        };
+
+        const float boosted = render(40);
+        set("eq.1.gain_db", 0.0f);
+        const float flat = render(40);
+        expectWithinAbsoluteError(boosted - flat, 12.0f, 1.0f);
+    }
+};
+
+class ProcessorBandParamsTest : public UnitTest
+{
+public:
+    ProcessorBandParamsTest() : UnitTest("MBC Processor Band Params") {}
+    void runTest() override
+    {
+        beginTest("Band edits above the band count apply when the count brings the band in");
+        const double sr = 48000.0; const int block = 512; const int C = 2;
+
+        // 5 kHz at -12 dBFS sits in band 2 (crossover 120 Hz); band 2 squashes it hard
+        auto render = [&](HungryGhostMultibandCompressorAudioProcessor& proc, int numBlocks) {
+            AudioBuffer<float> buf(C, block); MidiBuffer midi;
+            double phase = 0.0;
+            for (int i = 0; i < numBlocks; ++i)
+            {
+                for (int n = 0; n < block; ++n)
+                {
+                    const float s = Decibels::decibelsToGain(-12.0f) * (float) std::sin(phase);
+                    phase += 2.0 * MathConstants<double>::pi * 5000.0 / sr;
+                    for (int ch = 0; ch < C; ++ch) buf.setSample(ch, n, s);
+                }
+                proc.processBlock(buf, midi);
+            }
+            return Decibels::gainToDecibels(rms(buf) + 1e-9f);
+        };
+        auto set = [](HungryGhostMultibandCompressorAudioProcessor& proc, const char* id, float v) {
+            auto* p = proc.apvts.getParameter(id);
+            p->setValueNotifyingHost(p->convertTo0to1(v));
+        };
+        auto squashBand2 = [&](HungryGhostMultibandCompressorAudioProcessor& proc) {
+            set(proc, "band.2.threshold_dB", -50.0f);
+            set(proc, "band.2.ratio", 20.0f);
+        };
+
+        // Reference: band 2 edited while it is active
+        HungryGhostMultibandCompressorAudioProcessor ref;
+        ref.prepareToPlay(sr, block);
+        set(ref, "global.bandCount", 2.0f);
+        squashBand2(ref);
+        const float expected = render(ref, 40);
+
+        // Band 2 edited while the count is 1, then brought in
+        HungryGhostMultibandCompressorAudioProcessor proc;
+        proc.prepareToPlay(sr, block);
+        set(proc, "global.bandCount", 1.0f);
+        render(proc, 2);
+        squashBand2(proc);
+        render(proc, 2);
+        set(proc, "global.bandCount", 2.0f);
+        const float actual = render(proc, 40);
+
+        expectLessThan(expected, -20.0f);
+        expectWithinAbsoluteError(actual, expected, 0.5f);
+    }
+};
+
+class ProcessorHostBlockTest : public UnitTest
+{
+public:
+    ProcessorHostBlockTest() : UnitTest("MBC Processor Host Blocks") {}
+    void runTest() override
+    {
+        beginTest("Any host block size renders the same audio without allocating");
+        const double sr = 48000.0; const int block = 256; const int C = 2; const int total = 16384;
+
+        // Compressing noise burst through both bands; the sanitizer fails the test on any
+        // allocation or lock inside processBlock
+        AudioBuffer<float> input(C, total);
+        Random rng(11);
+        for (int n = 0; n < total; ++n)
+        {
+            const float s = (n / 2048) % 2 == 0 ? 0.8f * (rng.nextFloat() * 2.0f - 1.0f) : 0.0f;
+            for (int ch = 0; ch < C; ++ch) input.setSample(ch, n, s);
+        }
+
+        auto render = [&](std::initializer_list<int> hostBlocks) {
+            HungryGhostMultibandCompressorAudioProcessor proc;
+            proc.prepareToPlay(sr, block);
+            AudioBuffer<float> out(input); MidiBuffer midi;
+            for (int done = 0, i = 0; done < total; ++i)
+            {
+                const int n = jmin(total - done, *(hostBlocks.begin() + (i % (int) hostBlocks.size())));
+                AudioBuffer<float> view(out.getArrayOfWritePointers(), C, done, n);
+                proc.processBlock(view, midi);
+                done += n;
+            }
+            return out;
+        };
+
+        const auto expected = render({ block });
+        const auto actual = render({ 1000, 37, 3 * block + 5, block, 1 });
+        float err = 0.0f;
+        for (int ch = 0; ch < C; ++ch)
+            for (int n = 0; n < total; ++n)
+                err = jmax(err, std::abs(expected.getSample(ch, n) - actual.getSample(ch, n)));
+        expectLessThan(err, 1.0e-5f);
+        expectGreaterThan(rms(expected), 0.01f);
+    }
+};
+
 // Latency test disabled for now due to JUCE timer/shutdown assertions in console harness on some setups.
 // class LatencyReportTest : public UnitTest
 // {
@@ -97,12 +239,15 @@ public:
 
 static CrossoverNullTest   crossoverNullTest;
 static StaticGRTest        staticGRTest;
+static ProcessorEqUpdateTest processorEqUpdateTest;
+static ProcessorBandParamsTest processorBandParamsTest;
+static ProcessorHostBlockTest processorHostBlockTest;
 // static LatencyReportTest   latencyReportTest;
 
 int main (int, char**)
 {
     ConsoleApplication app;
-    UnitTestRunner runner;
+    audio::rtsan::TestRunner runner;
     runner.runAllTests();
-    return 0;
+    return runner.finish();
 }
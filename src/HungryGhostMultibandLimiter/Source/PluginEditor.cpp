@@ -10,7 +10,8 @@ HungryGhostMultibandLimiterAudioProcessorEditor::HungryGhostMultibandLimiterAudi
     metersPanel = std::make_unique<MetersPanel>();
     addAndMakeVisible(*metersPanel);
 
-    // Start timer for meter updates at 60 Hz
+    // Start timer for meter updates at 60 Hz (records queued before the editor opened are stale)
+    processor.getMeterFifo().discardAll();
     startTimerHz(60);
 
     setSize(800, 600);
@@ -40,15 +41,24 @@ void HungryGhostMultibandLimiterAudioProcessorEditor::timerCallback()
     if (!metersPanel)
         return;
 
+    // Merge every record since the last tick so short peaks and GR spikes are never skipped
+    const int n = processor.getMeterFifo().pop(meterRecords.data(), (int) meterRecords.size());
+    if (n == 0)
+        return;
+
+    auto sum = meterRecords[0];
+    for (int i = 1; i < n; ++i)
+        sum.merge(meterRecords[(size_t) i]);
+
     // Per-band data (2 bands for M1)
-    for (int b = 0; b < 2; ++b)
+    for (int b = 0; b < HungryGhostMultibandLimiterAudioProcessor::kMeterBands; ++b)
     {
-        metersPanel->setBandInputDb(b, processor.getBandInputDb(b));
-        metersPanel->setBandGrDb(b, processor.getBandGainReductionDb(b));
-        metersPanel->setBandOutputDb(b, processor.getBandOutputDb(b));
+        metersPanel->setBandInputDb(b, sum.bandIn.peakDb(b, -60.0f));
+        metersPanel->setBandGrDb(b, sum.bandOut.grMaxDb[(size_t) b]);
+        metersPanel->setBandOutputDb(b, sum.bandOut.peakDb(b, -60.0f));
     }
 
     // Master levels
-    metersPanel->setMasterInputDb(processor.getMasterInputDb());
-    metersPanel->setMasterOutputDb(processor.getMasterOutputDb());
+    metersPanel->setMasterInputDb(sum.master.peakDb(0, -60.0f));
+    metersPanel->setMasterOutputDb(sum.master.peakDb(1, -60.0f));
 }
@@ -28,6 +28,8 @@ private:
 
     // Timer for updating meter data from processor
     void timerCallback() override;
+    std::array<HungryGhostMultibandLimiterAudioProcessor::MeterRecord,
+               HungryGhostMultibandLimiterAudioProcessor::MeterFifo::kCapacity> meterRecords;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(HungryGhostMultibandLimiterAudioProcessorEditor)
 };
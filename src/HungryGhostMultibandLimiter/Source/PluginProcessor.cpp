@@ -2,6 +2,7 @@
 #ifndef HG_MBL_HEADLESS_TEST
 #include "PluginEditor.h"
 #endif
+#include <audio/RealtimeSanitizer.h>
 
 //==============================================================================
 
@@ -10,6 +11,17 @@ HungryGhostMultibandLimiterAudioProcessor::HungryGhostMultibandLimiterAudioProce
         .withInput("Input", juce::AudioChannelSet::stereo(), true)
         .withOutput("Output", juce::AudioChannelSet::stereo(), true))
 {
+    const audio::ParameterHandles h(apvts);
+    params.bind(pBandCount, h["global.bandCount"]);
+    params.bind(pCrossover1, h["xover.1.Hz"]);
+    params.bind(pOversampling, h["global.oversampling"]);
+    params.bind(pLookAhead, h["global.lookAheadMs"]);
+    params.bind(pOutputTrim, h["global.outputTrim_dB"]);
+
+    static constexpr const char* bandIds[kNumPerBand] = { "threshold_dB", "attack_ms", "release_ms", "mix_pct", "bypass", "solo" };
+    for (int b = 0; b < kMaxBands; ++b)
+        for (size_t k = 0; k < kNumPerBand; ++k)
+            params.bind(bandSlot(b, (BandParam) k), h.indexed("band", b + 1, bandIds[k]));
 }
 
 //==============================================================================
@@ -25,102 +37,123 @@ bool HungryGhostMultibandLimiterAudioProcessor::isBusesLayoutSupported(const Bus
 void HungryGhostMultibandLimiterAudioProcessor::prepareToPlay(double sr, int samplesPerBlockExpected)
 {
     sampleRateHz = sr;
-    this->samplesPerBlockExpected = samplesPerBlockExpected;
+    this->samplesPerBlockExpected = juce::jmax(1, samplesPerBlockExpected);
 
     // ===== STORY-MBL-002: Initialize band splitter =====
     splitter = std::make_unique<hgml::BandSplitterIIR>();
     splitter->prepare(sr, 2);  // Stereo input
 
     // Configure with initial crossover frequency from parameters
-    cachedCrossoverHz = apvts.getRawParameterValue("xover.1.Hz")->load();
+    params.update();
+    cachedCrossoverHz = params[pCrossover1];
     splitter->setCrossoverHz(cachedCrossoverHz);
 
+    // Size band buffers here for every band count: processBlock renders in chunks of at most
+    // the prepared block size, so it only reuses them
+    hgml::BandSplitterIIR::prepareBands(bandBuffers, 2, this->samplesPerBlockExpected);
+
     // ===== STORY-MBL-003: Initialize per-band limiters =====
-    for (int b = 0; b < limiters.size(); ++b)
+    for (int b = 0; b < (int) limiters.size(); ++b)
     {
         limiters[b].prepare((float)sr);
     }
+
+    meterRecord.clear();
+    meterRecordSamples = juce::jmax(1, (int) std::round(sr * 0.005));
+
+    // Time constants depend on the rate: make the next block re-apply every band's params
+    params.invalidate();
 }
 
 //==============================================================================
 
 void HungryGhostMultibandLimiterAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
 {
+    HG_RT_SCOPE("HungryGhostMultibandLimiterAudioProcessor::processBlock");
     juce::ScopedNoDenormals noDenormals;
 
-    // Update cached parameter values
-    cachedBandCount = apvts.getRawParameterValue("global.bandCount")->load();
-    cachedCrossoverHz = apvts.getRawParameterValue("xover.1.Hz")->load();
-    cachedOversamplingFactor = 1 << apvts.getRawParameterValue("global.oversampling")->load(); // 1x, 2x, 4x
-    cachedLookAheadMs = apvts.getRawParameterValue("global.lookAheadMs")->load();
-
-    // ===== STORY-MBL-002: Band splitting =====
-    // Ensure band buffers are properly sized for this block
-    ensureBandBuffers(buffer.getNumChannels(), buffer.getNumSamples());
+    // Update cached parameter values (one atomic load each, no ID lookups)
+    params.update();
+    cachedBandCount = params.getInt(pBandCount);
+    cachedCrossoverHz = params[pCrossover1];
+    cachedOversamplingFactor = 1 << params.getInt(pOversampling); // 1x, 2x, 4x
+    cachedLookAheadMs = params[pLookAhead];
 
     // Update crossover frequency if changed
-    if (juce::jabs(cachedCrossoverHz - splitter->getCrossoverHz()) > 0.01f)
+    if (std::abs(cachedCrossoverHz - splitter->getCrossoverHz()) > 0.01f)
     {
         splitter->setCrossoverHz(cachedCrossoverHz);
     }
 
-    // Split input into bands
+    // Reconfigure a band's limiter only when one of its parameters moved
+    for (int b = 0; b < juce::jmin(splitter->getNumBands(), (int)limiters.size()); ++b)
+    {
+        if (params.changed(bandSlot(b, bThreshold), kNumPerBand))
+        {
+            hgml::LimiterBandParams bp;
+            bp.thresholdDb = params[bandSlot(b, bThreshold)];
+            bp.attackMs = params[bandSlot(b, bAttack)];
+            bp.releaseMs = params[bandSlot(b, bRelease)];
+            bp.mixPct = params[bandSlot(b, bMix)];
+            bp.bypass = params.getBool(bandSlot(b, bBypass));
+            limiters[b].setParams(bp);
+        }
+    }
+
+    // A host block longer than the prepared size is rendered in prepared-size chunks
+    const int numSamples = buffer.getNumSamples();
+    for (int start = 0; start < numSamples; start += samplesPerBlockExpected)
+    {
+        juce::AudioBuffer<float> chunk(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), start,
+                                       juce::jmin(samplesPerBlockExpected, numSamples - start));
+        processChunk(chunk);
+    }
+}
+
+void HungryGhostMultibandLimiterAudioProcessor::processChunk(juce::AudioBuffer<float>& buffer)
+{
+    // ===== STORY-MBL-002: Band splitting =====
+    // Split input into bands: bandBuffers hold the prepared block size, the first numSamples
+    // of the first numBands are this chunk's
+    const int numBands = splitter->getNumBands();
     splitter->process(buffer, bandBuffers);
 
     // ===== STORY-MBL-007: Compute level metering data =====
-    // Master input level (before splitting)
-    float masterPeak = 0.0f;
-    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
-        masterPeak = juce::jmax(masterPeak, buffer.getMagnitude(ch, 0, buffer.getNumSamples()));
-    masterInputDb.store(juce::Decibels::gainToDecibels(juce::jmax(masterPeak, 1.0e-6f)));
-
-    // Per-band input levels
-    auto computeDb = [](const juce::AudioBuffer<float>& buf) -> float {
-        float peak = 0.0f;
+    // Master input level (before splitting) and per-band input levels, channels averaged
+    const int numSamples = buffer.getNumSamples();
+    const auto addLevels = [numSamples](auto& frame, int lane, const juce::AudioBuffer<float>& buf) {
+        const float weight = 1.0f / (float) juce::jmax(1, buf.getNumChannels());
         for (int ch = 0; ch < buf.getNumChannels(); ++ch)
-            peak = juce::jmax(peak, buf.getMagnitude(ch, 0, buf.getNumSamples()));
-        return juce::Decibels::gainToDecibels(juce::jmax(peak, 1.0e-6f));
+            frame.addLevels(lane, buf.getReadPointer(ch), numSamples, weight);
     };
-    for (size_t b = 0; b < bandBuffers.size() && b < 6; ++b)
-        bandInputDb[b].store(computeDb(bandBuffers[b]));
+    addLevels(meterRecord.master, 0, buffer);
+    for (int b = 0; b < juce::jmin(numBands, kMeterBands); ++b)
+        addLevels(meterRecord.bandIn, b, bandBuffers[(size_t) b]);
 
     // ===== STORY-MBL-003: Per-band limiting and recombination =====
     // Apply limiting to each band
-    for (int b = 0; b < juce::jmin((int)bandBuffers.size(), (int)limiters.size()); ++b)
+    for (int b = 0; b < juce::jmin(numBands, (int)limiters.size()); ++b)
     {
-        // Read parameters for this band from APVTS
-        const auto id = [b](const char* name){ return juce::String("band.") + juce::String(b + 1) + "." + name; };
-
-        float thresholdDb = apvts.getRawParameterValue(id("threshold_dB"))->load();
-        float attackMs = apvts.getRawParameterValue(id("attack_ms"))->load();
-        float releaseMs = apvts.getRawParameterValue(id("release_ms"))->load();
-        float mixPct = apvts.getRawParameterValue(id("mix_pct"))->load();
-        bool bypass = *apvts.getRawParameterValue(id("bypass")) > 0.5f;
-
-        // Configure limiter with current parameters
-        hgml::LimiterBandParams params;
-        params.thresholdDb = thresholdDb;
-        params.attackMs = attackMs;
-        params.releaseMs = releaseMs;
-        params.mixPct = mixPct;
-        params.bypass = bypass;
-        limiters[b].setParams(params);
-
         // Process the band through the limiter
-        float maxGrDb = limiters[b].processBlock(bandBuffers[b]);
+        juce::AudioBuffer<float> band(bandBuffers[b].getArrayOfWritePointers(), bandBuffers[b].getNumChannels(), numSamples);
+        float maxGrDb = limiters[b].processBlock(band);
 
         // Store gain reduction for metering
-        if (b < 6)
-            bandGainReductionDb[b].store(maxGrDb);
+        meterRecord.bandOut.addGainReduction(b, maxGrDb);
     }
 
     // Recombine limited bands back to output
     // Start with low band
-    if (bandBuffers.size() >= 1)
-        buffer.makeCopyOf(bandBuffers[0], true);
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+    {
+        if (ch < bandBuffers[0].getNumChannels())
+            buffer.copyFrom(ch, 0, bandBuffers[0], ch, 0, numSamples);
+        else
+            buffer.clear(ch, 0, numSamples);
+    }
 
     // Add high band(s) to output
-    for (size_t b = 1; b < bandBuffers.size(); ++b)
+    for (int b = 1; b < numBands; ++b)
     {
         for (int ch = 0; ch < juce::jmin(buffer.getNumChannels(), bandBuffers[b].getNumChannels()); ++ch)
         {
@@ -134,21 +167,17 @@ void HungryGhostMultibandLimiterAudioProcessor::processBlock(juce::AudioBuffer<f
     // ===== STORY-MBL-004: Solo and Delta routing =====
     // Check if any band is soloed
     bool anyBandSoloed = false;
-    for (int b = 0; b < juce::jmin((int)bandBuffers.size(), (int)limiters.size()); ++b)
+    for (int b = 0; b < juce::jmin(numBands, (int)limiters.size()); ++b)
     {
-        const auto id = [b](const char* name){ return juce::String("band.") + juce::String(b + 1) + "." + name; };
-        bool solo = *apvts.getRawParameterValue(id("solo")) > 0.5f;
-        if (solo) { anyBandSoloed = true; break; }
+        if (params.getBool(bandSlot(b, bSolo))) { anyBandSoloed = true; break; }
     }
 
     // Apply solo routing: zero out non-soloed bands if any are soloed
     if (anyBandSoloed)
     {
-        for (int b = 0; b < juce::jmin((int)bandBuffers.size(), (int)limiters.size()); ++b)
+        for (int b = 0; b < juce::jmin(numBands, (int)limiters.size()); ++b)
         {
-            const auto id = [b](const char* name){ return juce::String("band.") + juce::String(b + 1) + "." + name; };
-            bool solo = *apvts.getRawParameterValue(id("solo")) > 0.5f;
-            if (!solo)
+            if (!params.getBool(bandSlot(b, bSolo)))
             {
                 // Zero out this band since it's not soloed
                 for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
@@ -166,8 +195,8 @@ void HungryGhostMultibandLimiterAudioProcessor::processBlock(juce::AudioBuffer<f
     // Requires storing original split band before limiting
 
     // ===== STORY-MBL-004: Apply output trim (make-up gain) =====
-    float outputTrimDb = apvts.getRawParameterValue("global.outputTrim_dB")->load();
-    if (juce::jabs(outputTrimDb) > 0.01f)
+    const float outputTrimDb = params[pOutputTrim];
+    if (std::abs(outputTrimDb) > 0.01f)
     {
         float trimGain = hgml::dbToLin(outputTrimDb);
         for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
@@ -178,15 +207,19 @@ void HungryGhostMultibandLimiterAudioProcessor::processBlock(juce::AudioBuffer<f
         }
     }
 
-    // ===== STORY-MBL-007: Compute band output levels =====
-    for (size_t b = 0; b < bandBuffers.size() && b < 6; ++b)
-        bandOutputDb[b].store(computeDb(bandBuffers[b]));
+    // ===== STORY-MBL-007: Compute band and master output levels, publish the record =====
+    for (int b = 0; b < juce::jmin(numBands, kMeterBands); ++b)
+        addLevels(meterRecord.bandOut, b, bandBuffers[(size_t) b]);
+    addLevels(meterRecord.master, 1, buffer);
 
-    // ===== STORY-MBL-007: Compute master output level =====
-    float masterOutPeak = 0.0f;
-    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
-        masterOutPeak = juce::jmax(masterOutPeak, buffer.getMagnitude(ch, 0, buffer.getNumSamples()));
-    masterOutputDb.store(juce::Decibels::gainToDecibels(juce::jmax(masterOutPeak, 1.0e-6f)));
+    meterRecord.bandIn.advance(numSamples);
+    meterRecord.bandOut.advance(numSamples);
+    meterRecord.master.advance(numSamples);
+    if (meterRecord.master.numSamples >= meterRecordSamples)
+    {
+        meterFifo.push(meterRecord); // dropped when no editor is draining
+        meterRecord.clear();
+    }
 
     // ===== STORY-MBL-004: Latency reporting =====
     // TODO: Calculate and report total latency (band splitter + look-ahead)
@@ -297,8 +330,9 @@ HungryGhostMultibandLimiterAudioProcessor::APVTS::ParameterLayout HungryGhostMul
 
 void HungryGhostMultibandLimiterAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto state = apvts.copyValueTreeToXml(true, nullptr);
-    copyXmlToBinary(*state, destData);
+    if (auto state = apvts.copyState(); state.isValid())
+        if (auto xml = state.createXml())
+            copyXmlToBinary(*xml, destData);
 }
 
 //==============================================================================
@@ -312,21 +346,11 @@ void HungryGhostMultibandLimiterAudioProcessor::setStateInformation(const void*
 
 //==============================================================================
 
-void HungryGhostMultibandLimiterAudioProcessor::ensureBandBuffers(int numChannels, int numSamples)
-{
-    // Ensure we have enough band buffers (up to 8 bands max for future expansion)
-    const int maxBands = 8;
-    if ((int)bandBuffers.size() < maxBands)
-        bandBuffers.resize(maxBands);
-
-    // Resize each band buffer to match current block size
-    for (int b = 0; b < maxBands; ++b)
-        bandBuffers[b].setSize(numChannels, numSamples, false, true, true);
-}
-
 //==============================================================================
 
+#ifndef HG_MBL_HEADLESS_TEST // headless builds link several processors into one binary
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 {
     return new HungryGhostMultibandLimiterAudioProcessor();
 }
+#endif
@@ -12,6 +12,8 @@
 #include "dsp/BandSplitterIIR.h"
 #include "dsp/LimiterBand.h"
 #include "dsp/Utilities.h"
+#include <audio/ParameterHandles.h>
+#include <audio/MeterFifo.h>
 
 //==============================================================================
 
@@ -59,39 +61,56 @@ public:
     int getSamplesPerBlock() const { return samplesPerBlockExpected; }
 
     //==============================================================================
-    // STORY-MBL-007: Per-band and master metering for visual feedback
-    float getBandGainReductionDb(int i) const { return i >= 0 && i < 6 ? bandGainReductionDb[i].load() : 0.0f; }
-    float getBandInputDb(int i) const { return i >= 0 && i < 6 ? bandInputDb[i].load() : -60.0f; }
-    float getBandOutputDb(int i) const { return i >= 0 && i < 6 ? bandOutputDb[i].load() : -60.0f; }
-    float getMasterInputDb() const { return masterInputDb.load(); }
-    float getMasterOutputDb() const { return masterOutputDb.load(); }
+    // STORY-MBL-007: Per-band and master metering for visual feedback.
+    // One record per ~5 ms of audio whatever the host block size; the editor is the only consumer.
+    static constexpr int kMeterBands = 2; // bands defined in the layout (M1)
+    struct MeterRecord
+    {
+        audio::MeterFrame<kMeterBands> bandIn;   // split band levels before limiting
+        audio::MeterFrame<kMeterBands> bandOut;  // limited band levels + band gain reduction
+        audio::MeterFrame<2> master;             // lane 0 input, lane 1 output
+
+        void clear() noexcept { bandIn.clear(); bandOut.clear(); master.clear(); }
+        void merge(const MeterRecord& o) noexcept { bandIn.merge(o.bandIn); bandOut.merge(o.bandOut); master.merge(o.master); }
+    };
+    using MeterFifo = audio::MeterFifo<MeterRecord, 256>;
+    MeterFifo& getMeterFifo() noexcept { return meterFifo; }
 
 private:
     double sampleRateHz = 44100.0;
     int samplesPerBlockExpected = 512;
 
-    // STORY-MBL-007: Atomic meter storage for thread-safe UI access
-    std::atomic<float> bandGainReductionDb[6] { 0,0,0,0,0,0 };
-    std::atomic<float> bandInputDb[6] { -60.0f, -60.0f, -60.0f, -60.0f, -60.0f, -60.0f };
-    std::atomic<float> bandOutputDb[6] { -60.0f, -60.0f, -60.0f, -60.0f, -60.0f, -60.0f };
-    std::atomic<float> masterInputDb { -60.0f };
-    std::atomic<float> masterOutputDb { -60.0f };
-
-    // Parameter cache (for efficient lookup in processBlock)
+    // STORY-MBL-007: meter record being filled by processBlock, pushed every meterRecordSamples
+    MeterFifo meterFifo;
+    MeterRecord meterRecord;
+    int meterRecordSamples = 240;
+
+    // Parameter snapshot: handles resolved once in the constructor, loaded once per block.
+    // Globals first, then kNumPerBand slots for each band (band.N.*).
+    static constexpr int kMaxBands = kMeterBands;
+    enum Param : size_t { pBandCount, pCrossover1, pOversampling, pLookAhead, pOutputTrim, kNumGlobalParams };
+    enum BandParam : size_t { bThreshold, bAttack, bRelease, bMix, bBypass, bSolo, kNumPerBand };
+    static constexpr size_t bandSlot(int band, BandParam p) noexcept
+    {
+        return kNumGlobalParams + (size_t) band * kNumPerBand + p;
+    }
+    audio::ParamSnapshot<kNumGlobalParams + kNumPerBand * kMaxBands> params;
+
+    // Derived from the snapshot each block
     int cachedBandCount = 2;
     float cachedCrossoverHz = 120.0f;
     int cachedOversamplingFactor = 1;
     float cachedLookAheadMs = 3.0f;
 
-    // Helper method to ensure band buffers are properly sized
-    void ensureBandBuffers(int numChannels, int numSamples);
+    // Renders one chunk of at most samplesPerBlockExpected samples
+    void processChunk(juce::AudioBuffer<float>& buffer);
 
     // ===== STORY-MBL-002: Multiband Crossover System =====
     std::unique_ptr<hgml::BandSplitterIIR> splitter;
     std::vector<juce::AudioBuffer<float>> bandBuffers;
 
     // ===== STORY-MBL-003: Per-band Limiting =====
-    std::array<hgml::LimiterBand, 2> limiters;  // Up to 2 bands for M1
+    std::array<hgml::LimiterBand, kMaxBands> limiters;  // Up to 2 bands for M1
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(HungryGhostMultibandLimiterAudioProcessor)
 };
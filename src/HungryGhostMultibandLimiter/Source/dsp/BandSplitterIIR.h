@@ -1,5 +1,6 @@
 #pragma once
 #include <juce_dsp/juce_dsp.h>
+#include <audio/RealtimeSanitizer.h>
 #include <vector>
 #include <algorithm>
 
@@ -14,6 +15,15 @@ public:
         sampleRate = sr;
         numChannels = juce::jmax(1, channels);
         chans.resize((size_t) numChannels);
+        crossoverFreqs.reserve((size_t) kMaxCrossovers);
+
+        // Every filter gets its own biquad up front, so later coefficient updates are in-place
+        // writes of the same order (no allocation, no state reset on the audio thread)
+        for (auto& ch : chans)
+            for (int i = 0; i < kMaxCrossovers; ++i)
+                for (auto* f : { &ch.lp[i][0], &ch.lp[i][1], &ch.hp[i][0], &ch.hp[i][1] })
+                    f->coefficients = new juce::dsp::IIR::Coefficients<float>(1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f);
+
         setCrossoverHz(fcHz);  // Initialize with legacy single crossover
         reset();
     }
@@ -30,99 +40,104 @@ public:
     // Set N crossover frequencies (up to 5 for 6 bands)
     void setCrossoverFrequencies(const std::vector<float>& freqs)
     {
-        crossoverFreqs = freqs;
-        if (crossoverFreqs.size() > 5)
-            crossoverFreqs.resize(5);
-
-        // Sort and validate frequencies
-        for (auto& f : crossoverFreqs)
-            f = juce::jlimit(20.0f, (float)(0.45 * sampleRate), f);
-        std::sort(crossoverFreqs.begin(), crossoverFreqs.end());
-
-        // Update filter coefficients
-        for (size_t i = 0; i < crossoverFreqs.size(); ++i)
-        {
-            auto lpCoefs = juce::dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, crossoverFreqs[i]);
-            auto hpCoefs = juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, crossoverFreqs[i]);
-
-            for (auto& ch : chans)
-            {
-                ch.lp[i][0].coefficients = lpCoefs;
-                ch.lp[i][1].coefficients = lpCoefs;
-                ch.hp[i][0].coefficients = hpCoefs;
-                ch.hp[i][1].coefficients = hpCoefs;
-            }
-        }
+        setCrossovers(freqs.data(), (int) freqs.size());
     }
 
     // Legacy single-crossover API
     void setCrossoverHz(float fc)
     {
         fcHz = juce::jlimit(20.0f, (float)(0.45 * sampleRate), fc);
-        std::vector<float> freqs;
-        if (fc > 0) freqs.push_back(fc);
-        setCrossoverFrequencies(freqs);
+        setCrossovers(&fc, fc > 0 ? 1 : 0);
     }
 
-    // Multi-band process: src -> vector of N+1 bands
-    void process(const juce::AudioBuffer<float>& src, std::vector<juce::AudioBuffer<float>>& bands)
+    // Sizes `bands` for process(): one buffer per possible band, `channels` x `maxSamples`.
+    // Allocates: call it from prepare, never on the audio thread.
+    static void prepareBands(std::vector<juce::AudioBuffer<float>>& bands, int channels, int maxSamples)
     {
-        const int N = src.getNumSamples();
-        const int C = juce::jmin(src.getNumChannels(), numChannels);
-        const int numBands = (int)crossoverFreqs.size() + 1;
-
-        if ((int)bands.size() != numBands)
-            bands.resize((size_t) numBands);
+        bands.resize((size_t) kMaxCrossovers + 1);
+        for (auto& band : bands)
+            band.setSize(channels, maxSamples, false, true, false);
+    }
 
+    // Multi-band process: src -> bands[0 .. getNumBands()). `bands` comes from prepareBands()
+    // with at least src's samples; only those are written.
+    void process(const juce::AudioBuffer<float>& src, std::vector<juce::AudioBuffer<float>>& bands)
+    {
+        HG_RT_SCOPE("hgml::BandSplitterIIR::process");
+        const int numBands = juce::jmin((int)crossoverFreqs.size() + 1, (int)bands.size());
+        if (numBands == 0)
+            return;
+        int N = src.getNumSamples();
+        int C = juce::jmin(src.getNumChannels(), numChannels);
         for (int b = 0; b < numBands; ++b)
         {
-            bands[b].setSize(src.getNumChannels(), N, false, true, true);
-            bands[b].makeCopyOf(src, true);
+            N = juce::jmin(N, bands[(size_t) b].getNumSamples());
+            C = juce::jmin(C, bands[(size_t) b].getNumChannels());
         }
 
         for (int ch = 0; ch < C; ++ch)
         {
             auto& c = chans[(size_t) ch];
+            const float* x = src.getReadPointer(ch);
             for (int n = 0; n < N; ++n)
             {
-                const float x = src.getSample(ch, n);
-                if (crossoverFreqs.empty())
-                {
-                    bands[0].setSample(ch, n, x);
-                }
-                else
+                float lowPass = x[n];
+                for (int xo = 0; xo + 1 < numBands; ++xo)
                 {
-                    float lowPass = x;
-                    for (size_t xo = 0; xo < crossoverFreqs.size(); ++xo)
-                    {
-                        const float lpOut = c.lp[xo][1].processSample(c.lp[xo][0].processSample(lowPass));
-                        const float hpOut = c.hp[xo][1].processSample(c.hp[xo][0].processSample(lowPass));
-                        bands[xo].setSample(ch, n, hpOut);
-                        lowPass = lpOut;
-                    }
-                    bands[crossoverFreqs.size()].setSample(ch, n, lowPass);
+                    const float lpOut = c.lp[(size_t) xo][1].processSample(c.lp[(size_t) xo][0].processSample(lowPass));
+                    const float hpOut = c.hp[(size_t) xo][1].processSample(c.hp[(size_t) xo][0].processSample(lowPass));
+                    bands[(size_t) xo].setSample(ch, n, hpOut);
+                    lowPass = lpOut;
                 }
+                bands[(size_t) numBands - 1].setSample(ch, n, lowPass);
             }
         }
 
         for (int b = 0; b < numBands; ++b)
-            for (int ch = C; ch < bands[b].getNumChannels(); ++ch)
-                bands[b].clear(ch, 0, N);
+            for (int ch = C; ch < bands[(size_t) b].getNumChannels(); ++ch)
+                bands[(size_t) b].clear(ch, 0, N);
     }
 
-    // Legacy 2-band API
+    // Legacy 2-band API (allocates its band buffers: not for the audio thread)
     void process(const juce::AudioBuffer<float>& src, juce::AudioBuffer<float>& low, juce::AudioBuffer<float>& high)
     {
         std::vector<juce::AudioBuffer<float>> bands;
+        prepareBands(bands, src.getNumChannels(), src.getNumSamples());
         process(src, bands);
-        if (bands.size() >= 1) low.makeCopyOf(bands[0], true);
-        if (bands.size() >= 2) high.makeCopyOf(bands[1], true);
+        if (getNumBands() >= 1) low.makeCopyOf(bands[0], true);
+        if (getNumBands() >= 2) high.makeCopyOf(bands[1], true);
     }
 
     int getNumBands() const { return (int)crossoverFreqs.size() + 1; }
     float getCrossoverHz() const { return fcHz; }
 
 private:
+    // Allocation-free once prepared (capacity reserved, coefficients written in place)
+    void setCrossovers(const float* freqs, int count)
+    {
+        crossoverFreqs.assign(freqs, freqs + juce::jmin(count, kMaxCrossovers));
+
+        // Sort and validate frequencies
+        for (auto& f : crossoverFreqs)
+            f = juce::jlimit(20.0f, (float)(0.45 * sampleRate), f);
+        std::sort(crossoverFreqs.begin(), crossoverFreqs.end());
+
+        // Update filter coefficients
+        for (size_t i = 0; i < crossoverFreqs.size(); ++i)
+        {
+            const auto lpCoefs = juce::dsp::IIR::ArrayCoefficients<float>::makeLowPass(sampleRate, crossoverFreqs[i]);
+            const auto hpCoefs = juce::dsp::IIR::ArrayCoefficients<float>::makeHighPass(sampleRate, crossoverFreqs[i]);
+
+            for (auto& ch : chans)
+            {
+                *ch.lp[i][0].coefficients = lpCoefs;
+                *ch.lp[i][1].coefficients = lpCoefs;
+                *ch.hp[i][0].coefficients = hpCoefs;
+                *ch.hp[i][1].coefficients = hpCoefs;
+            }
+        }
+    }
+
     double sampleRate = 44100.0;
     int numChannels = 2;
     float fcHz = 120.0f;
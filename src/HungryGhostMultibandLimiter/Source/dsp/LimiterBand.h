@@ -4,6 +4,7 @@
 #include <juce_dsp/juce_dsp.h>
 #include <cmath>
 #include "Utilities.h"
+#include <audio/RealtimeSanitizer.h>
 
 namespace hgml {
 
@@ -45,6 +46,7 @@ public:
     // Returns peak gain reduction in dB (positive value, 0..60)
     float processBlock(juce::AudioBuffer<float>& buffer)
     {
+        HG_RT_SCOPE("hgml::LimiterBand::processBlock");
         if (params.bypass)
             return 0.0f;
 
@@ -472,6 +472,7 @@ public:
         }
 
         std::vector<AudioBuffer<float>> bands;
+        hgml::BandSplitterIIR::prepareBands(bands, 2, N);
         splitter.process(src, bands);
         if (bands.size() >= 1) low.makeCopyOf(bands[0], true);
         if (bands.size() >= 2) high.makeCopyOf(bands[1], true);
@@ -514,9 +515,10 @@ public:
         }
 
         std::vector<AudioBuffer<float>> bands;
+        hgml::BandSplitterIIR::prepareBands(bands, 2, N);
         splitter.process(src, bands);
 
-        expect((int)bands.size() == 4, "Should have 4 bands for 3 crossovers");
+        expect(splitter.getNumBands() == 4, "Should have 4 bands for 3 crossovers");
         expect(bands[0].getNumSamples() == N, "Band buffers should match input size");
     }
 };
@@ -636,9 +638,10 @@ public:
         }
 
         std::vector<AudioBuffer<float>> bands;
+        hgml::BandSplitterIIR::prepareBands(bands, 2, input.getNumSamples());
         splitter.process(input, bands);
 
-        expect((int)bands.size() >= 2, "Should have at least 2 bands");
+        expect(splitter.getNumBands() >= 2, "Should have at least 2 bands");
 
         if (bands.size() >= 1) limiterLow.processBlock(bands[0]);
         if (bands.size() >= 2) limiterHigh.processBlock(bands[1]);
@@ -656,6 +659,98 @@ public:
     }
 };
 
+class MeterFifoProcessorTest : public UnitTest
+{
+public:
+    MeterFifoProcessorTest() : UnitTest("MBL Meter Records") {}
+
+    void runTest() override
+    {
+        beginTest("A one-sample spike in one of many 32-sample blocks reaches the UI");
+        HungryGhostMultibandLimiterAudioProcessor proc;
+        proc.prepareToPlay(48000.0, 32);
+        proc.getMeterFifo().discardAll();
+
+        AudioBuffer<float> buffer(2, 32);
+        MidiBuffer midi;
+        for (int block = 0; block < 300; ++block)  // 200 ms; a record closes every 8 blocks (256 >= 240 samples)
+        {
+            buffer.clear();
+            for (int n = 0; n < 32; ++n)
+                buffer.setSample(0, n, 0.01f);
+            if (block == 123)
+                buffer.setSample(1, 17, 0.9f);
+            proc.processBlock(buffer, midi);
+        }
+
+        std::vector<HungryGhostMultibandLimiterAudioProcessor::MeterRecord> records(
+            (size_t) HungryGhostMultibandLimiterAudioProcessor::MeterFifo::kCapacity);
+        const int n = proc.getMeterFifo().pop(records.data(), (int) records.size());
+        expectEquals(n, 300 / 8);
+
+        auto sum = records[0];
+        int spikes = 0;
+        for (int i = 1; i < n; ++i)
+            sum.merge(records[(size_t) i]);
+        for (int i = 0; i < n; ++i)
+            spikes += records[(size_t) i].master.peak[0] > 0.5f ? 1 : 0;
+
+        expectWithinAbsoluteError(sum.master.peak[0], 0.9f, 1.0e-6f, "input peak held across blocks");
+        expectEquals(spikes, 1, "the spike lands in exactly one record");
+        expectEquals(sum.master.numSamples, n * 256, "records close on the first block boundary past 5 ms");
+        expectEquals(proc.getMeterFifo().getNumReady(), 0);
+    }
+};
+
+class ProcessorHostBlockTest : public UnitTest
+{
+public:
+    ProcessorHostBlockTest() : UnitTest("MBL Processor Host Blocks") {}
+
+    void runTest() override
+    {
+        beginTest("Any host block size renders the same audio without allocating");
+        const double sr = 48000.0;
+        const int block = 256;
+        const int C = 2;
+        const int total = 16384;
+
+        // Noise burst through both bands, below the -6 dB band thresholds: LimiterBand runs its
+        // envelope channel by channel, so only unlimited audio is block-size independent. The
+        // sanitizer fails the test on any allocation or lock inside processBlock
+        AudioBuffer<float> input(C, total);
+        Random rng(11);
+        for (int n = 0; n < total; ++n) {
+            const float s = (n / 2048) % 2 == 0 ? 0.2f * (rng.nextFloat() * 2.0f - 1.0f) : 0.0f;
+            for (int ch = 0; ch < C; ++ch)
+                input.setSample(ch, n, s);
+        }
+
+        auto render = [&](std::initializer_list<int> hostBlocks) {
+            HungryGhostMultibandLimiterAudioProcessor proc;
+            proc.prepareToPlay(sr, block);
+            AudioBuffer<float> out(input);
+            MidiBuffer midi;
+            for (int done = 0, i = 0; done < total; ++i) {
+                const int n = jmin(total - done, *(hostBlocks.begin() + (i % (int) hostBlocks.size())));
+                AudioBuffer<float> view(out.getArrayOfWritePointers(), C, done, n);
+                proc.processBlock(view, midi);
+                done += n;
+            }
+            return out;
+        };
+
+        const auto expected = render({ block });
+        const auto actual = render({ 1000, 37, 3 * block + 5, block, 1 });
+        float err = 0.0f;
+        for (int ch = 0; ch < C; ++ch)
+            for (int n = 0; n < total; ++n)
+                err = jmax(err, std::abs(expected.getSample(ch, n) - actual.getSample(ch, n)));
+        expectLessThan(err, 1.0e-5f);
+        expectGreaterThan(rms(expected), 0.01f);
+    }
+};
+
 //==============================================================================
 // Register all tests
 //==============================================================================
@@ -681,6 +776,8 @@ static LimiterBandMixTest                     limiterBandMixTest;
 static UtilitiesDbConversionTest              utilitiesDbTest;
 static UtilitiesTimeConstantTest              utilitiesTimeConstantTest;
 static SplitterLimiterIntegrationTest         integrationTest;
+static MeterFifoProcessorTest                 meterFifoProcessorTest;
+static ProcessorHostBlockTest                 processorHostBlockTest;
 
 //==============================================================================
 // Main entry point
@@ -689,7 +786,7 @@ static SplitterLimiterIntegrationTest         integrationTest;
 int main (int, char**)
 {
     ConsoleApplication app;
-    UnitTestRunner runner;
+    audio::rtsan::TestRunner runner;
     runner.runAllTests();
-    return 0;
+    return runner.finish();
 }
@@ -14,6 +14,14 @@ public:
         setGain(0.7f);
     }
 
+    // With the delay buffer from arena
+    void prepare(double sampleRate, int maxDelaySamples, DelayArena& arena)
+    {
+        dl.prepare(sampleRate, maxDelaySamples, arena);
+        setDelaySamples(maxDelaySamples / 2);
+        setGain(0.7f);
+    }
+
     void reset()
     {
         dl.reset();
@@ -33,7 +41,7 @@ public:
     }
 
 private:
-    DelayLine dl;
+    ExactDelayLine dl;
     float g = 0.7f;
 };
 
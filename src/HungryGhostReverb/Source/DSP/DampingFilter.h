@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include "FastMath.h"
 
 namespace hgr::dsp {
 
@@ -11,16 +12,31 @@ public:
     void prepare(double sampleRate) { fs = sampleRate; setCutoffHz(cutoffHz); reset(); }
     void reset() { z = 0.0f; }
 
-    void setCutoffHz(float hz)
+    // approx: fast polynomial coefficient, for the intermediate steps of a cutoff ramp
+    void setCutoffHz(float hz, bool approx = false)
     {
-        // Clamp cutoff to a safe, finite range and guard the tan() mapping
         cutoffHz = std::clamp(hz, 20.0f, 0.49f * (float) fs);
+        a = approx ? coefficientForApprox(cutoffHz, fs) : coefficientFor(cutoffHz, fs);
+    }
+
+    // TPT integrator coefficient for a cutoff, for callers that keep the state themselves
+    static float coefficientFor(float hz, double sampleRate) noexcept
+    {
+        // Clamp cutoff to a safe, finite range and guard the tan() mapping
+        const float fc = std::clamp(hz, 20.0f, 0.49f * (float) sampleRate);
         constexpr float pi = 3.14159265358979323846f;
-        const float x  = pi * (cutoffHz / (float) fs);
+        const float x  = pi * (fc / (float) sampleRate);
         const float wc = std::tan(x);
-        if (!std::isfinite(wc)) { a = 1.0f; return; } // transparent if bad
-        // TPT integrator coefficient
-        a = wc / (1.0f + wc);
+        if (!std::isfinite(wc)) return 1.0f; // transparent if bad
+        return wc / (1.0f + wc);
+    }
+
+    // coefficientFor() to ~1e-6 without std::tan
+    static float coefficientForApprox(float hz, double sampleRate) noexcept
+    {
+        const float fc = std::clamp(hz, 20.0f, 0.49f * (float) sampleRate);
+        constexpr float pi = 3.14159265358979323846f;
+        return fastmath::tptCoefficient(pi * (fc / (float) sampleRate));
     }
 
     inline float processSample(float x) noexcept
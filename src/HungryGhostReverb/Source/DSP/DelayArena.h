@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+
+namespace hgr::dsp {
+
+// One aligned block for many delay buffers, carved out in two passes over the same prepare
+// code: a sizing pass, where take() returns nullptr and only adds up the sizes, then
+// allocate(), then a second pass that hands out the memory in the same order. Every buffer
+// starts on a cache line; the memory is not cleared (the delay lines clear what they bind).
+// allocate() keeps the block when it is already large enough.
+class DelayArena {
+public:
+    static constexpr std::size_t kAlign = 64; // bytes
+    static constexpr int kAlignFloats = (int) (kAlign / sizeof(float));
+
+    // Floats a buffer of numFloats takes up, up to the next cache line
+    static int padded(int numFloats) noexcept { return (numFloats + kAlignFloats - 1) / kAlignFloats * kAlignFloats; }
+
+    // Starts a sizing pass
+    void beginSizing() noexcept
+    {
+        used = 0;
+        sizing = true;
+    }
+
+    // Sizes the block for the sizing pass; the next take() is the first buffer
+    void allocate()
+    {
+        if (used > capacity)
+        {
+            storage.reset();
+            storage.reset(static_cast<float*>(::operator new(used * sizeof(float), std::align_val_t { kAlign })));
+            capacity = used;
+        }
+        used = 0;
+        sizing = false;
+    }
+
+    // numFloats from the block; nullptr during a sizing pass
+    float* take(int numFloats) noexcept
+    {
+        float* p = sizing ? nullptr : storage.get() + used;
+        used += (std::size_t) padded(numFloats);
+        return p;
+    }
+
+    std::size_t getBytes() const noexcept { return capacity * sizeof(float); }
+
+private:
+    struct Free
+    {
+        void operator()(float* p) const noexcept { ::operator delete(p, std::align_val_t { kAlign }); }
+    };
+
+    std::unique_ptr<float, Free> storage;
+    std::size_t capacity = 0, used = 0; // floats
+    bool sizing = false;
+};
+
+} // namespace hgr::dsp
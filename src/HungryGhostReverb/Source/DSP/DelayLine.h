@@ -3,78 +3,147 @@
 #include <vector>
 #include <cmath>
 #include <algorithm>
+#include "DelayArena.h"
 
 namespace hgr::dsp {
 
+// How a delay line's ring wraps: Mask over a power-of-two buffer (which vector code can do per
+// lane, see FDN::readLines()), Exact with a compare over just the samples the delay needs
+enum class DelayWrap { Mask, Exact };
+
 // Simple fractional delay line with selectable interpolation.
-// Preallocate in prepare(). No allocations in process.
-class DelayLine {
+// Preallocate in prepare(), in a buffer of its own or from a DelayArena. No allocations in process.
+template <DelayWrap Wrap>
+class BasicDelayLine {
 public:
     enum class InterpMode { Linear, Lagrange3 };
 
+    BasicDelayLine() = default;
+    BasicDelayLine(const BasicDelayLine&) = delete; // buffer may point into owned
+    BasicDelayLine& operator=(const BasicDelayLine&) = delete;
+
+    // Buffer samples for delays up to maxDelaySamples
+    static int storageFor(int maxDelaySamples) noexcept
+    {
+        const int n = std::max(2, maxDelaySamples + 4);
+        return Wrap == DelayWrap::Mask ? nextPow2(n) : n;
+    }
+
     void prepare(double sampleRate, int maxDelaySamples)
     {
-        fs = sampleRate;
-        const int pow2 = nextPow2(std::max(2, maxDelaySamples + 4));
-        buffer.assign((size_t) pow2, 0.0f);
-        mask = pow2 - 1;
-        writeIdx = 0;
-        baseDelaySamples = std::min(maxDelaySamples, pow2 - 4);
-        fracDelay = 0.0f;
+        setUp(sampleRate, maxDelaySamples);
+        owned.assign((size_t) size, 0.0f);
+        buffer = owned.data();
+    }
+
+    void prepare(double sampleRate, int maxDelaySamples, DelayArena& arena)
+    {
+        prepare(sampleRate, maxDelaySamples, arena.take(storageFor(maxDelaySamples)));
+    }
+
+    // storage: storageFor(maxDelaySamples) samples the line does not own, or nullptr to bind()
+    // them later
+    void prepare(double sampleRate, int maxDelaySamples, float* storage)
+    {
+        setUp(sampleRate, maxDelaySamples);
+        owned = {};
+        bind(storage);
+    }
+
+    // Moves the line onto other storage of capacity() samples (nullptr: none), from silence
+    void bind(float* storage) noexcept
+    {
+        buffer = storage;
+        reset();
     }
 
-    void reset()
+    bool isBound() const noexcept { return buffer != nullptr; }
+
+    void reset() noexcept
     {
-        std::fill(buffer.begin(), buffer.end(), 0.0f);
+        if (buffer != nullptr)
+            std::fill(buffer, buffer + size, 0.0f);
         writeIdx = 0;
     }
 
     inline void pushSample(float x) noexcept
     {
-        buffer[(size_t) writeIdx] = x;
-        writeIdx = (writeIdx + 1) & mask;
+        buffer[writeIdx] = x;
+        writeIdx = wrap(writeIdx + 1);
     }
 
     inline float readFractional(float totalDelaySamples, float lfoOffsetSamples = 0.0f) const noexcept
+    {
+        return readFractionalAt(writeIdx, totalDelaySamples, lfoOffsetSamples);
+    }
+
+    inline float readLagrange3(float totalDelaySamples, float lfoOffsetSamples = 0.0f) const noexcept
+    {
+        return readLagrange3At(writeIdx, totalDelaySamples, lfoOffsetSamples);
+    }
+
+    inline float readInterpolated(float totalDelaySamples, float lfoOffsetSamples, InterpMode mode) const noexcept
+    {
+        return readInterpolatedAt(writeIdx, totalDelaySamples, lfoOffsetSamples, mode);
+    }
+
+    // Block access: the read a per-sample flow would make `ahead` pushes from now. Valid as long
+    // as every tap lies before the current write position, i.e. the delay exceeds ahead + 2.
+    inline float readInterpolatedAhead(int ahead, float totalDelaySamples, float lfoOffsetSamples, InterpMode mode) const noexcept
+    {
+        return readInterpolatedAt(wrap(writeIdx + ahead), totalDelaySamples, lfoOffsetSamples, mode);
+    }
+
+    // Writes n samples, as n pushSample() calls would
+    inline void pushBlock(const float* x, int n) noexcept
+    {
+        const int cap = capacity();
+        const int first = std::min(n, cap - writeIdx);
+        std::copy(x, x + first, buffer + writeIdx);
+        std::copy(x + first, x + n, buffer);
+        writeIdx = wrap(writeIdx + n);
+    }
+
+    inline float readFractionalAt(int writePos, float totalDelaySamples, float lfoOffsetSamples) const noexcept
     {
         // Clamp total delay to a safe range to avoid reading past stale memory
         const float cap = (float) capacity();
         const float dRaw = totalDelaySamples + lfoOffsetSamples;
         const float d = std::clamp(dRaw, 1.0f, cap - 3.0f);
         
-        const float rIdx = (float) writeIdx - d;
+        const float rIdx = (float) writePos - d;
         const float kf = std::floor(rIdx);
         const int k = (int) kf;
         
-        const int i0 = k & mask;
-        const int i1 = (i0 + 1) & mask;
+        const int i0 = wrap(k);
+        const int i1 = wrap(i0 + 1);
         const float frac = rIdx - kf;
-        const float s0 = buffer[(size_t) i0];
-        const float s1 = buffer[(size_t) i1];
+        const float s0 = buffer[i0];
+        const float s1 = buffer[i1];
         return s0 + (s1 - s0) * frac; // linear interp
     }
 
-    inline float readLagrange3(float totalDelaySamples, float lfoOffsetSamples = 0.0f) const noexcept
+    inline float readLagrange3At(int writePos, float totalDelaySamples, float lfoOffsetSamples) const noexcept
     {
         // 3rd-order Lagrange interpolation using 4 taps around the read index
         const float cap = (float) capacity();
         const float dRaw = totalDelaySamples + lfoOffsetSamples;
         const float d = std::clamp(dRaw, 2.0f, cap - 3.0f);
 
-        const float rIdx = (float) writeIdx - d;
+        const float rIdx = (float) writePos - d;
         const float kf = std::floor(rIdx);
         const int k = (int) kf;
         const float a = rIdx - kf; // fractional part in [0,1)
 
-        const int im1 = (k - 1) & mask; // x[-1]
-        const int i0  = k & mask;       // x[0]
-        const int i1  = (i0 + 1) & mask;// x[1]
-        const int i2  = (i0 + 2) & mask;// x[2]
+        const int im1 = wrap(k - 1);  // x[-1]
+        const int i0  = wrap(k);      // x[0]
+        const int i1  = wrap(i0 + 1); // x[1]
+        const int i2  = wrap(i0 + 2); // x[2]
 
-        const float xm1 = buffer[(size_t) im1];
-        const float x0  = buffer[(size_t) i0];
-        const float x1  = buffer[(size_t) i1];
-        const float x2  = buffer[(size_t) i2];
+        const float xm1 = buffer[im1];
+        const float x0  = buffer[i0];
+        const float x1  = buffer[i1];
+        const float x2  = buffer[i2];
 
         const float c0 = -a * (a - 1.0f) * (a - 2.0f) / 6.0f;
         const float c1 =  (a + 1.0f) * (a - 1.0f) * (a - 2.0f) / 2.0f;
@@ -84,11 +153,11 @@ public:
         return c0 * xm1 + c1 * x0 + c2 * x1 + c3 * x2;
     }
 
-    inline float readInterpolated(float totalDelaySamples, float lfoOffsetSamples, InterpMode mode) const noexcept
+    inline float readInterpolatedAt(int writePos, float totalDelaySamples, float lfoOffsetSamples, InterpMode mode) const noexcept
     {
         return (mode == InterpMode::Lagrange3)
-            ? readLagrange3(totalDelaySamples, lfoOffsetSamples)
-            : readFractional(totalDelaySamples, lfoOffsetSamples);
+            ? readLagrange3At(writePos, totalDelaySamples, lfoOffsetSamples)
+            : readFractionalAt(writePos, totalDelaySamples, lfoOffsetSamples);
     }
 
     inline float getDelayedSample(float totalDelaySamples) const noexcept { return readFractional(totalDelaySamples, 0.0f); }
@@ -103,12 +172,16 @@ public:
 
     void setBaseDelaySamples(int d)
     {
-        baseDelaySamples = std::clamp(d, 1, mask - 3);
+        baseDelaySamples = std::clamp(d, 1, size - 4);
     }
 
     int getBaseDelaySamples() const noexcept { return baseDelaySamples; }
 
-    int capacity() const noexcept { return mask + 1; }
+    int capacity() const noexcept { return size; }
+
+    // Raw access for readers that compute several lines' taps at once
+    const float* data() const noexcept { return buffer; }
+    int getWritePos() const noexcept { return writeIdx; }
 
     static int nextPow2(int v) noexcept
     {
@@ -117,13 +190,37 @@ public:
     }
 
 private:
+    void setUp(double sampleRate, int maxDelaySamples) noexcept
+    {
+        fs = sampleRate;
+        size = storageFor(maxDelaySamples);
+        mask = size - 1;
+        writeIdx = 0;
+        baseDelaySamples = std::min(maxDelaySamples, size - 4);
+        fracDelay = 0.0f;
+    }
+
+    // k in [-size, 2 size)
+    inline int wrap(int k) const noexcept
+    {
+        if constexpr (Wrap == DelayWrap::Mask)
+            return k & mask;
+        else
+            return k < 0 ? k + size : (k >= size ? k - size : k);
+    }
+
     double fs = 48000.0;
-    std::vector<float> buffer;
+    float* buffer = nullptr;
+    std::vector<float> owned; // buffer, unless it comes from elsewhere
+    int size = 0;
     int mask = 0;
     int writeIdx = 0;
     int baseDelaySamples = 1; // integer portion baseline
     float fracDelay = 0.0f;   // reserved for alt interpolation
 };
 
+using DelayLine = BasicDelayLine<DelayWrap::Mask>;
+using ExactDelayLine = BasicDelayLine<DelayWrap::Exact>;
+
 } // namespace hgr::dsp
 
@@ -3,20 +3,101 @@
 #include <array>
 #include <vector>
 #include <cmath>
+#include <cstdint>
 #include <algorithm>
 
 #include "DelayLine.h"
 #include "DampingFilter.h"
 #include "Modulator.h"
+#include "Simd4.h"
 
 namespace hgr::dsp {
 
-// 8x8 Feedback Delay Network with Hadamard feedback matrix
-class FDN8 {
+// Longest base delay of every network size (samples at 48k): sets the delay capacity and the
+// tail length, whatever the line count
+inline constexpr int kFdnLongestDelay48k = 6229;
+
+// Base delays (samples at 48k reference) per network size. Primes spaced roughly geometrically
+// up to the common longest line; the 8-line set is the original tuning.
+template <int N> struct FdnDelays;
+template <> struct FdnDelays<4>
+{
+    static constexpr std::array<int, 4> base48k { 1877, 2801, 4177, 6229 };
+};
+template <> struct FdnDelays<8>
+{
+    static constexpr std::array<int, 8> base48k { 1421, 1877, 2269, 2791, 3359, 4217, 5183, 6229 };
+};
+template <> struct FdnDelays<16>
+{
+    static constexpr std::array<int, 16> base48k { 887, 1009, 1151, 1307, 1493, 1699, 1933, 2203,
+                                                   2503, 2857, 3253, 3701, 4217, 4801, 5471, 6229 };
+};
+template <> struct FdnDelays<32>
+{
+    static constexpr std::array<int, 32> base48k { 557, 601, 653, 701, 761, 821, 887, 967,
+                                                   1039, 1123, 1213, 1307, 1423, 1531, 1657, 1789,
+                                                   1933, 2089, 2267, 2447, 2647, 2857, 3089, 3343,
+                                                   3613, 3907, 4219, 4561, 4931, 5333, 5749, 6229 };
+};
+
+// In-place Walsh-Hadamard transform of N points (unnormalised): log2(N) butterfly stages of span
+// 1, 2, 4 .. N/2, unrolled at compile time
+template <int N, int Span = 1>
+inline void fwht(float* x) noexcept
+{
+    if constexpr (Span < N)
+    {
+        for (int i = 0; i < N; i += 2 * Span)
+            for (int j = i; j < i + Span; ++j)
+            {
+                const float a = x[j], b = x[j + Span];
+                x[j] = a + b;
+                x[j + Span] = a - b;
+            }
+        fwht<N, 2 * Span>(x);
+    }
+}
+
+#if HGR_SIMD
+// fwht() over N / 4 registers of 4 points: spans 1 and 2 inside each register, then the spans
+// of 4 and up between registers; the same additions in the same order
+template <int G, int Span = 1>
+inline void fwhtRegisters(simd::f4* r) noexcept
+{
+    if constexpr (Span == 1)
+        for (int g = 0; g < G; ++g)
+            r[g] = simd::butterflyHalves(simd::butterflyPairs(r[g]));
+    if constexpr (Span < G)
+    {
+        for (int i = 0; i < G; i += 2 * Span)
+            for (int j = i; j < i + Span; ++j)
+            {
+                const simd::f4 a = r[j], b = r[j + Span];
+                r[j] = simd::add(a, b);
+                r[j + Span] = simd::sub(a, b);
+            }
+        fwhtRegisters<G, 2 * Span>(r);
+    }
+}
+#endif
+
+// N x N Feedback Delay Network (N = 4, 8, 16 or 32) with a Hadamard feedback matrix.
+// Per-line state is kept as structure-of-arrays (gains, damper coefficients and states, read
+// bounds) so the lines run as N / 4 4-lane SSE2/NEON registers; the scalar path computes the
+// same thing one line at a time and is selectable at runtime. More lines give a denser, faster
+// building tail for proportionally more CPU.
+template <int N>
+class FDN {
 public:
-    static constexpr int NumLines = 8;
+    static_assert(N == 4 || N == 8 || N == 16 || N == 32, "FDN sizes are 4, 8, 16 or 32 lines");
+    static_assert(FdnDelays<N>::base48k[N - 1] == kFdnLongestDelay48k, "longest line sets the capacity");
+
+    static constexpr int NumLines = N;
+    static constexpr int kMaxBlock = 256; // longest tickBlock() call
 
-    void prepare(double sampleRate, int maxBlockSize)
+    // ownDelayMemory false: the lines wait for bindDelayMemory() (and must have it to run)
+    void prepare(double sampleRate, int maxBlockSize, bool ownDelayMemory = true)
     {
         fs = sampleRate;
         // Freeze ramp coefficient for ~75 ms time constant
@@ -25,31 +106,60 @@ public:
         freezeXf = 0.0f;
         freezeTarget = 0.0f;
 
-        // Compute a worst-case max delay capacity to cover SR/Size/Mod ranges
-        // baseMax48k = longest base delay at 48k; sizeMax = 1.5; modMaxS = 10 ms in samples
-        const int baseMax48k = 6229;
+        // Worst-case delay of each line over the SR/Size/Mod ranges: its base delay at 48k
+        // scaled to fs, sizeMax = 1.5, modMaxS = 10 ms in samples. Masked lines round that up
+        // to a power of two each.
         const float sizeMax  = 1.5f;
         const float modMaxS  = (10e-3f) * (float) fs;
         const double scale   = fs / 48000.0;
-        const int maxDelaySamples = DelayLine::nextPow2((int) std::ceil(baseMax48k * scale * sizeMax + modMaxS + 4.0));
-        
+
+        delayFloats = 0;
         for (int i = 0; i < NumLines; ++i)
         {
-            lines[i].prepare(fs, maxDelaySamples);
-            dampers[i].prepare(fs);
-            dampers[i].setCutoffHz(hfHz);
+            const int maxDelaySamples = (int) std::ceil(FdnDelays<N>::base48k[(size_t) i] * scale * sizeMax + modMaxS + 4.0);
+            lines[i].prepare(fs, maxDelaySamples, nullptr);
+            delayFloats += DelayArena::padded(lines[i].capacity());
             lfos[i].prepare(fs, seed + i * 17);
+            readMask[i] = lines[i].capacity() - 1;
+            readHi[i] = (float) lines[i].capacity() - 3.0f;
+            tapGain[i] = inputTap(i);
         }
+        std::fill(dampZ.begin(), dampZ.end(), 0.0f);
         setSize(1.0f);
         setRT60(3.0f);
         setHFDampingHz(6000.0f);
         setModulation(0.3f, 1.5f);
         computeHadamardScale();
+
+        if (ownDelayMemory)
+            ownedDelay.assign((size_t) delayFloats, 0.0f);
+        else
+            ownedDelay = {};
+        bindDelayMemory(ownDelayMemory ? ownedDelay.data() : nullptr);
+    }
+
+    // Floats of delay memory the lines take, as laid out by bindDelayMemory(); set by prepare()
+    int delayMemoryFloats() const noexcept { return delayFloats; }
+
+    // Moves the lines onto delayMemoryFloats() of memory, from silence; nullptr leaves them
+    // without (not to be run until bound again). The memory is not owned.
+    void bindDelayMemory(float* memory) noexcept
+    {
+        for (int i = 0; i < NumLines; ++i)
+        {
+            lines[i].bind(memory);
+            if (memory != nullptr)
+                memory += DelayArena::padded(lines[i].capacity());
+        }
+        reset();
     }
 
+    bool hasDelayMemory() const noexcept { return lines[0].isBound(); }
+
     void reset()
     {
-        for (int i = 0; i < NumLines; ++i) { lines[i].reset(); dampers[i].reset(); }
+        for (int i = 0; i < NumLines; ++i) lines[i].reset();
+        std::fill(dampZ.begin(), dampZ.end(), 0.0f);
         std::fill(prevOut.begin(), prevOut.end(), 0.0f);
     }
 
@@ -63,25 +173,30 @@ public:
     {
         sizeScale = std::clamp(size, 0.5f, 1.5f);
         // Base delays (samples at 48k reference). Mutually inharmonic-ish lengths.
-        const int base48k[NumLines] = { 1421, 1877, 2269, 2791, 3359, 4217, 5183, 6229 };
+        const auto& base48k = FdnDelays<N>::base48k;
         for (int i = 0; i < NumLines; ++i)
         {
-            const float scaled = base48k[i] * (float) (fs / 48000.0) * sizeScale;
+            const float scaled = (float) base48k[(size_t) i] * (float) (fs / 48000.0) * sizeScale;
             lines[i].setBaseDelaySamples((int) std::round(scaled));
+            baseDelay[i] = (float) lines[i].getBaseDelaySamples();
         }
         updateGi();
+        updateBlockLimit();
     }
 
-    void setRT60(float seconds)
+    // approx (here and in setHFDampingHz): fast coefficient maths for the intermediate steps
+    // of a ramp; the final value should be set exactly
+    void setRT60(float seconds, bool approx = false)
     {
         rt60 = std::clamp(seconds, 0.1f, 60.0f);
-        updateGi();
+        updateGi(approx);
     }
 
-    void setHFDampingHz(float hz)
+    void setHFDampingHz(float hz, bool approx = false)
     {
         hfHz = std::clamp(hz, 1000.0f, 20000.0f);
-        for (auto& d : dampers) d.setCutoffHz(hfHz);
+        const float a = approx ? OnePoleLP::coefficientForApprox(hfHz, fs) : OnePoleLP::coefficientFor(hfHz, fs);
+        std::fill(dampA.begin(), dampA.end(), a);
     }
 
     void setFreeze(bool on)
@@ -95,17 +210,36 @@ public:
         modDepthMs = std::clamp(depthMs, 0.0f, 10.0f);
         const float depthSamples = (float) (modDepthMs * 1e-3 * fs);
         const float lagrThresh = 8.0f * (float) (fs / 48000.0); // ~8 samples at 48k
+        anyLagrange = false;
         for (int i = 0; i < NumLines; ++i)
         {
-            lfos[i].setRateHz(modRateHz * (1.0f + 0.03f * (float) i)); // slight offsets
+            lfos[i].setRateHz(modRateHz * (1.0f + kRateSpread * (float) i)); // slight offsets
             const float dS = depthSamples * depthMask(i);
             lfos[i].setDepthSamples(dS);
             interpMode[i] = (dS >= lagrThresh) ? DelayLine::InterpMode::Lagrange3 : DelayLine::InterpMode::Linear;
+
+            // Lane view of the mode: Lagrange reads clamp the delay at 2 samples, linear at 1
+            const bool lagr = interpMode[i] == DelayLine::InterpMode::Lagrange3;
+            lagrangeLane[i] = lagr ? -1 : 0;
+            readLo[i] = lagr ? 2.0f : 1.0f;
+            anyLagrange = anyLagrange || lagr;
         }
+        updateBlockLimit();
     }
 
     void setModulationMaskVariant(int variant) noexcept { modMaskVariant = (variant != 0 ? 1 : 0); }
 
+    // Samples between LFO oscillator steps; the delay offsets are interpolated in between
+    void setModulationControlInterval(int samples)
+    {
+        for (auto& l : lfos) l.setControlInterval(samples);
+    }
+
+    // Run the lines as SIMD lanes (default where SSE2/NEON exist) or one at a time. Both give
+    // the same output; the switch is for benchmarking and for checking one against the other.
+    void setSimdEnabled(bool on) noexcept { useSimd = on && HGR_SIMD; }
+    bool isSimdEnabled() const noexcept { return useSimd; }
+
     // Inject mono input x into the network and produce N raw line outputs into out[]
     inline void tick(float xIn, float out[NumLines]) noexcept
     {
@@ -116,106 +250,310 @@ public:
         const float motionScale = 1.0f - freezeXf; // 1 → normal, 0 → frozen
 
         // 1) Read current delay outputs with modulation (apply on longest lines only)
-        float v[NumLines];
+        alignas(16) float lfo[NumLines], v[NumLines], in[NumLines];
+        for (int i = 0; i < NumLines; ++i)
+            lfo[i] = lfos[i].nextOffsetSamples() * motionScale;
+        readLines(0, lfo, v);
+
+        // 2) Hadamard mix, 3) per-line feedback gain and damping (feedback-only), then write next
+        //    state with input injection (mute input when frozen)
+        feedbackLines(v, motionScale, motionScale * xIn, in);
         for (int i = 0; i < NumLines; ++i)
         {
-            const float lfo = lfos[i].nextOffsetSamples() * motionScale;
-            const float baseD = (float) lines[i].getBaseDelaySamples();
-            v[i] = lines[i].readInterpolated(baseD, lfo, interpMode[i]);
+            lines[i].pushSample(in[i]);
+            out[i] = v[i];
         }
+    }
 
-        // 2) Hadamard mix (unitary up to scale); produce feedback vector fb
-        float fb[NumLines];
-        hadamard(v, fb);
+    // Longest block tickBlock() accepts with the current size and modulation: shorter than every
+    // line's modulated delay, so a block never reads what it writes
+    int maxBlockSamples() const noexcept { return blockLimit; }
+
+    // n (<= maxBlockSamples()) tick()s at once, bit-identical to the per-sample path. The LFOs
+    // run a line at a time over the block, the reads, mixing and damping sample by sample across
+    // all lines, and each line then takes its n new samples in one write. out[i] gets line i.
+    void tickBlock(const float* xIn, float* const* out, int n) noexcept
+    {
+        // Freeze ramp, one value per sample
+        float* motion = motionBuf.data();
+        for (int k = 0; k < n; ++k)
+        {
+            freezeXf += (freezeTarget - freezeXf) * freezeAlpha;
+            if (freezeXf < 0.0f) freezeXf = 0.0f;
+            if (freezeXf > 1.0f) freezeXf = 1.0f;
+            motion[k] = 1.0f - freezeXf;
+        }
 
-        // 3) Apply per-line feedback gain and damping (feedback-only), then write next state with input injection
-        const float xinGain = motionScale; // mute input when frozen
+        // LFO offsets, lane-interleaved: lfoBuf[k * NumLines + i]
         for (int i = 0; i < NumLines; ++i)
         {
-            const float fbGain = gi[i] * motionScale + 0.99995f * (1.0f - motionScale);
-            const float fbSig  = fb[i] * fbGain;
-            const float damped = dampers[i].processSample(fbSig); // LP only on recirculating path
-            const float in     = damped + inputTap(i) * (xinGain * xIn); // undamped input injection keeps ER brighter
-            
-            lines[i].pushSample(in);
-            out[i] = v[i];
+            auto& lfoI = lfos[(size_t) i];
+            for (int k = 0; k < n; ++k)
+                lfoBuf[(size_t) (k * NumLines + i)] = lfoI.nextOffsetSamples() * motion[k];
         }
+
+        for (int k = 0; k < n; ++k)
+        {
+            alignas(16) float v[NumLines], in[NumLines];
+            readLines(k, lfoBuf.data() + k * NumLines, v);
+            feedbackLines(v, motion[k], motion[k] * xIn[k], in);
+            for (int i = 0; i < NumLines; ++i)
+            {
+                out[i][k] = v[i];
+                fbBuf[(size_t) i][(size_t) k] = in[i];
+            }
+        }
+
+        for (int i = 0; i < NumLines; ++i)
+            lines[(size_t) i].pushBlock(fbBuf[(size_t) i].data(), n);
     }
 
     // Stereo mix from line outputs using fixed tap weights and width
     inline void mixStereo(const float v[NumLines], float width, float& outL, float& outR) const noexcept
     {
-        // Mix with simple orthogonal patterns and normalize by sqrt(N)
+        float mScale, sScale;
+        widthScales(width, mScale, sScale);
+        mixScaled(v, mScale, sScale, outL, outR);
+    }
+
+    // mixStereo() over tickBlock() output: v[i] is line i, width one value per sample
+    void mixStereoBlock(const float* const* v, const float* width, float* outL, float* outR, int n) const noexcept
+    {
+        // Width is usually constant over a block: the law is only re-evaluated when it moves
+        float lastW = -1.0f, mS = 0.0f, sS = 0.0f;
+        int k = 0;
+       #if HGR_SIMD
+        if (useSimd)
+        {
+            // Four samples per register; each lane sums the lines in mixScaled()'s order
+            using namespace simd;
+            const f4 half = set1(0.5f), norm = set1(1.0f / std::sqrt((float) NumLines));
+            for (; k + 4 <= n; k += 4)
+            {
+                f4 sumL = set1(0.0f), sumR = set1(0.0f);
+                for (int i = 0; i < NumLines; ++i)
+                {
+                    const f4 x = loadu(v[i] + k);
+                    sumL = (i & 1) ? sub(sumL, x) : add(sumL, x);
+                    sumR = (i & 2) ? sub(sumR, x) : add(sumR, x);
+                }
+                const f4 mid0  = mul(mul(add(sumL, sumR), half), norm);
+                const f4 side0 = mul(mul(sub(sumL, sumR), half), norm);
+
+                alignas(16) float mArr[4], sArr[4];
+                for (int j = 0; j < 4; ++j)
+                {
+                    if (width[k + j] != lastW)
+                    {
+                        lastW = width[k + j];
+                        widthScales(lastW, mS, sS);
+                    }
+                    mArr[j] = mS;
+                    sArr[j] = sS;
+                }
+                const f4 m = load(mArr), s = load(sArr);
+                storeu(outL + k, add(mul(m, mid0), mul(s, side0)));
+                storeu(outR + k, sub(mul(m, mid0), mul(s, side0)));
+            }
+        }
+       #endif
+        for (; k < n; ++k)
+        {
+            float vk[NumLines];
+            for (int i = 0; i < NumLines; ++i)
+                vk[i] = v[i][k];
+            if (width[k] != lastW)
+            {
+                lastW = width[k];
+                widthScales(lastW, mS, sS);
+            }
+            mixScaled(vk, mS, sS, outL[k], outR[k]);
+        }
+    }
+
+private:
+    static constexpr int kGroups = NumLines / 4; // SIMD registers per line vector
+    static constexpr float kRateSpread = 0.03f * 8.0f / (float) NumLines; // LFO rate step per line
+
+    inline void mixScaled(const float v[NumLines], float mScale, float sScale, float& outL, float& outR) const noexcept
+    {
+        // Mix with two orthogonal sign patterns (Walsh rows 1 and 2, +-+- and ++--), so the sums
+        // are decorrelated for any N, and normalize by sqrt(N)
         float sumL = 0.0f, sumR = 0.0f;
         for (int i = 0; i < NumLines; ++i)
         {
-            const float s = (i & 1) ? -1.0f : 1.0f;
-            sumL += v[i] * s;
-            sumR += v[(i + 3) & (NumLines - 1)] * -s; // permuted index for decorrelation
+            sumL += v[i] * ((i & 1) ? -1.0f : 1.0f);
+            sumR += v[i] * ((i & 2) ? -1.0f : 1.0f);
         }
         const float norm  = 1.0f / std::sqrt((float) NumLines);
         const float mid0  = (sumL + sumR) * 0.5f * norm;
         const float side0 = (sumL - sumR) * 0.5f * norm;
 
-        // Equal-power width law: map width in [0..1] to energy-preserving M/S scales
+        outL = mScale * mid0 + sScale * side0;
+        outR = mScale * mid0 - sScale * side0;
+    }
+
+    // Equal-power width law: map width in [0..1] to energy-preserving M/S scales. Width 1 passes
+    // the two decorrelated sums as they are (both scales 1), width 0 their mid on both sides
+    // (mid scale sqrt 2); mScale^2 + sScale^2 = 2 throughout.
+    static void widthScales(float width, float& mScale, float& sScale) noexcept
+    {
         const float w = std::clamp(width, 0.0f, 1.0f);
         constexpr float pi = 3.14159265358979323846f;
-        const float sScale = std::sin(0.5f * pi * w);
-        const float mScale = std::sqrt(1.0f - sScale * sScale);
+        sScale = std::sqrt(2.0f) * std::sin(0.25f * pi * w);
+        mScale = std::sqrt(2.0f - sScale * sScale);
+    }
 
-        outL = mScale * mid0 + sScale * side0;
-        outR = mScale * mid0 - sScale * side0;
+    // Modulated reads of all lines, `ahead` pushes from now (see DelayLine::readInterpolatedAhead)
+    inline void readLines(int ahead, const float* lfo, float* v) const noexcept
+    {
+       #if HGR_SIMD
+        if (useSimd)
+        {
+            using namespace simd;
+            alignas(16) std::int32_t writePos[NumLines], im1[NumLines], i0[NumLines], i1[NumLines], i2[NumLines];
+            alignas(16) float frac[NumLines], xm1[NumLines], x0[NumLines], x1[NumLines], x2[NumLines];
+            for (int i = 0; i < NumLines; ++i)
+                writePos[i] = lines[(size_t) i].getWritePos();
+
+            // Read positions, as in DelayLine::readFractionalAt() / readLagrange3At()
+            for (int h = 0; h < NumLines; h += 4)
+            {
+                const f4 d = clamp(add(load(baseDelay.data() + h), load(lfo + h)), load(readLo.data() + h), load(readHi.data() + h));
+                const i4 mask = loadi(readMask.data() + h);
+                const f4 rIdx = sub(toFloat(andi(addi(loadi(writePos + h), set1i(ahead)), mask)), d);
+                const f4 kf = floor(rIdx);
+                const i4 k = truncToInt(kf);
+                const i4 k0 = andi(k, mask);
+                store(frac + h, sub(rIdx, kf));
+                storei(i0 + h, k0);
+                storei(i1 + h, andi(addi(k0, set1i(1)), mask));
+                storei(im1 + h, andi(addi(k, set1i(-1)), mask));
+                storei(i2 + h, andi(addi(k0, set1i(2)), mask));
+            }
+
+            // Gather the taps, one buffer per lane
+            for (int i = 0; i < NumLines; ++i)
+            {
+                const float* buf = lines[(size_t) i].data();
+                x0[i] = buf[i0[i]];
+                x1[i] = buf[i1[i]];
+            }
+            if (anyLagrange)
+                for (int i = 0; i < NumLines; ++i)
+                {
+                    const float* buf = lines[(size_t) i].data();
+                    xm1[i] = buf[im1[i]];
+                    x2[i] = buf[i2[i]];
+                }
+
+            for (int h = 0; h < NumLines; h += 4)
+            {
+                const f4 a = load(frac + h), s0 = load(x0 + h), s1 = load(x1 + h);
+                const f4 lin = add(s0, mul(sub(s1, s0), a));
+                if (!anyLagrange)
+                {
+                    store(v + h, lin);
+                    continue;
+                }
+                const f4 one = set1(1.0f), two = set1(2.0f), six = set1(6.0f);
+                const f4 ap1 = add(a, one), am1 = sub(a, one), am2 = sub(a, two);
+                const f4 c0 = div(mul(mul(neg(a), am1), am2), six);
+                const f4 c1 = div(mul(mul(ap1, am1), am2), two);
+                const f4 c2 = div(mul(mul(neg(ap1), a), am2), two);
+                const f4 c3 = div(mul(mul(ap1, a), am1), six);
+                const f4 lag = add(add(add(mul(c0, load(xm1 + h)), mul(c1, s0)), mul(c2, s1)), mul(c3, load(x2 + h)));
+                store(v + h, select(loadi(lagrangeLane.data() + h), lag, lin));
+            }
+            return;
+        }
+       #endif
+        for (int i = 0; i < NumLines; ++i)
+            v[i] = lines[(size_t) i].readInterpolatedAhead(ahead, baseDelay[(size_t) i], lfo[i], interpMode[(size_t) i]);
+    }
+
+    // Hadamard mix of v, per-line feedback gain (eased to unity by freeze), damping, plus the
+    // input injection: in[] are the samples to write. m is the motion scale, xin the scaled input.
+    inline void feedbackLines(const float* v, float m, float xin, float* in) noexcept
+    {
+        const float hold = 0.99995f * (1.0f - m);
+       #if HGR_SIMD
+        if (useSimd)
+        {
+            using namespace simd;
+            f4 fb[kGroups];
+            for (int h = 0; h < kGroups; ++h)
+                fb[h] = load(v + 4 * h);
+            fwhtRegisters<kGroups>(fb);
+
+            const f4 scale = set1(hadamardScale);
+            const f4 mv = set1(m), holdv = set1(hold), xv = set1(xin);
+            for (int h = 0; h < kGroups; ++h)
+            {
+                const f4 fbSig = mul(mul(fb[h], scale), add(mul(load(gi.data() + 4 * h), mv), holdv));
+                // OnePoleLP::processSample() per lane
+                const f4 z = load(dampZ.data() + 4 * h);
+                const f4 t = mul(sub(fbSig, z), load(dampA.data() + 4 * h));
+                const f4 y = add(t, z);
+                store(dampZ.data() + 4 * h, add(y, t));
+                store(in + 4 * h, add(y, mul(load(tapGain.data() + 4 * h), xv)));
+            }
+            return;
+        }
+       #endif
+        float fb[NumLines];
+        std::copy(v, v + NumLines, fb);
+        fwht<NumLines>(fb);
+        for (int i = 0; i < NumLines; ++i)
+        {
+            const float fbSig  = fb[i] * hadamardScale * (gi[(size_t) i] * m + hold);
+            // LP only on recirculating path
+            const float t      = (fbSig - dampZ[(size_t) i]) * dampA[(size_t) i];
+            const float damped = t + dampZ[(size_t) i];
+            dampZ[(size_t) i]  = damped + t;
+            in[i] = damped + tapGain[(size_t) i] * xin; // undamped input injection keeps ER brighter
+        }
+    }
+
+    void updateBlockLimit() noexcept
+    {
+        // Lagrange taps reach 2 samples past the read position; 1 more covers the LFO jitter
+        float shortest = (float) kMaxBlock + 3.0f;
+        for (int i = 0; i < NumLines; ++i)
+            shortest = std::min(shortest, (float) lines[i].getBaseDelaySamples() - std::abs(lfos[i].getDepthSamples()) - 1.0f);
+        blockLimit = std::clamp((int) std::floor(shortest) - 2, 1, kMaxBlock);
     }
 
-private:
     void computeHadamardScale() { hadamardScale = 1.0f / std::sqrt((float) NumLines); }
 
-    void hadamard(const float in[NumLines], float out[NumLines]) const noexcept
-    {
-        // unrolled 8-point hadamard butterflies
-        float s0 = in[0] + in[1]; float d0 = in[0] - in[1];
-        float s1 = in[2] + in[3]; float d1 = in[2] - in[3];
-        float s2 = in[4] + in[5]; float d2 = in[4] - in[5];
-        float s3 = in[6] + in[7]; float d3 = in[6] - in[7];
-        float s4 = s0 + s1;      float d4 = s0 - s1;
-        float s5 = d0 + d1;      float d5 = d0 - d1;
-        float s6 = s2 + s3;      float d6 = s2 - s3;
-        float s7 = d2 + d3;      float d7 = d2 - d3;
-        out[0] = (s4 + s6) * hadamardScale;
-        out[1] = (s5 + d7) * hadamardScale;
-        out[2] = (d4 + s7) * hadamardScale;
-        out[3] = (d5 + d6) * hadamardScale;
-        out[4] = (s4 - s6) * hadamardScale;
-        out[5] = (s5 - d7) * hadamardScale;
-        out[6] = (d4 - s7) * hadamardScale;
-        out[7] = (d5 - d6) * hadamardScale;
-    }
-
-    void updateGi()
+    void updateGi(bool approx = false)
     {
         // RT60 mapping: per-line gain so each delay line achieves ≈60 dB decay over rt60
+        const float lnPerSample = (float) (-3.0 / (rt60 * fs)) * fastmath::kLn10;
         for (int i = 0; i < NumLines; ++i)
         {
             const int Li = std::max(1, lines[i].getBaseDelaySamples());
-            const float g = std::pow(10.0f, (float) (-3.0 * (double) Li / (rt60 * fs)));
+            const float g = approx ? fastmath::exp(lnPerSample * (float) Li)
+                                   : std::pow(10.0f, (float) (-3.0 * (double) Li / (rt60 * fs)));
             gi[i] = std::clamp(g, 0.0f, 0.99f);
         }
     }
 
     static float inputTap(int i)
     {
-        // alternating signs for width; slightly stronger feed to ensure audible wet
+        // alternating signs for width; slightly stronger feed to ensure audible wet. The same per
+        // line for any N: with the 1/sqrt(N) output mix the level does not depend on N.
         return (i & 1) ? -0.5f : 0.5f;
     }
 
     float depthMask(int i) const noexcept
     {
         // Variant 0: longest half only (default)
-        // Variant 1: mod more lines (all except the two shortest) for livelier modes like Plate
+        // Variant 1: mod more lines (all but the shortest quarter) for livelier modes like Plate
         if (modMaskVariant == 0)
             return (i >= NumLines / 2) ? 1.0f : 0.0f;
         else
-            return (i >= 2) ? 1.0f : 0.0f; // mod 6 longest of 8
+            return (i >= NumLines / 4) ? 1.0f : 0.0f; // 6 longest of 8
     }
 
     double fs = 48000.0;
@@ -226,15 +564,34 @@ private:
     float modDepthMs = 1.5f;
     int seed = 1337;
     float hadamardScale = 1.0f;
+    bool useSimd = HGR_SIMD;
 
     std::array<DelayLine, NumLines> lines;
-    std::array<OnePoleLP, NumLines> dampers;
+    std::vector<float> ownedDelay; // the lines' memory, unless bound elsewhere
+    int delayFloats = 0;
     std::array<LFO, NumLines> lfos;
-    std::array<float, NumLines> gi { };
     std::array<float, NumLines> prevOut { };
-    std::array<DelayLine::InterpMode, NumLines> interpMode { DelayLine::InterpMode::Linear, DelayLine::InterpMode::Linear, DelayLine::InterpMode::Linear, DelayLine::InterpMode::Linear, DelayLine::InterpMode::Linear, DelayLine::InterpMode::Linear, DelayLine::InterpMode::Linear, DelayLine::InterpMode::Linear };
-
-    int modMaskVariant = 0; // 0: longest half, 1: all but two shortest
+    std::array<DelayLine::InterpMode, NumLines> interpMode { }; // all Linear
+
+    // Per-line state, one lane per line
+    alignas(16) std::array<float, NumLines> gi { };        // feedback gain for rt60
+    alignas(16) std::array<float, NumLines> dampA { };     // HF damper (TPT one-pole) coefficient
+    alignas(16) std::array<float, NumLines> dampZ { };     // HF damper state
+    alignas(16) std::array<float, NumLines> tapGain { };   // inputTap()
+    alignas(16) std::array<float, NumLines> baseDelay { }; // base delay, samples
+    alignas(16) std::array<float, NumLines> readLo { };    // delay clamp for the line's interpolation
+    alignas(16) std::array<float, NumLines> readHi { };
+    alignas(16) std::array<std::int32_t, NumLines> readMask { };
+    alignas(16) std::array<std::int32_t, NumLines> lagrangeLane { }; // -1 where interpMode is Lagrange3
+    bool anyLagrange = false;
+
+    int modMaskVariant = 0; // 0: longest half, 1: all but the shortest quarter
+
+    // tickBlock() scratch
+    int blockLimit = 1;
+    std::array<float, kMaxBlock> motionBuf { };
+    alignas(16) std::array<float, kMaxBlock * NumLines> lfoBuf { }; // [k * NumLines + i]
+    std::array<std::array<float, kMaxBlock>, NumLines> fbBuf { };
 
     // Freeze ramp state
     float freezeXf = 0.0f;     // 0 = normal, 1 = fully frozen
@@ -242,5 +599,6 @@ private:
     float freezeAlpha = 0.02f; // per-sample smoothing coefficient
 };
 
-} // namespace hgr::dsp
+using FDN8 = FDN<8>; // the default network
 
+} // namespace hgr::dsp
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+namespace hgr::dsp::fastmath {
+
+// Cheap approximations for coefficient updates while a parameter ramps. The settled value is
+// always recomputed with the exact std:: functions, so these only need to be close, not equal.
+
+inline float bitsToFloat(std::int32_t i) noexcept { float f; std::memcpy(&f, &i, sizeof f); return f; }
+
+constexpr float kLn2   = 0.69314718f;
+constexpr float kLog2e = 1.44269504f;
+constexpr float kLn10  = 2.30258509f;
+
+// e^x for x <= 0, relative error ~1e-7 (0 below -87)
+inline float exp(float x) noexcept
+{
+    if (x < -87.0f) return 0.0f;
+    // x = n ln2 + y with n = round(x / ln2), |y| <= ln2 / 2
+    const std::int32_t n = (std::int32_t) (x * kLog2e + 128.5f) - 128; // floor(. + 0.5), argument > 0
+    const float y = x - (float) n * kLn2;
+    const float p = 1.0f + y * (1.0f + y * (1.0f / 2.0f + y * (1.0f / 6.0f + y * (1.0f / 24.0f
+                  + y * (1.0f / 120.0f + y * (1.0f / 720.0f + y * (1.0f / 5040.0f)))))));
+    return p * bitsToFloat((n + 127) << 23);
+}
+
+// tan(x) / (1 + tan(x)) for x in [0, pi/2): the TPT one-pole coefficient, written as
+// sin / (sin + cos) so there is no pole near Nyquist. Absolute error ~1e-6.
+inline float tptCoefficient(float x) noexcept
+{
+    const float x2 = x * x;
+    const float s = x * (1.0f - x2 * (1.0f / 6.0f - x2 * (1.0f / 120.0f - x2 * (1.0f / 5040.0f - x2 * (1.0f / 362880.0f)))));
+    const float c = 1.0f - x2 * (1.0f / 2.0f - x2 * (1.0f / 24.0f - x2 * (1.0f / 720.0f - x2 * (1.0f / 40320.0f - x2 * (1.0f / 3628800.0f)))));
+    return s / (s + c);
+}
+
+} // namespace hgr::dsp::fastmath
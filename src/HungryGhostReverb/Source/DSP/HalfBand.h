@@ -0,0 +1,141 @@
+#pragma once
+
+#include <array>
+
+namespace hgr::dsp {
+
+// 2:1 polyphase IIR half-band (elliptic, Valenzuela & Constantinides): two branches of
+// first-order allpasses running at the low rate, H(z) = (A0(z^2) + z^-1 A1(z^2)) / 2. The same
+// structure as juce::dsp::Oversampling's filterHalfBandPolyphaseIIR, with coefficients from
+// FilterDesign::designIIRLowpassHalfBandPolyphaseAllpassMethod. Not linear phase, which a
+// diffuse tail does not mind; in exchange it costs 4-5 multiplies per low-rate sample.
+class HalfBandStage {
+public:
+    static constexpr int kMaxPerBranch = 3;
+
+    // steep: transition 0.1 fs, -87 dB (passband to 0.2 fs), for the stage next to the low
+    // rate. Otherwise transition 0.2 fs, -100 dB, for outer stages: their transition band lies
+    // above the next stage's passband.
+    void prepare(bool steep)
+    {
+        static constexpr float steepDirect[]  = { 0.0542307809f, 0.3987969736f, 0.8629178127f };
+        static constexpr float steepDelayed[] = { 0.1996995794f, 0.6210968451f };
+        static constexpr float wideDirect[]   = { 0.0495510353f, 0.4267366888f };
+        static constexpr float wideDelayed[]  = { 0.1935703263f, 0.7670700728f };
+
+        numDirect = steep ? 3 : 2;
+        numDelayed = 2;
+        for (int i = 0; i < numDirect; ++i) direct[i].a = steep ? steepDirect[i] : wideDirect[i];
+        for (int i = 0; i < numDelayed; ++i) delayed[i].a = steep ? steepDelayed[i] : wideDelayed[i];
+        reset();
+    }
+
+    void reset()
+    {
+        for (auto& s : direct) s.x1 = s.y1 = 0.0f;
+        for (auto& s : delayed) s.x1 = s.y1 = 0.0f;
+        phase = false;
+        held = 0.0f;
+    }
+
+    // Decimate: true (and out) on every second input
+    inline bool decimate(float x, float& out) noexcept
+    {
+        if (! phase)
+        {
+            held = run(delayed, numDelayed, x);
+            phase = true;
+            return false;
+        }
+        phase = false;
+        out = 0.5f * (run(direct, numDirect, x) + held);
+        return true;
+    }
+
+    // Interpolate: two outputs per input, unity passband gain
+    inline void interpolate(float x, float& out0, float& out1) noexcept
+    {
+        out0 = run(direct, numDirect, x);
+        out1 = run(delayed, numDelayed, x);
+    }
+
+private:
+    struct Section { float a = 0.0f, x1 = 0.0f, y1 = 0.0f; };
+
+    // Cascade of (a + z^-1) / (1 + a z^-1) at the low rate
+    static inline float run(std::array<Section, kMaxPerBranch>& s, int n, float x) noexcept
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            const float y = s[i].a * (x - s[i].y1) + s[i].x1;
+            s[i].x1 = x;
+            s[i].y1 = y;
+            x = y;
+        }
+        return x;
+    }
+
+    std::array<Section, kMaxPerBranch> direct {}, delayed {};
+    int numDirect = 0, numDelayed = 0;
+    bool phase = false;
+    float held = 0.0f;
+};
+
+// Cascade of half-band stages for a 2^numStages rate change (up to 8x). Stage 0 is at the
+// high rate; the last stage, next to the low rate, is the steep one.
+class HalfBandResampler {
+public:
+    static constexpr int kMaxStages = 3;
+
+    void prepare(int stagesIn)
+    {
+        stages = stagesIn < 0 ? 0 : (stagesIn > kMaxStages ? kMaxStages : stagesIn);
+        for (int s = 0; s < stages; ++s)
+            stage[s].prepare(s == stages - 1);
+        reset();
+    }
+
+    void reset() { for (auto& s : stage) s.reset(); }
+
+    int getFactor() const noexcept { return 1 << stages; }
+
+    // n high-rate samples in, the low-rate samples they complete out (in may alias out).
+    // Returns the number written.
+    int decimate(const float* in, int n, float* out) noexcept
+    {
+        int m = 0;
+        for (int k = 0; k < n; ++k)
+        {
+            float x = in[k];
+            bool ready = true;
+            for (int s = 0; s < stages && ready; ++s)
+                ready = stage[s].decimate(x, x);
+            if (ready)
+                out[m++] = x;
+        }
+        return m;
+    }
+
+    // n low-rate samples in, n * getFactor() high-rate samples out
+    void interpolate(const float* in, int n, float* out) noexcept
+    {
+        const int f = getFactor();
+        for (int k = 0; k < n; ++k)
+        {
+            float buf[2][1 << kMaxStages];
+            buf[0][0] = in[k];
+            int len = 1, cur = 0;
+            for (int s = stages - 1; s >= 0; --s, len *= 2, cur ^= 1)
+                for (int i = 0; i < len; ++i)
+                    stage[s].interpolate(buf[cur][i], buf[cur ^ 1][2 * i], buf[cur ^ 1][2 * i + 1]);
+            for (int i = 0; i < f; ++i)
+                out[k * f + i] = buf[cur][i];
+        }
+    }
+
+private:
+    std::array<HalfBandStage, kMaxStages> stage {};
+    int stages = 0;
+};
+
+} // namespace hgr::dsp
@@ -2,57 +2,130 @@
 
 #include <cmath>
 #include <cstdint>
-#include <random>
 
 namespace hgr::dsp {
 
-// Simple sine LFO + optional jitter
+// Sine LFO + optional jitter, evaluated at a control rate.
+// A quadrature (rotation) oscillator advances once per control interval and the offset is
+// linearly interpolated in between, so the per-sample cost is two ramp adds and a multiply.
+// The jitter is TPDF noise from a xorshift generator drawn at the same rate, which the
+// interpolation low-passes.
 class LFO {
 public:
+    static constexpr int kDefaultControlInterval = 32; // samples per oscillator step
+
     void prepare(double sampleRate, int seed = 1337)
     {
         fs = sampleRate;
-        phase = 0.0f;
-        rng.seed((uint32_t) seed);
+        rng = (uint32_t) seed != 0 ? (uint32_t) seed : 0x9e3779b9u;
+        updateInc();
+        setPhase(0.0f);
+    }
+
+    void setRateHz(float hz)
+    {
+        if (hz == rateHz) return;
+        rateHz = hz;
+        updateInc();
     }
 
-    void setRateHz(float hz) { rateHz = hz; updateInc(); }
     void setDepthSamples(float samples) { depthSamples = samples; }
     float getDepthSamples() const { return depthSamples; }
 
-    void setPhase(float ph) { phase = wrap01(ph); }
-    void randomisePhase() { std::uniform_real_distribution<float> d(0.0f, 1.0f); setPhase(d(rng)); }
+    // Samples between oscillator steps; shorter tracks fast rates more closely
+    void setControlInterval(int samples)
+    {
+        interval = samples < 1 ? 1 : samples;
+        invInterval = 1.0f / (float) interval;
+        updateInc();
+    }
 
-    inline float nextOffsetSamples()
+    void setPhase(float ph)
     {
-        // sine LFO; jitter is tiny filtered noise
         const float twoPi = 6.283185307179586f;
-        const float off = std::sin(twoPi * phase) * depthSamples + smallJitter();
-        phase += inc;
-        if (phase >= 1.0f) phase -= 1.0f;
+        const float p = wrap01(ph);
+        c = std::cos(twoPi * p);
+        s = std::sin(twoPi * p);
+        sineTarget = s;
+        jitterTarget = 0.0f;
+        remaining = 0;
+    }
+
+    void randomisePhase() { setPhase(uniform()); }
+
+    inline float nextOffsetSamples() noexcept
+    {
+        if (remaining == 0) step();
+        --remaining;
+        const float off = sine * depthSamples + jitter;
+        sine += sineSlope;
+        jitter += jitterSlope;
         return off;
     }
 
 private:
-    void updateInc() { inc = (float) (rateHz / fs); }
+    void updateInc()
+    {
+        const float twoPi = 6.283185307179586f;
+        const double theta = twoPi * (double) rateHz * (double) interval / fs;
+        rotC = (float) std::cos(theta);
+        rotS = (float) std::sin(theta);
+    }
+
     static float wrap01(float x) { x -= std::floor(x); return x; }
 
-    float smallJitter()
+    // Start the next control interval: ramp from the last targets to the next oscillator point
+    void step() noexcept
+    {
+        sine = sineTarget;
+        jitter = jitterTarget;
+
+        const float cn = c * rotC - s * rotS;
+        const float sn = s * rotC + c * rotS;
+        // First-order renormalisation keeps the rotation on the unit circle
+        const float g = 1.5f - 0.5f * (cn * cn + sn * sn);
+        c = cn * g;
+        s = sn * g;
+
+        sineTarget = s;
+        jitterTarget = smallJitter();
+        sineSlope = (sineTarget - sine) * invInterval;
+        jitterSlope = (jitterTarget - jitter) * invInterval;
+        remaining = interval;
+    }
+
+    float uniform() noexcept
+    {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        return (float) (rng >> 8) * (1.0f / 16777216.0f);
+    }
+
+    float smallJitter() noexcept
     {
         // TPDF-like small noise (~1e-4 samples)
-        const float a = uni(rng) - 0.5f;
-        const float b = uni(rng) - 0.5f;
+        const float a = uniform() - 0.5f;
+        const float b = uniform() - 0.5f;
         return (a + b) * 1e-4f;
     }
 
     double fs = 48000.0;
     float rateHz = 0.3f;
     float depthSamples = 0.0f;
-    float phase = 0.0f;
-    float inc = 0.0f;
-    std::mt19937 rng { 1337u };
-    std::uniform_real_distribution<float> uni { 0.0f, 1.0f };
+    int interval = kDefaultControlInterval;
+    float invInterval = 1.0f / (float) kDefaultControlInterval;
+
+    // Oscillator state (cos, sin) and its per-step rotation
+    float c = 1.0f, s = 0.0f;
+    float rotC = 1.0f, rotS = 0.0f;
+
+    // Current interval: unit sine and jitter ramps
+    float sine = 0.0f, sineSlope = 0.0f, sineTarget = 0.0f;
+    float jitter = 0.0f, jitterSlope = 0.0f, jitterTarget = 0.0f;
+    int remaining = 0;
+
+    uint32_t rng = 1337u;
 };
 
 } // namespace hgr::dsp
-
@@ -22,6 +22,16 @@ struct ReverbParameters {
     int   seed          = 1337;    // deterministic phases
     bool  freeze        = false;   // sustain tails
     ReverbMode mode     = ReverbMode::Hall; // Hall, Room, Plate, Ambience
+
+    bool operator== (const ReverbParameters& o) const noexcept
+    {
+        return mixPercent == o.mixPercent && decaySeconds == o.decaySeconds && size == o.size
+            && predelayMs == o.predelayMs && diffusion == o.diffusion && modRateHz == o.modRateHz
+            && modDepthMs == o.modDepthMs && hfDampingHz == o.hfDampingHz && lowCutHz == o.lowCutHz
+            && highCutHz == o.highCutHz && width == o.width && seed == o.seed && freeze == o.freeze
+            && mode == o.mode;
+    }
+    bool operator!= (const ReverbParameters& o) const noexcept { return ! (*this == o); }
 };
 
 } // namespace hgr::dsp
@@ -2,11 +2,20 @@
 
 #include <JuceHeader.h>
 #include <cmath>
+#include <limits>
 #include "ParameterTypes.h"
 #include "Allpass.h"
 #include "FDN.h"
 #include "DampingFilter.h"
+#include "DelayArena.h"
 #include "DelayLine.h"
+#include "HalfBand.h"
+#include <audio/PartitionedConvolver.h>
+#include <audio/Profiler.h>
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <vector>
 
 namespace hgr::dsp {
 
@@ -24,151 +33,230 @@ public:
         highSm.reset(fs, 0.02);
         rt60Sm.reset(fs, 0.02);
 
-        // Predelay lines per channel (up to 200 ms)
-        const int maxPredelaySamples = (int) std::ceil(0.2 * fs);
+        // Late field at 44.1/48 kHz when the host runs at a 2x/4x/8x multiple
+        int stages = 0;
+        while (decimateTank && stages < HalfBandResampler::kMaxStages && fs / (double) (2 << stages) >= 44000.0)
+            ++stages;
+        tankDownL.prepare(stages);
+        tankDownR.prepare(stages);
+        tankUpL.prepare(stages);
+        tankUpR.prepare(stages);
+        tankFactor = tankDownL.getFactor();
+        tankFs = fs / tankFactor;
+        wetL.fill(0.0f);
+        wetR.fill(0.0f);
+        wetPending = tankFactor - 1;
+
+        // A network pair for every line count a mode uses, without delay memory yet. The counts
+        // are fixed here: later setModeLineCount() calls wait for the next prepare().
+        preparedLines = modeLines;
+        prepareTanks(tanks4);
+        prepareTanks(tanks8);
+        prepareTanks(tanks16);
+        prepareTanks(tanks32);
+        tankFloats = 0;
+        for (int lines : preparedLines)
+            withFdn(lines, 0, [&](auto& f){ tankFloats = juce::jmax(tankFloats, f.delayMemoryFloats()); });
+
+        // All delay memory in one block: size it, then hand it out
+        arena.beginSizing();
+        layoutDelays();
+        arena.allocate();
+        layoutDelays();
+
+        // Input diffusion: 4 stages per channel, short delays
         for (int ch = 0; ch < 2; ++ch)
-        {
-            predelay[ch].prepare(fs, maxPredelaySamples);
-            // Input diffusion: 4 stages per channel, short delays
             for (int i = 0; i < 4; ++i) {
-                diffuser[ch][i].prepare(fs, (int) std::ceil(0.02 * fs)); // up to 20 ms
                 diffuser[ch][i].setGain(0.7f);
-                diffuser[ch][i].setDelaySamples((int) std::round((0.005f + 0.002f * i) * fs)); // 5..11 ms
+                diffuser[ch][i].setDelaySamples((int) std::round((0.005f + 0.002f * i) * tankFs)); // 5..11 ms
             }
-        }
 
-        fdnA.prepare(fs, maxBlock);
-        fdnB.prepare(fs, maxBlock);
-        useA = true;
+        activeLines = lineCountFor(params.mode);
+        activeSlot = 0;
+        activeMem = 0;
+        withFdn(activeLines, activeSlot, [&](auto& f){ f.bindDelayMemory(tankMem[0]); });
         xfActive = false;
         xf = 0.0f;
         const float tauXf = 0.10f; // 100 ms crossfade
-        xfAlpha = 1.0f - std::exp(-1.0f / (float) (tauXf * fs));
+        xfAlpha = 1.0f - std::exp(-1.0f / (float) (tauXf * tankFs));
         lastSizeApplied = 1.0f;
         for (int ch = 0; ch < 2; ++ch) {
             postLowCut[ch].reset();
             postHighCut[ch].reset();
-            postLowCut[ch].prepare(sampleRate);
-            postHighCut[ch].prepare(sampleRate);
+            postLowCut[ch].prepare(tankFs);
+            postHighCut[ch].prepare(tankFs);
             postHighCut[ch].setCutoffHz(18000.0f);
         }
+
+        // The tanks and filters were rebuilt with defaults: the next setParameters() and control
+        // update apply everything
+        paramsApplied = false;
+        controlsDirty = true;
+        idle = true; // nothing in the tank yet
+        tailLevelDb = kSilenceDb;
+        lastWetPeak = 0.0f;
+
+        // A rendered tank is only valid at the tank rate it was rendered for
+        if (staticTank != nullptr)
+            renderStaticImpulse(staticTank->usesBackgroundThread());
     }
 
     void reset()
     {
-        for (int ch = 0; ch < 2; ++ch) {
-            predelay[ch].reset();
-            for (auto& ap : diffuser[ch]) ap.reset();
-            postLowCut[ch].reset();
-            postHighCut[ch].reset();
-        }
-        fdnA.reset();
-        fdnB.reset();
+        clearState();
+        idle = true;
+        tailLevelDb = kSilenceDb;
+        lastWetPeak = 0.0f;
         mixSmoothed.reset(fs, 0.05);
-        widthSmoothed.reset(fs, 0.05);
+        widthSmoothed.reset(tankFs, 0.05); // applied in the tank's stereo mix
     }
 
-    void setParameters(const ReverbParameters& p)
+    // Run the late field (diffusion, FDN, post EQ and the ER blend of the diffused input) at
+    // fs / 2^k = 44.1/48 kHz at 88.2 kHz and above, between half-band decimation and
+    // interpolation; predelay and the dry/wet mix stay at the host rate. Takes effect at the
+    // next prepare().
+    void setTankDecimation(bool enabled) noexcept { decimateTank = enabled; }
+    bool isTankDecimated() const noexcept { return tankFactor > 1; }
+
+    // Host tail: predelay, diffusion and the longest tank line, then 120 dB of decay (2 x RT60);
+    // infinite while frozen. Follows the last setParameters().
+    double getTailLengthSeconds() const noexcept { return tailSeconds; }
+
+    // True while the engine is parked on the dry-only path (input and tail below -120 dBFS)
+    bool isIdle() const noexcept { return idle; }
+
+    // Tank network size per mode: 4 lines (cheapest, sparse), 8 (default), 16 or 32 (densest,
+    // about 4x the CPU of 8); other counts round up to the next size. Every size in use has its
+    // networks prepared, so a change takes effect at the next prepare(). Switching modes between
+    // sizes crossfades into the other network like a size change.
+    void setModeLineCount(ReverbMode m, int numLines) noexcept
     {
-        params = p;
+        const int lines = numLines <= 4 ? 4 : numLines <= 8 ? 8 : numLines <= 16 ? 16 : 32;
+        modeLines[(size_t) juce::jlimit(0, 3, static_cast<int>(m))] = lines;
+    }
+    int getModeLineCount(ReverbMode m) const noexcept { return modeLines[(size_t) juce::jlimit(0, 3, static_cast<int>(m))]; }
+
+    // Lines in the network currently audible
+    int getActiveLineCount() const noexcept { return activeLines; }
+
+    // Bytes of delay memory: predelays, diffusers and room for two networks of the largest
+    // size in use (the audible one and one a crossfade brings in)
+    std::size_t getDelayMemoryBytes() const noexcept { return arena.getBytes(); }
+
+    // Static late field: renders the tank as the last setParameters() configured it (mode, size,
+    // decay, damping, modulation, seed and width) to a stereo impulse response at the tank rate,
+    // then convolves the tank feed with that (audio::PartitionedConvolver, large partitions on
+    // its worker thread unless backgroundThread is false) instead of running the FDN. Predelay,
+    // diffusion, post EQ, the ER blend and the mix stay live; the tank settings hold until the
+    // next render, the LFO motion is baked in as rendered, and freeze has no effect. Allocates
+    // and renders up to kMaxStaticSeconds of tank: like prepare(), never while process() runs.
+    void renderStaticImpulse(bool backgroundThread = true)
+    {
+        const TankProfile prof = profileFor(params);
+
+        // Onset plus 120 dB of decay, as for the host tail, then trimmed where it falls 100 dB
+        // below its peak
+        const double longestLineSec = kFdnLongestDelay48k / 48000.0 * (double) juce::jlimit(0.5f, 1.5f, prof.size);
+        const double seconds = juce::jmin(kMaxStaticSeconds, longestLineSec + 2.0 * (double) juce::jlimit(0.1f, 60.0f, prof.rt60));
+        int length = (int) std::ceil(seconds * tankFs);
+        std::vector<float> irL((size_t) length), irR((size_t) length);
+        switch (lineCountFor(prof.mode))
+        {
+            case 4:  renderTank<4>(prof, irL.data(), irR.data(), length); break;
+            case 16: renderTank<16>(prof, irL.data(), irR.data(), length); break;
+            case 32: renderTank<32>(prof, irL.data(), irR.data(), length); break;
+            default: renderTank<8>(prof, irL.data(), irR.data(), length); break;
+        }
+        float peak = 0.0f;
+        for (int n = 0; n < length; ++n)
+            peak = juce::jmax(peak, std::abs(irL[(size_t) n]), std::abs(irR[(size_t) n]));
+        const float floor = peak * 1.0e-5f;
+        while (length > 1 && std::abs(irL[(size_t) length - 1]) <= floor && std::abs(irR[(size_t) length - 1]) <= floor)
+            --length;
+
+        auto conv = std::make_unique<audio::PartitionedConvolver>();
+        const float* ir[2] { irL.data(), irR.data() };
+        conv->prepare(ir, 2, length, backgroundThread);
+        staticTank = std::move(conv);
+    }
 
-        // Mode mapping (clamp underlying int into enum range)
-        const int mi = juce::jlimit(0, 3, static_cast<int>(params.mode));
-        mode = static_cast<ReverbMode>(mi);
+    // Back to the live FDN
+    void clearStaticImpulse() { staticTank.reset(); }
 
-        // Defaults (Hall-like)
-        numDiffusionStages = 4;
-        erBlend = 0.15f;
-        float sizeMul = 1.0f;
-        float hfDampOverrideHz = params.hfDampingHz;
-        float gDiffuserBase = 0.70f;
-        float rateMul = 1.0f, depthMul = 1.2f;
-        int   modMaskVariant = 0; // 0=longest half, 1=more lines
-        predelayMul = 1.0f;
+    bool isStaticImpulse() const noexcept { return staticTank != nullptr; }
 
-        switch (mode)
-        {
-            case ReverbMode::Room:
-                numDiffusionStages = 3;
-                erBlend = 0.12f;
-                sizeMul = 0.90f;
-                hfDampOverrideHz = 8000.0f;
-                gDiffuserBase = 0.62f;
-                rateMul = 1.2f;
-                depthMul = 0.9f;
-                modMaskVariant = 0;
-                predelayMul = 0.6f;
-                break;
-            case ReverbMode::Plate:
-                numDiffusionStages = 3;
-                erBlend = 0.10f;
-                sizeMul = 1.00f;
-                hfDampOverrideHz = 14000.0f;
-                gDiffuserBase = 0.78f;
-                rateMul = 1.6f;
-                depthMul = 0.7f;
-                modMaskVariant = 1; // mod more lines
-                predelayMul = 0.3f;
-                break;
-            case ReverbMode::Ambience:
-                numDiffusionStages = 2;
-                erBlend = 0.30f;
-                sizeMul = 0.75f;
-                hfDampOverrideHz = 11000.0f;
-                gDiffuserBase = 0.58f;
-                rateMul = 0.7f;
-                depthMul = 0.5f;
-                modMaskVariant = 0;
-                predelayMul = 0.2f;
-                break;
-            case ReverbMode::Hall:
-            default:
-                numDiffusionStages = 4;
-                erBlend = 0.15f;
-                sizeMul = 1.20f;
-                hfDampOverrideHz = 12000.0f;
-                gDiffuserBase = 0.72f;
-                rateMul = 0.9f;
-                depthMul = 1.3f;
-                modMaskVariant = 0;
-                predelayMul = 1.2f;
-                break;
-        }
-        numDiffusionStages = juce::jlimit(1, 4, numDiffusionStages);
+    // Rendered IR length in tank-rate samples (0 while live)
+    int getStaticImpulseLength() const noexcept { return staticTank != nullptr ? staticTank->getImpulseLength() : 0; }
 
-        // Map to internal modules with mode shaping
-        // Apply to both tanks; crossfade will decide which is audible
-        const float sizeEff = params.size * sizeMul;
-        const float rt60Eff = params.decaySeconds;
-        const float hfEff   = hfDampOverrideHz;
+    // Cheap when nothing moved: an unchanged snapshot returns at once, and the seed-derived LFO
+    // phases and diffuser delays are only rebuilt when the seed changes
+    void setParameters(const ReverbParameters& p)
+    {
+        if (paramsApplied && p == params)
+            return;
+        const bool seedChanged = ! paramsApplied || p.seed != params.seed;
+        params = p;
+        paramsApplied = true;
+        controlsDirty = true;
 
-        // Clamp modulation depth for non-Plate modes to avoid chorus; allow deeper in Plate
-        float modDepthMsPolicy = params.modDepthMs * depthMul;
-        if (mode != ReverbMode::Plate)
-        {
-            const float depthSamples = (float) (modDepthMsPolicy * 1e-3 * fs);
-            const float cappedSamples = juce::jlimit(0.0f, 8.0f * (float) (fs / 48000.0), depthSamples);
-            modDepthMsPolicy = cappedSamples * 1e3f / (float) fs;
-        }
+        const TankProfile prof = profileFor(params);
+        mode = prof.mode;
+        numDiffusionStages = prof.numDiffusionStages;
+        erBlend = prof.erBlend;
+        predelayMul = prof.predelayMul;
+
+        // Apply to both tanks; crossfade will decide which is audible
+        const float sizeEff = prof.size;
+        const float rt60Eff = prof.rt60;
+        const float hfEff   = prof.hfDampingHz;
 
-        auto applyCommon = [&](FDN8& f){
-            f.setSeed(params.seed);
+        auto applyCommon = [&](auto& f){
+            if (seedChanged)
+                f.setSeed(params.seed); // restarts the LFOs
             f.setRT60(rt60Eff);
             f.setHFDampingHz(hfEff);
-            f.setModulation(params.modRateHz * rateMul, modDepthMsPolicy);
-            f.setModulationMaskVariant(modMaskVariant);
+            f.setModulation(prof.modRateHz, prof.modDepthMs);
+            f.setModulationMaskVariant(prof.modMaskVariant);
         };
 
+        // A mode with another network size crossfades into that network; a crossfade already
+        // running to another network finishes at once
+        const int lines = lineCountFor(mode);
+        if (xfActive && xfLines != lines)
+            finishCrossfade();
+
         // Decide whether to start a size crossfade
         const float sizeDelta = std::abs(sizeEff - lastSizeApplied);
         const float sizeThresh = 0.02f; // 2% change triggers crossfade
-        if (!xfActive && sizeDelta > sizeThresh)
+        if (!xfActive && (sizeDelta > sizeThresh || lines != activeLines))
         {
-            // Configure idle tank with new size and common params
-            idleFdn().setSize(sizeEff);
-            applyCommon(idleFdn());
+            // Configure idle tank with new size and common params: the other network of the pair,
+            // or a network of the new size, whose pair starts from silence with every setting
+            if (lines == activeLines)
+            {
+                withFdn(lines, 1 - activeSlot, [&](auto& f){
+                    f.setSize(sizeEff);
+                    applyCommon(f);
+                });
+            }
+            else
+            {
+                withPair(lines, [&](auto& t){
+                    for (auto& f : t.fdn)
+                    {
+                        f.reset();
+                        f.setSeed(params.seed);
+                        f.setSize(sizeEff);
+                        applyCommon(f);
+                    }
+                });
+            }
+            xfLines = lines;
+            xfSlot = lines == activeLines ? 1 - activeSlot : 0;
+            // The incoming network takes the free memory slot and starts from silence
+            withFdn(xfLines, xfSlot, [&](auto& f){ f.bindDelayMemory(tankMem[(size_t) (1 - activeMem)]); });
             // Ensure active tank keeps old size until crossfade completes
-            applyCommon(activeFdn());
+            withFdn(activeLines, activeSlot, applyCommon);
             // Start crossfade
             xfActive = true;
             xf = 0.0f;
@@ -177,10 +265,10 @@ public:
         else
         {
             // No crossfade: apply size immediately to both (safe small change)
-            activeFdn().setSize(sizeEff);
-            idleFdn().setSize(sizeEff);
-            applyCommon(activeFdn());
-            applyCommon(idleFdn());
+            forLiveTanks([&](auto& f){
+                f.setSize(sizeEff);
+                applyCommon(f);
+            });
             lastSizeApplied = sizeEff;
         }
 
@@ -204,12 +292,15 @@ public:
             v ^= (uint32_t) (ch * 131);
             return (v & 1u) ? +1.0f : -1.0f;
         };
-        for (int ch = 0; ch < 2; ++ch) {
-            for (int i = 0; i < 4; ++i) {
-                const float baseMs = 5.0f + 2.0f * (float) i;
-                const float jitterMs = 0.15f * jitterSign(i, ch);
-                const int dSamp = (int) std::round((baseMs + jitterMs) * 1e-3f * (float) fs);
-                diffuser[ch][i].setDelaySamples(juce::jmax(1, dSamp));
+        if (seedChanged)
+        {
+            for (int ch = 0; ch < 2; ++ch) {
+                for (int i = 0; i < 4; ++i) {
+                    const float baseMs = 5.0f + 2.0f * (float) i;
+                    const float jitterMs = 0.15f * jitterSign(i, ch);
+                    const int dSamp = (int) std::round((baseMs + jitterMs) * 1e-3f * (float) tankFs);
+                    diffuser[ch][i].setDelaySamples(juce::jmax(1, dSamp));
+                }
             }
         }
 
@@ -217,17 +308,24 @@ public:
         widthSmoothed.setTargetValue(juce::jlimit(0.0f, 1.0f, params.width));
 
         // Freeze handling after params applied so it can override motion/EQ
-        activeFdn().setFreeze(params.freeze);
-        idleFdn().setFreeze(params.freeze);
+        forLiveTanks([&](auto& f){ f.setFreeze(params.freeze); });
 
         // Diffusion coefficient with perceptual taper; mode base steers range
         const float t = std::pow(juce::jlimit(0.0f, 1.0f, params.diffusion), 0.65f);
-        float minG = juce::jlimit(0.6f, 0.85f, gDiffuserBase - 0.10f);
-        float maxG = juce::jlimit(0.6f, 0.85f, gDiffuserBase + 0.10f);
+        float minG = juce::jlimit(0.6f, 0.85f, prof.gDiffuserBase - 0.10f);
+        float maxG = juce::jlimit(0.6f, 0.85f, prof.gDiffuserBase + 0.10f);
         if (minG > maxG) std::swap(minG, maxG);
         const float g = juce::jlimit(0.0f, 0.99f, juce::jmap(t, minG, maxG));
         for (int ch = 0; ch < 2; ++ch)
             for (auto& ap : diffuser[ch]) ap.setGain(g);
+
+        // Tail: the tank output starts after predelay + diffusion and takes up to the longest
+        // line to build up; it is then gone after 120 dB of decay
+        const double longestLineSec = kFdnLongestDelay48k / 48000.0 * (double) juce::jlimit(0.5f, 1.5f, sizeEff);
+        const double onsetSec = (double) predelaySamples() / fs + 0.03 + longestLineSec;
+        tailHoldSamples = (int) std::ceil(onsetSec * fs);
+        tailSeconds = params.freeze ? std::numeric_limits<double>::infinity()
+                                    : onsetSec + 2.0 * (double) juce::jlimit(0.1f, 60.0f, rt60Eff);
     }
 
     void process(juce::dsp::AudioBlock<float>& block)
@@ -238,105 +336,469 @@ public:
         if (numCh <= 0 || numSamp <= 0)
             return;
 
-        for (int n = 0; n < numSamp; ++n)
+        // Silent input on a decayed tail: dry-only path, no tank
+        if (updateIdle(block))
+        {
+            processIdle(block);
+            return;
+        }
+        lastWetPeak = 0.0f;
+
+        // Predelay and input diffusion run a chunk at a time ahead of the tank: each stage is a
+        // tight loop of its own (and can be timed on its own); per sample the result is unchanged
+        for (int start = 0; start < numSamp; start += kChunk)
         {
-            // 1) Read dry input for this sample (cache before writing)
-            const float inL = block.getChannelPointer(0)[n];
-            const float inR = (numCh > 1 ? block.getChannelPointer(1)[n] : inL);
-
-            // 2) Predelay on each channel's feed, then input diffusion per channel
-            const float preL = predelay[0].processSample(inL, predelaySamples());
-            const float preR = predelay[1].processSample(inR, predelaySamples());
-
-            float difL = preL;
-            float difR = preR;
-            for (int i = 0; i < numDiffusionStages; ++i) {
-                difL = diffuser[0][i].processSample(difL);
-                difR = diffuser[1][i].processSample(difR);
+            const int len = juce::jmin(kChunk, numSamp - start);
+            const float* inL = block.getChannelPointer(0) + start;
+            const float* inR = numCh > 1 ? block.getChannelPointer(1) + start : inL;
+
+            // 1) Predelay on each channel's feed
+            {
+                HG_PROFILE_SCOPE(profiler, "reverb.predelay");
+                const float d = predelaySamples();
+                for (int n = 0; n < len; ++n)
+                {
+                    diffL[(size_t) n] = predelay[0].processSample(inL[n], d);
+                    diffR[(size_t) n] = predelay[1].processSample(inR[n], d);
+                }
             }
 
-            // 3) Prepare mono feed from diffused mid (average L/R)
-            const float x = 0.5f * (difL + difR);
+            // 2) Input diffusion per channel (with a decimated tank, at the tank rate instead)
+            if (tankFactor == 1)
+            {
+                HG_PROFILE_SCOPE(profiler, "reverb.diffusion");
+                diffuse(diffL.data(), diffR.data(), len);
+            }
 
-            // 4) Mix to stereo and post-EQ
-            float wetL = 0.0f, wetR = 0.0f;
-            const float widthNow = widthSmoothed.getNextValue();
+            HG_PROFILE_SCOPE(profiler, "reverb.fdn");
+            processTank(block, start, len, numSamp);
+        }
+    }
+
+private:
+    static constexpr int kChunk = 256;
+    // Predelay range: the parameter's 0..200 ms times the mode's multiplier, at most Hall's 1.2
+    static constexpr double kMaxPredelayMs = 200.0;
+    static constexpr float kMaxPredelayMul = 1.2f;
+    static constexpr double kMaxStaticSeconds = 30.0; // longest rendered tank IR
+
+    void diffuse(float* L, float* R, int n) noexcept
+    {
+        for (int i = 0; i < numDiffusionStages; ++i)
+        {
+            auto& apL = diffuser[0][i];
+            auto& apR = diffuser[1][i];
+            for (int k = 0; k < n; ++k)
+            {
+                L[k] = apL.processSample(L[k]);
+                R[k] = apR.processSample(R[k]);
+            }
+        }
+    }
+
+    // 3) .. 6): tank, post EQ and the dry/wet mix for block samples [start, start + len).
+    // Control updates fall on the same host samples at every tank rate. With a decimated tank,
+    // the predelayed feed goes down to the tank rate, where diffusion, the tank, post EQ and the
+    // ER blend run, and the finished wet signal comes back up into the wet queue, which holds
+    // the up to factor - 1 samples one segment produces ahead of the host.
+    void processTank(juce::dsp::AudioBlock<float>& block, int start, int len, int numSamp) noexcept
+    {
+        const int numCh = (int) block.getNumChannels();
+        const int updStep = juce::jmax(1, numSamp / 8);
+
+        for (int i = 0; i < len;)
+        {
+            const int n0 = start + i;
 
             // Smoothly update EQ and tank damping/decay a few times per block
-            const int updStep = juce::jmax(1, numSamp / 8);
-            if ((n % updStep) == 0)
+            if ((n0 % updStep) == 0)
+                updateControls();
+
+            const int seg = juce::jmin(len - i, updStep - n0 % updStep);
+
+            if (tankFactor == 1)
             {
-                const float hfNow = hfSm.getNextValue();
-                const float lcNow = lowSm.getNextValue();
-                const float hcNow = highSm.getNextValue();
-                const float rtNow = rt60Sm.getNextValue();
-                activeFdn().setHFDampingHz(hfNow);
-                idleFdn().setHFDampingHz(hfNow);
-                activeFdn().setRT60(rtNow);
-                idleFdn().setRT60(rtNow);
-                postLowCut[0].setCutoffHz(lcNow); postLowCut[1].setCutoffHz(lcNow);
-                postHighCut[0].setCutoffHz(hcNow); postHighCut[1].setCutoffHz(hcNow);
+                // 3) Mono feed from diffused mid (average L/R)
+                for (int k = 0; k < seg; ++k)
+                    tankIn[(size_t) k] = 0.5f * (diffL[(size_t) (i + k)] + diffR[(size_t) (i + k)]);
+
+                // 4) Tank(s) and stereo mix, then post EQ and the ER blend
+                runTank(tankIn.data(), seg, wetL.data(), wetR.data());
+                finishWet(wetL.data(), wetR.data(), diffL.data() + i, diffR.data() + i, seg);
+            }
+            else
+            {
+                const int m = tankDownL.decimate(diffL.data() + i, seg, lowL.data());
+                tankDownR.decimate(diffR.data() + i, seg, lowR.data());
+                {
+                    HG_PROFILE_SCOPE(profiler, "reverb.diffusion");
+                    diffuse(lowL.data(), lowR.data(), m);
+                }
+                for (int k = 0; k < m; ++k)
+                    tankIn[(size_t) k] = 0.5f * (lowL[(size_t) k] + lowR[(size_t) k]);
+
+                runTank(tankIn.data(), m, tankOutL.data(), tankOutR.data());
+                finishWet(tankOutL.data(), tankOutR.data(), lowL.data(), lowR.data(), m);
+                tankUpL.interpolate(tankOutL.data(), m, wetL.data() + wetPending);
+                tankUpR.interpolate(tankOutR.data(), m, wetR.data() + wetPending);
+                wetPending += m * tankFactor - seg;
             }
 
-            float wetL_A = 0.0f, wetR_A = 0.0f;
-            float wetL_B = 0.0f, wetR_B = 0.0f;
+            // Mix gains are constant while the mix smoother is at rest
+            const bool mixMoving = mixSmoothed.isSmoothing();
+            float dryGain = std::sqrt(1.0f - mixSmoothed.getTargetValue());
+            float wetGain = std::sqrt(mixSmoothed.getTargetValue());
+            for (int k = 0; k < seg; ++k)
+            {
+                const int n = n0 + k;
+                const float inL = block.getChannelPointer(0)[n];
+                const float inR = (numCh > 1 ? block.getChannelPointer(1)[n] : inL);
+
+                // 5) Sanity: avoid propagating NaNs/Infs to host
+                float outL = wetL[(size_t) k];
+                float outR = wetR[(size_t) k];
+                if (! std::isfinite(outL)) outL = 0.0f;
+                if (! std::isfinite(outR)) outR = 0.0f;
+                lastWetPeak = juce::jmax(lastWetPeak, std::abs(outL), std::abs(outR));
+
+                // 6) Equal-power wet/dry mix to preserve perceived loudness
+                if (mixMoving)
+                {
+                    const float mix = mixSmoothed.getNextValue();
+                    dryGain = std::sqrt(1.0f - mix);
+                    wetGain = std::sqrt(mix);
+                }
+                block.getChannelPointer(0)[n] = dryGain * inL + wetGain * outL;
+                if (numCh > 1)
+                    block.getChannelPointer(1)[n] = dryGain * inR + wetGain * outR;
+            }
+
+            for (int k = 0; k < wetPending; ++k)
+            {
+                wetL[(size_t) k] = wetL[(size_t) (seg + k)];
+                wetR[(size_t) k] = wetR[(size_t) (seg + k)];
+            }
+            i += seg;
+        }
+    }
 
+    // Post EQ on the tank output, then blend in a small amount of the diffused input (early
+    // reflections) to guarantee audible wet
+    void finishWet(float* L, float* R, const float* erL, const float* erR, int n) noexcept
+    {
+        for (int k = 0; k < n; ++k)
+        {
+            L[k] = (1.0f - erBlend) * postEQ(L[k], 0) + erBlend * erL[k];
+            R[k] = (1.0f - erBlend) * postEQ(R[k], 1) + erBlend * erR[k];
+        }
+    }
+
+    // n tank-rate samples through the tank(s), or the rendered static tank, into outL/outR. The
+    // tanks run in whole FDN blocks (FDN::tickBlock); a block also ends on the sample a size
+    // crossfade completes, so every sample sees the same tank as with one tick() per sample.
+    void runTank(const float* in, int n, float* outL, float* outR) noexcept
+    {
+        if (staticTank != nullptr)
+        {
+            // Width is part of the rendered IR
+            float* out[2] { outL, outR };
+            staticTank->process(in, out, n);
+            widthSmoothed.skip(n);
+            return;
+        }
+
+        for (int i = 0; i < n;)
+        {
+            int seg = juce::jmin(n - i, maxBlockOf(activeLines, activeSlot));
             if (xfActive)
             {
-                float vA[FDN8::NumLines];
-                float vB[FDN8::NumLines];
-                // Tick both tanks
-                activeFdn().tick(x, vA);
-                idleFdn().tick(x, vB);
-                activeFdn().mixStereo(vA, widthNow, wetL_A, wetR_A);
-                idleFdn().mixStereo(vB, widthNow, wetL_B, wetR_B);
-                // Advance crossfade
-                xf += (1.0f - xf) * xfAlpha;
-                if (xf > 0.999f)
+                seg = juce::jmin(seg, maxBlockOf(xfLines, xfSlot));
+                // End the segment on the sample the crossfade completes
+                float t = xf;
+                for (int k = 0; k < seg; ++k)
                 {
-                    // Finish crossfade: swap tanks
-                    std::swap(fdnA, fdnB);
-                    useA = true; // after swap, A is active again
-                    xfActive = false;
-                    xf = 0.0f;
-                    lastSizeApplied = pendingSize;
+                    t += (1.0f - t) * xfAlpha;
+                    if (t > 0.999f) { seg = k + 1; break; }
                 }
             }
-            else
+
+            for (int k = 0; k < seg; ++k)
+                widthNow[(size_t) k] = widthSmoothed.getNextValue();
+
+            float* L = outL + i;
+            float* R = outR + i;
+            withPair(activeLines, [&](auto& t){ t.run(activeSlot, in + i, widthNow.data(), L, R, seg); });
+            if (xfActive)
             {
-                float vA[FDN8::NumLines];
-                activeFdn().tick(x, vA);
-                activeFdn().mixStereo(vA, widthNow, wetL_A, wetR_A);
+                withPair(xfLines, [&](auto& t){ t.run(xfSlot, in + i, widthNow.data(), wetLB.data(), wetRB.data(), seg); });
+                for (int k = 0; k < seg; ++k)
+                {
+                    xf += (1.0f - xf) * xfAlpha;
+                    if (xf > 0.999f)
+                    {
+                        // Finish crossfade. This last sample is still the old tank's.
+                        finishCrossfade();
+                        break;
+                    }
+                    L[k] = (1.0f - xf) * L[k] + xf * wetLB[(size_t) k];
+                    R[k] = (1.0f - xf) * R[k] + xf * wetRB[(size_t) k];
+                }
             }
+            i += seg;
+        }
+    }
+
+    // Steps the EQ and tank smoothers and recomputes only the coefficients that move: a smoother
+    // at rest costs nothing, one mid-ramp takes the fast approximations, and the value it
+    // settles on (or any value after setParameters()/prepare()) is set exactly
+    void updateControls() noexcept
+    {
+        const bool force = controlsDirty;
+        controlsDirty = false;
 
-            float wetLmix = xfActive ? ((1.0f - xf) * wetL_A + xf * wetL_B) : wetL_A;
-            float wetRmix = xfActive ? ((1.0f - xf) * wetR_A + xf * wetR_B) : wetR_A;
-            
-            wetL = wetLmix;
-            wetR = wetRmix;
-            wetL = postEQ(wetL, 0);
-            wetR = postEQ(wetR, 1);
-
-            // Blend in a small amount of diffused early reflections to guarantee audible wet
-            wetL = (1.0f - erBlend) * wetL + erBlend * difL;
-            wetR = (1.0f - erBlend) * wetR + erBlend * difR;
-
-            // 5) Sanity: avoid propagating NaNs/Infs to host
-            if (! std::isfinite(wetL)) wetL = 0.0f;
-            if (! std::isfinite(wetR)) wetR = 0.0f;
-
-            // 6) Equal-power wet/dry mix to preserve perceived loudness
-            const float mix = mixSmoothed.getNextValue();
-            const float dryGain = std::sqrt(1.0f - mix);
-            const float wetGain = std::sqrt(mix);
-            block.getChannelPointer(0)[n] = dryGain * inL + wetGain * wetL;
-            if (numCh > 1)
-                block.getChannelPointer(1)[n] = dryGain * inR + wetGain * wetR;
+        if (force || hfSm.isSmoothing())
+        {
+            const float hfNow = hfSm.getNextValue();
+            const bool approx = hfSm.isSmoothing();
+            forLiveTanks([&](auto& f){ f.setHFDampingHz(hfNow, approx); });
+        }
+        if (force || rt60Sm.isSmoothing())
+        {
+            const float rtNow = rt60Sm.getNextValue();
+            const bool approx = rt60Sm.isSmoothing();
+            forLiveTanks([&](auto& f){ f.setRT60(rtNow, approx); });
+        }
+        if (force || lowSm.isSmoothing())
+        {
+            const float lcNow = lowSm.getNextValue();
+            const bool approx = lowSm.isSmoothing();
+            postLowCut[0].setCutoffHz(lcNow, approx); postLowCut[1].setCutoffHz(lcNow, approx);
+        }
+        if (force || highSm.isSmoothing())
+        {
+            const float hcNow = highSm.getNextValue();
+            const bool approx = highSm.isSmoothing();
+            postHighCut[0].setCutoffHz(hcNow, approx); postHighCut[1].setCutoffHz(hcNow, approx);
         }
     }
 
-private:
-    inline float predelaySamples() const noexcept { return (float) ((params.predelayMs * predelayMul) * 1e-3 * fs); }
+    // Tail tracking. Non-silent input raises the tail estimate to its peak (+ a margin for the
+    // tank's build-up) and cancels idle at once. Over silent input the estimate holds for the
+    // tail onset, then falls at 60 dB per RT60; once it and the measured wet output are both
+    // below -120 dBFS the state is cleared and the engine goes idle. Never idle while frozen.
+    bool updateIdle(const juce::dsp::AudioBlock<float>& block) noexcept
+    {
+        const int numSamp = (int) block.getNumSamples();
+        float inPeak = 0.0f;
+        for (size_t ch = 0; ch < block.getNumChannels(); ++ch)
+        {
+            const auto r = juce::FloatVectorOperations::findMinAndMax(block.getChannelPointer(ch), numSamp);
+            inPeak = juce::jmax(inPeak, -r.getStart(), r.getEnd());
+        }
+
+        if (inPeak > kSilenceGain)
+        {
+            tailLevelDb = juce::jmax(tailLevelDb, juce::Decibels::gainToDecibels(inPeak) + kTailMarginDb);
+            silentSamples = 0;
+            idle = false;
+            return false;
+        }
+        if (idle)
+            return true;
+        if (params.freeze)
+            return false;
+
+        const int decaying = juce::jlimit(0, numSamp, silentSamples + numSamp - tailHoldSamples);
+        silentSamples = juce::jmin(silentSamples + numSamp, std::numeric_limits<int>::max() / 2);
+        const float rt60 = juce::jlimit(0.1f, 60.0f, params.decaySeconds);
+        tailLevelDb -= 60.0f * (float) decaying / (rt60 * (float) fs);
+        if (tailLevelDb > kSilenceDb || lastWetPeak > kSilenceGain)
+            return false;
+
+        clearState();
+        idle = true;
+        tailLevelDb = kSilenceDb;
+        return true;
+    }
+
+    // Dry signal only, with the mix ramp kept running
+    void processIdle(juce::dsp::AudioBlock<float>& block) noexcept
+    {
+        const int numCh = (int) block.getNumChannels();
+        const int numSamp = (int) block.getNumSamples();
+        widthSmoothed.skip(numSamp / tankFactor);
+        if (! mixSmoothed.isSmoothing())
+        {
+            const float dryGain = std::sqrt(1.0f - mixSmoothed.getTargetValue());
+            for (int ch = 0; ch < numCh; ++ch)
+                juce::FloatVectorOperations::multiply(block.getChannelPointer((size_t) ch), dryGain, numSamp);
+            return;
+        }
+        for (int n = 0; n < numSamp; ++n)
+        {
+            const float dryGain = std::sqrt(1.0f - mixSmoothed.getNextValue());
+            for (int ch = 0; ch < numCh; ++ch)
+                block.getChannelPointer((size_t) ch)[n] *= dryGain;
+        }
+    }
+
+    // Zero every delay and filter state (the smoothers keep running)
+    void clearState() noexcept
+    {
+        for (int ch = 0; ch < 2; ++ch) {
+            predelay[ch].reset();
+            for (auto& ap : diffuser[ch]) ap.reset();
+            postLowCut[ch].reset();
+            postHighCut[ch].reset();
+        }
+        forLiveTanks([](auto& f){ f.reset(); });
+        if (staticTank != nullptr)
+            staticTank->reset();
+        tankDownL.reset();
+        tankDownR.reset();
+        tankUpL.reset();
+        tankUpR.reset();
+        // Interpolated output runs up to factor - 1 samples behind the host: start on silence
+        wetPending = tankFactor - 1;
+        std::fill(wetL.begin(), wetL.begin() + wetPending, 0.0f);
+        std::fill(wetR.begin(), wetR.begin() + wetPending, 0.0f);
+        if (xfActive)
+        {
+            // Nothing left to crossfade: the new size takes over at once
+            finishCrossfade();
+        }
+    }
+
+    // The incoming tank becomes the audible one; the outgoing one gives back its memory
+    void finishCrossfade() noexcept
+    {
+        withFdn(activeLines, activeSlot, [](auto& f){ f.bindDelayMemory(nullptr); });
+        activeLines = xfLines;
+        activeSlot = xfSlot;
+        activeMem = 1 - activeMem;
+        xfActive = false;
+        xf = 0.0f;
+        lastSizeApplied = pendingSize;
+    }
+
+    // Mode profile and the tank settings it gives the current parameters; shared by
+    // setParameters() and the static impulse render
+    struct TankProfile
+    {
+        ReverbMode mode = ReverbMode::Hall;
+        int numDiffusionStages = 4;
+        float erBlend = 0.15f, predelayMul = 1.0f, gDiffuserBase = 0.70f;
+        float size = 1.0f, rt60 = 3.0f, hfDampingHz = 6000.0f;
+        float modRateHz = 0.3f, modDepthMs = 1.5f;
+        int modMaskVariant = 0; // 0=longest half, 1=more lines
+    };
+
+    TankProfile profileFor(const ReverbParameters& p) const noexcept
+    {
+        TankProfile prof;
+        // Mode mapping (clamp underlying int into enum range)
+        const int mi = juce::jlimit(0, 3, static_cast<int>(p.mode));
+        prof.mode = static_cast<ReverbMode>(mi);
+
+        // Defaults (Hall-like)
+        float sizeMul = 1.0f;
+        float hfDampOverrideHz = p.hfDampingHz;
+        float rateMul = 1.0f, depthMul = 1.2f;
+
+        switch (prof.mode)
+        {
+            case ReverbMode::Room:
+                prof.numDiffusionStages = 3;
+                prof.erBlend = 0.12f;
+                sizeMul = 0.90f;
+                hfDampOverrideHz = 8000.0f;
+                prof.gDiffuserBase = 0.62f;
+                rateMul = 1.2f;
+                depthMul = 0.9f;
+                prof.modMaskVariant = 0;
+                prof.predelayMul = 0.6f;
+                break;
+            case ReverbMode::Plate:
+                prof.numDiffusionStages = 3;
+                prof.erBlend = 0.10f;
+                sizeMul = 1.00f;
+                hfDampOverrideHz = 14000.0f;
+                prof.gDiffuserBase = 0.78f;
+                rateMul = 1.6f;
+                depthMul = 0.7f;
+                prof.modMaskVariant = 1; // mod more lines
+                prof.predelayMul = 0.3f;
+                break;
+            case ReverbMode::Ambience:
+                prof.numDiffusionStages = 2;
+                prof.erBlend = 0.30f;
+                sizeMul = 0.75f;
+                hfDampOverrideHz = 11000.0f;
+                prof.gDiffuserBase = 0.58f;
+                rateMul = 0.7f;
+                depthMul = 0.5f;
+                prof.modMaskVariant = 0;
+                prof.predelayMul = 0.2f;
+                break;
+            case ReverbMode::Hall:
+            default:
+                prof.numDiffusionStages = 4;
+                prof.erBlend = 0.15f;
+                sizeMul = 1.20f;
+                hfDampOverrideHz = 12000.0f;
+                prof.gDiffuserBase = 0.72f;
+                rateMul = 0.9f;
+                depthMul = 1.3f;
+                prof.modMaskVariant = 0;
+                prof.predelayMul = kMaxPredelayMul;
+                break;
+        }
+        prof.numDiffusionStages = juce::jlimit(1, 4, prof.numDiffusionStages);
+
+        // Map to internal modules with mode shaping
+        prof.size = p.size * sizeMul;
+        prof.rt60 = p.decaySeconds;
+        prof.hfDampingHz = hfDampOverrideHz;
+        prof.modRateHz = p.modRateHz * rateMul;
+
+        // Clamp modulation depth for non-Plate modes to avoid chorus; allow deeper in Plate
+        prof.modDepthMs = p.modDepthMs * depthMul;
+        if (prof.mode != ReverbMode::Plate)
+        {
+            const float depthSamples = (float) (prof.modDepthMs * 1e-3 * fs);
+            const float cappedSamples = juce::jlimit(0.0f, 8.0f * (float) (fs / 48000.0), depthSamples);
+            prof.modDepthMs = cappedSamples * 1e3f / (float) fs;
+        }
+        return prof;
+    }
+
+    // Stereo impulse response of a fresh N-line network set up as prof, over length samples
+    template <int N>
+    void renderTank(const TankProfile& prof, float* irL, float* irR, int length) const
+    {
+        auto fdn = std::make_unique<FDN<N>>();
+        fdn->prepare(tankFs, FDN<N>::kMaxBlock);
+        fdn->setSeed(params.seed);
+        fdn->setSize(prof.size);
+        fdn->setRT60(prof.rt60);
+        fdn->setHFDampingHz(prof.hfDampingHz);
+        fdn->setModulationMaskVariant(prof.modMaskVariant);
+        fdn->setModulation(prof.modRateHz, prof.modDepthMs);
+
+        const float width = juce::jlimit(0.0f, 1.0f, params.width);
+        float v[N];
+        for (int n = 0; n < length; ++n)
+        {
+            fdn->tick(n == 0 ? 1.0f : 0.0f, v);
+            fdn->mixStereo(v, width, irL[n], irR[n]);
+        }
+    }
+
+    inline float predelaySamples() const noexcept
+    {
+        const double ms = juce::jlimit(0.0, kMaxPredelayMs, (double) params.predelayMs) * juce::jmin(predelayMul, kMaxPredelayMul);
+        return (float) (ms * 1e-3 * fs);
+    }
 
     inline float postEQ(float x, int ch) noexcept
     {
@@ -352,20 +814,86 @@ private:
     int maxBlock = 512;
     int channels = 2;
 
+    static constexpr float kSilenceDb = -120.0f;
+    static constexpr float kSilenceGain = 1.0e-6f; // -120 dBFS
+    static constexpr float kTailMarginDb = 12.0f;  // tank build-up over the input peak
+
     ReverbParameters params;
+    bool paramsApplied = false; // params holds the last snapshot setParameters() applied
+    bool controlsDirty = true;  // next control update recomputes every coefficient
 
-    DelayLine predelay[2];
+    ExactDelayLine predelay[2];
     Allpass   diffuser[2][4];
-    FDN8      fdnA, fdnB;
+    std::array<float, kChunk> diffL {}, diffR {}; // predelayed + diffused input, one chunk
+    // Tank segment scratch (a segment never exceeds a chunk). wetL/wetR queue the host-rate tank
+    // output: a segment's worth plus the wetPending samples left over from the last one.
+    static constexpr int kWetQueue = kChunk + 2 * (1 << HalfBandResampler::kMaxStages);
+    std::array<float, kChunk> tankIn {}, widthNow {}, wetLB {}, wetRB {};
+    std::array<float, kChunk> lowL {}, lowR {}, tankOutL {}, tankOutR {}; // tank-rate feed and wet
+    std::array<float, kWetQueue> wetL {}, wetR {};
+    int wetPending = 0;
+
+    // Tank networks: two per line count in use (the audible one and the one a crossfade brings
+    // in), with the line-output scratch they share. Only the audible network and the incoming
+    // one hold delay memory, a slot of tankMem each.
+    template <int N>
+    struct TankPair
+    {
+        std::array<FDN<N>, 2> fdn;
+        std::array<std::array<float, FDN<N>::kMaxBlock>, N> lines {};
+
+        // tickBlock() + mixStereoBlock() of network slot into L/R, n <= its maxBlockSamples()
+        void run(int slot, const float* in, const float* width, float* L, float* R, int n) noexcept
+        {
+            float* v[N];
+            for (int i = 0; i < N; ++i)
+                v[i] = lines[(size_t) i].data();
+            fdn[(size_t) slot].tickBlock(in, v, n);
+            fdn[(size_t) slot].mixStereoBlock(v, width, L, R, n);
+        }
+    };
+    std::unique_ptr<TankPair<4>>  tanks4;
+    std::unique_ptr<TankPair<8>>  tanks8;
+    std::unique_ptr<TankPair<16>> tanks16;
+    std::unique_ptr<TankPair<32>> tanks32;
+    std::array<int, 4> modeLines { 8, 8, 8, 8 }; // lines per ReverbMode: Hall, Room, Plate, Ambience
+    std::array<int, 4> preparedLines = modeLines; // as of the last prepare(); what the tanks were built for
+
+    // Delay memory: one block with the predelays, the diffusers and two network slots of
+    // tankFloats each. The audible network holds tankMem[activeMem].
+    DelayArena arena;
+    std::array<float*, 2> tankMem { };
+    int tankFloats = 0;
+    int activeMem = 0;
+
+    // Decimated tank: the networks run at tankFs = fs / tankFactor
+    bool decimateTank = true;
+    int tankFactor = 1;
+    double tankFs = 48000.0;
+    HalfBandResampler tankDownL, tankDownR, tankUpL, tankUpR;
+
+    // Rendered tank (renderStaticImpulse()); runs in place of the networks when set
+    std::unique_ptr<audio::PartitionedConvolver> staticTank;
+
+    // Audible network and, while xfActive, the one fading in (line count and slot of its pair)
+    int   activeLines = 8, activeSlot = 0;
+    int   xfLines = 8, xfSlot = 1;
 
     // Crossfade state for size changes
-    bool  useA = true;
     bool  xfActive = false;
     float xf = 0.0f;
     float xfAlpha = 0.02f;
     float lastSizeApplied = 1.0f;
     float pendingSize = 1.0f;
 
+    // Tail tracking / idle state
+    bool  idle = true;
+    float tailLevelDb = kSilenceDb;     // estimated tail peak, dBFS
+    float lastWetPeak = 0.0f;           // wet output peak of the last processed block
+    int   silentSamples = 0;            // since the last non-silent input
+    int   tailHoldSamples = 0;          // tail onset: no decay credited before this
+    double tailSeconds = 2.0;
+
     OnePoleLP postLowCut[2], postHighCut[2];
 
     // Mode profile
@@ -377,8 +905,83 @@ private:
     juce::SmoothedValue<float> mixSmoothed { 0.25f }, widthSmoothed { 1.0f };
     juce::SmoothedValue<float> hfSm { 6000.0f }, lowSm { 100.0f }, highSm { 18000.0f }, rt60Sm { 3.0f };
 
-    inline FDN8& activeFdn() noexcept { return useA ? fdnA : fdnB; }
-    inline FDN8& idleFdn()   noexcept { return useA ? fdnB : fdnA; }
+    // Line count of a mode's prepared networks (preparedLines, not a pending setModeLineCount())
+    int lineCountFor(ReverbMode m) const noexcept { return preparedLines[(size_t) juce::jlimit(0, 3, static_cast<int>(m))]; }
+
+    // The network pair (or one network) with the given line count, if prepared
+    template <typename F>
+    void withPair(int lines, F&& f)
+    {
+        switch (lines)
+        {
+            case 4:  if (tanks4 != nullptr) f(*tanks4); break;
+            case 16: if (tanks16 != nullptr) f(*tanks16); break;
+            case 32: if (tanks32 != nullptr) f(*tanks32); break;
+            default: if (tanks8 != nullptr) f(*tanks8); break;
+        }
+    }
+    template <typename F>
+    void withFdn(int lines, int slot, F&& f)
+    {
+        withPair(lines, [&](auto& t){ f(t.fdn[(size_t) slot]); });
+    }
+
+    // The networks parameter and control updates keep current: the audible pair (so either
+    // network can start a size crossfade), and the pair fading in during a crossfade to another
+    // line count
+    template <typename F>
+    void forLiveTanks(F&& f)
+    {
+        withPair(activeLines, [&](auto& t){ f(t.fdn[0]); f(t.fdn[1]); });
+        if (xfActive && xfLines != activeLines)
+            withPair(xfLines, [&](auto& t){ f(t.fdn[0]); f(t.fdn[1]); });
+    }
+
+    int maxBlockOf(int lines, int slot)
+    {
+        int n = 1;
+        withFdn(lines, slot, [&](auto& f){ n = f.maxBlockSamples(); });
+        return n;
+    }
+
+    // Allocates and prepares a pair when a mode uses its line count, else frees it. The
+    // networks come without delay memory: prepare() binds the audible one, a crossfade the other.
+    template <int N>
+    void prepareTanks(std::unique_ptr<TankPair<N>>& t)
+    {
+        if (std::find(preparedLines.begin(), preparedLines.end(), N) == preparedLines.end())
+        {
+            t.reset();
+            return;
+        }
+        if (t == nullptr)
+            t = std::make_unique<TankPair<N>>();
+        for (auto& f : t->fdn)
+            f.prepare(tankFs, maxBlock / tankFactor + 1, false);
+    }
+
+    // Every delay buffer, from the arena: predelays (up to kMaxPredelayMs x kMaxPredelayMul at
+    // the host rate) and input diffusers (up to 20 ms at the tank rate) at their exact size, then
+    // the network slots
+    void layoutDelays()
+    {
+        const int maxPredelaySamples = (int) std::ceil(kMaxPredelayMs * kMaxPredelayMul * 1e-3 * fs);
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            predelay[ch].prepare(fs, maxPredelaySamples, arena);
+            for (auto& ap : diffuser[ch])
+                ap.prepare(tankFs, (int) std::ceil(0.02 * tankFs), arena);
+        }
+        for (auto& m : tankMem)
+            m = arena.take(tankFloats);
+    }
+
+   #if HG_PROFILING
+public:
+    void setProfiler(audio::Profiler* p) noexcept { profiler = p; }
+private:
+    audio::Profiler* profiler = nullptr;
+   #endif
 };
 
 } // namespace hgr::dsp
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+ #include <emmintrin.h>
+ #define HGR_SIMD_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+ #include <arm_neon.h>
+ #define HGR_SIMD_NEON 1
+#endif
+
+#if HGR_SIMD_SSE2 || HGR_SIMD_NEON
+ #define HGR_SIMD 1
+#else
+ #define HGR_SIMD 0
+#endif
+
+#if HGR_SIMD
+namespace hgr::dsp::simd {
+
+// Minimal 4-lane float/int vocabulary over SSE2 / NEON, just what the FDN kernels need. Every
+// operation is the plain IEEE op per lane (no fused multiply-add, exact floor), so a kernel
+// written against it gives the same result as the scalar code it mirrors.
+
+#if HGR_SIMD_SSE2
+using f4 = __m128;
+using i4 = __m128i;
+
+inline f4 load(const float* p) noexcept { return _mm_load_ps(p); }
+inline f4 loadu(const float* p) noexcept { return _mm_loadu_ps(p); }
+inline void store(float* p, f4 v) noexcept { _mm_store_ps(p, v); }
+inline void storeu(float* p, f4 v) noexcept { _mm_storeu_ps(p, v); }
+inline f4 set1(float x) noexcept { return _mm_set1_ps(x); }
+inline f4 add(f4 a, f4 b) noexcept { return _mm_add_ps(a, b); }
+inline f4 sub(f4 a, f4 b) noexcept { return _mm_sub_ps(a, b); }
+inline f4 mul(f4 a, f4 b) noexcept { return _mm_mul_ps(a, b); }
+inline f4 div(f4 a, f4 b) noexcept { return _mm_div_ps(a, b); }
+inline f4 neg(f4 a) noexcept { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+// std::clamp(x, lo, hi) for ordered inputs
+inline f4 clamp(f4 x, f4 lo, f4 hi) noexcept { return _mm_min_ps(_mm_max_ps(x, lo), hi); }
+// mask lanes are all-ones or all-zeros
+inline f4 select(i4 mask, f4 a, f4 b) noexcept
+{
+    const f4 m = _mm_castsi128_ps(mask);
+    return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b));
+}
+
+inline i4 loadi(const std::int32_t* p) noexcept { return _mm_load_si128(reinterpret_cast<const __m128i*>(p)); }
+inline void storei(std::int32_t* p, i4 v) noexcept { _mm_store_si128(reinterpret_cast<__m128i*>(p), v); }
+inline i4 set1i(std::int32_t x) noexcept { return _mm_set1_epi32(x); }
+inline i4 addi(i4 a, i4 b) noexcept { return _mm_add_epi32(a, b); }
+inline i4 andi(i4 a, i4 b) noexcept { return _mm_and_si128(a, b); }
+inline f4 toFloat(i4 v) noexcept { return _mm_cvtepi32_ps(v); }
+inline i4 truncToInt(f4 v) noexcept { return _mm_cvttps_epi32(v); }
+
+// std::floor for |x| < 2^31: truncate, then step down where truncation rounded up
+inline f4 floor(f4 x) noexcept
+{
+    const f4 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+    return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, x), _mm_set1_ps(1.0f)));
+}
+
+// Butterflies of the 4-point Walsh-Hadamard stages: (x0+x1, x0-x1, x2+x3, x2-x3) and
+// (x0+x2, x1+x3, x0-x2, x1-x3)
+inline f4 butterflyPairs(f4 x) noexcept
+{
+    const f4 e = _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 0, 2, 0));
+    const f4 o = _mm_shuffle_ps(x, x, _MM_SHUFFLE(3, 1, 3, 1));
+    return _mm_unpacklo_ps(_mm_add_ps(e, o), _mm_sub_ps(e, o));
+}
+inline f4 butterflyHalves(f4 x) noexcept
+{
+    const f4 lo = _mm_movelh_ps(x, x);
+    const f4 hi = _mm_movehl_ps(x, x);
+    return _mm_movelh_ps(_mm_add_ps(lo, hi), _mm_sub_ps(lo, hi));
+}
+
+#elif HGR_SIMD_NEON
+using f4 = float32x4_t;
+using i4 = int32x4_t;
+
+inline f4 load(const float* p) noexcept { return vld1q_f32(p); }
+inline f4 loadu(const float* p) noexcept { return vld1q_f32(p); }
+inline void store(float* p, f4 v) noexcept { vst1q_f32(p, v); }
+inline void storeu(float* p, f4 v) noexcept { vst1q_f32(p, v); }
+inline f4 set1(float x) noexcept { return vdupq_n_f32(x); }
+inline f4 add(f4 a, f4 b) noexcept { return vaddq_f32(a, b); }
+inline f4 sub(f4 a, f4 b) noexcept { return vsubq_f32(a, b); }
+inline f4 mul(f4 a, f4 b) noexcept { return vmulq_f32(a, b); }
+inline f4 div(f4 a, f4 b) noexcept { return vdivq_f32(a, b); }
+inline f4 neg(f4 a) noexcept { return vnegq_f32(a); }
+inline f4 clamp(f4 x, f4 lo, f4 hi) noexcept { return vminq_f32(vmaxq_f32(x, lo), hi); }
+inline f4 select(i4 mask, f4 a, f4 b) noexcept { return vbslq_f32(vreinterpretq_u32_s32(mask), a, b); }
+
+inline i4 loadi(const std::int32_t* p) noexcept { return vld1q_s32(p); }
+inline void storei(std::int32_t* p, i4 v) noexcept { vst1q_s32(p, v); }
+inline i4 set1i(std::int32_t x) noexcept { return vdupq_n_s32(x); }
+inline i4 addi(i4 a, i4 b) noexcept { return vaddq_s32(a, b); }
+inline i4 andi(i4 a, i4 b) noexcept { return vandq_s32(a, b); }
+inline f4 toFloat(i4 v) noexcept { return vcvtq_f32_s32(v); }
+inline i4 truncToInt(f4 v) noexcept { return vcvtq_s32_f32(v); }
+inline f4 floor(f4 x) noexcept { return vrndmq_f32(x); }
+
+inline f4 butterflyPairs(f4 x) noexcept
+{
+    const f4 e = vuzp1q_f32(x, x);
+    const f4 o = vuzp2q_f32(x, x);
+    return vzip1q_f32(vaddq_f32(e, o), vsubq_f32(e, o));
+}
+inline f4 butterflyHalves(f4 x) noexcept
+{
+    const float32x2_t lo = vget_low_f32(x), hi = vget_high_f32(x);
+    return vcombine_f32(vadd_f32(lo, hi), vsub_f32(lo, hi));
+}
+#endif
+
+} // namespace hgr::dsp::simd
+#endif
@@ -1,17 +1,36 @@
 #include "PluginProcessor.h"
+#ifndef HGR_HEADLESS_TEST
 #include "PluginEditor.h"
+#endif
+#include <audio/RealtimeSanitizer.h>
 
 HungryGhostReverbAudioProcessor::HungryGhostReverbAudioProcessor()
 : juce::AudioProcessor(BusesProperties().withInput("Input", juce::AudioChannelSet::stereo(), true)
                                           .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
   apvts(*this, nullptr, "PARAMS", createParameterLayout())
 {
+    const audio::ParameterHandles h(apvts);
+    const std::pair<Param, const char*> ids[] = {
+        { pMix, "mix" }, { pDecay, "decaySeconds" }, { pSize, "size" }, { pPredelay, "predelayMs" },
+        { pDiffusion, "diffusion" }, { pModRate, "modRateHz" }, { pModDepth, "modDepthMs" },
+        { pHfDamping, "hfDampingHz" }, { pLowCut, "lowCutHz" }, { pHighCut, "highCutHz" },
+        { pWidth, "width" }, { pSeed, "seed" }, { pFreeze, "freeze" }, { pMode, "mode" },
+    };
+    static_assert(std::size(ids) == kNumParams, "every snapshot slot needs an ID");
+    for (const auto& [slot, id] : ids)
+        params.bind(slot, h[id]);
+
+   #if HG_PROFILING
+    reverb.setProfiler(&profiling.profiler);
+   #endif
 }
 
 void HungryGhostReverbAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
     reverb.prepare(sampleRate, samplesPerBlock, getTotalNumOutputChannels());
     reverb.reset();
+    params.invalidate(); // the engine starts from defaults: hand it every parameter again
+    applyParameters();   // so the tail length is right before the first block
 }
 
 void HungryGhostReverbAudioProcessor::releaseResources() {}
@@ -20,35 +39,48 @@ void HungryGhostReverbAudioProcessor::processBlock(juce::AudioBuffer<float>& buf
 {
     juce::ignoreUnused(midi);
     juce::ScopedNoDenormals noDenormals;
+    HG_RT_SCOPE("HungryGhostReverbAudioProcessor::processBlock");
+    HG_PROFILE_BLOCK(&profiling.profiler, "reverb.processBlock", buffer.getNumSamples());
 
-    // Map APVTS to engine parameters
-    currentParams.mixPercent   = apvts.getRawParameterValue("mix")->load();
-    currentParams.decaySeconds = apvts.getRawParameterValue("decaySeconds")->load();
-    currentParams.size         = apvts.getRawParameterValue("size")->load();
-    currentParams.predelayMs   = apvts.getRawParameterValue("predelayMs")->load();
-    currentParams.diffusion    = apvts.getRawParameterValue("diffusion")->load();
-    currentParams.modRateHz    = apvts.getRawParameterValue("modRateHz")->load();
-    currentParams.modDepthMs   = apvts.getRawParameterValue("modDepthMs")->load();
-    currentParams.hfDampingHz  = apvts.getRawParameterValue("hfDampingHz")->load();
-    currentParams.lowCutHz     = apvts.getRawParameterValue("lowCutHz")->load();
-    currentParams.highCutHz    = apvts.getRawParameterValue("highCutHz")->load();
-    currentParams.width        = apvts.getRawParameterValue("width")->load();
-    currentParams.seed         = (int) apvts.getRawParameterValue("seed")->load();
-    currentParams.freeze       = apvts.getRawParameterValue("freeze")->load() > 0.5f;
-    {
-        const int mi = (int) apvts.getRawParameterValue("mode")->load();
-        currentParams.mode = static_cast<hgr::dsp::ReverbMode>(juce::jlimit(0, 3, mi));
-    }
-
-    reverb.setParameters(currentParams);
+    applyParameters();
 
     juce::dsp::AudioBlock<float> block(buffer);
     reverb.process(block);
 }
 
+void HungryGhostReverbAudioProcessor::applyParameters()
+{
+    // Map APVTS to engine parameters (snapshot: atomic loads only); the engine is only
+    // reconfigured when something moved
+    if (params.update())
+    {
+        currentParams.mixPercent   = params[pMix];
+        currentParams.decaySeconds = params[pDecay];
+        currentParams.size         = params[pSize];
+        currentParams.predelayMs   = params[pPredelay];
+        currentParams.diffusion    = params[pDiffusion];
+        currentParams.modRateHz    = params[pModRate];
+        currentParams.modDepthMs   = params[pModDepth];
+        currentParams.hfDampingHz  = params[pHfDamping];
+        currentParams.lowCutHz     = params[pLowCut];
+        currentParams.highCutHz    = params[pHighCut];
+        currentParams.width        = params[pWidth];
+        currentParams.seed         = params.getInt(pSeed);
+        currentParams.freeze       = params.getBool(pFreeze);
+        currentParams.mode         = static_cast<hgr::dsp::ReverbMode>(juce::jlimit(0, 3, params.getInt(pMode)));
+
+        reverb.setParameters(currentParams);
+        tailSeconds.store(reverb.getTailLengthSeconds(), std::memory_order_relaxed);
+    }
+}
+
 juce::AudioProcessorEditor* HungryGhostReverbAudioProcessor::createEditor()
 {
+#ifdef HGR_HEADLESS_TEST
+    return nullptr;
+#else
     return new HungryGhostReverbAudioProcessorEditor(*this);
+#endif
 }
 
 void HungryGhostReverbAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
@@ -90,8 +122,10 @@ juce::AudioProcessorValueTreeState::ParameterLayout HungryGhostReverbAudioProces
 }
 
 // This factory is required by JUCE plugin client code
+#ifndef HGR_HEADLESS_TEST // headless builds link several processors into one binary
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 {
     return new HungryGhostReverbAudioProcessor();
 }
+#endif
 
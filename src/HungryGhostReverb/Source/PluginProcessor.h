@@ -3,6 +3,8 @@
 #include <JuceHeader.h>
 #include "DSP/ReverbEngine.h"
 #include "DSP/ParameterTypes.h"
+#include <audio/ParameterHandles.h>
+#include <audio/Profiler.h>
 
 class HungryGhostReverbAudioProcessor : public juce::AudioProcessor {
 public:
@@ -21,7 +23,8 @@ public:
 
     bool acceptsMidi() const override { return false; }
     bool producesMidi() const override { return false; }
-    double getTailLengthSeconds() const override { return 2.0; }
+    // Follows decay, size, predelay and mode; infinite while frozen
+    double getTailLengthSeconds() const override { return tailSeconds.load(std::memory_order_relaxed); }
 
     int getNumPrograms() override { return 1; }
     int getCurrentProgram() override { return 0; }
@@ -38,6 +41,23 @@ private:
     hgr::dsp::ReverbEngine reverb;
     hgr::dsp::ReverbParameters currentParams;
 
+    // Parameter handles are resolved once in the constructor; processBlock only loads the snapshot
+    enum Param : size_t
+    {
+        pMix, pDecay, pSize, pPredelay, pDiffusion, pModRate, pModDepth,
+        pHfDamping, pLowCut, pHighCut, pWidth, pSeed, pFreeze, pMode,
+        kNumParams
+    };
+    audio::ParamSnapshot<kNumParams> params;
+    std::atomic<double> tailSeconds { 2.0 };
+
+    void applyParameters();
+
+   #if HG_PROFILING
+    // Per-stage timings, written to a trace when the instance is destroyed (see audio/Profiler.h)
+    audio::ProfileSession profiling { "HungryGhostReverb" };
+   #endif
+
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 };
 
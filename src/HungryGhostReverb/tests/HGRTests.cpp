@@ -0,0 +1,312 @@
+#include <JuceHeader.h>
+#include <audio/RealtimeSanitizer.h>
+#include "../Source/DSP/FDN.h"
+#include "../Source/DSP/ReverbEngine.h"
+
+using namespace juce;
+using hgr::dsp::ReverbEngine;
+using hgr::dsp::ReverbMode;
+using hgr::dsp::ReverbParameters;
+
+namespace {
+
+// Stereo noise in bursts of burstLen samples with gaps of the same length
+AudioBuffer<float> noiseBursts(int numSamples, int burstLen, float amp, int64 seed)
+{
+    AudioBuffer<float> buf(2, numSamples);
+    Random rng(seed);
+    for (int n = 0; n < numSamples; ++n)
+    {
+        const bool on = (n / burstLen) % 2 == 0;
+        buf.setSample(0, n, on ? amp * (rng.nextFloat() * 2.0f - 1.0f) : 0.0f);
+        buf.setSample(1, n, on ? amp * (rng.nextFloat() * 2.0f - 1.0f) : 0.0f);
+    }
+    return buf;
+}
+
+// Runs the engine over io in place, in blocks cycling through blockSizes
+void render(ReverbEngine& engine, AudioBuffer<float>& io, std::initializer_list<int> blockSizes)
+{
+    const int total = io.getNumSamples();
+    for (int done = 0, i = 0; done < total; ++i)
+    {
+        const int n = jmin(total - done, *(blockSizes.begin() + (i % (int) blockSizes.size())));
+        dsp::AudioBlock<float> block(io.getArrayOfWritePointers(), (size_t) io.getNumChannels(), (size_t) done, (size_t) n);
+        HG_RT_SCOPE("ReverbEngine::process (test)");
+        engine.process(block);
+        done += n;
+    }
+}
+
+float maxAbsDiff(const AudioBuffer<float>& a, const AudioBuffer<float>& b)
+{
+    float err = 0.0f;
+    for (int ch = 0; ch < a.getNumChannels(); ++ch)
+        for (int n = 0; n < a.getNumSamples(); ++n)
+            err = jmax(err, std::abs(a.getSample(ch, n) - b.getSample(ch, n)));
+    return err;
+}
+
+float rms(const AudioBuffer<float>& b, int start, int len)
+{
+    double acc = 0.0;
+    for (int ch = 0; ch < b.getNumChannels(); ++ch)
+        for (int n = start; n < start + len; ++n)
+            acc += (double) b.getSample(ch, n) * b.getSample(ch, n);
+    return (float) std::sqrt(acc / jmax(1, len * b.getNumChannels()));
+}
+
+} // namespace
+
+class FdnTickBlockTest : public UnitTest
+{
+public:
+    FdnTickBlockTest() : UnitTest("HGR FDN tickBlock") {}
+    void runTest() override
+    {
+        check<4>();
+        check<8>();
+        check<16>();
+        check<32>();
+    }
+
+private:
+    template <int N>
+    void check()
+    {
+        beginTest("tickBlock matches tick() sample for sample, " + String(N) + " lines");
+        const int total = 48000;
+        auto perSample = std::make_unique<hgr::dsp::FDN<N>>();
+        auto blocked = std::make_unique<hgr::dsp::FDN<N>>();
+        for (auto* f : { perSample.get(), blocked.get() })
+        {
+            f->prepare(48000.0, hgr::dsp::FDN<N>::kMaxBlock);
+            f->setSeed(4242);
+            f->setModulation(0.7f, 4.0f);
+            f->setRT60(2.0f);
+        }
+
+        std::vector<float> in((size_t) total);
+        Random rng(N);
+        for (auto& x : in)
+            x = rng.nextFloat() * 2.0f - 1.0f;
+
+        std::vector<std::vector<float>> expected(N, std::vector<float>((size_t) total));
+        std::vector<std::vector<float>> actual(N, std::vector<float>((size_t) total));
+        for (int n = 0; n < total; ++n)
+        {
+            if (n == total / 2)
+                perSample->setFreeze(true);
+            float v[N];
+            perSample->tick(in[(size_t) n], v);
+            for (int i = 0; i < N; ++i)
+                expected[(size_t) i][(size_t) n] = v[i];
+        }
+
+        // Odd block lengths, capped at what the network accepts
+        const int lengths[] = { 1, 17, 255, 64, 3, hgr::dsp::FDN<N>::kMaxBlock };
+        for (int done = 0, k = 0; done < total; ++k)
+        {
+            int n = jmin(total - done, lengths[k % (int) std::size(lengths)], blocked->maxBlockSamples());
+            if (done < total / 2)
+                n = jmin(n, total / 2 - done);
+            else if (done == total / 2)
+                blocked->setFreeze(true);
+            float* out[N];
+            for (int i = 0; i < N; ++i)
+                out[i] = actual[(size_t) i].data() + done;
+            blocked->tickBlock(in.data() + done, out, n);
+            done += n;
+        }
+
+        float err = 0.0f;
+        for (int i = 0; i < N; ++i)
+            for (int n = 0; n < total; ++n)
+                err = jmax(err, std::abs(expected[(size_t) i][(size_t) n] - actual[(size_t) i][(size_t) n]));
+        expectEquals(err, 0.0f, "bit-identical");
+    }
+};
+
+class DecimatedTankTest : public UnitTest
+{
+public:
+    DecimatedTankTest() : UnitTest("HGR Decimated Tank") {}
+    void runTest() override
+    {
+        for (double sr : { 96000.0, 192000.0 })
+        {
+            beginTest("Odd host blocks render the same late field at " + String(sr / 1000.0) + " kHz");
+            const int prepared = 509;
+            const auto input = noiseBursts((int) sr, (int) sr / 20, 0.5f, 7);
+
+            // The parameter ramps after setParameters() step once per control update, a few
+            // times per host block, so they follow the block size: let them settle (2 s of
+            // 63-sample updates covers every 20 ms ramp at 192 kHz), then start from silence
+            auto renderWith = [&](std::initializer_list<int> blockSizes) {
+                auto engine = std::make_unique<ReverbEngine>();
+                engine->prepare(sr, prepared, 2);
+                engine->reset();
+                ReverbParameters p;
+                p.mixPercent = 100.0f;
+                p.predelayMs = 0.0f;
+                engine->setParameters(p);
+                expect(engine->isTankDecimated());
+                AudioBuffer<float> warmUp(2, 2 * (int) sr);
+                for (int i = 0; i < 2; ++i)
+                    for (int ch = 0; ch < 2; ++ch)
+                        warmUp.copyFrom(ch, i * (int) sr, input, ch, 0, (int) sr);
+                render(*engine, warmUp, { prepared });
+                engine->reset();
+
+                AudioBuffer<float> out(input);
+                render(*engine, out, blockSizes);
+                return out;
+            };
+
+            const auto expected = renderWith({ prepared });
+            const auto actual = renderWith({ 1, 3, 127, prepared, 77, 255 });
+            expectLessThan(maxAbsDiff(expected, actual), 1.0e-5f);
+            expectGreaterThan(rms(expected, 0, expected.getNumSamples()), 0.01f);
+        }
+    }
+};
+
+class IdleTest : public UnitTest
+{
+public:
+    IdleTest() : UnitTest("HGR Idle") {}
+    void runTest() override
+    {
+        const double sr = 48000.0; const int block = 256;
+        auto engine = std::make_unique<ReverbEngine>();
+        engine->prepare(sr, block, 2);
+        engine->reset();
+        ReverbParameters p;
+        p.decaySeconds = 0.3f;
+        engine->setParameters(p);
+
+        AudioBuffer<float> buf(2, block);
+        auto processBlock = [&] {
+            dsp::AudioBlock<float> b(buf);
+            HG_RT_SCOPE("ReverbEngine::process (test)");
+            engine->process(b);
+        };
+
+        beginTest("A decayed tail parks the engine on the dry path");
+        expect(engine->isIdle(), "idle before any input");
+        buf.clear();
+        buf.setSample(0, 0, 1.0f);
+        buf.setSample(1, 0, 1.0f);
+        processBlock();
+        expect(! engine->isIdle(), "input wakes the engine");
+
+        // 120 dB of a 0.3 s RT60 plus the onset: well inside 2 s
+        int blocks = 0;
+        while (! engine->isIdle() && blocks < (int) (2.0 * sr) / block)
+        {
+            buf.clear();
+            processBlock();
+            ++blocks;
+        }
+        expect(engine->isIdle(), "idle once the tail is gone");
+        expectGreaterThan(blocks, (int) (0.3 * sr) / block, "not before the tail has decayed");
+
+        buf.clear();
+        processBlock();
+        expectEquals(buf.getMagnitude(0, block), 0.0f, "silence in, silence out while idle");
+
+        beginTest("Input resumes the tank at once");
+        const float dryGain = std::sqrt(1.0f - p.mixPercent * 0.01f);
+        double phase = 0.0;
+        float wetPeak = 0.0f;
+        for (int i = 0; i < 40; ++i)
+        {
+            for (int n = 0; n < block; ++n)
+            {
+                const float s = 0.5f * (float) std::sin(phase);
+                phase += 2.0 * MathConstants<double>::pi * 440.0 / sr;
+                buf.setSample(0, n, s);
+                buf.setSample(1, n, s);
+            }
+            AudioBuffer<float> dry(buf);
+            processBlock();
+            expect(! engine->isIdle());
+            for (int n = 0; n < block; ++n)
+                wetPeak = jmax(wetPeak, std::abs(buf.getSample(0, n) - dryGain * dry.getSample(0, n)));
+        }
+        expectGreaterThan(wetPeak, 0.01f, "the tank is heard again");
+    }
+};
+
+class CrossfadeRealtimeTest : public UnitTest
+{
+public:
+    CrossfadeRealtimeTest() : UnitTest("HGR Crossfades") {}
+    void runTest() override
+    {
+        const double sr = 48000.0; const int block = 256;
+        auto engine = std::make_unique<ReverbEngine>();
+        engine->setModeLineCount(ReverbMode::Plate, 16);
+        engine->setModeLineCount(ReverbMode::Ambience, 4);
+        engine->prepare(sr, block, 2);
+        engine->reset();
+
+        auto input = noiseBursts(block, block, 0.3f, 3);
+        AudioBuffer<float> buf(2, block);
+        ReverbParameters p;
+        // Parameters change on the audio thread (processBlock), so both run inside the scope
+        auto processBlocks = [&](int numBlocks) {
+            for (int i = 0; i < numBlocks; ++i)
+            {
+                buf.makeCopyOf(input, true);
+                dsp::AudioBlock<float> b(buf);
+                HG_RT_SCOPE("ReverbEngine::setParameters/process (test)");
+                engine->setParameters(p);
+                engine->process(b);
+            }
+        };
+
+        beginTest("Size and mode crossfades neither allocate nor lock");
+        processBlocks(20);
+        expectEquals(engine->getActiveLineCount(), 8);
+
+        p.size = 1.4f;                 // size crossfade within the 8-line pair
+        processBlocks(4);
+        p.mode = ReverbMode::Plate;    // into the 16-line network
+        processBlocks(400);
+        expectEquals(engine->getActiveLineCount(), 16);
+
+        p.mode = ReverbMode::Ambience; // into the 4-line network, then back mid-fade
+        processBlocks(3);
+        p.mode = ReverbMode::Hall;
+        p.size = 0.6f;
+        processBlocks(400);
+        expectEquals(engine->getActiveLineCount(), 8);
+        expect(std::isfinite(buf.getSample(0, block - 1)));
+
+        beginTest("A line count set after prepare() waits for the next prepare()");
+        engine->setModeLineCount(ReverbMode::Hall, 32);
+        p.size = 1.0f;
+        processBlocks(100);
+        expectEquals(engine->getActiveLineCount(), 8, "the 32-line networks are not prepared yet");
+        expectEquals(engine->getModeLineCount(ReverbMode::Hall), 32);
+
+        engine->prepare(sr, block, 2);
+        engine->reset();
+        processBlocks(4);
+        expectEquals(engine->getActiveLineCount(), 32);
+    }
+};
+
+static FdnTickBlockTest      fdnTickBlockTest;
+static DecimatedTankTest     decimatedTankTest;
+static IdleTest              idleTest;
+static CrossfadeRealtimeTest crossfadeRealtimeTest;
+
+int main (int, char**)
+{
+    ConsoleApplication app;
+    audio::rtsan::TestRunner runner;
+    runner.runAllTests();
+    return runner.finish();
+}
@@ -1,6 +1,14 @@
 #include "PluginProcessor.h"
+#ifndef HGS_HEADLESS_TEST
 #include "PluginEditor.h"
+#endif
 #include <cmath>
+#include <audio/RealtimeSanitizer.h>
+
+namespace
+{
+    using ArrayCoeffs = juce::dsp::IIR::ArrayCoefficients<float>;
+}
 
 HungryGhostSaturationAudioProcessor::HungryGhostSaturationAudioProcessor()
 : AudioProcessor (BusesProperties()
@@ -8,6 +16,17 @@ HungryGhostSaturationAudioProcessor::HungryGhostSaturationAudioProcessor()
                     .withOutput("Output", juce::AudioChannelSet::stereo(), true))
 , apvts(*this, nullptr, "PARAMS", createParameterLayout())
 {
+    const audio::ParameterHandles h(apvts);
+    const std::pair<Param, const char*> ids[] = {
+        { pIn, "in" }, { pOut, "out" }, { pMix, "mix" }, { pDrive, "drive" }, { pAsym, "asym" },
+        { pModel, "model" }, { pChannelMode, "channelMode" }, { pPreTilt, "pretilt" }, { pPostLP, "postlp" },
+        { pOversampling, "os" }, { pAutoGain, "autoGain" }, { pVocal, "vocal" }, { pVocalAmt, "vocalAmt" },
+        { pVocalStyle, "vocalStyle" },
+    };
+    static_assert(std::size(ids) == kNumParams, "every snapshot slot needs an ID");
+    for (const auto& [slot, id] : ids)
+        params.bind(slot, h[id]);
+
     mixSmoothed.reset(44100.0, 0.02);
     makeupSmoothedL.reset(44100.0, 0.06);
     makeupSmoothedR.reset(44100.0, 0.06);
@@ -16,7 +35,7 @@ HungryGhostSaturationAudioProcessor::HungryGhostSaturationAudioProcessor()
 void HungryGhostSaturationAudioProcessor::prepareToPlay(double newSampleRate, int samplesPerBlock)
 {
     sampleRate = static_cast<float>(newSampleRate);
-    maxBlock = samplesPerBlock;
+    maxBlock = juce::jmax(1, samplesPerBlock);
     lastNumChannels = juce::jlimit(1, 2, getTotalNumOutputChannels());
 
     // RMS smoothing factor scaled for sample rate (approx 1e-3 at 48k)
@@ -28,6 +47,11 @@ void HungryGhostSaturationAudioProcessor::prepareToPlay(double newSampleRate, in
     dcR = std::exp(-2.0f * juce::MathConstants<float>::pi * fc / sampleRate);
     dcStates.assign((size_t) lastNumChannels, {});
 
+    // Every parameter-driven filter gets its own biquad here; updateParameters() then only
+    // rewrites coefficients in place (no allocation or order change on the audio thread)
+    for (auto* f : { &preTilt, &postDeTilt, &postLP, &hpVox, &presencePeak, &lpVox, &hpVox2, &lpVox2 })
+        f->coefficients = new juce::dsp::IIR::Coefficients<float>(1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f);
+
     // Prepare filters
     juce::dsp::ProcessSpec spec { sampleRate, static_cast<juce::uint32>(samplesPerBlock), static_cast<juce::uint32>(lastNumChannels) };
     preTilt.prepare(spec);
@@ -61,16 +85,25 @@ void HungryGhostSaturationAudioProcessor::prepareToPlay(double newSampleRate, in
     mixSmoothed.setCurrentAndTargetValue(1.0f);
     makeupSmoothedL.setCurrentAndTargetValue(1.0f);
     makeupSmoothedR.setCurrentAndTargetValue(1.0f);
-    vocalAmtSmoothed.setCurrentAndTargetValue(apvts.getRawParameterValue("vocalAmt") != nullptr ? apvts.getRawParameterValue("vocalAmt")->load() : 1.0f);
 
-    // Buffers
-    dryBuffer.setSize(lastNumChannels, samplesPerBlock, false, true, true);
-    monoScratch.setSize(1, samplesPerBlock, false, true, true);
-    voxDry.setSize(lastNumChannels, samplesPerBlock, false, true, true);
-
-    // Oversampling
+    // Buffers (processBlock renders in chunks of at most maxBlock, so these never grow there)
+    dryBuffer.setSize(lastNumChannels, maxBlock, false, true, true);
+    monoScratch.setSize(1, maxBlock, false, true, true);
+    voxDry.setSize(lastNumChannels, maxBlock, false, true, true);
+
+    // Oversampling: build and prepare both factors, so the "os" parameter only selects one
+    using Oversampling = juce::dsp::Oversampling<float>;
+    oversampler2x = std::make_unique<Oversampling>((size_t) lastNumChannels, 1, Oversampling::filterHalfBandPolyphaseIIR, true);
+    oversampler4x = std::make_unique<Oversampling>((size_t) lastNumChannels, 2, Oversampling::filterHalfBandPolyphaseIIR, true);
+    for (auto* os : { oversampler2x.get(), oversampler4x.get() })
+        os->initProcessing((size_t) maxBlock);
+    oversampling = nullptr;
+
+    // Rate-dependent state: rebuild everything from the snapshot
+    params.invalidate();
     updateParameters();
-    updateOversamplingIfNeeded(lastNumChannels);
+    vocalAmtSmoothed.setCurrentAndTargetValue(params[pVocalAmt]);
+    selectOversampling();
     resetDSPState();
 }
 
@@ -90,31 +123,27 @@ bool HungryGhostSaturationAudioProcessor::isBusesLayoutSupported(const BusesLayo
     return monoOK || stereoOK;
 }
 
-static inline float softClipCubic1(float u)
-{
-    // Saturates to +/-1 at u=+/-1; smooth cubic
-    if (u >= 1.0f) return 1.0f;
-    if (u <= -1.0f) return -1.0f;
-    return 1.5f * u - 0.5f * u * u * u;
-}
-
 void HungryGhostSaturationAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
 {
     juce::ScopedNoDenormals _;
+    HG_RT_SCOPE("HungryGhostSaturationAudioProcessor::processBlock");
 
-    const int numSamples  = buffer.getNumSamples();
-    const int busChannels = getTotalNumOutputChannels();
-    lastNumChannels = juce::jlimit(1, 2, busChannels);
+    // Update parameter-cached state (selects the oversampler on an "os" change)
+    updateParameters();
 
-    // Ensure buffers sized
-    if (dryBuffer.getNumSamples() < numSamples || dryBuffer.getNumChannels() != lastNumChannels)
-        dryBuffer.setSize(lastNumChannels, numSamples, false, false, true);
-    if (monoScratch.getNumSamples() < numSamples)
-        monoScratch.setSize(1, numSamples, false, false, true);
+    // A host block longer than the prepared size is rendered in prepared-size chunks
+    const int numSamples = buffer.getNumSamples();
+    for (int start = 0; start < numSamples; start += maxBlock)
+    {
+        juce::AudioBuffer<float> chunk(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), start,
+                                       juce::jmin(maxBlock, numSamples - start));
+        processChunk(chunk);
+    }
+}
 
-    // Update parameter-cached state and rebuild oversampling if needed
-    updateParameters();
-    updateOversamplingIfNeeded(lastNumChannels);
+void HungryGhostSaturationAudioProcessor::processChunk(juce::AudioBuffer<float>& buffer)
+{
+    const int numSamples = buffer.getNumSamples();
 
     // Determine processing buffer based on ChannelMode
     juce::AudioBuffer<float>* procBuf = &buffer;
@@ -142,66 +171,34 @@ void HungryGhostSaturationAudioProcessor::processBlock(juce::AudioBuffer<float>&
         for (int n = 0; n < numSamples; ++n)
             d[n] *= inGain;
     }
-    dryBuffer.makeCopyOf(*procBuf, true);
+    for (int ch = 0; ch < procChans; ++ch)
+        dryBuffer.copyFrom(ch, 0, *procBuf, ch, 0, numSamples);
+
+    // The processed channels and samples (monoScratch is longer than a short block)
+    auto blk = juce::dsp::AudioBlock<float>(*procBuf).getSubsetChannelBlock(0, (size_t) procChans)
+                                                     .getSubBlock(0, (size_t) numSamples);
 
     // Pre-emphasis
     if (enablePreTilt)
     {
-        juce::dsp::AudioBlock<float> blk (*procBuf);
         juce::dsp::ProcessContextReplacing<float> ctx (blk);
         preTilt.process(ctx);
     }
 
     // Oversample up
-    juce::dsp::AudioBlock<float> blk (*procBuf);
-    juce::dsp::ProcessContextReplacing<float> ctx (blk);
     juce::dsp::AudioBlock<float> upBlk = oversampling ? oversampling->processSamplesUp(blk)
                                                       : blk;
 
-    // Shaper
-    {
-        for (size_t ch = 0; ch < upBlk.getNumChannels(); ++ch)
-        {
-            auto* d = upBlk.getChannelPointer(ch);
-            for (size_t n = 0; n < upBlk.getNumSamples(); ++n)
-            {
-                float x = juce::jlimit(-1.0f, 1.0f, d[n] * driveGain); // NEW: pre-gain into shaper
-                float y = 0.0f;
-                switch (model)
-                {
-                    case Model::TANH:
-                        y = std::tanh(k * x) * invTanhK; break;
-                    case Model::ATAN:
-                        y = std::atan(k * x) * invAtanK; break;
-                    case Model::SOFT:
-                    {
-                        float u = juce::jlimit(-1.0f, 1.0f, k * x);
-                        const float normSoft = 1.0f / (1.0f + 0.20f * (k - 1.0f)); // gentler normalization for more feel
-                        y = normSoft * softClipCubic1(u);
-                    } break;
-                    case Model::FEXP:
-                    {
-                        float xa = juce::jlimit(-1.0f, 1.0f, x + asym);
-                        float denom = 1.0f - std::exp(-k);
-                        if (denom <= 1.0e-6f) denom = 1.0e-6f;
-                        y = (1.0f - std::exp(-k * xa)) / denom;
-                    } break;
-                    case Model::AMP:
-                    {
-                        y = diodeSat(x, k, asym);
-                    } break;
-                }
-                d[n] = juce::jlimit(-1.0f, 1.0f, y);
-            }
-        }
-    }
+    // Shaper (the oversampled block carries every channel the oversampler was built for)
+    for (size_t ch = 0; ch < (size_t) procChans; ++ch)
+        shaper.process(upBlk.getChannelPointer(ch), (int) upBlk.getNumSamples());
 
     // Oversample down
     if (oversampling)
         oversampling->processSamplesDown(blk);
 
     // DC-block for asymmetric mode (post-down)
-    if (model == Model::FEXP)
+    if (shaper.getModel() == Model::FEXP)
     {
         for (int ch = 0; ch < procChans; ++ch)
         {
@@ -220,14 +217,12 @@ void HungryGhostSaturationAudioProcessor::processBlock(juce::AudioBuffer<float>&
     // Post de-emphasis and optional LP
     if (enablePreTilt)
     {
-        juce::dsp::AudioBlock<float> b (*procBuf);
-        juce::dsp::ProcessContextReplacing<float> c (b);
+        juce::dsp::ProcessContextReplacing<float> c (blk);
         postDeTilt.process(c);
     }
     if (enablePostLP)
     {
-        juce::dsp::AudioBlock<float> b (*procBuf);
-        juce::dsp::ProcessContextReplacing<float> c (b);
+        juce::dsp::ProcessContextReplacing<float> c (blk);
         postLP.process(c);
     }
 
@@ -235,19 +230,17 @@ void HungryGhostSaturationAudioProcessor::processBlock(juce::AudioBuffer<float>&
     if (vocalLoFi)
     {
         // Read amount and set smoother
-        if (auto* p = apvts.getRawParameterValue("vocalAmt"))
-            vocalAmtSmoothed.setTargetValue(p->load());
-        
+        vocalAmtSmoothed.setTargetValue(params[pVocalAmt]);
+
         // keep dry copy for amount crossfade
-        voxDry.makeCopyOf(*procBuf, true);
+        for (int ch = 0; ch < procChans; ++ch)
+            voxDry.copyFrom(ch, 0, *procBuf, ch, 0, numSamples);
         {
-            juce::dsp::AudioBlock<float> b (*procBuf);
-            juce::dsp::ProcessContextReplacing<float> c (b);
+            juce::dsp::ProcessContextReplacing<float> c (blk);
             hpVox.process(c);
             presencePeak.process(c);
             lpVox.process(c);
-            int vstyleNow = (int) (apvts.getRawParameterValue("vocalStyle") ? apvts.getRawParameterValue("vocalStyle")->load() : 0);
-            if (vstyleNow == 1) { hpVox2.process(c); lpVox2.process(c); }
+            if (params.getInt(pVocalStyle) == 1) { hpVox2.process(c); lpVox2.process(c); }
         }
         // Fast leveling comp per sample, per channel
         for (int ch = 0; ch < procChans; ++ch)
@@ -454,103 +447,89 @@ juce::AudioProcessorValueTreeState::ParameterLayout HungryGhostSaturationAudioPr
 
 void HungryGhostSaturationAudioProcessor::updateParameters()
 {
-    inGain  = juce::Decibels::decibelsToGain(apvts.getRawParameterValue("in")->load());
-    outGain = juce::Decibels::decibelsToGain(apvts.getRawParameterValue("out")->load());
-    mixTarget = apvts.getRawParameterValue("mix")->load();
-
-    driveDb = apvts.getRawParameterValue("drive")->load();
-    k = mapDriveDbToK(driveDb);
-    driveGain = juce::Decibels::decibelsToGain(driveDb); // NEW: pre-gain into shaper
-    invTanhK = 1.0f / (std::tanh(k) + 1.0e-6f);
-    invAtanK = 1.0f / (std::atan(k) + 1.0e-6f);
+    // One atomic load per parameter; derived state below is only rebuilt when its inputs moved
+    params.update();
 
-    asym = apvts.getRawParameterValue("asym")->load();
+    inGain  = juce::Decibels::decibelsToGain(params[pIn]);
+    outGain = juce::Decibels::decibelsToGain(params[pOut]);
+    mixTarget = params[pMix];
 
-    const int mdl = (int) apvts.getRawParameterValue("model")->load();
-    model = (Model) juce::jlimit(0, 4, mdl);
+    if (params.changed(pDrive))
+        shaper.setDriveDb(params[pDrive]);
 
-    const int chm = (int) apvts.getRawParameterValue("channelMode")->load();
-    channelMode = (ChannelMode) juce::jlimit(0, 2, chm);
+    shaper.setAsymmetry(params[pAsym]);
+    shaper.setModel((Model) juce::jlimit(0, 4, params.getInt(pModel)));
+    channelMode = (ChannelMode) juce::jlimit(0, 2, params.getInt(pChannelMode));
 
     // Pre-tilt shelves
-    const float preTiltDbPerOct = apvts.getRawParameterValue("pretilt")->load();
-    const float nyq = 0.5f * sampleRate;
-    const float octaves = juce::jmax(0.0f, std::log2(juce::jmax(1.0f, nyq) / 200.0f));
-    const float totalDb = preTiltDbPerOct * octaves;
-    const float gainPre = juce::Decibels::decibelsToGain(totalDb);
-    const float gainPost = 1.0f / juce::jmax(1.0e-6f, gainPre);
+    const float preTiltDbPerOct = params[pPreTilt];
     enablePreTilt = std::abs(preTiltDbPerOct) > 1.0e-3f;
-    if (enablePreTilt)
+    if (enablePreTilt && params.changed(pPreTilt))
     {
-        preTilt.coefficients    = juce::dsp::IIR::Coefficients<float>::makeHighShelf(sampleRate, 200.0f, 0.707f, gainPre);
-        postDeTilt.coefficients = juce::dsp::IIR::Coefficients<float>::makeHighShelf(sampleRate, 200.0f, 0.707f, gainPost);
+        const float nyq = 0.5f * sampleRate;
+        const float octaves = juce::jmax(0.0f, std::log2(juce::jmax(1.0f, nyq) / 200.0f));
+        const float totalDb = preTiltDbPerOct * octaves;
+        const float gainPre = juce::Decibels::decibelsToGain(totalDb);
+        const float gainPost = 1.0f / juce::jmax(1.0e-6f, gainPre);
+        *preTilt.coefficients    = ArrayCoeffs::makeHighShelf(sampleRate, 200.0f, 0.707f, gainPre);
+        *postDeTilt.coefficients = ArrayCoeffs::makeHighShelf(sampleRate, 200.0f, 0.707f, gainPost);
     }
 
     // Post LP
-    const int lpSel = (int) apvts.getRawParameterValue("postlp")->load();
     const float lpTable[5] = { 0.0f, 22000.0f, 16000.0f, 12000.0f, 8000.0f };
-    const float cutoff = lpTable[juce::jlimit(0, 4, lpSel)];
+    const float cutoff = lpTable[juce::jlimit(0, 4, params.getInt(pPostLP))];
     enablePostLP = cutoff > 0.0f && cutoff < 0.49f * sampleRate;
-    if (enablePostLP)
-        postLP.coefficients = juce::dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, cutoff, 0.707f);
+    if (enablePostLP && params.changed(pPostLP))
+        *postLP.coefficients = ArrayCoeffs::makeLowPass(sampleRate, cutoff, 0.707f);
 
     // Oversampling selection
-    const int osSel = (int) apvts.getRawParameterValue("os")->load();
+    const int osSel = params.getInt(pOversampling);
     const int newFactor = (osSel == 0 ? 1 : (osSel == 1 ? 2 : 4));
     if (newFactor != osFactor)
     {
         osFactor = newFactor;
-        osStages = (osFactor == 1 ? 0 : (osFactor == 2 ? 1 : 2));
-        updateOversamplingIfNeeded(lastNumChannels);
+        selectOversampling();
     }
 
-    autoGain = apvts.getRawParameterValue("autoGain")->load() > 0.5f;
+    autoGain = params.getBool(pAutoGain);
 
     // Vocal Lo-Fi switch and filters
-    vocalLoFi = apvts.getRawParameterValue("vocal")->load() > 0.5f;
-    if (vocalLoFi)
+    vocalLoFi = params.getBool(pVocal);
+    if (vocalLoFi && (params.changed(pVocal) || params.changed(pVocalStyle)))
     {
-        int vstyle = (int) (apvts.getRawParameterValue("vocalStyle") ? apvts.getRawParameterValue("vocalStyle")->load() : 0);
-        if (vstyle == 1) // Telephone
+        if (params.getInt(pVocalStyle) == 1) // Telephone
         {
-            hpVox.coefficients  = juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, 300.0f, 0.707f);
-            hpVox2.coefficients = juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, 300.0f, 0.707f);
-            presencePeak.coefficients = juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, 2000.0f, 0.9f, juce::Decibels::decibelsToGain(7.0f));
-            lpVox.coefficients  = juce::dsp::IIR::Coefficients<float>::makeLowPass (sampleRate, 5000.0f, 0.707f);
-            lpVox2.coefficients = juce::dsp::IIR::Coefficients<float>::makeLowPass (sampleRate, 5000.0f, 0.707f);
+            const auto hp = ArrayCoeffs::makeHighPass(sampleRate, 300.0f, 0.707f);
+            const auto lp = ArrayCoeffs::makeLowPass (sampleRate, 5000.0f, 0.707f);
+            *hpVox.coefficients  = hp;
+            *hpVox2.coefficients = hp;
+            *presencePeak.coefficients = ArrayCoeffs::makePeakFilter(sampleRate, 2000.0f, 0.9f, juce::Decibels::decibelsToGain(7.0f));
+            *lpVox.coefficients  = lp;
+            *lpVox2.coefficients = lp;
             for (auto& c : comps) { c.thresh = -18.0f; c.ratio = 10.0f; c.attMs = 2.0f; c.relMs = 30.0f; }
         }
         else // Normal
         {
-            hpVox.coefficients = juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, 220.0f, 0.707f);
-            presencePeak.coefficients = juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, 2000.0f, 0.9f, juce::Decibels::decibelsToGain(4.5f));
-            lpVox.coefficients = juce::dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, 6500.0f, 0.707f);
-            hpVox2.coefficients = hpVox.coefficients; // defaults
-            lpVox2.coefficients = lpVox.coefficients;
+            const auto hp = ArrayCoeffs::makeHighPass(sampleRate, 220.0f, 0.707f);
+            const auto lp = ArrayCoeffs::makeLowPass(sampleRate, 6500.0f, 0.707f);
+            *hpVox.coefficients = hp;
+            *presencePeak.coefficients = ArrayCoeffs::makePeakFilter(sampleRate, 2000.0f, 0.9f, juce::Decibels::decibelsToGain(4.5f));
+            *lpVox.coefficients = lp;
+            *hpVox2.coefficients = hp; // defaults
+            *lpVox2.coefficients = lp;
             for (auto& c : comps) { c.thresh = -12.0f; c.ratio = 8.0f; c.attMs = 3.0f; c.relMs = 40.0f; }
         }
     }
 }
 
-void HungryGhostSaturationAudioProcessor::updateOversamplingIfNeeded(int numChannels)
+void HungryGhostSaturationAudioProcessor::selectOversampling()
 {
-    const int desiredStages = (osFactor == 1 ? 0 : (osFactor == 2 ? 1 : 2));
-    bool needRebuild = false;
-    if (!oversampling) needRebuild = true;
-    if (desiredStages != osStages) needRebuild = true;
-
-    if (needRebuild)
-    {
-        oversampling.reset();
-        if (desiredStages > 0)
-        {
-            oversampling = std::make_unique<juce::dsp::Oversampling<float>>(
-                (size_t) juce::jlimit(1, 2, numChannels), desiredStages,
-                juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR, true);
-        }
-        osStages = desiredStages;
-        // Prepare not required explicitly; Oversampling works directly with processSamplesUp/Down
-    }
+    // Both oversamplers were prepared in prepareToPlay(); switching only picks one
+    auto* selected = osFactor == 4 ? oversampler4x.get() : (osFactor == 2 ? oversampler2x.get() : nullptr);
+    if (selected != nullptr && selected != oversampling)
+        selected->reset(); // no filter history from the last time it was selected
+    oversampling = selected;
+    setLatencySamples(selected != nullptr ? (int) selected->getLatencyInSamples() : 0);
 }
 
 void HungryGhostSaturationAudioProcessor::resetDSPState()
@@ -563,16 +542,13 @@ void HungryGhostSaturationAudioProcessor::resetDSPState()
     for (auto& s : dcStates) { s.x1 = 0.0f; s.y1 = 0.0f; }
 }
 
-float HungryGhostSaturationAudioProcessor::mapDriveDbToK(float dB)
-{
-    // Map 0..36 dB to k in [1..8]
-    dB = juce::jlimit(0.0f, 36.0f, dB);
-    return juce::jmap(dB, 0.0f, 36.0f, 1.0f, 8.0f);
-}
-
 juce::AudioProcessorEditor* HungryGhostSaturationAudioProcessor::createEditor()
 {
+#ifdef HGS_HEADLESS_TEST
+    return nullptr;
+#else
     return new HungryGhostSaturationAudioProcessorEditor(*this);
+#endif
 }
 
 void HungryGhostSaturationAudioProcessor::setCurrentProgram(int index)
@@ -615,7 +591,9 @@ const juce::String HungryGhostSaturationAudioProcessor::getProgramName(int index
 }
 
 // JUCE plugin entry point
+#ifndef HGS_HEADLESS_TEST // headless builds link several processors into one binary
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 {
     return new HungryGhostSaturationAudioProcessor();
 }
+#endif
@@ -1,10 +1,12 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <audio/ParameterHandles.h>
+#include "dsp/Shaper.h"
 
 class HungryGhostSaturationAudioProcessor : public juce::AudioProcessor {
 public:
-    enum class Model { TANH = 0, ATAN = 1, SOFT = 2, FEXP = 3, AMP = 4 };
+    using Model = hgs::Shaper::Model;
     enum class ChannelMode { Stereo = 0, DualMono = 1, MonoSum = 2 };
 
     HungryGhostSaturationAudioProcessor();
@@ -40,6 +42,15 @@ private:
     juce::AudioProcessorValueTreeState apvts;
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
+    // Handles resolved once in the constructor; updateParameters() loads the snapshot per block
+    enum Param : size_t
+    {
+        pIn, pOut, pMix, pDrive, pAsym, pModel, pChannelMode, pPreTilt, pPostLP,
+        pOversampling, pAutoGain, pVocal, pVocalAmt, pVocalStyle,
+        kNumParams
+    };
+    audio::ParamSnapshot<kNumParams> params;
+
     // Cached runtime settings
     float sampleRate { 48000.0f };
     int maxBlock { 512 };
@@ -51,14 +62,8 @@ private:
     float mixTarget { 1.0f };
     juce::SmoothedValue<float> mixSmoothed;
 
-    // Drive mapping and model
-    Model model { Model::TANH };
-    float driveDb { 12.0f };
-    float k { 2.5f };
-    float driveGain { 1.0f }; // NEW: pre-gain into the shaper
-    float invTanhK { 1.0f };
-    float invAtanK { 1.0f };
-    float asym { 0.0f };
+    // Drive, model and asymmetry
+    hgs::Shaper shaper;
 
     // Channel mode
     ChannelMode channelMode { ChannelMode::Stereo };
@@ -105,10 +110,10 @@ private:
     float slapTimeMs { 95.0f }, slapMix { 0.15f }, slapFb { 0.05f };
     bool slapReady { false }; // guard to avoid popSample on unprepared delay line
 
-    // Oversampling
-    std::unique_ptr<juce::dsp::Oversampling<float>> oversampling;
+    // Oversampling: both factors are built in prepareToPlay(); the audio thread only selects
+    std::unique_ptr<juce::dsp::Oversampling<float>> oversampler2x, oversampler4x;
+    juce::dsp::Oversampling<float>* oversampling { nullptr }; // nullptr at 1x
     int osFactor { 2 };
-    int osStages { 1 }; // 1->2x, 2->4x
 
     // DC blocker for FEXP (per-channel)
     struct DCState { float x1 { 0.0f }; float y1 { 0.0f }; };
@@ -131,18 +136,9 @@ private:
 
     // Internal helpers
     void updateParameters();
-    void updateOversamplingIfNeeded(int numChannels);
+    void selectOversampling();
+    void processChunk(juce::AudioBuffer<float>& buffer);
     void resetDSPState();
-    static float mapDriveDbToK(float driveDb);
-
-    static inline float diodeSat(float x, float kk, float a)
-    {
-        float xp = juce::jlimit(-1.0f, 1.0f, x + 0.5f * a);
-        float xn = juce::jlimit(-1.0f, 1.0f, x - 0.5f * a);
-        auto f = [kk](float v){ return 1.0f - std::exp(-kk * juce::jlimit(-1.0f, 1.0f, v)); };
-        float y = 0.7f * (f(xp) - f(-xn));
-        return juce::jlimit(-1.0f, 1.0f, y);
-    }
 
     int currentProgram { 0 }; // 0 = Default, 1 = Obvious
 };
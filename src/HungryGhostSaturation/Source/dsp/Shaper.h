@@ -0,0 +1,97 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <cmath>
+
+namespace hgs {
+
+// Static waveshaper of the saturation plugin: drive pre-gain into one of five curves.
+// Runs at the oversampled rate; everything around it (tilt, DC block, auto gain) stays in the
+// processor.
+class Shaper
+{
+public:
+    enum class Model { TANH = 0, ATAN = 1, SOFT = 2, FEXP = 3, AMP = 4 };
+
+    void setModel(Model m) noexcept { model = m; }
+    Model getModel() const noexcept { return model; }
+
+    // Drive 0..36 dB sets both the pre-gain and the curve steepness k
+    void setDriveDb(float driveDb) noexcept
+    {
+        k = mapDriveDbToK(driveDb);
+        driveGain = juce::Decibels::decibelsToGain(driveDb);
+        invTanhK = 1.0f / (std::tanh(k) + 1.0e-6f);
+        invAtanK = 1.0f / (std::atan(k) + 1.0e-6f);
+    }
+
+    // Bias for the FEXP and AMP curves (-0.5..0.5)
+    void setAsymmetry(float a) noexcept { asym = a; }
+
+    void process(float* d, int numSamples) const noexcept
+    {
+        for (int n = 0; n < numSamples; ++n)
+        {
+            float x = juce::jlimit(-1.0f, 1.0f, d[n] * driveGain);
+            float y = 0.0f;
+            switch (model)
+            {
+                case Model::TANH:
+                    y = std::tanh(k * x) * invTanhK; break;
+                case Model::ATAN:
+                    y = std::atan(k * x) * invAtanK; break;
+                case Model::SOFT:
+                {
+                    float u = juce::jlimit(-1.0f, 1.0f, k * x);
+                    const float normSoft = 1.0f / (1.0f + 0.20f * (k - 1.0f)); // gentler normalization for more feel
+                    y = normSoft * softClipCubic1(u);
+                } break;
+                case Model::FEXP:
+                {
+                    float xa = juce::jlimit(-1.0f, 1.0f, x + asym);
+                    float denom = 1.0f - std::exp(-k);
+                    if (denom <= 1.0e-6f) denom = 1.0e-6f;
+                    y = (1.0f - std::exp(-k * xa)) / denom;
+                } break;
+                case Model::AMP:
+                {
+                    y = diodeSat(x, k, asym);
+                } break;
+            }
+            d[n] = juce::jlimit(-1.0f, 1.0f, y);
+        }
+    }
+
+    static float mapDriveDbToK(float dB) noexcept
+    {
+        // Map 0..36 dB to k in [1..8]
+        dB = juce::jlimit(0.0f, 36.0f, dB);
+        return juce::jmap(dB, 0.0f, 36.0f, 1.0f, 8.0f);
+    }
+
+private:
+    static inline float softClipCubic1(float u) noexcept
+    {
+        // Saturates to +/-1 at u=+/-1; smooth cubic
+        if (u >= 1.0f) return 1.0f;
+        if (u <= -1.0f) return -1.0f;
+        return 1.5f * u - 0.5f * u * u * u;
+    }
+
+    static inline float diodeSat(float x, float kk, float a) noexcept
+    {
+        float xp = juce::jlimit(-1.0f, 1.0f, x + 0.5f * a);
+        float xn = juce::jlimit(-1.0f, 1.0f, x - 0.5f * a);
+        auto f = [kk](float v){ return 1.0f - std::exp(-kk * juce::jlimit(-1.0f, 1.0f, v)); };
+        float y = 0.7f * (f(xp) - f(-xn));
+        return juce::jlimit(-1.0f, 1.0f, y);
+    }
+
+    Model model { Model::TANH };
+    float k { 2.5f };
+    float driveGain { 1.0f };
+    float invTanhK { 1.0f };
+    float invAtanK { 1.0f };
+    float asym { 0.0f };
+};
+
+} // namespace hgs
@@ -0,0 +1,107 @@
+#include <JuceHeader.h>
+#include <audio/RealtimeSanitizer.h>
+#include "../Source/PluginProcessor.h"
+
+using namespace juce;
+
+namespace {
+
+void setParam(HungryGhostSaturationAudioProcessor& proc, const char* id, float v)
+{
+    auto* p = proc.getAPVTS().getParameter(id);
+    p->setValueNotifyingHost(p->convertTo0to1(v));
+}
+
+// Renders numSamples of a 1 kHz sine in host blocks of blockSize; returns the last block's rms/peak
+float renderSine(HungryGhostSaturationAudioProcessor& proc, double sr, int numSamples, int blockSize, float amp,
+                 double& phase, bool& allFinite)
+{
+    AudioBuffer<float> buf(2, blockSize); MidiBuffer midi;
+    float crest = 0.0f;
+    for (int done = 0; done < numSamples; done += blockSize)
+    {
+        buf.setSize(2, jmin(blockSize, numSamples - done), false, false, true);
+        for (int n = 0; n < buf.getNumSamples(); ++n)
+        {
+            const float s = amp * (float) std::sin(phase);
+            phase += 2.0 * MathConstants<double>::pi * 1000.0 / sr;
+            buf.setSample(0, n, s);
+            buf.setSample(1, n, s);
+        }
+        proc.processBlock(buf, midi);
+
+        double acc = 0.0; float peak = 0.0f;
+        for (int ch = 0; ch < 2; ++ch)
+            for (int n = 0; n < buf.getNumSamples(); ++n)
+            {
+                const float x = buf.getSample(ch, n);
+                allFinite = allFinite && std::isfinite(x);
+                acc += (double) x * x;
+                peak = jmax(peak, std::abs(x));
+            }
+        crest = (float) std::sqrt(acc / (2 * buf.getNumSamples())) / jmax(1.0e-9f, peak);
+    }
+    return crest;
+}
+
+} // namespace
+
+class OversamplingSwitchTest : public UnitTest
+{
+public:
+    OversamplingSwitchTest() : UnitTest("HGS Oversampling Switch") {}
+    void runTest() override
+    {
+        const double sr = 48000.0; const int block = 512;
+
+        beginTest("Every factor saturates and reports its latency");
+        {
+            // A heavily driven sine clips toward a square: rms/peak rises from 0.707 toward 1
+            for (int os = 0; os < 3; ++os)
+            {
+                HungryGhostSaturationAudioProcessor proc;
+                setParam(proc, "os", (float) os);
+                setParam(proc, "drive", 24.0f);
+                setParam(proc, "autoGain", 0.0f);
+                proc.prepareToPlay(sr, block);
+
+                double phase = 0.0; bool finite = true;
+                const float crest = renderSine(proc, sr, 8 * block, block, 0.25f, phase, finite);
+                expect(finite);
+                expectGreaterThan(crest, 0.85f, "os " + String(os));
+                expect(os == 0 ? proc.getLatencySamples() == 0 : proc.getLatencySamples() > 0);
+            }
+        }
+
+        beginTest("Switching factors and oversized host blocks render without allocating");
+        {
+            // The sanitizer fails this test on any allocation or lock inside processBlock
+            HungryGhostSaturationAudioProcessor proc;
+            proc.prepareToPlay(sr, block);
+
+            double phase = 0.0; bool finite = true;
+            const int hostBlocks[] = { block, 100, 3 * block + 7, 1 };
+            const float factors[] = { 0.0f, 2.0f, 1.0f, 0.0f, 1.0f, 2.0f };
+            for (const float os : factors)
+            {
+                setParam(proc, "os", os);
+                for (const int hostBlock : hostBlocks)
+                    renderSine(proc, sr, hostBlock, hostBlock, 0.5f, phase, finite);
+            }
+            setParam(proc, "channelMode", 2.0f); // mono sum through the stereo oversampler
+            for (const int hostBlock : hostBlocks)
+                renderSine(proc, sr, hostBlock, hostBlock, 0.5f, phase, finite);
+            expect(finite);
+        }
+    }
+};
+
+static OversamplingSwitchTest oversamplingSwitchTest;
+
+int main (int, char**)
+{
+    ConsoleApplication app;
+    audio::rtsan::TestRunner runner;
+    runner.runAllTests();
+    return runner.finish();
+}